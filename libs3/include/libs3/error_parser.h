@@ -78,6 +78,10 @@ S3Status error_parser_add(ErrorParser* errorParser, char* buffer, int bufferSize
 
 void error_parser_convert_status(ErrorParser* errorParser, S3Status* status);
 
+// Converts an S3 error code such as "NoSuchKey" into its S3Status, or
+// S3StatusErrorUnknown if it is not known
+void error_parser_convert_code(const char* code, S3Status* status);
+
 // Always call this
 void error_parser_deinitialize(ErrorParser* errorParser);
 
@@ -142,6 +142,12 @@ extern "C" {
  **/
 #define S3_MAX_KEY_SIZE                   1024
 
+/**
+ * S3_MAX_DELETE_OBJECTS_COUNT is the maximum number of keys that may be
+ * deleted with one S3_delete_objects request.
+ **/
+#define S3_MAX_DELETE_OBJECTS_COUNT       1000
+
 /**
  * S3_MAX_METADATA_SIZE is the maximum number of bytes allowed for
  * x-amz-meta header names and values in any request passed to Amazon S3
@@ -958,6 +964,14 @@ typedef struct S3PutProperties
      **/
     int64_t xAmzDecodedContentLength;
 
+    /**
+     * This optional field sets the x-amz-copy-source-if-match header on
+     * S3_copy_object() requests.  The copy then fails with
+     * S3StatusErrorPreconditionFailed unless the ETag of the source object
+     * matches this value.
+     **/
+    const char* xAmzCopySourceIfMatch;
+
 } S3PutProperties;
 
 /**
@@ -1074,6 +1088,17 @@ typedef S3Status(S3ResponsePropertiesCallback)(const S3ResponseProperties* prope
  **/
 typedef void(S3ResponseCompleteCallback)(S3Status status, const S3ErrorDetails* errorDetails, void* callbackData);
 
+/**
+ * This callback is made periodically while a request that was issued with it
+ * is in progress, including while the connection is being made.  Returning
+ * nonzero aborts the request, which then completes with S3StatusInterrupted.
+ *
+ * @param callbackData is the callback data as specified when the request
+ *        was issued.
+ * @return nonzero to abort the request, 0 to continue.
+ **/
+typedef int(S3AbortCallback)(void* callbackData);
+
 /**
  * This callback is made for each bucket resulting from a list service
  * operation.
@@ -1136,6 +1161,31 @@ typedef S3Status(S3ListBucketCallback)(int isTruncated,
                                        const char** commonPrefixes,
                                        void* callbackData);
 
+/**
+ * This callback is made once for each key reported back by a delete objects
+ * operation.  In quiet mode only the keys that could not be deleted are
+ * reported.
+ *
+ * @param key is the key that was deleted or could not be deleted
+ * @param status is S3StatusOK if the key was deleted (S3 also reports keys
+ *        that did not exist as deleted), otherwise the S3Status of the S3
+ *        error code, S3StatusErrorUnknown if the code is not known
+ * @param errorCode is the S3 error code if the key could not be deleted,
+ *        otherwise NULL
+ * @param errorMessage is the S3 error message if the key could not be
+ *        deleted and S3 supplied one, otherwise NULL
+ * @param callbackData is the callback data as specified when the request
+ *        was issued.
+ * @return S3StatusOK to continue processing the request, anything else to
+ *         immediately abort the request with a status which will be
+ *         passed to the S3ResponseCompleteCallback for this request.
+ **/
+typedef S3Status(S3DeleteObjectsCallback)(const char* key,
+                                          S3Status status,
+                                          const char* errorCode,
+                                          const char* errorMessage,
+                                          void* callbackData);
+
 /**
  * This callback is made during a put object operation, to obtain the next
  * chunk of data to put to the S3 service as the contents of the object.  This
@@ -1392,6 +1442,24 @@ typedef struct S3ListBucketHandler
 	S3ListBucketCallback* listBucketCallback;
 } S3ListBucketHandler;
 
+/**
+ * An S3DeleteObjectsHandler defines the callbacks which are made for
+ * delete_objects requests.
+ **/
+typedef struct S3DeleteObjectsHandler
+{
+	/**
+	 * responseHandler provides the properties and complete callback
+	 **/
+	S3ResponseHandler responseHandler;
+
+	/**
+	 * The deleteObjectsCallback is called for each key reported back by S3
+	 * before the complete callback is made.
+	 **/
+	S3DeleteObjectsCallback* deleteObjectsCallback;
+} S3DeleteObjectsHandler;
+
 /**
  * An S3GetObjectAttributesHandler defines the callbacks which are made for
  * get_object_attributes requests.
@@ -1909,6 +1977,22 @@ S3Status S3_generate_authenticated_query_string(char* buffer,
                                                 const char* resource,
                                                 const char* httpMethod);
 
+/**
+ * Derives the signing key used to sign requests today (UTC) in the given
+ * region with the secret access key and keeps it.  The last few signing keys
+ * are kept as requests are signed anyway; this allows the work to be done
+ * ahead of a request whose latency matters.
+ *
+ * @param secretAccessKey gives the secret access key requests will be signed
+ *        with
+ * @param authRegion gives the AWS region requests will be signed for, or NULL
+ *        for the default region
+ * @return One of:
+ *         S3StatusInternalError if secretAccessKey is NULL
+ *         S3StatusOK on success
+ **/
+S3Status S3_precompute_signing_key(const char* secretAccessKey, const char* authRegion);
+
 /** **************************************************************************
  * Service Functions
  ************************************************************************** **/
@@ -2115,6 +2199,60 @@ void S3_list_bucket(const S3BucketContext* bucketContext,
                     const S3ListBucketHandler* handler,
                     void* callbackData);
 
+/**
+ * Lists keys within a bucket with the ListObjectsV2 API.  The owner of each key
+ * is not fetched.
+ *
+ * @param bucketContext gives the bucket and associated parameters for this
+ *        request
+ * @param prefix if present and non-empty, gives a prefix for matching keys
+ * @param continuationToken if present and non-empty, continues a previous
+ *        listing which returned this value as its next continuation token
+ * @param startAfter if present and non-empty, only keys occuring after this
+ *        value will be listed.  Ignored by S3 when continuationToken is given.
+ * @param delimiter if present and non-empty, causes keys that contain the
+ *        same string between the prefix and the first occurrence of the
+ *        delimiter to be rolled up into a single result element
+ * @param maxkeys is the maximum number of keys to return, 0 for the service
+ *        default (1000)
+ * @param requestContext if non-NULL, gives the S3RequestContext to add this
+ *        request to, and does not perform the request immediately.  If NULL,
+ *        performs the request immediately and synchronously.
+ * @param timeoutMs if not 0 contains total request timeout in milliseconds
+ * @param handler gives the callbacks to call as the request is processed and
+ *        completed.  The nextMarker argument of the list bucket callback is
+ *        the next continuation token.
+ * @param callbackData will be passed in as the callbackData parameter to
+ *        all callbacks for this request
+ **/
+void S3_list_objects_v2(const S3BucketContext* bucketContext,
+                        const char* prefix,
+                        const char* continuationToken,
+                        const char* startAfter,
+                        const char* delimiter,
+                        int maxkeys,
+                        S3RequestContext* requestContext,
+                        int timeoutMs,
+                        const S3ListBucketHandler* handler,
+                        void* callbackData);
+
+/**
+ * Parses the body of a ListObjects or ListObjectsV2 response, making the
+ * same list bucket callbacks that S3_list_bucket and S3_list_objects_v2 make.
+ *
+ * @param xml is the response body
+ * @param xmlLen is the length of the response body
+ * @param callback is called one or more times with the parsed keys
+ * @param callbackData will be passed in as the callbackData parameter to
+ *        the callback
+ * @return S3StatusOK on success, or the status returned by the callback or
+ *        the parser on failure
+ **/
+S3Status S3_parse_list_bucket_response(const char* xml,
+                                       int xmlLen,
+                                       S3ListBucketCallback* callback,
+                                       void* callbackData);
+
 /** **************************************************************************
  * Object Functions
  ************************************************************************** **/
@@ -2309,6 +2447,20 @@ void S3_head_object(const S3BucketContext* bucketContext,
                     const S3ResponseHandler* handler,
                     void* callbackData);
 
+/**
+ * Same as S3_head_object, but the request can be aborted by another thread.
+ *
+ * @param abortCallback if non-NULL, is made periodically while the request
+ *        is in progress and aborts it when it returns nonzero
+ **/
+void S3_head_object_ex(const S3BucketContext* bucketContext,
+                       const char* key,
+                       S3RequestContext* requestContext,
+                       int timeoutMs,
+                       const S3ResponseHandler* handler,
+                       S3AbortCallback* abortCallback,
+                       void* callbackData);
+
 /**
  * Gets the object attributes for the object, but not the object contents.
  *
@@ -2358,6 +2510,40 @@ void S3_delete_object(const S3BucketContext* bucketContext,
                       const S3ResponseHandler* handler,
                       void* callbackData);
 
+/**
+ * Deletes up to S3_MAX_DELETE_OBJECTS_COUNT objects of a bucket with one
+ * Multi-Object Delete (POST /?delete) request.  The XML request body is
+ * generated from the keys as it is sent.  The request as a whole succeeds
+ * even if some of the keys could not be deleted; the result of each key is
+ * reported through the deleteObjectsCallback.  Requesting more than
+ * S3_MAX_DELETE_OBJECTS_COUNT keys completes with S3StatusXmlDocumentTooLarge
+ * and requesting none completes immediately with S3StatusOK.
+ *
+ * @param bucketContext gives the bucket and associated parameters for this
+ *        request
+ * @param keyCount is the number of keys in keys
+ * @param keys are the keys of the objects to delete.  The keys must remain
+ *        valid until the request completes.
+ * @param quiet if nonzero, only the keys that could not be deleted are
+ *        reported back; otherwise every key is reported
+ * @param requestContext if non-NULL, gives the S3RequestContext to add this
+ *        request to, and does not perform the request immediately.  If NULL,
+ *        performs the request immediately and synchronously.
+ * @param timeoutMs if not 0 contains total request timeout in milliseconds
+ * @param handler gives the callbacks to call as the request is processed and
+ *        completed
+ * @param callbackData will be passed in as the callbackData parameter to
+ *        all callbacks for this request
+ **/
+void S3_delete_objects(const S3BucketContext* bucketContext,
+                       int keyCount,
+                       const char* const* keys,
+                       int quiet,
+                       S3RequestContext* requestContext,
+                       int timeoutMs,
+                       const S3DeleteObjectsHandler* handler,
+                       void* callbackData);
+
 /** **************************************************************************
  * Access Control List Functions
  ************************************************************************** **/
@@ -0,0 +1,116 @@
+/** **************************************************************************
+ * list_bucket_parser.h
+ *
+ * This file is part of libs3.
+ *
+ * libs3 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, version 3 or above of the License.  You can also
+ * redistribute and/or modify it under the terms of the GNU General Public
+ * License, version 2 or above of the License.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of this library and its programs with the
+ * OpenSSL library, and distribute linked combinations including the two.
+ *
+ * libs3 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with libs3, in a file named COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * You should also have received a copy of the GNU General Public License
+ * version 2 along with libs3, in a file named COPYING-GPLv2.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ ************************************************************************** **/
+
+#ifndef LIST_BUCKET_PARSER_H
+#define LIST_BUCKET_PARSER_H
+
+#include "libs3/libs3.h"
+
+// Streaming parser for ListBucketResult responses (ListObjects and
+// ListObjectsV2).
+//
+// The response bytes are appended to a single growable arena as they arrive
+// and scanned incrementally for complete tags.  Field values are entity
+// decoded and NUL terminated in place inside the arena and only their offsets
+// are recorded, so no per-field copies are made.  All of the Contents and
+// CommonPrefixes of a response are delivered with a single
+// S3ListBucketCallback once the response is complete, i.e. in batches sized
+// to the page that was requested.
+//
+// Only the subset of XML that S3 produces is understood: elements, attributes,
+// the five predefined entities and character references.  Processing
+// instructions and declarations are skipped; CDATA sections are not
+// supported.
+
+// Offsets into the arena of the fields of one Contents, -1 if not present
+typedef struct ListBucketParserContents
+{
+	int key;
+	int lastModified;
+	int eTag;
+	int size;
+	int ownerId;
+	int ownerDisplayName;
+} ListBucketParserContents;
+
+#define LIST_BUCKET_PARSER_MAX_DEPTH 8
+
+typedef struct ListBucketParser
+{
+	// The response, with values decoded in place
+	char* arena;
+	int arenaSize;
+	int arenaCapacity;
+
+	// Where scanning resumes when more data is added
+	int scanPosition;
+
+	// Start of the character data of the innermost open element
+	int textStart;
+
+	// Identifiers of the open elements, outermost first
+	int depth;
+	unsigned char path[LIST_BUCKET_PARSER_MAX_DEPTH];
+
+	int isTruncated;
+	int nextMarker;
+
+	ListBucketParserContents* contents;
+	int contentsCount;
+	int contentsCapacity;
+
+	int* commonPrefixes;
+	int commonPrefixesCount;
+	int commonPrefixesCapacity;
+
+	// The last LastModified converted, truncated to the hour, and its time.
+	// Keys listed together tend to be modified in the same hour, and the
+	// mktime() behind each conversion costs more than parsing the key.
+	char lastModifiedHour[64];
+	int64_t lastModifiedHourTime;
+
+	S3Status status;
+} ListBucketParser;
+
+// Always call this, even if the parser doesn't end up being used
+void list_bucket_parser_initialize(ListBucketParser* parser);
+
+// Adds the next chunk of the response and parses every tag that it completes
+S3Status list_bucket_parser_add(ListBucketParser* parser, const char* data, int dataLen);
+
+// Makes one callback with everything that was parsed, if there is anything.
+// Returns S3StatusXmlParseFailure if the response ended inside an element,
+// otherwise the status returned by the callback.
+S3Status list_bucket_parser_finish(ListBucketParser* parser, S3ListBucketCallback* callback, void* callbackData);
+
+// Always call this.  The parser may be initialized again afterwards.
+void list_bucket_parser_deinitialize(ListBucketParser* parser);
+
+#endif /* LIST_BUCKET_PARSER_H */
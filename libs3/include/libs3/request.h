@@ -121,6 +121,12 @@ typedef struct RequestParams
 	 * When set, enables chunked transfer encoding with trailing header support.
 	 **/
 	void* chunkedState;
+
+	/**
+	 * If non-NULL, made periodically while a request is in progress and
+	 * aborts the request when it returns nonzero.
+	 **/
+	S3AbortCallback* abortCallback;
 } RequestParams;
 
 // This is the stuff associated with a request that needs to be on the heap
@@ -170,6 +176,10 @@ typedef struct Request
 	// Data passed to the callbacks
 	void* callbackData;
 
+	// Callback to be made periodically to check whether the request should be
+	// aborted.  May be NULL.
+	S3AbortCallback* abortCallback;
+
 	// Handler of response headers
 	ResponseHeadersHandler responseHeadersHandler;
 
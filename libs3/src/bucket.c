@@ -30,10 +30,10 @@
  *
  ************************************************************************** **/
 
-#include <alloca.h>
 #include <string.h>
 #include <stdlib.h>
 #include "libs3/libs3.h"
+#include "libs3/list_bucket_parser.h"
 #include "libs3/request.h"
 #include "libs3/simplexml.h"
 
@@ -159,7 +159,8 @@ void S3_test_bucket(S3Protocol protocol,
 		tbData,                        // callbackData
 		timeoutMs,                     // timeoutMs
 		0,                             // xAmzObjectAttributes
-		0                              // chunkedState
+		0,                             // chunkedState
+		0                              // abortCallback
 	};
 
 	// Perform the request
@@ -284,7 +285,8 @@ void S3_create_bucket(S3Protocol protocol,
         0,         // xAmzChecksumAlgorithm
         0,         // xAmzChecksumType
         0,         // xAmzTrailer
-        -1         // xAmzDecodedContentLength (-1 = unknown)
+        -1,        // xAmzDecodedContentLength (-1 = unknown)
+        0          // xAmzCopySourceIfMatch
 	};
 
 	// Set up the RequestParams
@@ -316,7 +318,8 @@ void S3_create_bucket(S3Protocol protocol,
 		cbData,                          // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		0                                // abortCallback
 	};
 
 	// Perform the request
@@ -404,7 +407,8 @@ void S3_delete_bucket(S3Protocol protocol,
 		dbData,                          // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		0                                // abortCallback
 	};
 
 	// Perform the request
@@ -413,190 +417,16 @@ void S3_delete_bucket(S3Protocol protocol,
 
 // list bucket ----------------------------------------------------------------
 
-typedef struct ListBucketContents
-{
-	string_buffer(key, 1024);
-	string_buffer(lastModified, 256);
-	string_buffer(eTag, 256);
-	string_buffer(size, 24);
-	string_buffer(ownerId, 256);
-	string_buffer(ownerDisplayName, 256);
-} ListBucketContents;
-
-static void initialize_list_bucket_contents(ListBucketContents* contents)
-{
-	string_buffer_initialize(contents->key);
-	string_buffer_initialize(contents->lastModified);
-	string_buffer_initialize(contents->eTag);
-	string_buffer_initialize(contents->size);
-	string_buffer_initialize(contents->ownerId);
-	string_buffer_initialize(contents->ownerDisplayName);
-}
-
-// We read up to 32 Contents at a time
-#define MAX_CONTENTS        32
-// We read up to 8 CommonPrefixes at a time
-#define MAX_COMMON_PREFIXES 8
-
 typedef struct ListBucketData
 {
-	SimpleXml simpleXml;
+	ListBucketParser listBucketParser;
 
 	S3ResponsePropertiesCallback* responsePropertiesCallback;
 	S3ListBucketCallback* listBucketCallback;
 	S3ResponseCompleteCallback* responseCompleteCallback;
 	void* callbackData;
-
-	string_buffer(isTruncated, 64);
-	string_buffer(nextMarker, 1024);
-
-	int contentsCount;
-	ListBucketContents contents[MAX_CONTENTS];
-
-	int commonPrefixesCount;
-	char commonPrefixes[MAX_COMMON_PREFIXES][1024];
-	int commonPrefixLens[MAX_COMMON_PREFIXES];
 } ListBucketData;
 
-static void initialize_list_bucket_data(ListBucketData* lbData)
-{
-	lbData->contentsCount = 0;
-	initialize_list_bucket_contents(lbData->contents);
-	lbData->commonPrefixesCount = 0;
-	lbData->commonPrefixes[0][0] = 0;
-	lbData->commonPrefixLens[0] = 0;
-}
-
-static S3Status make_list_bucket_callback(ListBucketData* lbData)
-{
-	int i;
-
-	// Convert IsTruncated
-	int isTruncated = (!strcmp(lbData->isTruncated, "true") || !strcmp(lbData->isTruncated, "1")) ? 1 : 0;
-
-	// Convert the contents
-	S3ListBucketContent* contents = alloca(sizeof(S3ListBucketContent) * lbData->contentsCount);
-
-	int contentsCount = lbData->contentsCount;
-	for (i = 0; i < contentsCount; i++) {
-		S3ListBucketContent* contentDest = &(contents[i]);
-		ListBucketContents* contentSrc = &(lbData->contents[i]);
-		contentDest->key = contentSrc->key;
-		contentDest->lastModified = parseIso8601Time(contentSrc->lastModified);
-		contentDest->eTag = contentSrc->eTag;
-		contentDest->size = parseUnsignedInt(contentSrc->size);
-		contentDest->ownerId = contentSrc->ownerId[0] ? contentSrc->ownerId : 0;
-		contentDest->ownerDisplayName = (contentSrc->ownerDisplayName[0] ? contentSrc->ownerDisplayName : 0);
-	}
-
-	// Make the common prefixes array
-	int commonPrefixesCount = lbData->commonPrefixesCount;
-	char** commonPrefixes = alloca(sizeof(char*) * commonPrefixesCount);
-	for (i = 0; i < commonPrefixesCount; i++) {
-		commonPrefixes[i] = lbData->commonPrefixes[i];
-	}
-
-	return (*(lbData->listBucketCallback))(isTruncated,
-	                                       lbData->nextMarker,
-	                                       contentsCount,
-	                                       contents,
-	                                       commonPrefixesCount,
-	                                       (const char**) commonPrefixes,
-	                                       lbData->callbackData);
-}
-
-static S3Status listBucketXmlCallback(const char* elementPath, const char* data, int dataLen, void* callbackData)
-{
-	ListBucketData* lbData = (ListBucketData*) callbackData;
-
-	int fit;
-
-	if (data) {
-		if (!strcmp(elementPath, "ListBucketResult/IsTruncated")) {
-			string_buffer_append(lbData->isTruncated, data, dataLen, fit);
-		}
-		else if (!strcmp(elementPath, "ListBucketResult/NextMarker")) {
-			string_buffer_append(lbData->nextMarker, data, dataLen, fit);
-		}
-		else if (!strcmp(elementPath, "ListBucketResult/Contents/Key")) {
-			ListBucketContents* contents = &(lbData->contents[lbData->contentsCount]);
-			string_buffer_append(contents->key, data, dataLen, fit);
-		}
-		else if (!strcmp(elementPath, "ListBucketResult/Contents/LastModified")) {
-			ListBucketContents* contents = &(lbData->contents[lbData->contentsCount]);
-			string_buffer_append(contents->lastModified, data, dataLen, fit);
-		}
-		else if (!strcmp(elementPath, "ListBucketResult/Contents/ETag")) {
-			ListBucketContents* contents = &(lbData->contents[lbData->contentsCount]);
-			string_buffer_append(contents->eTag, data, dataLen, fit);
-		}
-		else if (!strcmp(elementPath, "ListBucketResult/Contents/Size")) {
-			ListBucketContents* contents = &(lbData->contents[lbData->contentsCount]);
-			string_buffer_append(contents->size, data, dataLen, fit);
-		}
-		else if (!strcmp(elementPath, "ListBucketResult/Contents/Owner/ID")) {
-			ListBucketContents* contents = &(lbData->contents[lbData->contentsCount]);
-			string_buffer_append(contents->ownerId, data, dataLen, fit);
-		}
-		else if (!strcmp(elementPath, "ListBucketResult/Contents/Owner/DisplayName")) {
-			ListBucketContents* contents = &(lbData->contents[lbData->contentsCount]);
-			string_buffer_append(contents->ownerDisplayName, data, dataLen, fit);
-		}
-		else if (!strcmp(elementPath, "ListBucketResult/CommonPrefixes/Prefix")) {
-			int which = lbData->commonPrefixesCount;
-			size_t oldLen = lbData->commonPrefixLens[which];
-			lbData->commonPrefixLens[which] += snprintf(lbData->commonPrefixes[which] + oldLen,
-			                                            sizeof(lbData->commonPrefixes[which]) - oldLen - 1,
-			                                            "%.*s",
-			                                            dataLen,
-			                                            data);
-			if (lbData->commonPrefixLens[which] >= (int) sizeof(lbData->commonPrefixes[which])) {
-				return S3StatusXmlParseFailure;
-			}
-		}
-	}
-	else {
-		if (!strcmp(elementPath, "ListBucketResult/Contents")) {
-			// Finished a Contents
-			lbData->contentsCount++;
-			if (lbData->contentsCount == MAX_CONTENTS) {
-				// Make the callback
-				S3Status status = make_list_bucket_callback(lbData);
-				if (status != S3StatusOK) {
-					return status;
-				}
-				initialize_list_bucket_data(lbData);
-			}
-			else {
-				// Initialize the next one
-				initialize_list_bucket_contents(&(lbData->contents[lbData->contentsCount]));
-			}
-		}
-		else if (!strcmp(elementPath, "ListBucketResult/CommonPrefixes/Prefix")) {
-			// Finished a Prefix
-			lbData->commonPrefixesCount++;
-			if (lbData->commonPrefixesCount == MAX_COMMON_PREFIXES) {
-				// Make the callback
-				S3Status status = make_list_bucket_callback(lbData);
-				if (status != S3StatusOK) {
-					return status;
-				}
-				initialize_list_bucket_data(lbData);
-			}
-			else {
-				// Initialize the next one
-				lbData->commonPrefixes[lbData->commonPrefixesCount][0] = 0;
-				lbData->commonPrefixLens[lbData->commonPrefixesCount] = 0;
-			}
-		}
-	}
-
-	/* Avoid compiler error about variable set but not used */
-	(void) fit;
-
-	return S3StatusOK;
-}
-
 static S3Status listBucketPropertiesCallback(const S3ResponseProperties* responseProperties, void* callbackData)
 {
 	ListBucketData* lbData = (ListBucketData*) callbackData;
@@ -608,25 +438,85 @@ static S3Status listBucketDataCallback(int bufferSize, const char* buffer, void*
 {
 	ListBucketData* lbData = (ListBucketData*) callbackData;
 
-	return simplexml_add(&(lbData->simpleXml), buffer, bufferSize);
+	return list_bucket_parser_add(&(lbData->listBucketParser), buffer, bufferSize);
 }
 
 static void listBucketCompleteCallback(S3Status requestStatus, const S3ErrorDetails* s3ErrorDetails, void* callbackData)
 {
 	ListBucketData* lbData = (ListBucketData*) callbackData;
 
-	// Make the callback if there is anything
-	if (lbData->contentsCount || lbData->commonPrefixesCount) {
-		make_list_bucket_callback(lbData);
+	// Deliver the whole page with one callback
+	if (requestStatus == S3StatusOK) {
+		requestStatus =
+			list_bucket_parser_finish(&(lbData->listBucketParser), lbData->listBucketCallback, lbData->callbackData);
 	}
 
 	(*(lbData->responseCompleteCallback))(requestStatus, s3ErrorDetails, lbData->callbackData);
 
-	simplexml_deinitialize(&(lbData->simpleXml));
+	list_bucket_parser_deinitialize(&(lbData->listBucketParser));
 
 	free(lbData);
 }
 
+// Sends a list request with the given query parameters, shared by ListObjects and ListObjectsV2
+static void list_bucket_perform(const S3BucketContext* bucketContext,
+                                const char* queryParams,
+                                S3RequestContext* requestContext,
+                                int timeoutMs,
+                                const S3ListBucketHandler* handler,
+                                void* callbackData)
+{
+	ListBucketData* lbData = (ListBucketData*) malloc(sizeof(ListBucketData));
+
+	if (!lbData) {
+		(*(handler->responseHandler.completeCallback))(S3StatusOutOfMemory, 0, callbackData);
+		return;
+	}
+
+	list_bucket_parser_initialize(&(lbData->listBucketParser));
+
+	lbData->responsePropertiesCallback = handler->responseHandler.propertiesCallback;
+	lbData->listBucketCallback = handler->listBucketCallback;
+	lbData->responseCompleteCallback = handler->responseHandler.completeCallback;
+	lbData->callbackData = callbackData;
+
+	// Set up the RequestParams
+	RequestParams params = {
+		HttpRequestTypeGET,               // httpRequestType
+		{bucketContext->hostName,         // hostName
+	     bucketContext->bucketName,       // bucketName
+	     bucketContext->protocol,         // protocol
+	     bucketContext->uriStyle,         // uriStyle
+	     bucketContext->accessKeyId,      // accessKeyId
+	     bucketContext->secretAccessKey,  // secretAccessKey
+	     bucketContext->securityToken,    // securityToken
+	     bucketContext->authRegion,       // authRegion
+	     bucketContext->stsDate},         // stsDate
+		0,                                // key
+		queryParams[0] ? queryParams : 0, // queryParams
+		0,                                // subResource
+		0,                                // copySourceBucketName
+		0,                                // copySourceKey
+		0,                                // getConditions
+		0,                                // startByte
+		0,                                // byteCount
+		0,                                // putProperties
+		&listBucketPropertiesCallback,    // propertiesCallback
+		0,                                // toS3Callback
+		0,                                // toS3CallbackTotalSize
+		&listBucketDataCallback,          // fromS3Callback
+		&listBucketCompleteCallback,      // completeCallback
+		lbData,                           // callbackData
+		timeoutMs,                        // timeoutMs
+		0,                                // xAmzObjectAttributes
+		0,                                // chunkedState
+		0                                 // abortCallback
+	};
+
+	// Perform the request
+	request_perform(&params, requestContext);
+}
+
 void S3_list_bucket(const S3BucketContext* bucketContext,
                     const char* prefix,
                     const char* marker,
@@ -686,56 +576,61 @@ void S3_list_bucket(const S3BucketContext* bucketContext,
 		safe_append("max-keys", maxKeysString);
 	}
 
-	ListBucketData* lbData = (ListBucketData*) malloc(sizeof(ListBucketData));
+	list_bucket_perform(bucketContext, queryParams, requestContext, timeoutMs, handler, callbackData);
+}
 
-	if (!lbData) {
-		(*(handler->responseHandler.completeCallback))(S3StatusOutOfMemory, 0, callbackData);
-		return;
+void S3_list_objects_v2(const S3BucketContext* bucketContext,
+                        const char* prefix,
+                        const char* continuationToken,
+                        const char* startAfter,
+                        const char* delimiter,
+                        int maxkeys,
+                        S3RequestContext* requestContext,
+                        int timeoutMs,
+                        const S3ListBucketHandler* handler,
+                        void* callbackData)
+{
+	// Compose the query params
+	string_buffer(queryParams, 4096);
+	string_buffer_initialize(queryParams);
+
+	int amp = 0;
+	safe_append("list-type", "2");
+	if (prefix && *prefix) {
+		safe_append("prefix", prefix);
+	}
+	if (continuationToken && *continuationToken) {
+		safe_append("continuation-token", continuationToken);
+	}
+	if (startAfter && *startAfter) {
+		safe_append("start-after", startAfter);
+	}
+	if (delimiter && *delimiter) {
+		safe_append("delimiter", delimiter);
+	}
+	safe_append("fetch-owner", "false");
+	if (maxkeys) {
+		char maxKeysString[64];
+		snprintf(maxKeysString, sizeof(maxKeysString), "%d", maxkeys);
+		safe_append("max-keys", maxKeysString);
 	}
 
-	simplexml_initialize(&(lbData->simpleXml), &listBucketXmlCallback, lbData);
+	list_bucket_perform(bucketContext, queryParams, requestContext, timeoutMs, handler, callbackData);
+}
 
-	lbData->responsePropertiesCallback = handler->responseHandler.propertiesCallback;
-	lbData->listBucketCallback = handler->listBucketCallback;
-	lbData->responseCompleteCallback = handler->responseHandler.completeCallback;
-	lbData->callbackData = callbackData;
+S3Status S3_parse_list_bucket_response(const char* xml, int xmlLen, S3ListBucketCallback* callback, void* callbackData)
+{
+	ListBucketParser parser;
 
-	string_buffer_initialize(lbData->isTruncated);
-	string_buffer_initialize(lbData->nextMarker);
-	initialize_list_bucket_data(lbData);
+	list_bucket_parser_initialize(&parser);
 
-	// Set up the RequestParams
-	RequestParams params = {
-		HttpRequestTypeGET,               // httpRequestType
-		{bucketContext->hostName,         // hostName
-	     bucketContext->bucketName,       // bucketName
-	     bucketContext->protocol,         // protocol
-	     bucketContext->uriStyle,         // uriStyle
-	     bucketContext->accessKeyId,      // accessKeyId
-	     bucketContext->secretAccessKey,  // secretAccessKey
-	     bucketContext->securityToken,    // securityToken
-	     bucketContext->authRegion,       // authRegion
-	     bucketContext->stsDate},         // stsDate
-		0,                                // key
-		queryParams[0] ? queryParams : 0, // queryParams
-		0,                                // subResource
-		0,                                // copySourceBucketName
-		0,                                // copySourceKey
-		0,                                // getConditions
-		0,                                // startByte
-		0,                                // byteCount
-		0,                                // putProperties
-		&listBucketPropertiesCallback,    // propertiesCallback
-		0,                                // toS3Callback
-		0,                                // toS3CallbackTotalSize
-		&listBucketDataCallback,          // fromS3Callback
-		&listBucketCompleteCallback,      // completeCallback
-		lbData,                           // callbackData
-		timeoutMs,                        // timeoutMs
-		0,                                // xAmzObjectAttributes
-		0                                 // chunkedState
-	};
+	S3Status status = list_bucket_parser_add(&parser, xml, xmlLen);
 
-	// Perform the request
-	request_perform(&params, requestContext);
+	if (status == S3StatusOK) {
+		status = list_bucket_parser_finish(&parser, callback, callbackData);
+	}
+
+	list_bucket_parser_deinitialize(&parser);
+
+	return status;
 }
@@ -157,7 +157,8 @@ void S3_get_acl(const S3BucketContext* bucketContext,
 		gaData,                          // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		0                                // abortCallback
 	};
 
 	// Perform the request
@@ -355,7 +356,8 @@ void S3_set_acl(const S3BucketContext* bucketContext,
 		data,                            // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		0                                // abortCallback
 	};
 
 	// Perform the request
@@ -458,7 +460,8 @@ void S3_get_lifecycle(const S3BucketContext* bucketContext,
 		gaData,                          // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		0                                // abortCallback
 	};
 
 	// Perform the request
@@ -552,7 +555,8 @@ void S3_set_lifecycle(const S3BucketContext* bucketContext,
         0,         // xAmzChecksumAlgorithm
         0,         // xAmzChecksumType
         0,         // xAmzTrailer
-        -1         // xAmzDecodedContentLength (-1 = unknown)
+        -1,        // xAmzDecodedContentLength (-1 = unknown)
+        0          // xAmzCopySourceIfMatch
 	};
 
 	// Set up the RequestParams
@@ -584,7 +588,8 @@ void S3_set_lifecycle(const S3BucketContext* bucketContext,
 		data,                            // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		0                                // abortCallback
 	};
 
 	// Perform the request
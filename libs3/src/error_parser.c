@@ -142,9 +142,14 @@ void error_parser_convert_status(ErrorParser* errorParser, S3Status* status)
 		return;
 	}
 
+	error_parser_convert_code(errorParser->code, status);
+}
+
+void error_parser_convert_code(const char* code, S3Status* status)
+{
 #define HANDLE_CODE(name)                        \
 	do {                                         \
-		if (!strcmp(errorParser->code, #name)) { \
+		if (!strcmp(code, #name)) {              \
 			*status = S3StatusError##name;       \
 			goto code_set;                       \
 		}                                        \
@@ -31,29 +31,45 @@
  ************************************************************************** **/
 
 #include <ctype.h>
+#include <pthread.h>
 #include <string.h>
 #include "libs3/request.h"
 #include "libs3/simplexml.h"
 #include "libs3/util.h"
 
+// S3_initialize and S3_deinitialize may be called from any thread, so the
+// count of initializations is protected.
+static pthread_mutex_t initializeMutexG = PTHREAD_MUTEX_INITIALIZER;
 static int initializeCountG = 0;
 
 S3Status S3_initialize(const char* userAgentInfo, int flags, const char* defaultS3HostName)
 {
-	if (initializeCountG++) {
-		return S3StatusOK;
+	S3Status status = S3StatusOK;
+
+	pthread_mutex_lock(&initializeMutexG);
+
+	if (!initializeCountG) {
+		status = request_api_initialize(userAgentInfo, flags, defaultS3HostName);
+	}
+
+	if (status == S3StatusOK) {
+		initializeCountG++;
 	}
 
-	return request_api_initialize(userAgentInfo, flags, defaultS3HostName);
+	pthread_mutex_unlock(&initializeMutexG);
+
+	return status;
 }
 
 void S3_deinitialize()
 {
-	if (--initializeCountG) {
-		return;
+	pthread_mutex_lock(&initializeMutexG);
+
+	if (initializeCountG && !--initializeCountG) {
+		request_api_deinitialize();
 	}
 
-	request_api_deinitialize();
+	pthread_mutex_unlock(&initializeMutexG);
 }
 
 const char* S3_get_status_name(S3Status status)
@@ -0,0 +1,588 @@
+/** **************************************************************************
+ * list_bucket_parser.c
+ *
+ * This file is part of libs3.
+ *
+ * libs3 is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, version 3 or above of the License.  You can also
+ * redistribute and/or modify it under the terms of the GNU General Public
+ * License, version 2 or above of the License.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of this library and its programs with the
+ * OpenSSL library, and distribute linked combinations including the two.
+ *
+ * libs3 is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * version 3 along with libs3, in a file named COPYING.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * You should also have received a copy of the GNU General Public License
+ * version 2 along with libs3, in a file named COPYING-GPLv2.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ ************************************************************************** **/
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libs3/list_bucket_parser.h"
+#include "libs3/util.h"
+
+// The arena starts large enough for a typical 1000 key page
+#define INITIAL_ARENA_CAPACITY (256 * 1024)
+
+// Elements that the parser cares about, everything else is ElementOther
+enum
+{
+	ElementOther = 0,
+	ElementListBucketResult,
+	ElementIsTruncated,
+	ElementNextMarker,
+	ElementNextContinuationToken,
+	ElementContents,
+	ElementKey,
+	ElementLastModified,
+	ElementETag,
+	ElementSize,
+	ElementOwner,
+	ElementID,
+	ElementDisplayName,
+	ElementCommonPrefixes,
+	ElementPrefix
+};
+
+static int element_id(const char* name, int nameLen)
+{
+#define match(str, id)                                                    \
+	if (nameLen == (int) (sizeof(str) - 1) && !memcmp(name, str, nameLen)) { \
+		return id;                                                        \
+	}
+
+	switch (name[0]) {
+		case 'C':
+			match("Contents", ElementContents);
+			match("CommonPrefixes", ElementCommonPrefixes);
+			break;
+		case 'D':
+			match("DisplayName", ElementDisplayName);
+			break;
+		case 'E':
+			match("ETag", ElementETag);
+			break;
+		case 'I':
+			match("IsTruncated", ElementIsTruncated);
+			match("ID", ElementID);
+			break;
+		case 'K':
+			match("Key", ElementKey);
+			break;
+		case 'L':
+			match("LastModified", ElementLastModified);
+			match("ListBucketResult", ElementListBucketResult);
+			break;
+		case 'N':
+			match("NextMarker", ElementNextMarker);
+			match("NextContinuationToken", ElementNextContinuationToken);
+			break;
+		case 'O':
+			match("Owner", ElementOwner);
+			break;
+		case 'P':
+			match("Prefix", ElementPrefix);
+			break;
+		case 'S':
+			match("Size", ElementSize);
+			break;
+	}
+
+#undef match
+
+	return ElementOther;
+}
+
+static int is_name_end(char c)
+{
+	return ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') || (c == '/'));
+}
+
+// Writes the UTF-8 encoding of a character reference, returns its length
+static int encode_utf8(char* dest, unsigned long c)
+{
+	if (c < 0x80) {
+		dest[0] = (char) c;
+		return 1;
+	}
+	if (c < 0x800) {
+		dest[0] = (char) (0xC0 | (c >> 6));
+		dest[1] = (char) (0x80 | (c & 0x3F));
+		return 2;
+	}
+	if (c < 0x10000) {
+		dest[0] = (char) (0xE0 | (c >> 12));
+		dest[1] = (char) (0x80 | ((c >> 6) & 0x3F));
+		dest[2] = (char) (0x80 | (c & 0x3F));
+		return 3;
+	}
+	dest[0] = (char) (0xF0 | ((c >> 18) & 0x07));
+	dest[1] = (char) (0x80 | ((c >> 12) & 0x3F));
+	dest[2] = (char) (0x80 | ((c >> 6) & 0x3F));
+	dest[3] = (char) (0x80 | (c & 0x3F));
+	return 4;
+}
+
+// Decodes the entities of value in place and NUL terminates it.  The decoded
+// value is never longer than the encoded one, so this never writes past
+// value[len], which is the '<' of the end tag that has already been scanned.
+static S3Status decode_value(char* value, int len)
+{
+	char* amp = memchr(value, '&', len);
+
+	if (!amp) {
+		value[len] = 0;
+		return S3StatusOK;
+	}
+
+	const char* src = amp;
+	const char* end = value + len;
+	char* dest = amp;
+
+	while (src < end) {
+		if (*src != '&') {
+			*dest++ = *src++;
+			continue;
+		}
+
+		const char* semicolon = memchr(src, ';', end - src);
+		if (!semicolon) {
+			return S3StatusXmlParseFailure;
+		}
+
+		const char* entity = src + 1;
+		int entityLen = semicolon - entity;
+
+		if ((entityLen == 3) && !memcmp(entity, "amp", 3)) {
+			*dest++ = '&';
+		}
+		else if ((entityLen == 2) && !memcmp(entity, "lt", 2)) {
+			*dest++ = '<';
+		}
+		else if ((entityLen == 2) && !memcmp(entity, "gt", 2)) {
+			*dest++ = '>';
+		}
+		else if ((entityLen == 4) && !memcmp(entity, "quot", 4)) {
+			*dest++ = '"';
+		}
+		else if ((entityLen == 4) && !memcmp(entity, "apos", 4)) {
+			*dest++ = '\'';
+		}
+		else if ((entityLen > 1) && (entity[0] == '#')) {
+			// A character reference is at least as long as its encoding
+			int hex = ((entity[1] == 'x') || (entity[1] == 'X'));
+			const char* digits = entity + 1 + hex;
+			unsigned long c = 0;
+			if (digits == semicolon) {
+				return S3StatusXmlParseFailure;
+			}
+			for (; digits < semicolon; digits++) {
+				int d;
+				if ((*digits >= '0') && (*digits <= '9')) {
+					d = *digits - '0';
+				}
+				else if (hex && (*digits >= 'a') && (*digits <= 'f')) {
+					d = *digits - 'a' + 10;
+				}
+				else if (hex && (*digits >= 'A') && (*digits <= 'F')) {
+					d = *digits - 'A' + 10;
+				}
+				else {
+					return S3StatusXmlParseFailure;
+				}
+				c = (c * (hex ? 16 : 10)) + d;
+				if (c > 0x10FFFF) {
+					return S3StatusXmlParseFailure;
+				}
+			}
+			dest += encode_utf8(dest, c);
+		}
+		else {
+			return S3StatusXmlParseFailure;
+		}
+
+		src = semicolon + 1;
+	}
+
+	*dest = 0;
+
+	return S3StatusOK;
+}
+
+static S3Status grow(void** array, int* capacity, int count, size_t elementSize)
+{
+	if (count < *capacity) {
+		return S3StatusOK;
+	}
+
+	int newCapacity = *capacity ? (*capacity * 2) : 256;
+	void* newArray = realloc(*array, newCapacity * elementSize);
+	if (!newArray) {
+		return S3StatusOutOfMemory;
+	}
+
+	*array = newArray;
+	*capacity = newCapacity;
+
+	return S3StatusOK;
+}
+
+// Same as parseIso8601Time(), reusing the conversion of the previous value
+// when it is in the same hour
+static int64_t parse_last_modified(ListBucketParser* parser, const char* str)
+{
+	char hour[sizeof(parser->lastModifiedHour)];
+	size_t len = strlen(str);
+
+	// YYYY-MM-DDTHH:MM:SS
+	if ((len < 19) || (len >= sizeof(hour)) || (str[13] != ':') || (str[16] != ':') ||
+	    !isdigit((unsigned char) str[14]) || !isdigit((unsigned char) str[15]) || !isdigit((unsigned char) str[17]) ||
+	    !isdigit((unsigned char) str[18]))
+	{
+		return parseIso8601Time(str);
+	}
+
+	int seconds = (((((str[14] - '0') * 10) + (str[15] - '0')) * 60) + ((str[17] - '0') * 10) + (str[18] - '0'));
+
+	memcpy(hour, str, len + 1);
+	memcpy(hour + 14, "00:00", 5);
+
+	if (strcmp(hour, parser->lastModifiedHour)) {
+		int64_t time = parseIso8601Time(hour);
+		if (time == -1) {
+			return -1;
+		}
+		memcpy(parser->lastModifiedHour, hour, len + 1);
+		parser->lastModifiedHourTime = time;
+	}
+
+	return parser->lastModifiedHourTime + seconds;
+}
+
+static S3Status start_element(ListBucketParser* parser, int element)
+{
+	if (parser->depth < LIST_BUCKET_PARSER_MAX_DEPTH) {
+		parser->path[parser->depth] = (unsigned char) element;
+	}
+	parser->depth++;
+
+	if ((parser->depth == 2) && (element == ElementContents) && (parser->path[0] == ElementListBucketResult)) {
+		S3Status status = grow((void**) &(parser->contents),
+		                       &(parser->contentsCapacity),
+		                       parser->contentsCount,
+		                       sizeof(ListBucketParserContents));
+		if (status != S3StatusOK) {
+			return status;
+		}
+
+		ListBucketParserContents* contents = &(parser->contents[parser->contentsCount++]);
+		contents->key = -1;
+		contents->lastModified = -1;
+		contents->eTag = -1;
+		contents->size = -1;
+		contents->ownerId = -1;
+		contents->ownerDisplayName = -1;
+	}
+
+	return S3StatusOK;
+}
+
+// Returns where the value of the innermost open element is to be recorded, or
+// 0 if it is not of interest
+static int* value_slot(ListBucketParser* parser)
+{
+	const unsigned char* path = parser->path;
+
+	if ((parser->depth < 2) || (parser->depth > 4) || (path[0] != ElementListBucketResult)) {
+		return 0;
+	}
+
+	if (parser->depth == 2) {
+		switch (path[1]) {
+			case ElementIsTruncated:
+				return &(parser->isTruncated);
+			case ElementNextMarker:
+			case ElementNextContinuationToken:
+				// ListObjectsV2 - reported to the callback in place of the next marker
+				return &(parser->nextMarker);
+		}
+		return 0;
+	}
+
+	if (path[1] == ElementCommonPrefixes) {
+		if ((parser->depth != 3) || (path[2] != ElementPrefix)) {
+			return 0;
+		}
+		if (grow((void**) &(parser->commonPrefixes),
+		         &(parser->commonPrefixesCapacity),
+		         parser->commonPrefixesCount,
+		         sizeof(int)) != S3StatusOK)
+		{
+			parser->status = S3StatusOutOfMemory;
+			return 0;
+		}
+		return &(parser->commonPrefixes[parser->commonPrefixesCount++]);
+	}
+
+	if ((path[1] != ElementContents) || !parser->contentsCount) {
+		return 0;
+	}
+
+	ListBucketParserContents* contents = &(parser->contents[parser->contentsCount - 1]);
+
+	if (parser->depth == 3) {
+		switch (path[2]) {
+			case ElementKey:
+				return &(contents->key);
+			case ElementLastModified:
+				return &(contents->lastModified);
+			case ElementETag:
+				return &(contents->eTag);
+			case ElementSize:
+				return &(contents->size);
+		}
+		return 0;
+	}
+
+	if (path[2] == ElementOwner) {
+		switch (path[3]) {
+			case ElementID:
+				return &(contents->ownerId);
+			case ElementDisplayName:
+				return &(contents->ownerDisplayName);
+		}
+	}
+
+	return 0;
+}
+
+// The character data of the element that ends is [textStart, textEnd)
+static S3Status end_element(ListBucketParser* parser, int textEnd)
+{
+	int* slot = value_slot(parser);
+
+	parser->depth--;
+
+	if (!slot) {
+		return parser->status;
+	}
+
+	S3Status status = decode_value(parser->arena + parser->textStart, textEnd - parser->textStart);
+	if (status != S3StatusOK) {
+		return status;
+	}
+
+	*slot = parser->textStart;
+
+	return S3StatusOK;
+}
+
+// Handles the tag arena[tagStart] == '<' to arena[tagEnd] == '>'
+static S3Status process_tag(ListBucketParser* parser, int tagStart, int tagEnd)
+{
+	const char* tag = parser->arena + tagStart + 1;
+	int tagLen = tagEnd - tagStart - 1;
+
+	if (tagLen <= 0) {
+		return S3StatusXmlParseFailure;
+	}
+
+	// Processing instructions and declarations
+	if ((tag[0] == '?') || (tag[0] == '!')) {
+		return S3StatusOK;
+	}
+
+	if (tag[0] == '/') {
+		const char* name = tag + 1;
+		int nameLen = 0;
+		while ((nameLen < (tagLen - 1)) && !is_name_end(name[nameLen])) {
+			nameLen++;
+		}
+
+		if (!parser->depth) {
+			return S3StatusXmlParseFailure;
+		}
+		if ((parser->depth <= LIST_BUCKET_PARSER_MAX_DEPTH) &&
+		    (parser->path[parser->depth - 1] != element_id(name, nameLen)))
+		{
+			return S3StatusXmlParseFailure;
+		}
+
+		return end_element(parser, tagStart);
+	}
+
+	int nameLen = 0;
+	while ((nameLen < tagLen) && !is_name_end(tag[nameLen])) {
+		nameLen++;
+	}
+	if (!nameLen) {
+		return S3StatusXmlParseFailure;
+	}
+
+	S3Status status = start_element(parser, element_id(tag, nameLen));
+	if (status != S3StatusOK) {
+		return status;
+	}
+
+	if (tag[tagLen - 1] == '/') {
+		// An empty element, its value is the empty string at tagStart
+		parser->textStart = tagStart;
+		return end_element(parser, tagStart);
+	}
+
+	parser->textStart = tagEnd + 1;
+
+	return S3StatusOK;
+}
+
+void list_bucket_parser_initialize(ListBucketParser* parser)
+{
+	memset(parser, 0, sizeof(*parser));
+	parser->isTruncated = -1;
+	parser->nextMarker = -1;
+	parser->status = S3StatusOK;
+}
+
+S3Status list_bucket_parser_add(ListBucketParser* parser, const char* data, int dataLen)
+{
+	if (parser->status != S3StatusOK) {
+		return parser->status;
+	}
+
+	if (dataLen <= 0) {
+		return S3StatusOK;
+	}
+
+	if (dataLen > (INT_MAX / 2) - parser->arenaSize) {
+		return (parser->status = S3StatusOutOfMemory);
+	}
+
+	// Leave room for the NUL that terminates an unterminated final value
+	if ((parser->arenaSize + dataLen + 1) > parser->arenaCapacity) {
+		int newCapacity = parser->arenaCapacity ? parser->arenaCapacity : INITIAL_ARENA_CAPACITY;
+		while (newCapacity < (parser->arenaSize + dataLen + 1)) {
+			newCapacity *= 2;
+		}
+		char* newArena = realloc(parser->arena, newCapacity);
+		if (!newArena) {
+			return (parser->status = S3StatusOutOfMemory);
+		}
+		parser->arena = newArena;
+		parser->arenaCapacity = newCapacity;
+	}
+
+	memcpy(parser->arena + parser->arenaSize, data, dataLen);
+	parser->arenaSize += dataLen;
+
+	char* arena = parser->arena;
+	int size = parser->arenaSize;
+	int position = parser->scanPosition;
+
+	while (position < size) {
+		const char* lt = memchr(arena + position, '<', size - position);
+		if (!lt) {
+			position = size;
+			break;
+		}
+		position = lt - arena;
+
+		// Wait for the rest of the tag
+		const char* gt = memchr(lt + 1, '>', size - position - 1);
+		if (!gt) {
+			break;
+		}
+
+		S3Status status = process_tag(parser, position, gt - arena);
+		if (status != S3StatusOK) {
+			return (parser->status = status);
+		}
+
+		position = (gt - arena) + 1;
+	}
+
+	parser->scanPosition = position;
+
+	return S3StatusOK;
+}
+
+S3Status list_bucket_parser_finish(ListBucketParser* parser, S3ListBucketCallback* callback, void* callbackData)
+{
+	int i;
+
+	if (parser->status != S3StatusOK) {
+		return parser->status;
+	}
+
+	if (parser->depth) {
+		return S3StatusXmlParseFailure;
+	}
+
+	if (!parser->contentsCount && !parser->commonPrefixesCount) {
+		return S3StatusOK;
+	}
+
+	const char* arena = parser->arena;
+
+#define value(offset) (((offset) >= 0) ? (arena + (offset)) : "")
+
+	int isTruncated = (!strcmp(value(parser->isTruncated), "true") || !strcmp(value(parser->isTruncated), "1")) ? 1 : 0;
+
+	S3ListBucketContent* contents = malloc((sizeof(S3ListBucketContent) * parser->contentsCount) +
+	                                       (sizeof(const char*) * parser->commonPrefixesCount));
+	if (!contents) {
+		return S3StatusOutOfMemory;
+	}
+
+	for (i = 0; i < parser->contentsCount; i++) {
+		S3ListBucketContent* contentDest = &(contents[i]);
+		const ListBucketParserContents* contentSrc = &(parser->contents[i]);
+		contentDest->key = value(contentSrc->key);
+		contentDest->lastModified = parse_last_modified(parser, value(contentSrc->lastModified));
+		contentDest->eTag = value(contentSrc->eTag);
+		contentDest->size = parseUnsignedInt(value(contentSrc->size));
+		contentDest->ownerId = *value(contentSrc->ownerId) ? value(contentSrc->ownerId) : 0;
+		contentDest->ownerDisplayName =
+			*value(contentSrc->ownerDisplayName) ? value(contentSrc->ownerDisplayName) : 0;
+	}
+
+	const char** commonPrefixes = (const char**) &(contents[parser->contentsCount]);
+	for (i = 0; i < parser->commonPrefixesCount; i++) {
+		commonPrefixes[i] = value(parser->commonPrefixes[i]);
+	}
+
+	S3Status status = (*callback)(isTruncated,
+	                              value(parser->nextMarker),
+	                              parser->contentsCount,
+	                              contents,
+	                              parser->commonPrefixesCount,
+	                              commonPrefixes,
+	                              callbackData);
+
+#undef value
+
+	free(contents);
+
+	return status;
+}
+
+void list_bucket_parser_deinitialize(ListBucketParser* parser)
+{
+	free(parser->arena);
+	free(parser->contents);
+	free(parser->commonPrefixes);
+	list_bucket_parser_initialize(parser);
+}
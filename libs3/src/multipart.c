@@ -141,7 +141,8 @@ void S3_initiate_multipart(S3BucketContext* bucketContext,
 		mdata,                              // callbackData
 		timeoutMs,                          // timeoutMs
 		0,                                  // xAmzObjectAttributes
-		0                                   // chunkedState
+		0,                                  // chunkedState
+		0                                   // abortCallback
 	};
 
 	// Perform the request
@@ -185,7 +186,8 @@ void S3_abort_multipart_upload(S3BucketContext* bucketContext,
 		0,                                           // callbackData
 		timeoutMs,                                   // timeoutMs
 		0,                                           // xAmzObjectAttributes
-		0                                            // chunkedState
+		0,                                           // chunkedState
+		0                                            // abortCallback
 	};
 
 	// Perform the request
@@ -238,7 +240,8 @@ void S3_upload_part(S3BucketContext* bucketContext,
 		callbackData,                                // callbackData
 		timeoutMs,                                   // timeoutMs
 		0,                                           // xAmzObjectAttributes
-		0                                            // chunkedState
+		0,                                           // chunkedState
+		0                                            // abortCallback
 	};
 
 	request_perform(&params, requestContext);
@@ -369,7 +372,8 @@ void S3_complete_multipart_upload(S3BucketContext* bucketContext,
 		data,                              // callbackData
 		timeoutMs,                         // timeoutMs
 		0,                                 // xAmzObjectAttributes
-		0                                  // chunkedState
+		0,                                 // chunkedState
+		0                                  // abortCallback
 	};
 
 	request_perform(&params, requestContext);
@@ -902,7 +906,8 @@ void S3_list_multipart_uploads(S3BucketContext* bucketContext,
 		lmData,                           // callbackData
 		timeoutMs,                        // timeoutMs
 		0,                                // xAmzObjectAttributes
-		0                                 // chunkedState
+		0,                                // chunkedState
+		0                                 // abortCallback
 	};
 
 	// Perform the request
@@ -1021,7 +1026,8 @@ void S3_list_parts(S3BucketContext* bucketContext,
 		lpData,                           // callbackData
 		timeoutMs,                        // timeoutMs
 		0,                                // xAmzObjectAttributes
-		0                                 // chunkedState
+		0,                                // chunkedState
+		0                                 // abortCallback
 	};
 
 	// Perform the request
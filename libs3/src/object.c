@@ -34,8 +34,17 @@
 #include <stddef.h>
 #include <string.h>
 #include <strings.h>
+
+#ifndef __APPLE__
+#  include <openssl/evp.h>
+#  include <openssl/md5.h>
+#endif
+
 #include "libs3/libs3.h"
+#include "libs3/error_parser.h"
 #include "libs3/request.h"
+#include "libs3/simplexml.h"
+#include "libs3/string_buffer.h"
 
 // put object ----------------------------------------------------------------
 
@@ -77,7 +86,8 @@ void S3_put_object(const S3BucketContext* bucketContext,
 		callbackData,                                // callbackData
 		timeoutMs,                                   // timeoutMs
 		0,                                           // xAmzObjectAttributes
-		0                                            // chunkedState
+		0,                                           // chunkedState
+		0                                            // abortCallback
 	};
 
 	// Perform the request
@@ -274,7 +284,8 @@ void S3_copy_object_range(const S3BucketContext* bucketContext,
 		data,                                                               // callbackData
 		timeoutMs,                                                          // timeoutMs
 		0,                                                                  // xAmzObjectAttributes
-		0                                                                   // chunkedState
+		0,                                                                  // chunkedState
+		0                                                                   // abortCallback
 	};
 
 	// Perform the request
@@ -322,7 +333,8 @@ void S3_get_object(const S3BucketContext* bucketContext,
 		callbackData,                                // callbackData
 		timeoutMs,                                   // timeoutMs
 		0,                                           // xAmzObjectAttributes
-		0                                            // chunkedState
+		0,                                           // chunkedState
+		0                                            // abortCallback
 	};
 
 	// Perform the request
@@ -337,6 +349,17 @@ void S3_head_object(const S3BucketContext* bucketContext,
                     int timeoutMs,
                     const S3ResponseHandler* handler,
                     void* callbackData)
+{
+	S3_head_object_ex(bucketContext, key, requestContext, timeoutMs, handler, 0, callbackData);
+}
+
+void S3_head_object_ex(const S3BucketContext* bucketContext,
+                       const char* key,
+                       S3RequestContext* requestContext,
+                       int timeoutMs,
+                       const S3ResponseHandler* handler,
+                       S3AbortCallback* abortCallback,
+                       void* callbackData)
 {
 	// Set up the RequestParams
 	RequestParams params = {
@@ -367,7 +390,8 @@ void S3_head_object(const S3BucketContext* bucketContext,
 		callbackData,                    // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		abortCallback                    // abortCallback
 	};
 
 	// Perform the request
@@ -412,11 +436,354 @@ void S3_delete_object(const S3BucketContext* bucketContext,
 		callbackData,                    // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		0                                // abortCallback
+	};
+
+	// Perform the request
+	request_perform(&params, requestContext);
+}
+
+// delete objects ------------------------------------------------------------
+
+typedef struct DeleteObjectsData
+{
+	SimpleXml simpleXml;
+
+	S3ResponsePropertiesCallback* responsePropertiesCallback;
+	S3DeleteObjectsCallback* deleteObjectsCallback;
+	S3ResponseCompleteCallback* responseCompleteCallback;
+	void* callbackData;
+
+	// The request body is generated one element at a time from the keys as
+	// it is sent.  nextElement is -1 for the opening element, then the index
+	// of the next key, then keyCount for the closing element.
+	const char* const* keys;
+	int keyCount;
+	int quiet;
+	int nextElement;
+	int elementLen;
+	int elementOffset;
+	char element[sizeof("<Object><Key></Key></Object>") + (S3_MAX_KEY_SIZE * 6)];
+
+	char md5[32];
+
+	// The key being reported back
+	string_buffer(key, S3_MAX_KEY_SIZE + 1);
+	string_buffer(code, 256);
+	string_buffer(message, 1024);
+} DeleteObjectsData;
+
+static int xml_escape(char* dest, const char* src)
+{
+	char* start = dest;
+
+	for (; *src; src++) {
+		switch (*src) {
+			case '&':
+				memcpy(dest, "&amp;", 5);
+				dest += 5;
+				break;
+			case '<':
+				memcpy(dest, "&lt;", 4);
+				dest += 4;
+				break;
+			case '>':
+				memcpy(dest, "&gt;", 4);
+				dest += 4;
+				break;
+			case '"':
+				memcpy(dest, "&quot;", 6);
+				dest += 6;
+				break;
+			case '\'':
+				memcpy(dest, "&apos;", 6);
+				dest += 6;
+				break;
+			default:
+				*dest++ = *src;
+				break;
+		}
+	}
+
+	return dest - start;
+}
+
+static void delete_objects_rewind(DeleteObjectsData* doData)
+{
+	doData->nextElement = -1;
+	doData->elementLen = 0;
+	doData->elementOffset = 0;
+}
+
+// Generates the next element of the request body, returns 0 after the last
+static int delete_objects_next_element(DeleteObjectsData* doData)
+{
+	if (doData->nextElement < 0) {
+		doData->elementLen = snprintf(doData->element,
+		                              sizeof(doData->element),
+		                              "<Delete><Quiet>%s</Quiet>",
+		                              doData->quiet ? "true" : "false");
+	}
+	else if (doData->nextElement < doData->keyCount) {
+		char* element = doData->element;
+		memcpy(element, "<Object><Key>", 13);
+		element += 13;
+		element += xml_escape(element, doData->keys[doData->nextElement]);
+		memcpy(element, "</Key></Object>", 15);
+		element += 15;
+		doData->elementLen = element - doData->element;
+	}
+	else if (doData->nextElement == doData->keyCount) {
+		doData->elementLen = snprintf(doData->element, sizeof(doData->element), "</Delete>");
+	}
+	else {
+		return 0;
+	}
+
+	doData->nextElement++;
+	doData->elementOffset = 0;
+
+	return 1;
+}
+
+static S3Status deleteObjectsXmlCallback(const char* elementPath, const char* data, int dataLen, void* callbackData)
+{
+	DeleteObjectsData* doData = (DeleteObjectsData*) callbackData;
+
+	int fit;
+
+	if (data) {
+		if (!strcmp(elementPath, "DeleteResult/Deleted/Key") || !strcmp(elementPath, "DeleteResult/Error/Key")) {
+			string_buffer_append(doData->key, data, dataLen, fit);
+			if (!fit) {
+				return S3StatusKeyTooLong;
+			}
+		}
+		else if (!strcmp(elementPath, "DeleteResult/Error/Code")) {
+			string_buffer_append(doData->code, data, dataLen, fit);
+		}
+		else if (!strcmp(elementPath, "DeleteResult/Error/Message")) {
+			string_buffer_append(doData->message, data, dataLen, fit);
+		}
+	}
+	else {
+		S3Status status = S3StatusOK;
+
+		if (!strcmp(elementPath, "DeleteResult/Deleted")) {
+			status = (*(doData->deleteObjectsCallback))(doData->key, S3StatusOK, 0, 0, doData->callbackData);
+		}
+		else if (!strcmp(elementPath, "DeleteResult/Error")) {
+			S3Status keyStatus = S3StatusErrorUnknown;
+			error_parser_convert_code(doData->code, &keyStatus);
+			status = (*(doData->deleteObjectsCallback))(doData->key,
+			                                            keyStatus,
+			                                            doData->code,
+			                                            doData->messageLen ? doData->message : 0,
+			                                            doData->callbackData);
+		}
+		else {
+			return S3StatusOK;
+		}
+
+		string_buffer_initialize(doData->key);
+		string_buffer_initialize(doData->code);
+		string_buffer_initialize(doData->message);
+
+		return status;
+	}
+
+	/* Avoid compiler error about variable set but not used */
+	(void) fit;
+
+	return S3StatusOK;
+}
+
+static S3Status deleteObjectsPropertiesCallback(const S3ResponseProperties* responseProperties, void* callbackData)
+{
+	DeleteObjectsData* doData = (DeleteObjectsData*) callbackData;
+
+	if (doData->responsePropertiesCallback) {
+		return (*(doData->responsePropertiesCallback))(responseProperties, doData->callbackData);
+	}
+
+	return S3StatusOK;
+}
+
+static int deleteObjectsToS3Callback(int bufferSize, char* buffer, void* callbackData)
+{
+	DeleteObjectsData* doData = (DeleteObjectsData*) callbackData;
+
+	int written = 0;
+
+	while (written < bufferSize) {
+		if ((doData->elementOffset == doData->elementLen) && !delete_objects_next_element(doData)) {
+			break;
+		}
+
+		int len = doData->elementLen - doData->elementOffset;
+		if (len > (bufferSize - written)) {
+			len = bufferSize - written;
+		}
+
+		memcpy(buffer + written, doData->element + doData->elementOffset, len);
+		doData->elementOffset += len;
+		written += len;
+	}
+
+	return written;
+}
+
+static S3Status deleteObjectsFromS3Callback(int bufferSize, const char* buffer, void* callbackData)
+{
+	DeleteObjectsData* doData = (DeleteObjectsData*) callbackData;
+
+	return simplexml_add(&(doData->simpleXml), buffer, bufferSize);
+}
+
+static void deleteObjectsCompleteCallback(S3Status requestStatus,
+                                          const S3ErrorDetails* s3ErrorDetails,
+                                          void* callbackData)
+{
+	DeleteObjectsData* doData = (DeleteObjectsData*) callbackData;
+
+	(*(doData->responseCompleteCallback))(requestStatus, s3ErrorDetails, doData->callbackData);
+
+	simplexml_deinitialize(&(doData->simpleXml));
+
+	free(doData);
+}
+
+void S3_delete_objects(const S3BucketContext* bucketContext,
+                       int keyCount,
+                       const char* const* keys,
+                       int quiet,
+                       S3RequestContext* requestContext,
+                       int timeoutMs,
+                       const S3DeleteObjectsHandler* handler,
+                       void* callbackData)
+{
+#ifdef __APPLE__
+	/* This request requires calculating MD5 sum.
+	 * MD5 sum requires OpenSSL library, which is not used on Apple.
+	 */
+	(*(handler->responseHandler.completeCallback))(S3StatusNotSupported, 0, callbackData);
+	return;
+#else
+	int i;
+
+	if (keyCount <= 0) {
+		(*(handler->responseHandler.completeCallback))(S3StatusOK, 0, callbackData);
+		return;
+	}
+
+	if (keyCount > S3_MAX_DELETE_OBJECTS_COUNT) {
+		(*(handler->responseHandler.completeCallback))(S3StatusXmlDocumentTooLarge, 0, callbackData);
+		return;
+	}
+
+	for (i = 0; i < keyCount; i++) {
+		if (!keys[i] || (strlen(keys[i]) > S3_MAX_KEY_SIZE)) {
+			(*(handler->responseHandler.completeCallback))(S3StatusKeyTooLong, 0, callbackData);
+			return;
+		}
+	}
+
+	DeleteObjectsData* doData = (DeleteObjectsData*) malloc(sizeof(DeleteObjectsData));
+
+	if (!doData) {
+		(*(handler->responseHandler.completeCallback))(S3StatusOutOfMemory, 0, callbackData);
+		return;
+	}
+
+	simplexml_initialize(&(doData->simpleXml), &deleteObjectsXmlCallback, doData);
+
+	doData->responsePropertiesCallback = handler->responseHandler.propertiesCallback;
+	doData->deleteObjectsCallback = handler->deleteObjectsCallback;
+	doData->responseCompleteCallback = handler->responseHandler.completeCallback;
+	doData->callbackData = callbackData;
+
+	doData->keys = keys;
+	doData->keyCount = keyCount;
+	doData->quiet = quiet;
+
+	string_buffer_initialize(doData->key);
+	string_buffer_initialize(doData->code);
+	string_buffer_initialize(doData->message);
+
+	// S3 requires the Content-MD5 of the body, so generate it once up front
+	// to compute its length and MD5 without keeping it in memory
+	MD5_CTX mdContext;
+	unsigned char md5Buffer[MD5_DIGEST_LENGTH];
+	int64_t contentLength = 0;
+
+	MD5_Init(&mdContext);
+	delete_objects_rewind(doData);
+	while (delete_objects_next_element(doData)) {
+		MD5_Update(&mdContext, doData->element, doData->elementLen);
+		contentLength += doData->elementLen;
+	}
+	MD5_Final(md5Buffer, &mdContext);
+	EVP_EncodeBlock((unsigned char*) doData->md5, md5Buffer, MD5_DIGEST_LENGTH);
+
+	delete_objects_rewind(doData);
+
+	// Set up S3PutProperties
+	S3PutProperties properties = {
+		"application/xml", // contentType
+		doData->md5,       // md5
+		0,                 // cacheControl
+		0,                 // contentDispositionFilename
+		0,                 // contentEncoding
+		-1,                // expires
+		0,                 // cannedAcl
+		0,                 // metaDataCount
+		0,                 // metaData
+		0,                 // useServerSideEncryption
+		0,                 // xAmzStorageClass
+		0,                 // xAmzChecksumAlgorithm
+		0,                 // xAmzChecksumType
+		0,                 // xAmzTrailer
+		-1,                // xAmzDecodedContentLength (-1 = unknown)
+		0                  // xAmzCopySourceIfMatch
+	};
+
+	// Set up the RequestParams
+	RequestParams params = {
+		HttpRequestTypePOST,               // httpRequestType
+		{bucketContext->hostName,          // hostName
+	     bucketContext->bucketName,        // bucketName
+	     bucketContext->protocol,          // protocol
+	     bucketContext->uriStyle,          // uriStyle
+	     bucketContext->accessKeyId,       // accessKeyId
+	     bucketContext->secretAccessKey,   // secretAccessKey
+	     bucketContext->securityToken,     // securityToken
+	     bucketContext->authRegion,        // authRegion
+	     bucketContext->stsDate},          // stsDate
+		0,                                 // key
+		0,                                 // queryParams
+		"delete",                          // subResource
+		0,                                 // copySourceBucketName
+		0,                                 // copySourceKey
+		0,                                 // getConditions
+		0,                                 // startByte
+		0,                                 // byteCount
+		&properties,                       // putProperties
+		&deleteObjectsPropertiesCallback,  // propertiesCallback
+		&deleteObjectsToS3Callback,        // toS3Callback
+		contentLength,                     // toS3CallbackTotalSize
+		&deleteObjectsFromS3Callback,      // fromS3Callback
+		&deleteObjectsCompleteCallback,    // completeCallback
+		doData,                            // callbackData
+		timeoutMs,                         // timeoutMs
+		0,                                 // xAmzObjectAttributes
+		0,                                 // chunkedState
+		0                                  // abortCallback
 	};
 
 	// Perform the request
 	request_perform(&params, requestContext);
+#endif
 }
 
 // restore object --------------------------------------------------------------
@@ -511,7 +878,8 @@ void S3_restore_object(S3BucketContext* bucketContext,
 		data,                            // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		0                                // abortCallback
 	};
 
 	request_perform(&params, requestContext);
@@ -668,7 +1036,8 @@ void S3_get_object_attributes(S3BucketContext* bucketContext,
 		goaData,                               // callbackData
 		timeoutMs,                             // timeoutMs
 		xAmzObjectAttributes,                  // xAmzObjectAttributes
-		0                                      // chunkedState
+		0,                                     // chunkedState
+		0                                      // abortCallback
 	};
 
 	// Perform the request
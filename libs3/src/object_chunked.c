@@ -172,7 +172,8 @@ void S3_put_object_chunked(const S3BucketContext *bucketContext,
         &context,                                    // callbackData
         timeoutMs,                                   // timeoutMs
         0,                                           // xAmzObjectAttributes
-        context.chunkedState                         // chunkedState (for trailing headers)
+        context.chunkedState,                        // chunkedState (for trailing headers)
+        0                                            // abortCallback
     };
 
     /* Perform the request
@@ -258,7 +259,8 @@ void S3_upload_part_chunked(const S3BucketContext *bucketContext,
         &context,                                    // callbackData
         timeoutMs,                                   // timeoutMs
         0,                                           // xAmzObjectAttributes
-        context.chunkedState                         // chunkedState (for trailing headers)
+        context.chunkedState,                        // chunkedState (for trailing headers)
+        0                                            // abortCallback
     };
 
     /* Perform the request */
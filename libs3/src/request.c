@@ -69,6 +69,32 @@ static int requestStackCountG;
 
 char defaultHostNameG[S3_MAX_HOSTNAME_SIZE];
 
+// SigV4 signing keys only depend on the secret key, the date and the region,
+// so the last few derived are kept instead of being derived with four HMACs
+// for every request.
+#define SIGNING_KEY_CACHE_SIZE 4
+#define SIGNING_KEY_REGION_SIZE 64
+
+typedef struct SigningKeyCacheEntry
+{
+	// NULL if the entry is unused
+	char* secretAccessKey;
+
+	// yyyymmdd
+	char date[9];
+
+	char region[SIGNING_KEY_REGION_SIZE];
+
+	unsigned char signingKey[S3_SHA256_DIGEST_LENGTH];
+} SigningKeyCacheEntry;
+
+static pthread_mutex_t signingKeyCacheMutexG = PTHREAD_MUTEX_INITIALIZER;
+
+static SigningKeyCacheEntry signingKeyCacheG[SIGNING_KEY_CACHE_SIZE];
+
+// The entry replaced next
+static int signingKeyCacheNextG;
+
 typedef struct RequestComputedValues
 {
 	// All x-amz- headers, in normalized form (i.e. NAME: VALUE, no other ws)
@@ -283,6 +309,24 @@ static size_t curl_write_func(void* ptr, size_t size, size_t nmemb, void* data)
 	return ((request->status == S3StatusOK) ? len : 0);
 }
 
+// Made periodically by curl while a request with an abort callback is in
+// progress, including while it is connecting
+static int curl_xferinfo_func(void* data, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow)
+{
+	(void) dltotal;
+	(void) dlnow;
+	(void) ultotal;
+	(void) ulnow;
+
+	Request* request = (Request*) data;
+
+	if ((request->status == S3StatusOK) && (*(request->abortCallback))(request->callbackData)) {
+		request->status = S3StatusInterrupted;
+	}
+
+	return (request->status == S3StatusInterrupted);
+}
+
 static S3Status append_amz_header(RequestComputedValues* values,
                                   int addPrefix,
                                   const char* headerName,
@@ -436,6 +480,9 @@ static S3Status compose_amz_headers(const RequestParams* params,
 			snprintf(bucketKey, sizeof(bucketKey), "/%s/%s", params->copySourceBucketName, params->copySourceKey);
 			append_amz_header(values, 0, "x-amz-copy-source", bucketKey);
 		}
+		if (properties && properties->xAmzCopySourceIfMatch) {
+			append_amz_header(values, 0, "x-amz-copy-source-if-match", properties->xAmzCopySourceIfMatch);
+		}
 		// If byteCount != 0 then we're just copying a range, add header
 		if (params->byteCount > 0) {
 			char byteRange[S3_MAX_METADATA_SIZE];
@@ -449,8 +496,11 @@ static S3Status compose_amz_headers(const RequestParams* params,
 		else {
 			// Add the x-amz-metadata-directive header
 			// Only for CopyObject, not UploadPartCopy (above)
+			// If metadata is supplied it replaces the metadata of the source object,
+			// otherwise the metadata is copied from the source.
 			if (properties) {
-				append_amz_header(values, 0, "x-amz-metadata-directive", "COPY");
+				append_amz_header(values, 0, "x-amz-metadata-directive",
+				                  properties->metaDataCount > 0 ? "REPLACE" : "COPY");
 			}
 		}
 	}
@@ -986,6 +1036,108 @@ static const char* http_request_type_to_verb(HttpRequestType requestType)
 	}
 }
 
+// Derives the SigV4 signing key from the secret key, the date (the first
+// eight characters of date are used) and the region
+static void compute_signing_key(const char* secretAccessKey,
+                                const char* date,
+                                const char* awsRegion,
+                                unsigned char* signingKey)
+{
+	const size_t accessKeySize = sizeof(char) * (strlen(secretAccessKey) + 5);
+	char* accessKey = alloca(accessKeySize);
+	snprintf(accessKey, accessKeySize, "AWS4%s", secretAccessKey);
+
+#ifdef __APPLE__
+	unsigned char dateKey[S3_SHA256_DIGEST_LENGTH];
+	CCHmac(kCCHmacAlgSHA256, accessKey, strlen(accessKey), date, 8, dateKey);
+	unsigned char dateRegionKey[S3_SHA256_DIGEST_LENGTH];
+	CCHmac(kCCHmacAlgSHA256, dateKey, S3_SHA256_DIGEST_LENGTH, awsRegion, strlen(awsRegion), dateRegionKey);
+	unsigned char dateRegionServiceKey[S3_SHA256_DIGEST_LENGTH];
+	CCHmac(kCCHmacAlgSHA256, dateRegionKey, S3_SHA256_DIGEST_LENGTH, "s3", 2, dateRegionServiceKey);
+	CCHmac(kCCHmacAlgSHA256,
+	       dateRegionServiceKey,
+	       S3_SHA256_DIGEST_LENGTH,
+	       "aws4_request",
+	       strlen("aws4_request"),
+	       signingKey);
+#else
+	const EVP_MD* sha256evp = EVP_sha256();
+	unsigned char dateKey[S3_SHA256_DIGEST_LENGTH];
+	HMAC(sha256evp, accessKey, strlen(accessKey), (const unsigned char*) date, 8, dateKey, NULL);
+	unsigned char dateRegionKey[S3_SHA256_DIGEST_LENGTH];
+	HMAC(sha256evp,
+	     dateKey,
+	     S3_SHA256_DIGEST_LENGTH,
+	     (const unsigned char*) awsRegion,
+	     strlen(awsRegion),
+	     dateRegionKey,
+	     NULL);
+	unsigned char dateRegionServiceKey[S3_SHA256_DIGEST_LENGTH];
+	HMAC(sha256evp, dateRegionKey, S3_SHA256_DIGEST_LENGTH, (const unsigned char*) "s3", 2, dateRegionServiceKey, NULL);
+	HMAC(sha256evp,
+	     dateRegionServiceKey,
+	     S3_SHA256_DIGEST_LENGTH,
+	     (const unsigned char*) "aws4_request",
+	     strlen("aws4_request"),
+	     signingKey,
+	     NULL);
+#endif
+}
+
+// Returns the signing key from the cache, deriving and caching it if needed
+static void get_signing_key(const char* secretAccessKey,
+                            const char* date,
+                            const char* awsRegion,
+                            unsigned char* signingKey)
+{
+	int i;
+
+	pthread_mutex_lock(&signingKeyCacheMutexG);
+	for (i = 0; i < SIGNING_KEY_CACHE_SIZE; i++) {
+		const SigningKeyCacheEntry* entry = &(signingKeyCacheG[i]);
+		if (entry->secretAccessKey && !strncmp(entry->date, date, 8) && !strcmp(entry->region, awsRegion) &&
+		    !strcmp(entry->secretAccessKey, secretAccessKey))
+		{
+			memcpy(signingKey, entry->signingKey, S3_SHA256_DIGEST_LENGTH);
+			pthread_mutex_unlock(&signingKeyCacheMutexG);
+			return;
+		}
+	}
+	pthread_mutex_unlock(&signingKeyCacheMutexG);
+
+	compute_signing_key(secretAccessKey, date, awsRegion, signingKey);
+
+	const size_t secretAccessKeySize = strlen(secretAccessKey) + 1;
+	char* secretAccessKeyCopy;
+	if (strlen(awsRegion) >= SIGNING_KEY_REGION_SIZE || !(secretAccessKeyCopy = malloc(secretAccessKeySize))) {
+		return;
+	}
+	memcpy(secretAccessKeyCopy, secretAccessKey, secretAccessKeySize);
+
+	pthread_mutex_lock(&signingKeyCacheMutexG);
+	SigningKeyCacheEntry* entry = &(signingKeyCacheG[signingKeyCacheNextG]);
+	signingKeyCacheNextG = (signingKeyCacheNextG + 1) % SIGNING_KEY_CACHE_SIZE;
+	free(entry->secretAccessKey);
+	entry->secretAccessKey = secretAccessKeyCopy;
+	snprintf(entry->date, sizeof(entry->date), "%.8s", date);
+	snprintf(entry->region, sizeof(entry->region), "%s", awsRegion);
+	memcpy(entry->signingKey, signingKey, S3_SHA256_DIGEST_LENGTH);
+	pthread_mutex_unlock(&signingKeyCacheMutexG);
+}
+
+static void clear_signing_key_cache()
+{
+	int i;
+
+	pthread_mutex_lock(&signingKeyCacheMutexG);
+	for (i = 0; i < SIGNING_KEY_CACHE_SIZE; i++) {
+		free(signingKeyCacheG[i].secretAccessKey);
+		memset(&(signingKeyCacheG[i]), 0, sizeof(SigningKeyCacheEntry));
+	}
+	signingKeyCacheNextG = 0;
+	pthread_mutex_unlock(&signingKeyCacheMutexG);
+}
+
 // Composes the Authorization header for the request
 static S3Status compose_auth_header(const RequestParams* params, RequestComputedValues* values)
 {
@@ -1056,53 +1208,14 @@ static S3Status compose_auth_header(const RequestParams* params, RequestComputed
 	printf("--\nString to Sign:\n%s\n", stringToSign);
 #endif
 
-	const char* secretAccessKey = params->bucketContext.secretAccessKey;
-	const size_t accessKeySize = sizeof(char) * (strlen(secretAccessKey) + 5);
-	char* accessKey = alloca(accessKeySize);
-	snprintf(accessKey, accessKeySize, "AWS4%s", secretAccessKey);
-
-#ifdef __APPLE__
-	unsigned char dateKey[S3_SHA256_DIGEST_LENGTH];
-	CCHmac(kCCHmacAlgSHA256, accessKey, strlen(accessKey), values->requestDateISO8601, 8, dateKey);
-	unsigned char dateRegionKey[S3_SHA256_DIGEST_LENGTH];
-	CCHmac(kCCHmacAlgSHA256, dateKey, S3_SHA256_DIGEST_LENGTH, awsRegion, strlen(awsRegion), dateRegionKey);
-	unsigned char dateRegionServiceKey[S3_SHA256_DIGEST_LENGTH];
-	CCHmac(kCCHmacAlgSHA256, dateRegionKey, S3_SHA256_DIGEST_LENGTH, "s3", 2, dateRegionServiceKey);
 	unsigned char signingKey[S3_SHA256_DIGEST_LENGTH];
-	CCHmac(kCCHmacAlgSHA256,
-	       dateRegionServiceKey,
-	       S3_SHA256_DIGEST_LENGTH,
-	       "aws4_request",
-	       strlen("aws4_request"),
-	       signingKey);
+	get_signing_key(params->bucketContext.secretAccessKey, values->requestDateISO8601, awsRegion, signingKey);
 
 	unsigned char finalSignature[S3_SHA256_DIGEST_LENGTH];
+#ifdef __APPLE__
 	CCHmac(kCCHmacAlgSHA256, signingKey, S3_SHA256_DIGEST_LENGTH, stringToSign, strlen(stringToSign), finalSignature);
 #else
-	const EVP_MD* sha256evp = EVP_sha256();
-	unsigned char dateKey[S3_SHA256_DIGEST_LENGTH];
-	HMAC(sha256evp, accessKey, strlen(accessKey), (const unsigned char*) values->requestDateISO8601, 8, dateKey, NULL);
-	unsigned char dateRegionKey[S3_SHA256_DIGEST_LENGTH];
-	HMAC(sha256evp,
-	     dateKey,
-	     S3_SHA256_DIGEST_LENGTH,
-	     (const unsigned char*) awsRegion,
-	     strlen(awsRegion),
-	     dateRegionKey,
-	     NULL);
-	unsigned char dateRegionServiceKey[S3_SHA256_DIGEST_LENGTH];
-	HMAC(sha256evp, dateRegionKey, S3_SHA256_DIGEST_LENGTH, (const unsigned char*) "s3", 2, dateRegionServiceKey, NULL);
-	unsigned char signingKey[S3_SHA256_DIGEST_LENGTH];
-	HMAC(sha256evp,
-	     dateRegionServiceKey,
-	     S3_SHA256_DIGEST_LENGTH,
-	     (const unsigned char*) "aws4_request",
-	     strlen("aws4_request"),
-	     signingKey,
-	     NULL);
-
-	unsigned char finalSignature[S3_SHA256_DIGEST_LENGTH];
-	HMAC(sha256evp,
+	HMAC(EVP_sha256(),
 	     signingKey,
 	     S3_SHA256_DIGEST_LENGTH,
 	     (const unsigned char*) stringToSign,
@@ -1248,8 +1361,16 @@ static S3Status setup_curl(Request* request, const RequestParams* params, const
 	// library, which we do not do yet.
 	curl_easy_setopt_safe(CURLOPT_NOSIGNAL, 1);
 
-	// Turn off Curl's built-in progress meter
-	curl_easy_setopt_safe(CURLOPT_NOPROGRESS, 1);
+	// Turn off Curl's built-in progress meter.  The progress callback is used
+	// to abort requests that have an abort callback.
+	if (params->abortCallback) {
+		curl_easy_setopt_safe(CURLOPT_XFERINFODATA, request);
+		curl_easy_setopt_safe(CURLOPT_XFERINFOFUNCTION, &curl_xferinfo_func);
+		curl_easy_setopt_safe(CURLOPT_NOPROGRESS, 0);
+	}
+	else {
+		curl_easy_setopt_safe(CURLOPT_NOPROGRESS, 1);
+	}
 
 	// xxx todo - support setting the proxy for Curl to use (can't use https
 	// for proxies though)
@@ -1504,6 +1625,8 @@ static S3Status request_get(const RequestParams* params,
 
 	request->callbackData = params->callbackData;
 
+	request->abortCallback = params->abortCallback;
+
 	response_headers_handler_initialize(&(request->responseHeadersHandler));
 
 	request->propertiesCallbackMade = 0;
@@ -1593,6 +1716,8 @@ void request_api_deinitialize()
 	while (requestStackCountG--) {
 		request_destroy(requestStackG[requestStackCountG]);
 	}
+
+	clear_signing_key_cache();
 }
 
 static S3Status setup_request(const RequestParams* params, RequestComputedValues* computed, int forceUnsignedPayload)
@@ -1861,6 +1986,7 @@ S3Status S3_generate_authenticated_query_string(char* buffer,
 	                        NULL,
 	                        0,
                             0,
+                            0,
                             0};
 
 	RequestComputedValues computed;
@@ -1888,3 +2014,21 @@ S3Status S3_generate_authenticated_query_string(char* buffer,
 	return compose_uri(
 		buffer, S3_MAX_AUTHENTICATED_QUERY_STRING_SIZE, bucketContext, computed.urlEncodedKey, resource, queryParams);
 }
+
+S3Status S3_precompute_signing_key(const char* secretAccessKey, const char* authRegion)
+{
+	if (!secretAccessKey) {
+		return S3StatusInternalError;
+	}
+
+	time_t now = time(NULL);
+	struct tm gmt;
+	gmtime_r(&now, &gmt);
+	char date[9];
+	strftime(date, sizeof(date), "%Y%m%d", &gmt);
+
+	unsigned char signingKey[S3_SHA256_DIGEST_LENGTH];
+	get_signing_key(secretAccessKey, date, authRegion ? authRegion : S3_DEFAULT_REGION, signingKey);
+
+	return S3StatusOK;
+}
@@ -178,7 +178,8 @@ void S3_list_service(S3Protocol protocol,
 		data,                // callbackData
 		timeoutMs,           // timeoutMs
 		0,                   // xAmzObjectAttributes
-		0                    // chunkedState
+		0,                   // chunkedState
+		0                    // abortCallback
 	};
 
 	// Perform the request
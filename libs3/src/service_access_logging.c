@@ -351,7 +351,8 @@ void S3_get_server_access_logging(const S3BucketContext* bucketContext,
 		gsData,                          // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		0                                // abortCallback
 	};
 
 	// Perform the request
@@ -551,7 +552,8 @@ void S3_set_server_access_logging(const S3BucketContext* bucketContext,
 		data,                            // callbackData
 		timeoutMs,                       // timeoutMs
 		0,                               // xAmzObjectAttributes
-		0                                // chunkedState
+		0,                               // chunkedState
+		0                                // abortCallback
 	};
 
 	// Perform the request
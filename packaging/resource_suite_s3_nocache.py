@@ -329,6 +329,140 @@ class Test_S3_NoCache_Base(session.make_sessions_mixin([('otherrods', 'rods')],
         self.admin.assert_icommand("imv " + self.testfile + " " + copyfile, 'STDERR_SINGLELINE', "CAT_NAME_EXISTS_AS_DATAOBJ")
         # local cleanup
 
+    def test_local_imv_multipart_object(self):
+        # large enough to be moved in several parts whether or not CopyObject is enabled
+        file_name = f'{inspect.currentframe().f_code.co_name}'
+        moved_file_name = f'{inspect.currentframe().f_code.co_name}_moved'
+        get_file_name = f'{inspect.currentframe().f_code.co_name}_get'
+        file_size = 40*1024*1024
+
+        lib.make_file(file_name, file_size)
+
+        try:
+            self.admin.assert_icommand("iput %s" % file_name)
+            self.admin.assert_icommand("imv %s %s" % (file_name, moved_file_name))
+            self.admin.assert_icommand("ils -L %s" % moved_file_name, 'STDOUT_SINGLELINE', str(file_size))
+            self.admin.assert_icommand_fail("ils -L %s" % file_name, 'STDOUT_SINGLELINE', file_name)
+
+            # make sure the contents survived the move
+            self.admin.assert_icommand("iget -f %s %s" % (moved_file_name, get_file_name))
+            self.admin.assert_icommand("diff %s %s " % (file_name, get_file_name), 'EMPTY')
+
+        finally:
+            self.admin.run_icommand("irm -f %s" % moved_file_name)
+            s3plugin_lib.remove_if_exists(file_name)
+            s3plugin_lib.remove_if_exists(get_file_name)
+
+    def test_ichksum_with_ranged_reads(self):
+        # large enough to be read in several ranges
+        file_name = f'{inspect.currentframe().f_code.co_name}'
+        file_size = 40*1024*1024
+
+        lib.make_arbitrary_file(file_name, file_size)
+        with open(file_name, 'rb') as f:
+            checksum = 'sha2:' + base64.b64encode(hashlib.sha256(f.read()).digest()).decode()
+
+        try:
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context', self.s3_context + ';S3_CHECKSUM_READ_THREADS=4'])
+            self.admin.assert_icommand(['iput', file_name])
+            self.admin.assert_icommand(['ichksum', '-f', file_name], 'STDOUT_SINGLELINE', checksum)
+            self.admin.assert_icommand(['ils', '-L', file_name], 'STDOUT_SINGLELINE', checksum)
+
+        finally:
+            self.admin.run_icommand(['irm', '-f', file_name])
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context', self.s3_context])
+            s3plugin_lib.remove_if_exists(file_name)
+
+    def test_irm_with_deferred_delete(self):
+        collection_name = f'{inspect.currentframe().f_code.co_name}'
+        local_dir = f'{collection_name}_dir'
+        number_of_files = 20
+
+        s3_client = Minio(self.s3endPoint,
+                access_key=self.aws_access_key_id,
+                secret_key=self.aws_secret_access_key,
+                region=self.s3region,
+                secure=(self.proto == 'HTTPS'))
+
+        def keys_in_bucket():
+            return [o.object_name for o in s3_client.list_objects(self.s3bucketname, recursive=True)
+                    if collection_name in o.object_name]
+
+        try:
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context', self.s3_context + ';S3_DEFERRED_DELETE=1'])
+
+            os.makedirs(local_dir, exist_ok=True)
+            for i in range(number_of_files):
+                lib.make_arbitrary_file(f'{local_dir}/f{i}', 1024)
+            self.admin.assert_icommand(['iput', '-r', local_dir, collection_name])
+            self.assertEqual(len(keys_in_bucket()), number_of_files)
+
+            self.admin.assert_icommand(['irm', '-rf', collection_name])
+
+            # the objects are deleted in the background
+            for _ in range(60):
+                if not keys_in_bucket():
+                    break
+                time.sleep(1)
+            self.assertEqual(keys_in_bucket(), [])
+
+            # a path that is unlinked and written again right away must keep the new object
+            self.admin.assert_icommand(['imkdir', collection_name])
+            file_name = f'{local_dir}/f0'
+            logical_path = f'{collection_name}/f0'
+            self.admin.assert_icommand(['iput', file_name, logical_path])
+            self.admin.assert_icommand(['irm', '-f', logical_path])
+            self.admin.assert_icommand(['iput', file_name, logical_path])
+            time.sleep(5)
+            self.assertEqual(len(keys_in_bucket()), 1)
+            self.admin.assert_icommand(['iget', '-f', logical_path, f'{file_name}.get'])
+            self.assertTrue(filecmp.cmp(file_name, f'{file_name}.get', shallow=False))
+
+        finally:
+            self.admin.run_icommand(['irm', '-rf', collection_name])
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context', self.s3_context])
+            shutil.rmtree(local_dir, ignore_errors=True)
+
+    def test_overwrite_and_rename_with_metadata_cache(self):
+        collection_name = f'{inspect.currentframe().f_code.co_name}'
+        small_file = f'{collection_name}_small'
+        large_file = f'{collection_name}_large'
+        logical_path = f'{collection_name}/f'
+        renamed_logical_path = f'{collection_name}/g'
+
+        try:
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context', self.s3_context + ';S3_METADATA_CACHE_TTL_SECONDS=60'])
+
+            lib.make_arbitrary_file(small_file, 1024)
+            lib.make_arbitrary_file(large_file, 4096)
+            self.admin.assert_icommand(['imkdir', collection_name])
+
+            # the cached size of the first object must not be used for the second
+            self.admin.assert_icommand(['iput', small_file, logical_path])
+            self.admin.assert_icommand(['iget', '-f', logical_path, f'{small_file}.get'])
+            self.assertTrue(filecmp.cmp(small_file, f'{small_file}.get', shallow=False))
+            self.admin.assert_icommand(['iput', '-f', large_file, logical_path])
+            self.admin.assert_icommand(['iget', '-f', logical_path, f'{large_file}.get'])
+            self.assertTrue(filecmp.cmp(large_file, f'{large_file}.get', shallow=False))
+
+            # the object is read at its new location
+            self.admin.assert_icommand(['imv', logical_path, renamed_logical_path])
+            self.admin.assert_icommand(['iget', '-f', renamed_logical_path, f'{large_file}.get'])
+            self.assertTrue(filecmp.cmp(large_file, f'{large_file}.get', shallow=False))
+
+            # a path that was unlinked and written again is read in full
+            self.admin.assert_icommand(['irm', '-f', renamed_logical_path])
+            self.admin.assert_icommand(['iput', small_file, renamed_logical_path])
+            self.admin.assert_icommand(['iget', '-f', renamed_logical_path, f'{small_file}.get'])
+            self.assertTrue(filecmp.cmp(small_file, f'{small_file}.get', shallow=False))
+
+        finally:
+            self.admin.run_icommand(['irm', '-rf', collection_name])
+            self.admin.assert_icommand(['iadmin', 'modresc', 'demoResc', 'context', self.s3_context])
+            for f in [small_file, large_file, f'{small_file}.get', f'{large_file}.get']:
+                if os.path.exists(f):
+                    os.unlink(f)
+
     def test_local_imv_collection_to_sibling_collection__ticket_2448(self):
         self.admin.assert_icommand("imkdir first_dir")  # first collection
         self.admin.assert_icommand("icp " + self.testfile + " first_dir")  # add file
@@ -1616,6 +1750,38 @@ OUTPUT ruleExecOut
         file_count = self.admin.run_icommand('''iquest "%s" "SELECT count(DATA_ID) where COLL_NAME like '%/basedir%'"''')[0]
         self.assertEqual(file_count, u'9\n')
 
+    def test_recursive_register_from_s3_bucket_with_multiple_listing_pages(self):
+
+        # more keys than are returned by one list so readdir crosses page boundaries
+        s3_client = Minio(self.s3endPoint,
+                access_key=self.aws_access_key_id,
+                secret_key=self.aws_secret_access_key,
+                region=self.s3region,
+                secure=(self.proto == 'HTTPS'))
+
+        file_contents = b'random test data'
+        size = len(file_contents)
+        number_of_files = 2500
+
+        for i in range(number_of_files):
+            s3_client.put_object(self.s3bucketname, 'largedir/f%d' % i, io.BytesIO(file_contents), size)
+        s3_client.put_object(self.s3bucketname, 'largedir/subdir/f1', io.BytesIO(file_contents), size)
+
+        # register the same directory twice so the second listing starts over
+        for collection in ['largedir1', 'largedir2']:
+            self.admin.assert_icommand("ireg -r /%s/largedir %s/%s" % (self.s3bucketname, self.admin.session_collection, collection))
+            file_count = self.admin.run_icommand('''iquest "%s" "SELECT count(DATA_ID) where COLL_NAME like '%/{}%'"'''.format(collection))[0]
+            self.assertEqual(file_count, u'{}\n'.format(number_of_files + 1))
+
+    def test_recursive_register_and_ils_of_empty_collection(self):
+
+        # no keys have this prefix so the listing is empty and must end after the first page
+        collection = '%s/emptydir' % self.admin.session_collection
+        self.admin.assert_icommand("ireg -r /%s/emptydir_no_keys %s" % (self.s3bucketname, collection))
+        self.admin.assert_icommand("ils %s" % collection, 'STDOUT_SINGLELINE', collection)
+        file_count = self.admin.run_icommand('''iquest "%s" "SELECT count(DATA_ID) where COLL_NAME like '%/emptydir%'"''')[0]
+        self.assertEqual(file_count, u'0\n')
+
     def test_copy_file_greater_than_chunk_size(self):
 
         try:
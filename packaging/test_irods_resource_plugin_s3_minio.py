@@ -95,6 +95,17 @@ class Test_S3_NoCache_MPU_Disabled(Test_S3_NoCache_MPU_Disabled_Base, unittest.T
         self.s3EnableMPU=0
         super(Test_S3_NoCache_MPU_Disabled, self).__init__(*args, **kwargs)
 
+class Test_S3_NoCache_CopyObject_Disabled(Test_S3_NoCache_Base, unittest.TestCase):
+    def __init__(self, *args, **kwargs):
+        """Set up the test."""
+        self.proto = 'HTTP'
+        self.keypairfile='/var/lib/irods/minio.keypair'
+        self.s3region='us-east-1'
+        self.s3endPoint = 'localhost:9000'
+        self.s3EnableMPU=1
+        self.s3DisableCopyObject=1
+        super(Test_S3_NoCache_CopyObject_Disabled, self).__init__(*args, **kwargs)
+
 class Test_S3_NoCache_Decoupled(Test_S3_NoCache_Base, unittest.TestCase):
     def __init__(self, *args, **kwargs):
         """Set up the test."""
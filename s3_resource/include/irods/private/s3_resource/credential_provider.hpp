@@ -0,0 +1,112 @@
+#ifndef IRODS_S3_RESOURCE_CREDENTIAL_PROVIDER_HPP
+#define IRODS_S3_RESOURCE_CREDENTIAL_PROVIDER_HPP
+
+#include <irods/irods_resource_plugin.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace irods_s3
+{
+    // The keys read from S3_AUTH_FILE.  Each version of the file is a new object.
+    struct s3_credentials
+    {
+        std::string   key_id;
+        std::string   access_key;
+        std::uint64_t version;
+    };
+
+    // Reads S3_AUTH_FILE once and again whenever the file changes, so that the keys can be
+    // rotated without restarting the server.  Agents are short-lived and many run at once, so
+    // rather than each holding an inotify instance (there are only 128 per user by default) the
+    // file is checked with stat() on use, at most once every CHECK_INTERVAL.  Every version
+    // handed out is kept until the provider is destroyed, so callers may hold on to the
+    // reference (and to pointers into its strings, as bucket contexts do) without a lock.  Keys
+    // rotate rarely so the old versions cost little.
+    class credential_provider
+    {
+        public:
+
+            static constexpr std::chrono::seconds CHECK_INTERVAL{10};
+
+            // Reads the auth file.  Fails if it cannot be opened or does not hold two keys.
+            static irods::error make(const std::string& _auth_file,
+                                     const std::string& _resource_name,
+                                     std::shared_ptr<credential_provider>& _provider);
+
+            credential_provider(const credential_provider&) = delete;
+            credential_provider& operator=(const credential_provider&) = delete;
+
+            const std::string& auth_file() const noexcept
+            {
+                return auth_file_;
+            }
+
+            // The keys in use.  A single atomic load, except for the one caller per
+            // CHECK_INTERVAL that checks whether the file has changed and reads it if it has.
+            const s3_credentials& current()
+            {
+                check_for_changes();
+                return *current_.load(std::memory_order_acquire);
+            }
+
+            // Reads the auth file again and publishes the keys if they changed.  The keys in
+            // use are kept if the file cannot be read.
+            irods::error reload();
+
+        private:
+
+            // what stat() says about the auth file, compared to notice that it was replaced
+            struct file_identity
+            {
+                dev_t           device{};
+                ino_t           inode{};
+                off_t           size{};
+                struct timespec modified{};
+                struct timespec changed{};
+
+                bool operator==(const file_identity& _other) const noexcept;
+
+                // false if the file cannot be stat'ed
+                static bool of(const std::string& _path, file_identity& _identity);
+            };
+
+            credential_provider(std::string _auth_file, std::string _resource_name, s3_credentials _credentials);
+
+            void check_for_changes();
+
+            irods::error reload(const file_identity& _identity);
+
+            const std::string auth_file_;
+            const std::string resource_name_;
+
+            std::atomic<const s3_credentials*> current_;
+
+            // steady clock time of the next check
+            std::atomic<std::chrono::steady_clock::rep> next_check_;
+
+            // guards the versions and the identity
+            std::mutex mutex_;
+            std::vector<std::unique_ptr<const s3_credentials>> versions_;
+            file_identity identity_;
+    }; // class credential_provider
+
+    // Creates the provider for the resource, or reloads the one it has, and keeps it in the
+    // property map.
+    irods::error read_credentials(irods::plugin_property_map& _prop_map, const std::string& _auth_file);
+
+    // Sets _provider to the provider created by read_credentials().
+    irods::error get_credential_provider(irods::plugin_property_map& _prop_map,
+                                         std::shared_ptr<credential_provider>& _provider);
+
+} // namespace irods_s3
+
+#endif // IRODS_S3_RESOURCE_CREDENTIAL_PROVIDER_HPP
@@ -0,0 +1,47 @@
+#ifndef IRODS_S3_RESOURCE_DEFERRED_DELETE_QUEUE_HPP
+#define IRODS_S3_RESOURCE_DEFERRED_DELETE_QUEUE_HPP
+
+#include <irods/irods_resource_plugin.hpp>
+
+#include <string>
+
+namespace irods_s3
+{
+    // Deferred deletes (S3_DEFERRED_DELETE).  Unlinked objects are recorded in a journal under
+    // <cache directory>/deferred_delete that is shared by all agents on this server.  Deletes are
+    // only deferred when S3_CACHE_DIR is set (see s3_deferred_delete_enabled) so the journal
+    // survives restarts as long as that directory does:
+    //
+    //   pending/<entry>          objects waiting to be deleted, the file holds the physical path
+    //   draining/<pid>/<entry>   objects claimed by the worker in process <pid>
+    //   incoming/<pid>-<entry>   entries being written, renamed into pending/ once complete
+    //
+    // The entry name is a hash of the physical path so a path is only ever queued once.  A worker
+    // thread per resource and agent drains the journal with Multi-Object Delete requests.  Entries
+    // left in draining/ by agents that have exited are returned to pending/.
+
+    // Queues the object for deletion and makes sure a worker is running.  Returns false if the
+    // object was not queued, either because the journal has grown past
+    // S3_DEFERRED_DELETE_QUEUE_LIMIT or because it could not be written.  The caller must then
+    // delete the object itself.
+    bool enqueue_deferred_delete(irods::plugin_property_map& _prop_map, const std::string& _physical_path);
+
+    // Removes the object from the journal before it is written again.  If the object is being
+    // deleted at that moment this waits for the delete to finish, and fails if it is still in
+    // progress after the time a batch of deletes may take with all of its retries.  The object
+    // must not be written then.
+    irods::error cancel_deferred_delete(irods::plugin_property_map& _prop_map, const std::string& _physical_path);
+
+    // Starts a worker for this resource if deletes were left in the journal.
+    void start_deferred_delete_worker(irods::plugin_property_map& _prop_map);
+
+    // Stops the worker for this resource.  The worker first sends what is queued for up to five
+    // seconds, without waiting to retry deletes that fail, so that the deletes of a short-lived
+    // agent are not left for the next one.  A batch being sent when the time runs out is allowed
+    // to complete, which takes as long as one Multi-Object Delete request with its retries at
+    // worst.  Whatever is still queued is left for the next agent.
+    void stop_deferred_delete_worker(irods::plugin_property_map& _prop_map);
+
+} // namespace irods_s3
+
+#endif // IRODS_S3_RESOURCE_DEFERRED_DELETE_QUEUE_HPP
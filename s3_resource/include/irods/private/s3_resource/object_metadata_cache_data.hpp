@@ -0,0 +1,127 @@
+#ifndef IRODS_S3_RESOURCE_OBJECT_METADATA_CACHE_DATA_HPP
+#define IRODS_S3_RESOURCE_OBJECT_METADATA_CACHE_DATA_HPP
+
+#include "irods/private/s3_resource/multipart_shared_data.hpp"
+
+#include <irods/rodsDef.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+namespace irods_s3
+{
+    // What a HEAD of an object returned.
+    struct object_metadata
+    {
+        std::int64_t size;
+        time_t       last_modified;
+        std::string  storage_class;
+        std::string  etag;
+    };
+
+    // Results of recent HEAD requests (S3_METADATA_CACHE_TTL_SECONDS), shared by all agents on
+    // this server so that the stat, open and transport of one operation do not each send a HEAD
+    // for the same object.  There is one of these per resource so the physical path, which holds
+    // the bucket and the key, identifies the object.  Only objects that can be read right away are
+    // stored.  Objects that do not exist or are archived change state without a write through this
+    // plugin.  Entries are removed when this plugin writes, renames or unlinks the object.
+    struct object_metadata_cache_data
+    {
+        static constexpr std::size_t NUMBER_OF_ENTRIES{256};
+        static constexpr std::size_t MAXIMUM_STORAGE_CLASS_LENGTH{32};
+        static constexpr std::size_t MAXIMUM_ETAG_LENGTH{128};
+
+        struct entry
+        {
+            char         physical_path[MAX_NAME_LEN];
+            std::int64_t size;
+            time_t       last_modified;
+            char         storage_class[MAXIMUM_STORAGE_CLASS_LENGTH];
+            char         etag[MAXIMUM_ETAG_LENGTH];
+            time_t       time_stored;
+        };
+
+        explicit object_metadata_cache_data(const interprocess_types::void_allocator &allocator)
+            : ref_count{0}
+            , entries{}
+        {}
+
+        // the entries must outlive the agent that stored them
+        bool can_delete() {
+            return false;
+        }
+
+        void store(const std::string& _physical_path, const object_metadata& _metadata)
+        {
+            entry* slot = find_entry(_physical_path);
+
+            if (_physical_path.size() >= MAX_NAME_LEN ||
+                    _metadata.storage_class.size() >= MAXIMUM_STORAGE_CLASS_LENGTH ||
+                    _metadata.etag.size() >= MAXIMUM_ETAG_LENGTH) {
+                if (slot) {
+                    *slot = entry{};
+                }
+                return;
+            }
+
+            // otherwise replace the oldest entry
+            if (!slot) {
+                slot = &entries[0];
+                for (auto& e : entries) {
+                    if (e.time_stored < slot->time_stored) {
+                        slot = &e;
+                    }
+                }
+            }
+
+            *slot = entry{};
+            std::strncpy(slot->physical_path, _physical_path.c_str(), MAX_NAME_LEN - 1);
+            slot->size = _metadata.size;
+            slot->last_modified = _metadata.last_modified;
+            std::strncpy(slot->storage_class, _metadata.storage_class.c_str(), MAXIMUM_STORAGE_CLASS_LENGTH - 1);
+            std::strncpy(slot->etag, _metadata.etag.c_str(), MAXIMUM_ETAG_LENGTH - 1);
+            slot->time_stored = time(nullptr);
+        }
+
+        void remove(const std::string& _physical_path)
+        {
+            if (entry* slot = find_entry(_physical_path)) {
+                *slot = entry{};
+            }
+        }
+
+        // Returns the metadata for the path if it was stored no more than _ttl_seconds ago
+        bool find(const std::string& _physical_path, time_t _ttl_seconds, object_metadata& _metadata)
+        {
+            const entry* e = find_entry(_physical_path);
+            if (!e || time(nullptr) - e->time_stored > _ttl_seconds) {
+                return false;
+            }
+            _metadata.size = e->size;
+            _metadata.last_modified = e->last_modified;
+            _metadata.storage_class = e->storage_class;
+            _metadata.etag = e->etag;
+            return true;
+        }
+
+        int ref_count;
+        std::array<entry, NUMBER_OF_ENTRIES> entries;
+
+    private:
+
+        entry* find_entry(const std::string& _physical_path)
+        {
+            for (auto& e : entries) {
+                if (e.time_stored != 0 && _physical_path == e.physical_path) {
+                    return &e;
+                }
+            }
+            return nullptr;
+        }
+    }; // struct object_metadata_cache_data
+} // namespace irods_s3
+
+#endif // IRODS_S3_RESOURCE_OBJECT_METADATA_CACHE_DATA_HPP
@@ -0,0 +1,75 @@
+#ifndef IRODS_S3_RESOURCE_RESOURCE_CONFIG_HPP
+#define IRODS_S3_RESOURCE_RESOURCE_CONFIG_HPP
+
+#include "irods/private/s3_resource/credential_provider.hpp"
+#include "libs3/libs3.h"
+
+#include <irods/irods_resource_plugin.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace irods_s3
+{
+    // The settings every request needs, parsed from the property map once (when the resource is
+    // started) rather than by each operation.  A snapshot is never modified so it can be used from
+    // any thread.  Operations hold it by shared pointer for as long as they use the bucket
+    // contexts made from it.  The keys are not part of the snapshot, they come from the
+    // credential provider of the resource so that a rotation is picked up at once.
+    class resource_config
+    {
+        public:
+
+            resource_config(irods::plugin_property_map& _prop_map, std::shared_ptr<credential_provider> _credentials);
+
+            resource_config(const resource_config&) = delete;
+            resource_config& operator=(const resource_config&) = delete;
+
+            // Returns a bucket context for _bucket with the host set to the next host in
+            // S3_DEFAULT_HOSTNAME and the current keys.  The strings it points to belong to this
+            // snapshot, its credential provider and _bucket.
+            S3BucketContext bucket_context(const std::string& _bucket) const;
+
+            // Returns the keys read most recently from S3_AUTH_FILE.
+            const s3_credentials& credentials() const
+            {
+                return credentials_->current();
+            }
+
+            // Returns the hosts in S3_DEFAULT_HOSTNAME in turn, an empty string if there are none.
+            const std::string& next_hostname() const;
+
+            const std::string  resource_name;
+            const std::string  region_name;
+            const S3Protocol   protocol;
+            const S3STSDate    sts_date;
+            const S3UriStyle   uri_style;
+            const std::size_t  retry_count_limit;
+            const std::size_t  retry_wait;
+            const std::size_t  max_retry_wait;
+            const std::int64_t mpu_chunk_size;
+            const unsigned int non_data_transfer_timeout_seconds;
+            const std::vector<std::string> hostnames;
+
+        private:
+
+            std::size_t next_host_index() const;
+
+            std::shared_ptr<credential_provider> credentials_;
+
+            // everything but the bucket and the keys, one per host
+            std::vector<S3BucketContext> bucket_context_templates_;
+            mutable std::atomic<std::size_t> host_counter_;
+    }; // class resource_config
+
+    // Sets _config to the snapshot of the resource, making it the first time.  Fails if the
+    // credentials have not been read.
+    irods::error get_resource_config(irods::plugin_property_map& _prop_map,
+                                     std::shared_ptr<const resource_config>& _config);
+
+} // namespace irods_s3
+
+#endif // IRODS_S3_RESOURCE_RESOURCE_CONFIG_HPP
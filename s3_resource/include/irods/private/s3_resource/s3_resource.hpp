@@ -14,6 +14,10 @@
 #include <irods/rcConnect.h>
 #include "libs3/libs3.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #define S3_AUTH_FILE "s3Auth"
 #define ARCHIVE_NAMING_POLICY_KW    "ARCHIVE_NAMING_POLICY"
 #define CONSISTENT_NAMING           "consistent"
@@ -57,6 +61,13 @@ extern const unsigned int S3_DEFAULT_NON_DATA_TRANSFER_TIMEOUT_SECONDS;
 std::string s3GetHostname(irods::plugin_property_map& _prop_map);
 std::int64_t s3GetMPUChunksize(irods::plugin_property_map& _prop_map);
 ssize_t s3GetMPUThreads(irods::plugin_property_map& _prop_map);
+std::int64_t s3_get_copy_part_size(irods::plugin_property_map& _prop_map);
+int s3_get_copy_concurrency(irods::plugin_property_map& _prop_map);
+int s3_get_checksum_read_threads(irods::plugin_property_map& _prop_map);
+std::int64_t s3_get_small_object_upload_size(irods::plugin_property_map& _prop_map);
+std::int64_t s3_get_read_cache_size(irods::plugin_property_map& _prop_map);
+std::int64_t s3_get_read_page_size(irods::plugin_property_map& _prop_map);
+std::int64_t s3_get_read_merge_distance(irods::plugin_property_map& _prop_map);
 bool s3GetEnableMultiPartUpload (irods::plugin_property_map& _prop_map);
 S3UriStyle s3_get_uri_request_style(irods::plugin_property_map& _prop_map);
 std::string get_region_name(irods::plugin_property_map& _prop_map);
@@ -72,6 +83,14 @@ std::string s3_get_restoration_tier(irods::plugin_property_map& _prop_map);
 std::string s3_get_storage_class_from_configuration(irods::plugin_property_map& _prop_map);
 bool s3_direct_checksum_read_enabled(irods::plugin_property_map& _prop_map);
 bool s3_trailing_checksum_on_upload_enabled(irods::plugin_property_map& _prop_map);
+std::string s3_get_checksum_on_upload_scheme(irods::plugin_property_map& _prop_map);
+bool s3_cache_io_uring_enabled(irods::plugin_property_map& _prop_map);
+bool s3_sparse_cache_file_enabled(irods::plugin_property_map& _prop_map);
+bool s3_list_objects_v2_enabled(irods::plugin_property_map& _prop_map);
+bool s3_deferred_delete_enabled(irods::plugin_property_map& _prop_map);
+std::size_t s3_get_deferred_delete_queue_limit(irods::plugin_property_map& _prop_map);
+int s3_get_warm_up_connections(irods::plugin_property_map& _prop_map);
+int s3_get_metadata_cache_ttl_seconds(irods::plugin_property_map& _prop_map);
 
 void StoreAndLogStatus(S3Status status, const S3ErrorDetails *error,
         const char *function, const S3BucketContext *pCtx, S3Status *pStatus,
@@ -104,6 +123,9 @@ typedef struct callback_data
         , prop_map_ptr{nullptr}
         , x_amz_storage_class{}   // for glacier
         , x_amz_restore{}         // for glacier
+        , etag{}
+        , upload_checksum{}
+        , upload_checksum_scheme{}
     {}
     int fd;
     std::int64_t offset;       /* For multiple upload */
@@ -116,6 +138,9 @@ typedef struct callback_data
     irods::plugin_property_map *prop_map_ptr;
     std::string x_amz_storage_class;
     std::string x_amz_restore;
+    std::string etag;
+    std::string upload_checksum;          // from the object metadata, see ENABLE_CHECKSUM_ON_UPLOAD
+    std::string upload_checksum_scheme;
 } callback_data_t;
 
 typedef struct upload_manager
@@ -227,6 +252,43 @@ irods::error s3PutCopyFile(
     const std::string& _access_key,
     irods::plugin_property_map& _prop_map);
 
+/// @brief Function to copy the specified src file to the specified dest file using
+///        concurrent UploadPartCopy requests
+irods::error s3_copy_object_multipart(
+    irods::plugin_property_map& _prop_map,
+    const std::string& _src_file,
+    const std::string& _dest_file,
+    rodsLong_t _object_size,
+    const std::string& _key_id,
+    const std::string& _access_key);
+
+/// @brief Function to copy the specified src file to the specified dest file by reading
+///        it through this server, for providers that do not support CopyObject
+irods::error s3_copy_object_pipelined(
+    irods::plugin_property_map& _prop_map,
+    const std::string& _src_file,
+    const std::string& _dest_file,
+    rodsLong_t _object_size,
+    const std::string& _key_id,
+    const std::string& _access_key);
+
+/// @brief Deletes the specified files with Multi-Object Delete requests of up to
+///        S3_MAX_DELETE_OBJECTS_COUNT keys each, falling back to one DELETE per key when
+///        the provider does not support them.  The files that could not be deleted are
+///        returned in _failed with their status.  Files that do not exist are not failures.
+irods::error s3_delete_objects(
+    irods::plugin_property_map& _prop_map,
+    const std::vector<std::string>& _files,
+    std::vector<std::pair<std::string, S3Status>>& _failed);
+
+/// @brief Computes the checksum of the specified file, in iRODS format, with
+///        S3_CHECKSUM_READ_THREADS concurrent ranged GETs
+irods::error s3_compute_checksum_with_ranged_reads(
+    irods::plugin_property_map& _prop_map,
+    const std::string& _file,
+    const std::string& _scheme,
+    std::string& _checksum);
+
 /// @brief Function to copy the specified src file to the specified dest file
 irods::error s3CopyFile(
     irods::plugin_context& _src_ctx,
@@ -238,6 +300,25 @@ irods::error s3CopyFile(
     const S3STSDate _stsDate,
     const S3UriStyle _s3_uri_style);
 
+/// @brief Reads the checksum saved in the object's metadata when it was uploaded with
+///        ENABLE_CHECKSUM_ON_UPLOAD.  _scheme and _checksum are empty if there is none.
+irods::error s3_get_upload_checksum_metadata(
+    irods::plugin_property_map& _prop_map,
+    const std::string& _file,
+    std::string& _scheme,
+    std::string& _checksum);
+
+/// @brief Saves the checksum in the metadata of an existing object by copying the
+///        object onto itself.  The object must not be larger than CopyObject allows.
+///        The copy is only made while the object's ETag is still _etag, so an object
+///        written again since then does not get the checksum of the old one.
+irods::error s3_put_upload_checksum_metadata(
+    irods::plugin_property_map& _prop_map,
+    const std::string& _file,
+    const std::string& _etag,
+    const std::string& _scheme,
+    const std::string& _checksum);
+
 // =-=-=-=-=-=-=-
 /// @brief Checks the basic operation parameters and updates the physical path in the file object
 irods::error s3CheckParams(irods::plugin_context& _ctx );
@@ -0,0 +1,103 @@
+#ifndef IRODS_S3_RESOURCE_UPLOAD_CHECKSUM_CACHE_DATA_HPP
+#define IRODS_S3_RESOURCE_UPLOAD_CHECKSUM_CACHE_DATA_HPP
+
+#include "irods/private/s3_resource/multipart_shared_data.hpp"
+
+#include <irods/rodsDef.h>
+
+#include <array>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+namespace irods_s3
+{
+    // Checksums computed while objects were uploaded (ENABLE_CHECKSUM_ON_UPLOAD), shared by all
+    // agents on this server so that the checksum request that usually follows an upload does not
+    // have to read the object or its metadata.  There is one of these per resource.  Entries are
+    // only used for a short time after they are stored as the object may be overwritten through
+    // another server.
+    struct upload_checksum_cache_data
+    {
+        static constexpr std::size_t NUMBER_OF_ENTRIES{256};
+        static constexpr std::size_t MAXIMUM_SCHEME_LENGTH{32};
+        static constexpr std::size_t MAXIMUM_CHECKSUM_LENGTH{160};
+        static constexpr time_t      ENTRY_LIFETIME_IN_SECONDS{60};
+
+        struct entry
+        {
+            char   physical_path[MAX_NAME_LEN];
+            char   scheme[MAXIMUM_SCHEME_LENGTH];
+            char   checksum[MAXIMUM_CHECKSUM_LENGTH];
+            time_t time_stored;
+        };
+
+        explicit upload_checksum_cache_data(const interprocess_types::void_allocator &allocator)
+            : ref_count{0}
+            , entries{}
+        {}
+
+        // the entries must outlive the agent that stored them
+        bool can_delete() {
+            return false;
+        }
+
+        // Store the checksum for the path.  An empty checksum removes the entry.
+        void store(const std::string& _physical_path, const std::string& _scheme, const std::string& _checksum)
+        {
+            const time_t now = time(nullptr);
+
+            entry* slot = nullptr;
+            for (auto& e : entries) {
+                if (_physical_path == e.physical_path) {
+                    slot = &e;
+                    break;
+                }
+            }
+
+            if (_checksum.empty() || _physical_path.size() >= MAX_NAME_LEN ||
+                    _scheme.size() >= MAXIMUM_SCHEME_LENGTH || _checksum.size() >= MAXIMUM_CHECKSUM_LENGTH) {
+                if (slot) {
+                    *slot = entry{};
+                }
+                return;
+            }
+
+            // otherwise replace the oldest entry
+            if (!slot) {
+                slot = &entries[0];
+                for (auto& e : entries) {
+                    if (e.time_stored < slot->time_stored) {
+                        slot = &e;
+                    }
+                }
+            }
+
+            std::strncpy(slot->physical_path, _physical_path.c_str(), MAX_NAME_LEN - 1);
+            std::strncpy(slot->scheme, _scheme.c_str(), MAXIMUM_SCHEME_LENGTH - 1);
+            std::strncpy(slot->checksum, _checksum.c_str(), MAXIMUM_CHECKSUM_LENGTH - 1);
+            slot->time_stored = now;
+        }
+
+        // Returns the checksum for the path if it has not expired and was computed with the scheme
+        bool find(const std::string& _physical_path, const std::string& _scheme, std::string& _checksum) const
+        {
+            const time_t now = time(nullptr);
+            for (const auto& e : entries) {
+                if (e.time_stored != 0 && _physical_path == e.physical_path) {
+                    if (now - e.time_stored > ENTRY_LIFETIME_IN_SECONDS || _scheme != e.scheme) {
+                        return false;
+                    }
+                    _checksum = e.checksum;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        int ref_count;
+        std::array<entry, NUMBER_OF_ENTRIES> entries;
+    }; // struct upload_checksum_cache_data
+} // namespace irods_s3
+
+#endif // IRODS_S3_RESOURCE_UPLOAD_CHECKSUM_CACHE_DATA_HPP
@@ -0,0 +1,235 @@
+// =-=-=-=-=-=-=-
+// local includes
+#include "irods/private/s3_resource/credential_provider.hpp"
+#include "irods/private/s3_resource/s3_resource.hpp"
+#include "irods/private/s3_resource/s3_plugin_logging_category.hpp"
+
+// =-=-=-=-=-=-=-
+// irods includes
+#include <irods/irods_at_scope_exit.hpp>
+#include <irods/rcMisc.h>
+#include <irods/rodsErrorTable.h>
+
+// =-=-=-=-=-=-=-
+// other includes
+#include <fmt/format.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace irods_s3
+{
+    namespace
+    {
+        using logger = irods::experimental::log::logger<s3_plugin_logging_category>;
+
+        // the property holding the provider
+        const std::string CREDENTIAL_PROVIDER_KW{"S3_CREDENTIAL_PROVIDER"};
+
+        // The first line of the file holds the access key id and the second the secret access key.
+        irods::error read_auth_file(const std::string& _auth_file,
+                                    const std::string& _resource_name,
+                                    std::string& _key_id,
+                                    std::string& _access_key)
+        {
+            char inbuf[MAX_NAME_LEN];
+            int lineLen, bytesCopied;
+            int linecnt = 0;
+            char access_key_id[S3_MAX_KEY_SIZE];
+            char secret_access_key[S3_MAX_KEY_SIZE];
+
+            FILE* fptr = fopen(_auth_file.c_str(), "r");
+            const auto close_fptr = irods::at_scope_exit{[fptr] { if (fptr) fclose(fptr); }};
+
+            if (!fptr) {
+                return ERROR(SYS_CONFIG_FILE_ERR, fmt::format(
+                             "[resource_name={}] Failed to open S3 auth file: \"{}\", errno = \"{}\".",
+                             _resource_name, _auth_file, strerror(errno)));
+            }
+
+            while ((lineLen = getLine (fptr, inbuf, MAX_NAME_LEN)) > 0) {
+                char *inPtr = inbuf;
+                if (linecnt == 0) {
+                    while ((bytesCopied = getStrInBuf (&inPtr, access_key_id, &lineLen, S3_MAX_KEY_SIZE)) > 0) {
+                        linecnt ++;
+                        break;
+                    }
+                } else if (linecnt == 1) {
+                    while ((bytesCopied = getStrInBuf (&inPtr, secret_access_key, &lineLen, S3_MAX_KEY_SIZE)) > 0) {
+                        linecnt ++;
+                        break;
+                    }
+                }
+            }
+
+            if (linecnt != 2) {
+                return ERROR(SYS_CONFIG_FILE_ERR, fmt::format(
+                             "[resource_name={}] Read {} lines in the auth file. Expected 2.",
+                             _resource_name, linecnt));
+            }
+
+            _key_id = access_key_id;
+            _access_key = secret_access_key;
+
+            return SUCCESS();
+        }
+    } // namespace
+
+    bool credential_provider::file_identity::operator==(const file_identity& _other) const noexcept
+    {
+        return device == _other.device && inode == _other.inode && size == _other.size &&
+               modified.tv_sec == _other.modified.tv_sec && modified.tv_nsec == _other.modified.tv_nsec &&
+               changed.tv_sec == _other.changed.tv_sec && changed.tv_nsec == _other.changed.tv_nsec;
+    }
+
+    bool credential_provider::file_identity::of(const std::string& _path, file_identity& _identity)
+    {
+        // follows symbolic links, so replacing the target of a link (as secret stores do) is seen
+        struct stat statbuf;
+        if (stat(_path.c_str(), &statbuf) < 0) {
+            return false;
+        }
+
+        _identity.device = statbuf.st_dev;
+        _identity.inode = statbuf.st_ino;
+        _identity.size = statbuf.st_size;
+        _identity.modified = statbuf.st_mtim;
+        _identity.changed = statbuf.st_ctim;
+        return true;
+    }
+
+    credential_provider::credential_provider(std::string _auth_file,
+                                             std::string _resource_name,
+                                             s3_credentials _credentials)
+        : auth_file_{std::move(_auth_file)}
+        , resource_name_{std::move(_resource_name)}
+        , current_{nullptr}
+        , next_check_{(std::chrono::steady_clock::now() + CHECK_INTERVAL).time_since_epoch().count()}
+        , mutex_{}
+        , versions_{}
+        , identity_{}
+    {
+        versions_.push_back(std::make_unique<const s3_credentials>(std::move(_credentials)));
+        current_.store(versions_.back().get(), std::memory_order_release);
+    }
+
+    irods::error credential_provider::make(const std::string& _auth_file,
+                                           const std::string& _resource_name,
+                                           std::shared_ptr<credential_provider>& _provider)
+    {
+        // taken before the file is read so that a change made while reading it is not missed
+        file_identity identity;
+        file_identity::of(_auth_file, identity);
+
+        std::string key_id;
+        std::string access_key;
+        irods::error ret = read_auth_file(_auth_file, _resource_name, key_id, access_key);
+        if (!ret.ok()) {
+            return PASS(ret);
+        }
+
+        _provider.reset(new credential_provider{_auth_file, _resource_name, s3_credentials{key_id, access_key, 1}});
+        _provider->identity_ = identity;
+        return SUCCESS();
+    }
+
+    irods::error credential_provider::reload()
+    {
+        file_identity identity;
+        file_identity::of(auth_file_, identity);
+        return reload(identity);
+    }
+
+    irods::error credential_provider::reload(const file_identity& _identity)
+    {
+        std::string key_id;
+        std::string access_key;
+        irods::error ret = read_auth_file(auth_file_, resource_name_, key_id, access_key);
+
+        std::lock_guard lock(mutex_);
+
+        // A file that cannot be read is not read again until it changes, so that it is
+        // reported once rather than at every check.
+        identity_ = _identity;
+
+        if (!ret.ok()) {
+            return PASS(ret);
+        }
+
+        const s3_credentials& in_use = *current_.load(std::memory_order_acquire);
+        if (in_use.key_id == key_id && in_use.access_key == access_key) {
+            return SUCCESS();
+        }
+
+        versions_.push_back(std::make_unique<const s3_credentials>(
+                    s3_credentials{key_id, access_key, in_use.version + 1}));
+        current_.store(versions_.back().get(), std::memory_order_release);
+
+        logger::info("[resource_name={}] Read new keys from \"{}\".", resource_name_, auth_file_);
+
+        return SUCCESS();
+    }
+
+    void credential_provider::check_for_changes()
+    {
+        const auto now = std::chrono::steady_clock::now();
+        auto next_check = next_check_.load(std::memory_order_relaxed);
+        if (now.time_since_epoch().count() < next_check) {
+            return;
+        }
+
+        // one caller makes the check, the others keep going with the keys they have
+        if (!next_check_.compare_exchange_strong(next_check, (now + CHECK_INTERVAL).time_since_epoch().count(),
+                    std::memory_order_relaxed)) {
+            return;
+        }
+
+        // The file may be missing for a moment while it is replaced.  Keep the keys in use and
+        // look again at the next check.
+        file_identity identity;
+        if (!file_identity::of(auth_file_, identity)) {
+            return;
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            if (identity == identity_) {
+                return;
+            }
+        }
+
+        if (irods::error ret = reload(identity); !ret.ok()) {
+            logger::warn("[resource_name={}] Keeping the S3 keys in use.  {}", resource_name_, ret.result());
+        }
+    }
+
+    irods::error read_credentials(irods::plugin_property_map& _prop_map, const std::string& _auth_file)
+    {
+        std::shared_ptr<credential_provider> provider;
+        if (get_credential_provider(_prop_map, provider).ok() && provider->auth_file() == _auth_file) {
+            return provider->reload();
+        }
+
+        irods::error ret = credential_provider::make(_auth_file, get_resource_name(_prop_map), provider);
+        if (!ret.ok()) {
+            return PASS(ret);
+        }
+
+        return _prop_map.set<std::shared_ptr<credential_provider>>(CREDENTIAL_PROVIDER_KW, provider);
+    }
+
+    irods::error get_credential_provider(irods::plugin_property_map& _prop_map,
+                                         std::shared_ptr<credential_provider>& _provider)
+    {
+        irods::error ret = _prop_map.get<std::shared_ptr<credential_provider>>(CREDENTIAL_PROVIDER_KW, _provider);
+        if (ret.ok() && !_provider) {
+            return ERROR(SYS_INTERNAL_NULL_INPUT_ERR, fmt::format(
+                         "[resource_name={}] The S3 credential provider is null.",
+                         get_resource_name(_prop_map)));
+        }
+        return ret;
+    }
+
+} // namespace irods_s3
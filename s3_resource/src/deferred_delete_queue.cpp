@@ -0,0 +1,577 @@
+// =-=-=-=-=-=-=-
+// local includes
+#include "irods/private/s3_resource/deferred_delete_queue.hpp"
+#include "irods/private/s3_resource/s3_resource.hpp"
+#include "irods/private/s3_resource/s3_plugin_logging_category.hpp"
+
+// =-=-=-=-=-=-=-
+// irods includes
+#include <irods/rodsErrorTable.h>
+
+// =-=-=-=-=-=-=-
+// other includes
+#include <fmt/format.h>
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace irods_s3
+{
+    namespace
+    {
+        namespace fs = std::filesystem;
+        using logger = irods::experimental::log::logger<s3_plugin_logging_category>;
+
+        // The backlog is counted on the first enqueue in an agent and then every this many enqueues.
+        constexpr std::size_t BACKLOG_CHECK_INTERVAL{256};
+
+        // How long the worker waits for more deletes to batch with the ones already queued, and
+        // for new deletes once the journal is empty before it exits.
+        constexpr std::chrono::milliseconds LINGER_TIME{1000};
+
+        // How long a worker that is asked to stop keeps sending queued deletes before it leaves
+        // the rest for the next agent.  A batch already being sent is not interrupted.
+        constexpr std::chrono::seconds STOP_DRAIN_TIME{5};
+
+        // How often cancel_deferred_delete checks whether a delete in progress has finished.
+        constexpr std::chrono::milliseconds CANCEL_POLL_INTERVAL{50};
+
+        struct journal_paths
+        {
+            explicit journal_paths(irods::plugin_property_map& _prop_map)
+                : root{get_cache_directory(_prop_map) + "/deferred_delete"}
+                , pending{root / "pending"}
+                , draining{root / "draining"}
+                , incoming{root / "incoming"}
+                , claimed{draining / std::to_string(getpid())}
+            {}
+
+            fs::path root;
+            fs::path pending;
+            fs::path draining;
+            fs::path incoming;
+            fs::path claimed;     // draining/ directory of this agent
+        };
+
+        // Held while entries move between pending/ and draining/ so that cancel_deferred_delete
+        // always finds an entry in one or the other.
+        class journal_lock
+        {
+          public:
+            explicit journal_lock(const journal_paths& _journal)
+                : fd_{open((_journal.root / "lock").c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0600)}
+            {
+                if (fd_ >= 0) {
+                    while (flock(fd_, LOCK_EX) < 0 && EINTR == errno) {}
+                }
+            }
+
+            ~journal_lock()
+            {
+                if (fd_ >= 0) {
+                    close(fd_);
+                }
+            }
+
+            journal_lock(const journal_lock&) = delete;
+            journal_lock& operator=(const journal_lock&) = delete;
+
+          private:
+            int fd_;
+        }; // class journal_lock
+
+        struct worker
+        {
+            std::thread thread;
+            bool running{false};
+            bool stop_requested{false};
+            bool over_limit{false};
+        };
+
+        // workers of this agent by resource name
+        std::mutex workers_mutex;
+        std::condition_variable workers_cv;
+        std::map<std::string, worker> workers;
+
+        std::atomic<std::size_t> enqueue_count{0};
+
+        std::string entry_name(const std::string& _physical_path)
+        {
+            unsigned char digest[EVP_MAX_MD_SIZE];
+            unsigned int digest_length = 0;
+            EVP_Digest(_physical_path.data(), _physical_path.size(), digest, &digest_length, EVP_sha256(), nullptr);
+
+            std::string name;
+            name.reserve(2 * digest_length);
+            for (unsigned int i = 0; i < digest_length; ++i) {
+                name += fmt::format("{:02x}", digest[i]);
+            }
+            return name;
+        }
+
+        bool process_is_alive(pid_t _pid)
+        {
+            return 0 == kill(_pid, 0) || EPERM == errno;
+        }
+
+        // returns the pid a draining/ or incoming/ name starts with, 0 if there is none
+        pid_t pid_of(const std::string& _name)
+        {
+            pid_t pid = 0;
+            for (char c : _name) {
+                if (c < '0' || c > '9') {
+                    break;
+                }
+                pid = pid * 10 + (c - '0');
+            }
+            return pid;
+        }
+
+        // the names in a directory, skipping anything that cannot be an entry
+        std::vector<std::string> list_directory(const fs::path& _directory, std::size_t _limit = SIZE_MAX)
+        {
+            std::vector<std::string> names;
+            std::error_code ec;
+            for (auto it = fs::directory_iterator(_directory, ec);
+                    !ec && it != fs::directory_iterator() && names.size() < _limit; it.increment(ec)) {
+                auto name = it->path().filename().string();
+                if (!name.empty() && '.' != name[0]) {
+                    names.push_back(std::move(name));
+                }
+            }
+            return names;
+        }
+
+        void sync_directory(const fs::path& _directory)
+        {
+            const int fd = open(_directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd >= 0) {
+                fsync(fd);
+                close(fd);
+            }
+        }
+
+        // Writes the entry to incoming/ and moves it into pending/ once it is on disk, so that a
+        // partially written entry is never seen.
+        bool write_entry(const journal_paths& _journal, const std::string& _name, const std::string& _physical_path)
+        {
+            std::error_code ec;
+            fs::create_directories(_journal.pending, ec);
+            fs::create_directories(_journal.incoming, ec);
+
+            const auto temporary = _journal.incoming / fmt::format("{}-{}", getpid(), _name);
+
+            const int fd = open(temporary.c_str(), O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC, 0600);
+            if (fd < 0) {
+                return false;
+            }
+
+            bool written = true;
+            for (std::size_t offset = 0; written && offset < _physical_path.size(); ) {
+                const ssize_t n = write(fd, _physical_path.data() + offset, _physical_path.size() - offset);
+                if (n > 0) {
+                    offset += n;
+                }
+                else if (n < 0 && EINTR != errno) {
+                    written = false;
+                }
+            }
+            written = written && 0 == fsync(fd);
+            close(fd);
+
+            if (!written || rename(temporary.c_str(), (_journal.pending / _name).c_str()) < 0) {
+                unlink(temporary.c_str());
+                return false;
+            }
+
+            sync_directory(_journal.pending);
+            return true;
+        }
+
+        // returns the physical path held by the entry if it matches the name of the entry
+        std::optional<std::string> read_entry(const fs::path& _entry)
+        {
+            const int fd = open(_entry.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return std::nullopt;
+            }
+
+            std::string physical_path;
+            char buffer[MAX_NAME_LEN];
+            ssize_t n;
+            while ((n = read(fd, buffer, sizeof(buffer))) != 0 && physical_path.size() <= MAX_NAME_LEN) {
+                if (n > 0) {
+                    physical_path.append(buffer, n);
+                }
+                else if (EINTR != errno) {
+                    break;
+                }
+            }
+            close(fd);
+
+            if (entry_name(physical_path) != _entry.filename().string()) {
+                return std::nullopt;
+            }
+            return physical_path;
+        }
+
+        bool has_pending_entries(const journal_paths& _journal)
+        {
+            return !list_directory(_journal.pending, 1).empty();
+        }
+
+        // Returns the entries claimed by agents that are no longer running to pending/ and removes
+        // entries those agents did not finish writing.
+        void recover_abandoned_entries(const journal_paths& _journal)
+        {
+            journal_lock lock{_journal};
+
+            for (const auto& directory : list_directory(_journal.draining)) {
+                const pid_t pid = pid_of(directory);
+                if (0 == pid || process_is_alive(pid)) {
+                    continue;
+                }
+                const auto path = _journal.draining / directory;
+                for (const auto& name : list_directory(path)) {
+                    rename((path / name).c_str(), (_journal.pending / name).c_str());
+                }
+                std::error_code ec;
+                fs::remove(path, ec);
+            }
+
+            for (const auto& name : list_directory(_journal.incoming)) {
+                const pid_t pid = pid_of(name);
+                if (0 != pid && !process_is_alive(pid)) {
+                    unlink((_journal.incoming / name).c_str());
+                }
+            }
+        }
+
+        // Moves up to _count entries from pending/ to the draining/ directory of this agent and
+        // returns their names and physical paths.
+        std::vector<std::pair<std::string, std::string>> claim_entries(
+            const journal_paths& _journal,
+            const std::string& _resource_name,
+            std::size_t _count)
+        {
+            std::error_code ec;
+            fs::create_directories(_journal.claimed, ec);
+
+            std::vector<std::string> names;
+            {
+                journal_lock lock{_journal};
+                for (auto& name : list_directory(_journal.pending, _count)) {
+                    if (0 == rename((_journal.pending / name).c_str(), (_journal.claimed / name).c_str())) {
+                        names.push_back(std::move(name));
+                    }
+                }
+            }
+
+            std::vector<std::pair<std::string, std::string>> entries;
+            entries.reserve(names.size());
+            for (auto& name : names) {
+                auto physical_path = read_entry(_journal.claimed / name);
+                if (!physical_path) {
+                    logger::error("[resource_name={}] Discarding invalid deferred delete entry \"{}\".",
+                            _resource_name, (_journal.claimed / name).string());
+                    unlink((_journal.claimed / name).c_str());
+                    continue;
+                }
+                entries.emplace_back(std::move(name), std::move(*physical_path));
+            }
+            return entries;
+        }
+
+        void release_entries(const journal_paths& _journal, const std::vector<std::string>& _names)
+        {
+            journal_lock lock{_journal};
+            for (const auto& name : _names) {
+                rename((_journal.claimed / name).c_str(), (_journal.pending / name).c_str());
+            }
+        }
+
+        // Waits for the time given or until the worker is asked to stop.  Returns true if it was.
+        bool wait_for_stop(const std::string& _resource_name, std::chrono::milliseconds _time)
+        {
+            std::unique_lock lock{workers_mutex};
+            return workers_cv.wait_for(lock, _time, [&_resource_name] {
+                return workers[_resource_name].stop_requested;
+            });
+        }
+
+        void drain(irods::plugin_property_map _prop_map)
+        {
+            const auto resource_name = get_resource_name(_prop_map);
+            const journal_paths journal{_prop_map};
+
+            const std::size_t initial_retry_wait = std::max<std::size_t>(get_retry_wait_time_sec(_prop_map), 1);
+            const std::size_t max_retry_wait = std::max(get_max_retry_wait_time_sec(_prop_map), initial_retry_wait);
+            std::size_t retry_wait = initial_retry_wait;
+
+            recover_abandoned_entries(journal);
+
+            // let the deletes that usually follow the first one be sent with it, unless the agent
+            // is already exiting
+            bool stop = wait_for_stop(resource_name, LINGER_TIME);
+            std::optional<std::chrono::steady_clock::time_point> stop_deadline;
+
+            while (true) {
+                // the deletes of an agent that exits are sent before it does, as long as that
+                // does not hold up the exit for long
+                stop = stop || wait_for_stop(resource_name, std::chrono::milliseconds{0});
+                if (stop && !stop_deadline) {
+                    stop_deadline = std::chrono::steady_clock::now() + STOP_DRAIN_TIME;
+                }
+                if (stop_deadline && std::chrono::steady_clock::now() >= *stop_deadline) {
+                    break;
+                }
+
+                const auto entries = claim_entries(journal, resource_name, S3_MAX_DELETE_OBJECTS_COUNT);
+
+                if (entries.empty()) {
+                    if (stop || wait_for_stop(resource_name, LINGER_TIME)) {
+                        break;
+                    }
+
+                    recover_abandoned_entries(journal);
+
+                    // decided under the lock so that an enqueue either sees this worker running
+                    // or starts a new one
+                    std::lock_guard lock{workers_mutex};
+                    if (!has_pending_entries(journal)) {
+                        workers[resource_name].running = false;
+                        return;
+                    }
+                    continue;
+                }
+
+                std::vector<std::string> files;
+                std::map<std::string, std::string> name_by_file;
+                files.reserve(entries.size());
+                for (const auto& [name, physical_path] : entries) {
+                    files.push_back(physical_path);
+                    name_by_file.emplace(physical_path, name);
+                }
+
+                std::vector<std::string> retry;
+                std::set<std::string> failed_names;
+                std::vector<std::pair<std::string, S3Status>> failed;
+                irods::error ret = s3_delete_objects(_prop_map, files, failed);
+                if (!ret.ok()) {
+                    logger::error("[resource_name={}] Failed to delete {} queued objects, they will be retried.  {}",
+                            resource_name, entries.size(), ret.result());
+                    for (const auto& [name, physical_path] : entries) {
+                        retry.push_back(name);
+                        failed_names.insert(name);
+                    }
+                }
+                else {
+                    for (const auto& [file, status] : failed) {
+                        const auto name = name_by_file.find(file);
+                        if (name == name_by_file.end()) {
+                            continue;
+                        }
+                        if (S3_status_is_retryable(status)) {
+                            retry.push_back(name->second);
+                            failed_names.insert(name->second);
+                        }
+                        else {
+                            logger::error("[resource_name={}] Giving up on deleting \"{}\" - \"{}\".",
+                                    resource_name, file, S3_get_status_name(status));
+                        }
+                    }
+                }
+
+                for (const auto& [name, physical_path] : entries) {
+                    if (0 == failed_names.count(name)) {
+                        unlink((journal.claimed / name).c_str());
+                    }
+                }
+
+                if (retry.empty()) {
+                    retry_wait = initial_retry_wait;
+                    continue;
+                }
+
+                release_entries(journal, retry);
+
+                // the failed deletes are left for the next agent
+                if (stop) {
+                    break;
+                }
+
+                stop = wait_for_stop(resource_name, std::chrono::seconds(retry_wait));
+                retry_wait = std::min(retry_wait * 2, max_retry_wait);
+            }
+
+            std::lock_guard lock{workers_mutex};
+            workers[resource_name].running = false;
+        } // drain
+
+        // workers_mutex must be held
+        void start_worker(const std::string& _resource_name, irods::plugin_property_map& _prop_map)
+        {
+            auto& w = workers[_resource_name];
+            if (w.running) {
+                return;
+            }
+
+            // a worker that has exited on its own
+            if (w.thread.joinable()) {
+                w.thread.join();
+            }
+
+            w.running = true;
+            w.stop_requested = false;
+            w.thread = std::thread{drain, _prop_map};
+        }
+
+    } // namespace
+
+    bool enqueue_deferred_delete(irods::plugin_property_map& _prop_map, const std::string& _physical_path)
+    {
+        const auto resource_name = get_resource_name(_prop_map);
+        const journal_paths journal{_prop_map};
+
+        if (0 == enqueue_count++ % BACKLOG_CHECK_INTERVAL) {
+            const std::size_t limit = s3_get_deferred_delete_queue_limit(_prop_map);
+            const bool over_limit = list_directory(journal.pending, limit).size() >= limit;
+
+            std::lock_guard lock{workers_mutex};
+            auto& w = workers[resource_name];
+            if (over_limit && !w.over_limit) {
+                logger::warn("[resource_name={}] More than {} deletes are queued, deleting objects synchronously.",
+                        resource_name, limit);
+            }
+            w.over_limit = over_limit;
+        }
+
+        {
+            std::lock_guard lock{workers_mutex};
+            if (workers[resource_name].over_limit) {
+                start_worker(resource_name, _prop_map);
+                return false;
+            }
+        }
+
+        if (!write_entry(journal, entry_name(_physical_path), _physical_path)) {
+            logger::warn("[resource_name={}] Failed to queue the delete of \"{}\" in \"{}\", deleting it now.",
+                    resource_name, _physical_path, journal.pending.string());
+            return false;
+        }
+
+        // the entry is written first so that a worker that is about to exit either sees it or
+        // has already marked itself as stopped
+        std::lock_guard lock{workers_mutex};
+        start_worker(resource_name, _prop_map);
+        return true;
+    } // enqueue_deferred_delete
+
+    irods::error cancel_deferred_delete(irods::plugin_property_map& _prop_map, const std::string& _physical_path)
+    {
+        const journal_paths journal{_prop_map};
+
+        // deferred deletes have never been used on this server
+        std::error_code ec;
+        if (!fs::exists(journal.pending, ec)) {
+            return SUCCESS();
+        }
+
+        const auto name = entry_name(_physical_path);
+
+        // The entry stays claimed until the whole batch holding it has been sent, so wait for as
+        // long as s3_delete_objects can take for one batch: every attempt timing out and the
+        // longest backoff between each of them.
+        const std::size_t retry_count = get_retry_count(_prop_map);
+        const auto batch_time = std::chrono::seconds(
+                get_non_data_transfer_timeout_seconds(_prop_map) * (retry_count + 1) +
+                get_max_retry_wait_time_sec(_prop_map) * retry_count);
+        const auto deadline = std::chrono::steady_clock::now() + batch_time;
+
+        while (true) {
+            pid_t owner = 0;
+            {
+                journal_lock lock{journal};
+                unlink((journal.pending / name).c_str());
+
+                for (const auto& directory : list_directory(journal.draining)) {
+                    const auto entry = journal.draining / directory / name;
+                    if (!fs::exists(entry, ec)) {
+                        continue;
+                    }
+                    if (process_is_alive(pid_of(directory))) {
+                        owner = pid_of(directory);
+                    }
+                    else {
+                        unlink(entry.c_str());
+                    }
+                }
+            }
+
+            if (0 == owner) {
+                return SUCCESS();
+            }
+
+            // Writing now would race the delete and could lose the new object.
+            if (std::chrono::steady_clock::now() > deadline) {
+                return ERROR(S3_PUT_ERROR, fmt::format(
+                             "[resource_name={}] The queued delete of \"{}\" is still being sent by process {} "
+                             "after {} seconds.  Refusing to write the object until it completes.",
+                             get_resource_name(_prop_map), _physical_path, owner, batch_time.count()));
+            }
+
+            std::this_thread::sleep_for(CANCEL_POLL_INTERVAL);
+        }
+    } // cancel_deferred_delete
+
+    void start_deferred_delete_worker(irods::plugin_property_map& _prop_map)
+    {
+        const journal_paths journal{_prop_map};
+
+        if (!has_pending_entries(journal) && list_directory(journal.draining, 1).empty()) {
+            return;
+        }
+
+        std::lock_guard lock{workers_mutex};
+        start_worker(get_resource_name(_prop_map), _prop_map);
+    } // start_deferred_delete_worker
+
+    void stop_deferred_delete_worker(irods::plugin_property_map& _prop_map)
+    {
+        std::thread thread;
+        {
+            std::lock_guard lock{workers_mutex};
+            const auto w = workers.find(get_resource_name(_prop_map));
+            if (w == workers.end()) {
+                return;
+            }
+            w->second.stop_requested = true;
+            thread = std::move(w->second.thread);
+        }
+
+        workers_cv.notify_all();
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+    } // stop_deferred_delete_worker
+
+} // namespace irods_s3
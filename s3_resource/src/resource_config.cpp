@@ -0,0 +1,118 @@
+// =-=-=-=-=-=-=-
+// local includes
+#include "irods/private/s3_resource/resource_config.hpp"
+#include "irods/private/s3_resource/s3_resource.hpp"
+
+// =-=-=-=-=-=-=-
+// other includes
+#include <mutex>
+#include <utility>
+
+namespace irods_s3
+{
+    namespace
+    {
+        // the property holding the snapshot
+        const std::string RESOURCE_CONFIG_KW{"S3_RESOURCE_CONFIG"};
+
+        // the property map is not safe to use from more than one thread
+        std::mutex resource_config_mutex;
+
+        std::vector<std::string> read_hostnames(irods::plugin_property_map& _prop_map)
+        {
+            std::vector<std::string> hostname_vector;
+            _prop_map.get<std::vector<std::string>>(s3_default_hostname_vector, hostname_vector);
+            return hostname_vector;
+        }
+
+        // s3Init() picks a random first host so agents do not all start with the same one
+        std::size_t read_hostname_index(irods::plugin_property_map& _prop_map)
+        {
+            std::size_t hostname_index = 0;
+            _prop_map.get<std::size_t>(s3_hostname_index, hostname_index);
+            return hostname_index;
+        }
+    } // namespace
+
+    resource_config::resource_config(irods::plugin_property_map& _prop_map,
+                                     std::shared_ptr<credential_provider> _credentials)
+        : resource_name{get_resource_name(_prop_map)}
+        , region_name{get_region_name(_prop_map)}
+        , protocol{s3GetProto(_prop_map)}
+        , sts_date{s3GetSTSDate(_prop_map)}
+        , uri_style{s3_get_uri_request_style(_prop_map)}
+        , retry_count_limit{get_retry_count(_prop_map)}
+        , retry_wait{get_retry_wait_time_sec(_prop_map)}
+        , max_retry_wait{get_max_retry_wait_time_sec(_prop_map)}
+        , mpu_chunk_size{s3GetMPUChunksize(_prop_map)}
+        , non_data_transfer_timeout_seconds{get_non_data_transfer_timeout_seconds(_prop_map)}
+        , hostnames{read_hostnames(_prop_map)}
+        , credentials_{std::move(_credentials)}
+        , bucket_context_templates_{}
+        , host_counter_{read_hostname_index(_prop_map)}
+    {
+        S3BucketContext bucket_context{};
+        bucket_context.protocol = protocol;
+        bucket_context.stsDate = sts_date;
+        bucket_context.uriStyle = uri_style;
+        bucket_context.authRegion = region_name.c_str();
+
+        for (const auto& hostname : hostnames) {
+            bucket_context.hostName = hostname.c_str();
+            bucket_context_templates_.push_back(bucket_context);
+        }
+
+        // no hosts, libs3 uses the default host
+        if (bucket_context_templates_.empty()) {
+            bucket_context.hostName = "";
+            bucket_context_templates_.push_back(bucket_context);
+        }
+    }
+
+    std::size_t resource_config::next_host_index() const
+    {
+        return host_counter_.fetch_add(1, std::memory_order_relaxed) % bucket_context_templates_.size();
+    }
+
+    S3BucketContext resource_config::bucket_context(const std::string& _bucket) const
+    {
+        const s3_credentials& keys = credentials();
+
+        S3BucketContext bucket_context = bucket_context_templates_[next_host_index()];
+        bucket_context.bucketName = _bucket.c_str();
+        bucket_context.accessKeyId = keys.key_id.c_str();
+        bucket_context.secretAccessKey = keys.access_key.c_str();
+        return bucket_context;
+    }
+
+    const std::string& resource_config::next_hostname() const
+    {
+        static const std::string no_hostname;
+        if (hostnames.empty()) {
+            return no_hostname;
+        }
+        return hostnames[next_host_index()];
+    }
+
+    irods::error get_resource_config(irods::plugin_property_map& _prop_map,
+                                     std::shared_ptr<const resource_config>& _config)
+    {
+        std::lock_guard<std::mutex> lock(resource_config_mutex);
+
+        if (_prop_map.get<std::shared_ptr<const resource_config>>(RESOURCE_CONFIG_KW, _config).ok() && _config) {
+            return SUCCESS();
+        }
+
+        // not started yet, only keep a snapshot that has the credentials
+        std::shared_ptr<credential_provider> credentials;
+        irods::error ret = get_credential_provider(_prop_map, credentials);
+        if (!ret.ok()) {
+            return PASS(ret);
+        }
+
+        _config = std::make_shared<const resource_config>(_prop_map, std::move(credentials));
+        _prop_map.set<std::shared_ptr<const resource_config>>(RESOURCE_CONFIG_KW, _config);
+        return SUCCESS();
+    }
+
+} // namespace irods_s3
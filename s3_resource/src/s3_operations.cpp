@@ -6,6 +6,10 @@
 #include "irods/private/s3_transport/managed_shared_memory_object.hpp"
 #include "irods/private/s3_resource/s3_plugin_logging_category.hpp"
 #include "irods/private/s3_resource/multipart_shared_data.hpp"
+#include "irods/private/s3_resource/upload_checksum_cache_data.hpp"
+#include "irods/private/s3_resource/object_metadata_cache_data.hpp"
+#include "irods/private/s3_resource/deferred_delete_queue.hpp"
+#include "irods/private/s3_resource/resource_config.hpp"
 
 // =-=-=-=-=-=-=-
 // irods includes
@@ -54,6 +58,12 @@
 #include <cstdlib>
 #include <list>
 #include <map>
+#include <algorithm>
+#include <future>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <limits>
 #include <assert.h>
 #include <curl/curl.h>
 #include <fmt/format.h>
@@ -81,6 +91,18 @@ namespace irods_s3 {
     // no way of knowing the size for these.  It is stated that 100*sizeof(void*) would
     // be enough.
     inline static constexpr std::int64_t SHMEM_SIZE{100*sizeof(void*) + sizeof(multipart_shared_data)};
+
+    // Shared memory for the checksums computed while uploading.  This is kept when no agent
+    // is using it and is rebuilt if it has not been accessed for a day.
+    inline static const std::string UPLOAD_CHECKSUM_CACHE_KEY_PREFIX{"irods_s3-checksum-cache-"};
+    inline static constexpr int     UPLOAD_CHECKSUM_CACHE_TIMEOUT_IN_SECONDS{24*60*60};
+    inline static constexpr std::int64_t UPLOAD_CHECKSUM_CACHE_SHMEM_SIZE{100*sizeof(void*) + sizeof(upload_checksum_cache_data)};
+
+    // Shared memory for the results of HEAD requests.  This is kept when no agent is using it
+    // and is rebuilt if it has not been accessed for a day.
+    inline static const std::string OBJECT_METADATA_CACHE_KEY_PREFIX{"irods_s3-metadata-cache-"};
+    inline static constexpr int     OBJECT_METADATA_CACHE_TIMEOUT_IN_SECONDS{24*60*60};
+    inline static constexpr std::int64_t OBJECT_METADATA_CACHE_SHMEM_SIZE{100*sizeof(void*) + sizeof(object_metadata_cache_data)};
     namespace log  = irods::experimental::log;
     using logger = log::logger<s3_plugin_logging_category>;
 
@@ -89,62 +111,246 @@ namespace irods_s3 {
     int number_of_threads = 0;
     int oprType = -1;
 
+    // What the L1 descriptor table says about the operation on an object.  The table is
+    // searched when the object is opened and the result is kept with the fd.
+    struct l1_descriptor_info {
+        bool found = false;
+        int opr_type = -1;
+        int requested_number_of_threads = 0;
+        std::int64_t data_size = s3_transport_config::UNKNOWN_OBJECT_SIZE;
+
+        // for a replication to this resource, from the REPLICATE_SRC and REPLICATE_DEST entries
+        bool found_replication_source = false;
+        std::int64_t replication_source_data_size = s3_transport_config::UNKNOWN_OBJECT_SIZE;
+        bool found_replication_destination = false;
+        int replication_destination_number_of_threads = 0;
+    }; // end l1_descriptor_info
+
     // data per thread
     struct per_thread_data {
         std::ios_base::openmode open_mode;
         std::shared_ptr<dstream> dstream_ptr;
         std::shared_ptr<s3_transport> s3_transport_ptr;
+        l1_descriptor_info l1_info;
     }; // end per_thread_data
 
+    // The data of the open fds, in a fixed array of slots indexed by fd.  An fd is used by the
+    // thread that opened it (the stat for issue 2153 is the exception) so that thread finds its
+    // slot without a lock and uses the data in place.  The slot lock is taken to change which
+    // dstream an fd has, to remove the fd, and by other threads to copy the data.
     class fd_to_data_map {
 
         public:
 
-            fd_to_data_map() : fd_counter{3} {
+            // more than the L1 descriptors an agent can have open
+            static constexpr int NUMBER_OF_SLOTS{2048};
+
+            fd_to_data_map() : fd_counter{3}, slots{} {
             }
 
             fd_to_data_map(const fd_to_data_map& src) = delete;
             fd_to_data_map& operator=(fd_to_data_map& src) = delete;
 
-            per_thread_data get(int fd) {
+            // Stores the data under a new fd and returns the fd, or -1 if every slot is in use.
+            int add(const per_thread_data& data) {
+                for (int i = 0; i < NUMBER_OF_SLOTS; ++i) {
+                    const int fd = fd_counter.fetch_add(1, std::memory_order_relaxed) & std::numeric_limits<int>::max();
+                    if (claim(fd, data)) {
+                        return fd;
+                    }
+                }
+                return -1;
+            }
+
+            // Stores the data under fd.  Fails if another fd is using the slot.
+            bool add(int fd, const per_thread_data& data) {
+                return fd >= 0 && claim(fd, data);
+            }
 
-                std::lock_guard lock(fd_to_data_map_mutex);
-                assert(data_map.find(fd) != data_map.end());
-                return data_map[fd];
+            // Returns the data of an fd opened by this thread.  The reference is valid until the
+            // fd is removed.
+            per_thread_data& get(int fd) {
+                slot& s = slot_for(fd);
+                assert(s.fd.load(std::memory_order_acquire) == fd);
+                return s.data;
+            }
+
+            // Copies the data of an fd that may be in use by another thread.  Returns false if
+            // the fd is not open.
+            bool copy(int fd, per_thread_data& data) {
+                if (fd < 0) {
+                    return false;
+                }
+                slot& s = slot_for(fd);
+                std::lock_guard lock(s.mutex);
+                if (s.fd.load(std::memory_order_relaxed) != fd) {
+                    return false;
+                }
+                data = s.data;
+                return true;
             }
 
-            void set(int fd, const per_thread_data data) {
-                std::lock_guard lock(fd_to_data_map_mutex);
-                data_map[fd] = data;
+            void set_dstream(int fd,
+                             std::ios_base::openmode open_mode,
+                             std::shared_ptr<dstream> dstream_ptr,
+                             std::shared_ptr<s3_transport> s3_transport_ptr) {
+                slot& s = slot_for(fd);
+                std::lock_guard lock(s.mutex);
+                assert(s.fd.load(std::memory_order_relaxed) == fd);
+                s.data.open_mode = open_mode;
+                s.data.dstream_ptr = std::move(dstream_ptr);
+                s.data.s3_transport_ptr = std::move(s3_transport_ptr);
             }
 
             void remove(int fd) {
-                std::lock_guard lock(fd_to_data_map_mutex);
-                if (data_map.find(fd) == data_map.end()) {
+                if (!exists(fd)) {
 					logger::info("{}:{} ({}) fd is not in table", __FILE__, __LINE__, __FUNCTION__);
-                } else {
-                    data_map.erase(fd);
+                    return;
                 }
+                slot& s = slot_for(fd);
+                std::lock_guard lock(s.mutex);
+                s.data = per_thread_data{};
+                s.fd.store(FREE, std::memory_order_release);
             }
 
             bool exists(int fd) {
-                std::lock_guard lock(fd_to_data_map_mutex);
-                return data_map.find(fd) != data_map.end();
+                return fd >= 0 && slot_for(fd).fd.load(std::memory_order_acquire) == fd;
             }
 
-            int get_and_increment_fd_counter() {
-                return fd_counter++;
+        private:
+
+            static constexpr int FREE{-1};
+            static constexpr int CLAIMED{-2};
+
+            struct slot {
+                std::atomic<int> fd{FREE};
+                std::mutex       mutex;
+                per_thread_data  data{};
+            };
+
+            slot& slot_for(int fd) {
+                return slots[fd % NUMBER_OF_SLOTS];
             }
 
-        private:
+            // the data is written before the fd so a thread that finds the fd sees the data
+            bool claim(int fd, const per_thread_data& data) {
+                slot& s = slot_for(fd);
+                int expected = FREE;
+                if (!s.fd.compare_exchange_strong(expected, CLAIMED, std::memory_order_acquire)) {
+                    return false;
+                }
+                s.data = data;
+                s.fd.store(fd, std::memory_order_release);
+                return true;
+            }
 
-            std::mutex fd_to_data_map_mutex;
-            std::map<int, per_thread_data> data_map;
-            int fd_counter;
+            std::atomic<int> fd_counter;
+            std::array<slot, NUMBER_OF_SLOTS> slots;
     }; // end class fd_to_data_map
 
     fd_to_data_map fd_data;
 
+    // Searches the L1 descriptor table for the entries of the object.  On a replication from an
+    // s3 src within a replication node, there are two entries for the replica - one for PUT and
+    // one for REPL_DEST.  During the initial PUT there is only one entry.  To see if we are doing
+    // the PUT or REPL, look for the last entry on the list.
+    l1_descriptor_info find_l1_descriptor_info(const irods::file_object_ptr& _file_obj)
+    {
+        using logger_config = irods::experimental::log::logger_config<s3_plugin_logging_category>;
+        std::uint64_t thread_id = std::hash<std::thread::id>{}(std::this_thread::get_id());
+
+        // ********* DEBUG - print L1desc for all
+        if (logger_config::get_level() == log::level::debug ||  logger_config::get_level() == log::level::trace) {
+
+            logger::debug("{}:{} ({}) [[{}]] ------------- L1desc ---------------",
+                    __FILE__, __LINE__, __FUNCTION__, thread_id);
+            for (int i = 0; i < NUM_L1_DESC; ++i) {
+                if (L1desc[i].inuseFlag && L1desc[i].dataObjInp && L1desc[i].dataObjInfo) {
+                   int thread_count = L1desc[i].dataObjInp->numThreads;
+                   int oprType = L1desc[i].dataObjInp->oprType;
+                   std::int64_t data_size = L1desc[i].dataSize;
+                   logger::debug("{}:{} ({}) [[{}]] [{}][objPath={}][filePath={}][oprType={}]"
+                           "[requested_number_of_threads={}][dataSize={}][dataObjInfo->dataSize={}][srcL1descInx={}]",
+                           __FILE__, __LINE__, __FUNCTION__, thread_id, i, L1desc[i].dataObjInp->objPath,
+                           L1desc[i].dataObjInfo->filePath, oprType, thread_count, data_size,
+                           L1desc[i].dataObjInfo->dataSize, L1desc[i].srcL1descInx);
+                }
+            }
+            logger::debug("{}:{} ({}) [[{}]] ------------------------------------",
+                    __FILE__, __LINE__, __FUNCTION__, thread_id);
+        }
+        // ********* END DEBUG - print L1desc for all
+
+        const std::string& logical_path = _file_obj->logical_path();
+        const std::string& physical_path = _file_obj->physical_path();
+
+        l1_descriptor_info info;
+        for (int i = 0; i < NUM_L1_DESC; ++i) {
+            if (L1desc[i].inuseFlag) {
+                if (L1desc[i].dataObjInp && L1desc[i].dataObjInfo &&
+                        L1desc[i].dataObjInp->objPath == logical_path
+                        && L1desc[i].dataObjInfo->filePath == physical_path) {
+
+                    info.found = true;
+                    info.requested_number_of_threads = L1desc[i].dataObjInp->numThreads;
+                    info.opr_type = L1desc[i].dataObjInp->oprType;
+                    info.data_size = L1desc[i].dataSize;
+                }
+            } else if (info.found) {
+                break;
+            }
+        }
+
+        // special treatment for replication
+        // 1) data_size is only available from the REPLICATE_SRC entry.
+        // 2) number_of_threads is available in REPLICATE_DEST entry.
+        // When the object is not in the table the caller may still learn it is a replication.
+        if (!info.found || info.opr_type == REPLICATE_DEST) {
+            for (int i = 0; i < NUM_L1_DESC; ++i) {
+                const auto& l1d = L1desc[i];
+                const auto* dobj_input = l1d.dataObjInp;
+                const auto* dobj_info = l1d.dataObjInfo;
+
+                if (!l1d.inuseFlag || !dobj_input || dobj_input->objPath != logical_path) {
+                    continue;
+                }
+
+                // get the data size from source dataObjInfo
+                if (!info.found_replication_source && dobj_info && dobj_input->oprType == REPLICATE_SRC) {
+                    info.replication_source_data_size = dobj_info->dataSize;
+                    info.found_replication_source = true;
+                }
+
+                // get the number_of_threads from destination dataObjInp
+                if (!info.found_replication_destination && dobj_input->oprType == REPLICATE_DEST) {
+                    info.replication_destination_number_of_threads = dobj_input->numThreads;
+                    info.found_replication_destination = true;
+                }
+
+                // once we have both pieces of information break out of for loop
+                if (info.found_replication_source && info.found_replication_destination) {
+                    break;
+                }
+            }
+        }
+
+        return info;
+    }
+
+    // Returns what the L1 descriptor table said about the object when it was opened, or
+    // searches the table if the object was not in it then.
+    l1_descriptor_info get_l1_descriptor_info(const irods::file_object_ptr& _file_obj)
+    {
+        const int fd = _file_obj->file_descriptor();
+        if (fd_data.exists(fd)) {
+            l1_descriptor_info info = fd_data.get(fd).l1_info;
+            if (info.found) {
+                return info;
+            }
+        }
+        return find_l1_descriptor_info(_file_obj);
+    }
+
     bool operation_requires_that_object_exists(std::ios_base::openmode open_mode, int oprType) {
 
         using std::ios_base;
@@ -181,6 +387,186 @@ namespace irods_s3 {
     irods::error s3_file_stat_operation_with_flag_for_retry_on_not_found(irods::plugin_context& _ctx,
             struct stat* _statbuf, bool retry_on_not_found );
 
+    // Saves the checksum computed while uploading the object at _physical_path.  An
+    // empty _checksum forgets any checksum previously saved for it.
+    void cache_upload_checksum(irods::plugin_property_map& _prop_map,
+                               const std::string& _physical_path,
+                               const std::string& _scheme,
+                               const std::string& _checksum)
+    {
+        using named_shared_memory_object =
+            irods::experimental::interprocess::shared_memory::named_shared_memory_object
+            <upload_checksum_cache_data>;
+
+        std::string shmem_key = UPLOAD_CHECKSUM_CACHE_KEY_PREFIX +
+            std::to_string(std::hash<std::string>{}(get_resource_name(_prop_map)));
+
+        named_shared_memory_object shm_obj{shmem_key,
+            UPLOAD_CHECKSUM_CACHE_TIMEOUT_IN_SECONDS,
+            UPLOAD_CHECKSUM_CACHE_SHMEM_SIZE};
+
+        shm_obj.atomic_exec([&_physical_path, &_scheme, &_checksum](auto& data) {
+            data.store(_physical_path, _scheme, _checksum);
+        });
+    }
+
+    bool find_cached_upload_checksum(irods::plugin_property_map& _prop_map,
+                                     const std::string& _physical_path,
+                                     const std::string& _scheme,
+                                     std::string& _checksum)
+    {
+        using named_shared_memory_object =
+            irods::experimental::interprocess::shared_memory::named_shared_memory_object
+            <upload_checksum_cache_data>;
+
+        std::string shmem_key = UPLOAD_CHECKSUM_CACHE_KEY_PREFIX +
+            std::to_string(std::hash<std::string>{}(get_resource_name(_prop_map)));
+
+        named_shared_memory_object shm_obj{shmem_key,
+            UPLOAD_CHECKSUM_CACHE_TIMEOUT_IN_SECONDS,
+            UPLOAD_CHECKSUM_CACHE_SHMEM_SIZE};
+
+        return shm_obj.atomic_exec([&_physical_path, &_scheme, &_checksum](auto& data) {
+            return data.find(_physical_path, _scheme, _checksum);
+        });
+    }
+
+    using object_metadata_cache =
+        irods::experimental::interprocess::shared_memory::named_shared_memory_object
+        <object_metadata_cache_data>;
+
+    object_metadata_cache open_object_metadata_cache(irods::plugin_property_map& _prop_map)
+    {
+        std::string shmem_key = OBJECT_METADATA_CACHE_KEY_PREFIX +
+            std::to_string(std::hash<std::string>{}(get_resource_name(_prop_map)));
+
+        return object_metadata_cache{shmem_key,
+            OBJECT_METADATA_CACHE_TIMEOUT_IN_SECONDS,
+            OBJECT_METADATA_CACHE_SHMEM_SIZE};
+    }
+
+    // Archived objects change state without a write through this plugin so they are only cached
+    // once they have been restored.
+    bool object_metadata_can_be_cached(const std::string& _storage_class, const std::string& _restore)
+    {
+        namespace s3t = irods::experimental::io::s3_transport;
+
+        if (!boost::iequals(_storage_class, s3t::S3_STORAGE_CLASS_GLACIER) &&
+                !boost::iequals(_storage_class, s3t::S3_STORAGE_CLASS_DEEP_ARCHIVE)) {
+            return true;
+        }
+        return _restore.find("ongoing-request=\"false\"") != std::string::npos;
+    }
+
+    // Saves what a HEAD of the object at _physical_path returned (S3_METADATA_CACHE_TTL_SECONDS)
+    void cache_object_metadata(irods::plugin_property_map& _prop_map,
+                               const std::string& _physical_path,
+                               const object_metadata& _metadata)
+    {
+        if (s3_get_metadata_cache_ttl_seconds(_prop_map) <= 0) {
+            return;
+        }
+
+        auto shm_obj = open_object_metadata_cache(_prop_map);
+        shm_obj.atomic_exec([&_physical_path, &_metadata](auto& data) {
+            data.store(_physical_path, _metadata);
+        });
+    }
+
+    bool find_cached_object_metadata(irods::plugin_property_map& _prop_map,
+                                     const std::string& _physical_path,
+                                     object_metadata& _metadata)
+    {
+        const time_t ttl = s3_get_metadata_cache_ttl_seconds(_prop_map);
+        if (ttl <= 0) {
+            return false;
+        }
+
+        auto shm_obj = open_object_metadata_cache(_prop_map);
+        return shm_obj.atomic_exec([&_physical_path, ttl, &_metadata](auto& data) {
+            return data.find(_physical_path, ttl, _metadata);
+        });
+    }
+
+    // Called whenever this plugin changes or removes the object at _physical_path
+    void forget_object_metadata(irods::plugin_property_map& _prop_map, const std::string& _physical_path)
+    {
+        if (s3_get_metadata_cache_ttl_seconds(_prop_map) <= 0) {
+            return;
+        }
+
+        auto shm_obj = open_object_metadata_cache(_prop_map);
+        shm_obj.atomic_exec([&_physical_path](auto& data) {
+            data.remove(_physical_path);
+        });
+    }
+
+    // get_object_s3_status() for the object at _physical_path that uses the metadata cache
+    irods::error get_cached_object_s3_status(irods::plugin_property_map& _prop_map,
+            const std::string& _physical_path,
+            const std::string& _object_key,
+            S3BucketContext& _bucket_context,
+            std::int64_t& _object_size,
+            irods::experimental::io::s3_transport::object_s3_status& _object_status,
+            std::string& _storage_class)
+    {
+        namespace s3t = irods::experimental::io::s3_transport;
+
+        object_metadata metadata{};
+        if (find_cached_object_metadata(_prop_map, _physical_path, metadata)) {
+            _object_size = metadata.size;
+            _object_status = s3t::object_s3_status::IN_S3;
+            _storage_class = metadata.storage_class;
+            return SUCCESS();
+        }
+
+        irods::error ret = s3t::get_object_s3_status(_object_key, _bucket_context, _object_size, _object_status,
+                _storage_class, metadata.etag, metadata.last_modified);
+        if (ret.ok() && _object_status == s3t::object_s3_status::IN_S3) {
+            metadata.size = _object_size;
+            metadata.storage_class = _storage_class;
+            cache_object_metadata(_prop_map, _physical_path, metadata);
+        }
+        return ret;
+    }
+
+    // Called when the last thread closes an object that was written.  Save the checksum computed
+    // during the upload so that a checksum request does not need to read the object.
+    void save_upload_checksum(irods::plugin_context& _ctx,
+                              const std::string& _physical_path,
+                              const s3_transport& _transport,
+                              std::int64_t _object_size)
+    {
+        const std::string scheme = s3_get_checksum_on_upload_scheme(_ctx.prop_map());
+        if (scheme.empty()) {
+            return;
+        }
+
+        const std::string& checksum = _transport.get_upload_checksum();
+        cache_upload_checksum(_ctx.prop_map(), _physical_path, scheme, checksum);
+
+        if (checksum.empty() || _transport.is_upload_checksum_in_object_metadata()) {
+            return;
+        }
+
+        // The upload was streamed so the checksum was not known when it started.  Save
+        // it in the metadata with a copy unless the object is too large for CopyObject.
+        // The copy is conditional on the ETag of the upload so that it cannot attach the
+        // checksum to an object written since then.  Without the ETag that is not possible.
+        const std::string& etag = _transport.get_upload_etag();
+        if (etag.empty() || s3_copyobject_disabled(_ctx.prop_map()) ||
+                _object_size < 0 || _object_size > s3GetMaxUploadSizeMB(_ctx.prop_map()) * 1024 * 1024) {
+            return;
+        }
+
+        irods::error ret = s3_put_upload_checksum_metadata(_ctx.prop_map(), _physical_path, etag, scheme, checksum);
+        forget_object_metadata(_ctx.prop_map(), _physical_path);
+        if (!ret.ok()) {
+            // not fatal, a checksum request will read the object instead
+            logger::warn("[resource_name={}] {}", get_resource_name(_ctx.prop_map()), ret.result());
+        }
+    }
+
     // determines the data size and number of threads, stores them, and returns them
     auto get_number_of_threads_data_size_and_opr_type(irods::plugin_context& _ctx,
                                                       int& number_of_threads,
@@ -188,7 +574,6 @@ namespace irods_s3 {
                                                       int& oprType,
                                                       bool query_metadata = true) -> irods::error
     {
-        using logger_config = irods::experimental::log::logger_config<s3_plugin_logging_category>;
         using named_shared_memory_object =
             irods::experimental::interprocess::shared_memory::named_shared_memory_object
             <multipart_shared_data>;
@@ -207,33 +592,14 @@ namespace irods_s3 {
 
         // wrapping this in an atomic_exec so only one thread/process for a specific data object is executed at a time
         std::string func(__func__);
-        auto ret_value = shm_obj.atomic_exec([&number_of_threads, &data_size, &oprType, &_ctx, thread_id, file_obj, func](auto& data) {
+        // the L1 descriptor table is searched once, when the object is opened
+        const l1_descriptor_info l1_info = get_l1_descriptor_info(file_obj);
+
+        auto ret_value = shm_obj.atomic_exec([&number_of_threads, &data_size, &oprType, &_ctx, &l1_info, thread_id, file_obj, func](auto& data) {
 
             oprType = -1;
             int requested_number_of_threads = 0;
 
-            // ********* DEBUG - print L1desc for all
-            if (logger_config::get_level() == log::level::debug ||  logger_config::get_level() == log::level::trace) {
-
-                logger::debug("{}:{} ({}) [[{}]] ------------- L1desc ---------------",
-                        __FILE__, __LINE__, func, thread_id);
-                for (int i = 0; i < NUM_L1_DESC; ++i) {
-                    if (L1desc[i].inuseFlag && L1desc[i].dataObjInp && L1desc[i].dataObjInfo) {
-                       int thread_count = L1desc[i].dataObjInp->numThreads;
-                       int oprType = L1desc[i].dataObjInp->oprType;
-                       std::int64_t data_size = L1desc[i].dataSize;
-                       logger::debug("{}:{} ({}) [[{}]] [{}][objPath={}][filePath={}][oprType={}]"
-                               "[requested_number_of_threads={}][dataSize={}][dataObjInfo->dataSize={}][srcL1descInx={}]",
-                               __FILE__, __LINE__, func, thread_id, i, L1desc[i].dataObjInp->objPath,
-                               L1desc[i].dataObjInfo->filePath, oprType, thread_count, data_size,
-                               L1desc[i].dataObjInfo->dataSize, L1desc[i].srcL1descInx);
-                    }
-                }
-                logger::debug("{}:{} ({}) [[{}]] ------------------------------------",
-                        __FILE__, __LINE__, func, thread_id);
-            }
-            // ********* END DEBUG - print L1desc for all
-
             if (data.number_of_threads > 0) {
                 number_of_threads = data.number_of_threads;
             }
@@ -267,27 +633,13 @@ namespace irods_s3 {
             }
 
             // first try to get requested number of threads, data size, and oprType from L1desc
-            // Note: On a replication from an s3 src within a replication node, there are two entries for the
-            //   replica - one for PUT and one for REPL_DEST.  During the initial PUT there is only one
-            //   entry.  To see if we are doing the PUT or REPL, look for the last entry on the list.
-            bool found = false;
-            for (int i = 0; i < NUM_L1_DESC; ++i) {
-                if (L1desc[i].inuseFlag) {
-                    if (L1desc[i].dataObjInp && L1desc[i].dataObjInfo &&
-                            L1desc[i].dataObjInp->objPath == file_obj->logical_path()
-                            && L1desc[i].dataObjInfo->filePath == file_obj->physical_path()) {
-
-                        found = true;
-                        requested_number_of_threads = L1desc[i].dataObjInp->numThreads;
-                        oprType = L1desc[i].dataObjInp->oprType;
-
-                        // if data_size is zero or UNKNOWN, try to get it from L1desc
-                        if (data_size == s3_transport_config::UNKNOWN_OBJECT_SIZE) {
-                            data_size = L1desc[i].dataSize;
-                        }
-                    }
-                } else if (found) {
-                    break;
+            if (l1_info.found) {
+                requested_number_of_threads = l1_info.requested_number_of_threads;
+                oprType = l1_info.opr_type;
+
+                // if data_size is zero or UNKNOWN, try to get it from L1desc
+                if (data_size == s3_transport_config::UNKNOWN_OBJECT_SIZE) {
+                    data_size = l1_info.data_size;
                 }
             }
 
@@ -295,44 +647,24 @@ namespace irods_s3 {
             // 1) data_size is only available from the REPLICATE_SRC entry so use that.
             // 2) number_of_threads is available in REPLICATE_DEST entry so use that.
             if (oprType == REPLICATE_DEST) {
-                bool found_data_size = false;
                 bool found_number_of_threads = (number_of_threads > 0);
 
-                for (int i = 0; i < NUM_L1_DESC; ++i) {
-                    const auto& l1d = L1desc[i];
-                    const auto* dobj_input = l1d.dataObjInp;
-                    const auto* dobj_info = l1d.dataObjInfo;
-
-                    if (!l1d.inuseFlag || !dobj_input || dobj_input->objPath != file_obj->logical_path()) {
-                        continue;
-                    }
-
-                    // get the data size from source dataObjInfo
-                    if (!found_data_size && dobj_info && dobj_input->oprType == REPLICATE_SRC) {
-                        data_size = dobj_info->dataSize;
-                        logger::debug("{}:{} ({}) [[{}]] repl to s3 destination.  setting data_size to {}",
-                                __FILE__, __LINE__, func, thread_id, data_size);
-
-                        found_data_size = true;
-                    }
+                if (l1_info.found_replication_source) {
+                    data_size = l1_info.replication_source_data_size;
+                    logger::debug("{}:{} ({}) [[{}]] repl to s3 destination.  setting data_size to {}",
+                            __FILE__, __LINE__, func, thread_id, data_size);
+                }
 
-                    // get the number_of_threads from destination dataObjInp
-                    if (!found_number_of_threads && dobj_input->oprType == REPLICATE_DEST) {
-                        number_of_threads = dobj_input->numThreads;
-                        logger::debug("{}:{} ({}) [[{}]] repl to s3 destination.  setting number_of_threads to {}",
-                                      __FILE__,
-                                      __LINE__,
-                                      func,
-                                      thread_id,
-                                      number_of_threads);
-
-                        found_number_of_threads = true;
-                    }
+                if (!found_number_of_threads && l1_info.found_replication_destination) {
+                    number_of_threads = l1_info.replication_destination_number_of_threads;
+                    logger::debug("{}:{} ({}) [[{}]] repl to s3 destination.  setting number_of_threads to {}",
+                                  __FILE__,
+                                  __LINE__,
+                                  func,
+                                  thread_id,
+                                  number_of_threads);
 
-                    // once we have both pieces of information break out of for loop
-                    if (found_data_size && found_number_of_threads) {
-                        break;
-                    }
+                    found_number_of_threads = true;
                 }
 
                 if (!found_number_of_threads) {
@@ -595,19 +927,20 @@ namespace irods_s3 {
         int number_of_threads = 0;
         std::string bucket_name;
         std::string object_key;
-        std::string access_key;
-        std::string secret_access_key;
+        std::shared_ptr<const resource_config> config;
         unsigned int circular_buffer_size = S3_DEFAULT_CIRCULAR_BUFFER_SIZE;
         unsigned int circular_buffer_timeout_seconds = S3_DEFAULT_CIRCULAR_BUFFER_TIMEOUT_SECONDS;
 
         // create entry for fd if it doesn't exist
-        if (!fd_data.exists(fd)) {
-            per_thread_data data;
-            fd_data.set(fd, data);
+        if (!fd_data.exists(fd) && !fd_data.add(fd, per_thread_data{})) {
+            return std::make_tuple(ERROR(S3_FILE_OPEN_ERR,
+                        fmt::format("[resource_name={}] fd={} could not be added to fd_data",
+                        get_resource_name(_ctx.prop_map()), fd)),
+                    std::shared_ptr<dstream>{}, std::shared_ptr<s3_transport>{});
         }
 
         // if dstream/transport already created just return
-        per_thread_data data = fd_data.get(fd);
+        per_thread_data& data = fd_data.get(fd);
         if (data.dstream_ptr && data.s3_transport_ptr) {
             return make_tuple(SUCCESS(), data.dstream_ptr, data.s3_transport_ptr);
         }
@@ -620,7 +953,7 @@ namespace irods_s3 {
         logger::debug("{}:{} ({}) [[{}]] [physical_path={}][bucket_name={}][fd={}]",
                 __FILE__, __LINE__, __FUNCTION__, thread_id, file_obj->physical_path().c_str(), bucket_name.c_str(), fd);
 
-        ret = s3GetAuthCredentials(_ctx.prop_map(), access_key, secret_access_key);
+        ret = get_resource_config(_ctx.prop_map(), config);
         if(!ret.ok()) {
             return std::make_tuple(PASS(ret), data.dstream_ptr, data.s3_transport_ptr);
         }
@@ -659,41 +992,57 @@ namespace irods_s3 {
 
         std::string s3_cache_dir_str = get_cache_directory(_ctx.prop_map());
 
-        std::string&& hostname = s3GetHostname(_ctx.prop_map());
         s3_transport_config s3_config;
-        s3_config.hostname = hostname;
+        s3_config.hostname = config->next_hostname();
         s3_config.object_size = data_size;
         s3_config.number_of_cache_transfer_threads = s3GetMPUThreads(_ctx.prop_map());      // number of threads created by s3_transport when writing/reading to/from cache
         s3_config.number_of_client_transfer_threads = number_of_threads;                    // number of threads created by client
         s3_config.bytes_this_thread = data_size == s3_transport_config::UNKNOWN_OBJECT_SIZE // if number of threads is 0, cache is forced and bytes_this_thread is n/a
             || number_of_threads == 0 ? 0 : data_size / number_of_threads;
         s3_config.bucket_name = bucket_name;
-        s3_config.access_key = access_key;
-        s3_config.secret_access_key = secret_access_key;
+        // the transport signs with the keys current when the object was opened
+        const s3_credentials& credentials = config->credentials();
+        s3_config.access_key = credentials.key_id;
+        s3_config.secret_access_key = credentials.access_key;
         s3_config.shared_memory_timeout_in_seconds = 180;
-        s3_config.minimum_part_size = s3GetMPUChunksize(_ctx.prop_map());
+        s3_config.minimum_part_size = config->mpu_chunk_size;
         s3_config.circular_buffer_size = circular_buffer_size * s3_config.minimum_part_size;
         s3_config.circular_buffer_timeout_seconds = circular_buffer_timeout_seconds;
         s3_config.s3_protocol_str = get_protocol_as_string(_ctx.prop_map());
-        s3_config.s3_uri_request_style = s3_get_uri_request_style(_ctx.prop_map()) == S3UriStyleVirtualHost ? "host" : "path";
-        s3_config.region_name = get_region_name(_ctx.prop_map());
+        s3_config.s3_uri_request_style = config->uri_style == S3UriStyleVirtualHost ? "host" : "path";
+        s3_config.region_name = config->region_name;
         s3_config.put_repl_flag = ( oprType == PUT_OPR || oprType == REPLICATE_DEST || oprType == COPY_DEST );
         s3_config.server_encrypt_flag = s3GetServerEncrypt(_ctx.prop_map());
         s3_config.cache_directory = s3_cache_dir_str;
         s3_config.multipart_enabled = s3GetEnableMultiPartUpload (_ctx.prop_map());
-        s3_config.retry_count_limit = get_retry_count(_ctx.prop_map());
-        s3_config.retry_wait_seconds = get_retry_wait_time_sec(_ctx.prop_map());
-        s3_config.max_retry_wait_seconds = get_max_retry_wait_time_sec(_ctx.prop_map());
-        s3_config.resource_name = get_resource_name(_ctx.prop_map());
+        s3_config.retry_count_limit = config->retry_count_limit;
+        s3_config.retry_wait_seconds = config->retry_wait;
+        s3_config.max_retry_wait_seconds = config->max_retry_wait;
+        s3_config.resource_name = config->resource_name;
         s3_config.restoration_days = s3_get_restoration_days(_ctx.prop_map());
         s3_config.restoration_tier = s3_get_restoration_tier(_ctx.prop_map());
         s3_config.max_single_part_upload_size = s3GetMaxUploadSizeMB(_ctx.prop_map()) * 1024 * 1024;
-        s3_config.non_data_transfer_timeout_seconds = get_non_data_transfer_timeout_seconds(_ctx.prop_map());
+        s3_config.non_data_transfer_timeout_seconds = config->non_data_transfer_timeout_seconds;
         s3_config.s3_storage_class = s3_get_storage_class_from_configuration(_ctx.prop_map());
         s3_config.trailing_checksum_on_upload_enabled = s3_trailing_checksum_on_upload_enabled(_ctx.prop_map());
+        s3_config.small_object_upload_size_limit = s3_get_small_object_upload_size(_ctx.prop_map());
+        s3_config.upload_checksum_scheme = s3_get_checksum_on_upload_scheme(_ctx.prop_map());
+        s3_config.cache_io_uring_enabled = s3_cache_io_uring_enabled(_ctx.prop_map());
+        s3_config.read_cache_size = s3_get_read_cache_size(_ctx.prop_map());
+        s3_config.read_page_size = s3_get_read_page_size(_ctx.prop_map());
+        s3_config.read_merge_distance = s3_get_read_merge_distance(_ctx.prop_map());
+        s3_config.sparse_cache_file_enabled = s3_sparse_cache_file_enabled(_ctx.prop_map());
+        s3_config.append_with_copy_enabled = !s3_copyobject_disabled(_ctx.prop_map());
+
+        s3_config.s3_sts_date_str = config->sts_date == S3STSAmzOnly ? "amz" : config->sts_date == S3STSAmzAndDate ? "both" : "date";
 
-        auto sts_date_setting = s3GetSTSDate(_ctx.prop_map());
-        s3_config.s3_sts_date_str = sts_date_setting == S3STSAmzOnly ? "amz" : sts_date_setting == S3STSAmzAndDate ? "both" : "date";
+        // the open or a stat in this operation has usually just sent a HEAD for the object
+        object_metadata metadata{};
+        if (find_cached_object_metadata(_ctx.prop_map(), file_obj->physical_path(), metadata)) {
+            s3_config.existing_object_size = metadata.size;
+            s3_config.existing_object_etag = metadata.etag;
+            s3_config.existing_object_last_modified = metadata.last_modified;
+        }
 
         logger::debug("{}:{} ({}) [[{}]] [put_repl_flag={}][object_size={}][multipart_enabled={}][minimum_part_size={}] ",
                 __FILE__, __LINE__, __FUNCTION__, thread_id, s3_config.put_repl_flag, s3_config.object_size,
@@ -707,24 +1056,23 @@ namespace irods_s3 {
         // of order
         if (data_size == 0) {
             open_mode |= std::ios_base::in;
-            data.open_mode = open_mode;
         }
 
-        data.s3_transport_ptr = std::make_shared<s3_transport>(s3_config);
-        data.dstream_ptr = std::make_shared<dstream>(*data.s3_transport_ptr, object_key, open_mode);
+        auto s3_transport_ptr = std::make_shared<s3_transport>(s3_config);
+        auto dstream_ptr = std::make_shared<dstream>(*s3_transport_ptr, object_key, open_mode);
 
         irods::error return_error = SUCCESS();
 
-        if (!data.s3_transport_ptr || !data.dstream_ptr) {
+        if (!s3_transport_ptr || !dstream_ptr) {
             return_error  = ERROR(S3_FILE_OPEN_ERR,
                     fmt::format("[resource_name={}] null dstream or s3_transport encountered",
                     get_resource_name(_ctx.prop_map())));
         } else {
-            fd_data.set(fd, data);
-            return_error = data.s3_transport_ptr->get_error();
+            fd_data.set_dstream(fd, open_mode, dstream_ptr, s3_transport_ptr);
+            return_error = s3_transport_ptr->get_error();
         }
 
-        return std::make_tuple(return_error, data.dstream_ptr, data.s3_transport_ptr);
+        return std::make_tuple(return_error, dstream_ptr, s3_transport_ptr);
     }
 
     // =-=-=-=-=-=-=-
@@ -789,10 +1137,20 @@ namespace irods_s3 {
             // update the physical path
             update_physical_path_for_decoupled_naming(_ctx);
 
-            int fd = fd_data.get_and_increment_fd_counter();
+            // the path may be reused by a new object while the old one is still queued for deletion
+            if (irods::error ret = cancel_deferred_delete(_ctx.prop_map(), file_obj->physical_path()); !ret.ok()) {
+                return PASS(ret);
+            }
+
             per_thread_data data;
             data.open_mode = open_mode;
-            fd_data.set(fd, data);
+            data.l1_info = find_l1_descriptor_info(file_obj);
+            int fd = fd_data.add(data);
+            if (fd < 0) {
+                return ERROR(SYS_OUT_OF_FILE_DESC,
+                        fmt::format("[resource_name={}] {} - Too many open files.",
+                            get_resource_name(_ctx.prop_map()), __FUNCTION__));
+            }
             file_obj->file_descriptor(fd);
 
             logger::debug("{}:{} ({}) [[{}]] physical_path = {}", __FILE__, __LINE__, __FUNCTION__, thread_id, file_obj->physical_path().c_str());
@@ -815,7 +1173,6 @@ namespace irods_s3 {
 
             using std::ios_base;
             using irods::experimental::io::s3_transport::object_s3_status;
-            using irods::experimental::io::s3_transport::get_object_s3_status;
             using irods::experimental::io::s3_transport::handle_glacier_status;
 
             logger::debug("{}:{} ({}) [[{}]]", __FILE__, __LINE__, __FUNCTION__,
@@ -830,21 +1187,8 @@ namespace irods_s3 {
             // get oprType
             // note on replication there will be two matching entries for repl source, one for put and one for repl src
             // get the highest one
-            int oprType = -1;
-            bool found = false;
-            for (int i = 0; i < NUM_L1_DESC; ++i) {
-               if (L1desc[i].inuseFlag) {
-                   if (L1desc[i].dataObjInp && L1desc[i].dataObjInfo &&
-                           L1desc[i].dataObjInp->objPath == file_obj->logical_path()
-                           && L1desc[i].dataObjInfo->filePath == file_obj->physical_path()) {
-
-                       found = true;
-                       oprType = L1desc[i].dataObjInp->oprType;
-                   }
-               } else if (found) {
-                   break;
-               }
-            }
+            const l1_descriptor_info l1_info = find_l1_descriptor_info(file_obj);
+            int oprType = l1_info.opr_type;
 
             logger::debug("{}:{} ({}) [[{}]] oprType set to {}",
                     __FILE__, __LINE__, __FUNCTION__, thread_id, oprType);
@@ -870,23 +1214,23 @@ namespace irods_s3 {
                 open_mode = translate_open_mode_posix_to_stream(file_obj->flags(), __FUNCTION__);
             }
 
-            int fd = fd_data.get_and_increment_fd_counter();
             per_thread_data data;
             data.open_mode = open_mode;
-            fd_data.set(fd, data);
+            data.l1_info = l1_info;
+            int fd = fd_data.add(data);
+            if (fd < 0) {
+                return ERROR(SYS_OUT_OF_FILE_DESC,
+                        fmt::format("[resource_name={}] {} - Too many open files.",
+                            get_resource_name(_ctx.prop_map()), __FUNCTION__));
+            }
             file_obj->file_descriptor(fd);
 
             bool object_must_exist = operation_requires_that_object_exists(open_mode, oprType);
 
             if (object_must_exist) {
 
-                S3BucketContext bucket_context = {};
-
-                std::string hostname = s3GetHostname(_ctx.prop_map()).c_str();
-                std::string region_name = get_region_name(_ctx.prop_map());
-
-                std::string access_key, secret_access_key;
-                result = s3GetAuthCredentials(_ctx.prop_map(), access_key, secret_access_key);
+                std::shared_ptr<const resource_config> config;
+                result = get_resource_config(_ctx.prop_map(), config);
                 if(!result.ok()) {
                     return PASS(result);
                 }
@@ -898,20 +1242,14 @@ namespace irods_s3 {
                     return PASS(result);
                 }
 
-                bucket_context.hostName         = hostname.c_str();
-                bucket_context.bucketName       = bucket_name.c_str();
-                bucket_context.authRegion       = region_name.c_str();
-                bucket_context.accessKeyId      = access_key.c_str();
-                bucket_context.secretAccessKey  = secret_access_key.c_str();
-                bucket_context.protocol         = s3GetProto(_ctx.prop_map());
-                bucket_context.stsDate          = s3GetSTSDate(_ctx.prop_map());
-                bucket_context.uriStyle         = s3_get_uri_request_style(_ctx.prop_map());
+                S3BucketContext bucket_context = config->bucket_context(bucket_name);
 
                 // determine if the object exists
                 object_s3_status object_status;
                 std::string storage_class;
                 std::int64_t object_size = 0;
-                result = get_object_s3_status(object_key, bucket_context, object_size, object_status, storage_class);
+                result = get_cached_object_s3_status(_ctx.prop_map(), file_obj->physical_path(), object_key,
+                        bucket_context, object_size, object_status, storage_class);
                 if (!result.ok()) {
                     addRErrorMsg( &_ctx.comm()->rError, 0, result.result().c_str());
                     return PASS(result);
@@ -1158,6 +1496,11 @@ namespace irods_s3 {
                 logger::trace("{}:{} ({}) [[{}]] shmem_key={} hashed_string={} open_count={} ref_coun={}", __FILE__, __LINE__, __func__, thread_id, shmem_key, get_resource_name(_ctx.prop_map()) + file_obj->logical_path(), open_count, ref_count);
             }
 
+            // the object was replaced, the stat below saves what it is now
+            if (s3_transport_ptr && s3_transport_ptr->is_last_file_to_close() && (data.open_mode & std::ios_base::out)) {
+                forget_object_metadata(_ctx.prop_map(), file_obj->physical_path());
+            }
+
             //  because s3 might not provide immediate consistency for subsequent stats,
             //  do a stat with a retry if not found
             if (s3_transport_ptr && s3_transport_ptr->is_last_file_to_close() && result.ok()) {
@@ -1179,7 +1522,12 @@ namespace irods_s3 {
 
                 // do not return an error here as this is meant only as a delay until the stat is available
                 // if it is still not avaiable after close() returns it will be detected in a subsequent stat
-                s3_file_stat_operation_with_flag_for_retry_on_not_found(_ctx, &statbuf, true);
+                irods::error stat_ret = s3_file_stat_operation_with_flag_for_retry_on_not_found(_ctx, &statbuf, true);
+
+                if (data.open_mode & std::ios_base::out) {
+                    save_upload_checksum(_ctx, file_obj->physical_path(), *s3_transport_ptr,
+                            stat_ret.ok() ? statbuf.st_size : -1);
+                }
             }
 
             dstream_ptr.reset();  // make sure dstream is destructed first
@@ -1250,41 +1598,38 @@ namespace irods_s3 {
             return PASS(ret);
         }
 
+        // queue the object for the background worker unless too many deletes are queued already
+        if (s3_deferred_delete_enabled(_ctx.prop_map()) &&
+                enqueue_deferred_delete(_ctx.prop_map(), file_obj->physical_path())) {
+            forget_object_metadata(_ctx.prop_map(), file_obj->physical_path());
+            if (!s3_get_checksum_on_upload_scheme(_ctx.prop_map()).empty()) {
+                cache_upload_checksum(_ctx.prop_map(), file_obj->physical_path(), "", "");
+            }
+            return SUCCESS();
+        }
+
         ret = s3InitPerOperation(_ctx.prop_map());
         if(!ret.ok()) {
             return PASS(ret);
         }
 
-        std::string key_id;
-        std::string access_key;
-        ret = s3GetAuthCredentials(_ctx.prop_map(), key_id, access_key);
+        std::shared_ptr<const resource_config> config;
+        ret = get_resource_config(_ctx.prop_map(), config);
         if(!ret.ok()) {
             return PASS(ret);
         }
 
-
-        std::string region_name = get_region_name(_ctx.prop_map());
-
-        S3BucketContext bucketContext = {};
-        bucketContext.bucketName = bucket.c_str();
-        bucketContext.protocol = s3GetProto(_ctx.prop_map());
-        bucketContext.stsDate = s3GetSTSDate(_ctx.prop_map());
-        bucketContext.uriStyle = s3_get_uri_request_style(_ctx.prop_map());
-        bucketContext.accessKeyId = key_id.c_str();
-        bucketContext.secretAccessKey = access_key.c_str();
-        bucketContext.authRegion = region_name.c_str();
+        S3BucketContext bucketContext = config->bucket_context(bucket);
 
         callback_data_t data;
         S3ResponseHandler responseHandler = { 0, &responseCompleteCallback };
 
         data = {};
-        std::string&& hostname = s3GetHostname(_ctx.prop_map());
-        bucketContext.hostName = hostname.c_str();
         data.pCtx = &bucketContext;
         S3_delete_object(
             &bucketContext,
             key.c_str(), 0,
-            get_non_data_transfer_timeout_seconds(_ctx.prop_map()) * 1000,    // timeout (ms)
+            config->non_data_transfer_timeout_seconds * 1000,    // timeout (ms)
             &responseHandler,
             &data);
 
@@ -1300,6 +1645,12 @@ namespace irods_s3 {
             return ERROR(S3_FILE_UNLINK_ERR, msg);
         }
 
+        forget_object_metadata(_ctx.prop_map(), file_obj->physical_path());
+
+        if (!s3_get_checksum_on_upload_scheme(_ctx.prop_map()).empty()) {
+            cache_upload_checksum(_ctx.prop_map(), file_obj->physical_path(), "", "");
+        }
+
         return SUCCESS();
 
     } // s3_file_unlink_operation
@@ -1315,10 +1666,6 @@ namespace irods_s3 {
         std::uint64_t thread_id = std::hash<std::thread::id>{}(std::this_thread::get_id());
         logger::debug("{}:{} ({}) [[{}]]", __FILE__, __LINE__, __FUNCTION__, thread_id);
 
-        std::size_t retry_count_limit = get_retry_count(_ctx.prop_map());
-        std::size_t retry_wait = get_retry_wait_time_sec(_ctx.prop_map());
-        std::size_t max_retry_wait = get_max_retry_wait_time_sec(_ctx.prop_map());
-
         const auto resource_name = get_resource_name(_ctx.prop_map());
 
         // =-=-=-=-=-=-=-
@@ -1344,8 +1691,6 @@ namespace irods_s3 {
 
         std::string bucket;
         std::string key;
-        std::string key_id;
-        std::string access_key;
 
         ret = parseS3Path(object->physical_path(), bucket, key, _ctx.prop_map());
         if (!ret.ok()) {
@@ -1358,6 +1703,19 @@ namespace irods_s3 {
             return ret;
         }
 
+        // a stat that waits for a write to show up must ask S3
+        object_metadata metadata{};
+        if (!retry_on_not_found && find_cached_object_metadata(_ctx.prop_map(), object->physical_path(), metadata)) {
+            _statbuf->st_mode = S_IFREG;
+            _statbuf->st_nlink = 1;
+            _statbuf->st_uid = getuid ();
+            _statbuf->st_gid = getgid ();
+            _statbuf->st_atime = _statbuf->st_mtime = _statbuf->st_ctime = metadata.last_modified;
+            _statbuf->st_size = metadata.size;
+
+            return SUCCESS();
+        }
+
         ret = s3InitPerOperation( _ctx.prop_map() );
         if (!ret.ok()) {
             ret = PASSMSG(fmt::format(
@@ -1369,7 +1727,8 @@ namespace irods_s3 {
             return ret;
         }
 
-        ret = s3GetAuthCredentials(_ctx.prop_map(), key_id, access_key);
+        std::shared_ptr<const resource_config> config;
+        ret = get_resource_config(_ctx.prop_map(), config);
         if (!ret.ok()) {
             ret = PASSMSG(fmt::format(
                         "[resource_name={}] Failed to get the S3 credentials properties.",
@@ -1380,24 +1739,15 @@ namespace irods_s3 {
             return ret;
         }
 
-        std::string region_name = get_region_name(_ctx.prop_map());
+        std::size_t retry_wait = config->retry_wait;
 
         callback_data_t data;
-        S3BucketContext bucketContext{};
-
-        bucketContext.bucketName = bucket.c_str();
-        bucketContext.protocol = s3GetProto(_ctx.prop_map());
-        bucketContext.stsDate = s3GetSTSDate(_ctx.prop_map());
-        bucketContext.uriStyle = s3_get_uri_request_style(_ctx.prop_map());
-        bucketContext.accessKeyId = key_id.c_str();
-        bucketContext.secretAccessKey = access_key.c_str();
-        bucketContext.authRegion = region_name.c_str();
+        S3BucketContext bucketContext = config->bucket_context(bucket);
 
         S3ResponseHandler headObjectHandler = { &responsePropertiesCallback, &responseCompleteCallbackIgnoreLoggingNotFound};
         std::size_t retry_cnt = 0;
         do {
-            std::string&& hostname = s3GetHostname(_ctx.prop_map());
-            bucketContext.hostName = hostname.c_str();
+            bucketContext.hostName = config->next_hostname().c_str();
             data.pCtx = &bucketContext;
 
             S3_head_object(&bucketContext, key.c_str(), 0, 0, &headObjectHandler, &data);
@@ -1413,14 +1763,14 @@ namespace irods_s3 {
                     s3_sleep( retry_wait );
                     retry_wait *= 2;
                 }
-                if (retry_wait > max_retry_wait) {
-                    retry_wait = max_retry_wait;
+                if (retry_wait > config->max_retry_wait) {
+                    retry_wait = config->max_retry_wait;
                 }
             }
         } while ( data.status != S3StatusOK &&
                 ( irods::experimental::io::s3_transport::S3_status_is_retryable(data.status) ||
                   ( retry_on_not_found && data.status == S3StatusHttpErrorNotFound ) ) &&
-                ++retry_cnt < retry_count_limit );
+                ++retry_cnt < config->retry_count_limit );
 
         if (data.status == S3StatusOK) {
             _statbuf->st_mode = S_IFREG;
@@ -1430,6 +1780,14 @@ namespace irods_s3 {
             _statbuf->st_atime = _statbuf->st_mtime = _statbuf->st_ctime = savedProperties.lastModified;
             _statbuf->st_size = savedProperties.contentLength;
 
+            if (object_metadata_can_be_cached(data.x_amz_storage_class, data.x_amz_restore)) {
+                metadata.size = savedProperties.contentLength;
+                metadata.last_modified = savedProperties.lastModified;
+                metadata.storage_class = data.x_amz_storage_class;
+                metadata.etag = data.etag;
+                cache_object_metadata(_ctx.prop_map(), object->physical_path(), metadata);
+            }
+
             return SUCCESS();
         }
 
@@ -1501,8 +1859,7 @@ namespace irods_s3 {
             }
         }
 
-        if (fd_data.exists(fd)) {
-            per_thread_data data = fd_data.get(fd);
+        if (per_thread_data data; fd_data.copy(fd, data)) {
             if (data.dstream_ptr && data.s3_transport_ptr && data.s3_transport_ptr->is_cache_file_open()) {
 
                 // do a stat on the cache file, populate stat_buf, and return
@@ -1621,11 +1978,310 @@ namespace irods_s3 {
 
     } // s3_rmdir_operation
 
+    // A directory listing for readdir.  The keys under the prefix are listed a page at a time with
+    // ListObjectsV2 (or ListObjects if it is disabled) and while readdir returns the entries of one
+    // page the next page is listed in the background, so at most two pages are in memory however
+    // large the collection is.
+    class directory_listing {
+
+        public:
+
+            // The number of keys requested with each list, the most S3 returns.
+            static constexpr int PAGE_SIZE{1000};
+
+            // Everything needed to list the bucket, copied so the listing does not use the
+            // property map from the background thread.
+            struct list_settings {
+                std::string bucket;
+                std::string prefix;
+                std::string key_id;
+                std::string access_key;
+                std::string region_name;
+                S3Protocol  protocol;
+                S3STSDate   sts_date;
+                S3UriStyle  uri_style;
+                std::size_t retry_count_limit;
+                std::size_t retry_wait;
+                std::size_t max_retry_wait;
+                bool        list_objects_v2;
+            };
+
+            explicit directory_listing(list_settings _settings)
+                : settings_{std::move(_settings)}
+                , current_page_{}
+                , position_{0}
+                , next_page_{}
+                , first_page_listed_{false}
+            {}
+
+            directory_listing(const directory_listing&) = delete;
+            directory_listing& operator=(const directory_listing&) = delete;
+
+            // Sets _name to the next entry of the collection or to an empty string at the end.
+            irods::error next(irods::plugin_property_map& _prop_map, std::string& _name) {
+
+                while (position_ == current_page_.entries.size()) {
+
+                    if (first_page_listed_ && !current_page_.is_truncated) {
+                        _name.clear();
+                        return SUCCESS();
+                    }
+                    first_page_listed_ = true;
+
+                    // only the first page is not prefetched
+                    if (!next_page_.valid()) {
+                        list_next_page(_prop_map, current_page_.next_marker);
+                    }
+
+                    current_page_ = next_page_.get();
+                    position_ = 0;
+
+                    if (current_page_.status != S3StatusOK) {
+                        auto msg = fmt::format("[resource_name={}] - Error in S3 listing:  \"{}\"",
+                                    get_resource_name(_prop_map),
+                                    settings_.prefix.c_str());
+
+                        if(current_page_.status >= 0) {
+                            msg += fmt::format(" - \"{}\"", S3_get_status_name(current_page_.status));
+                        }
+
+                        return ERROR(S3_FILE_STAT_ERR, msg);
+                    }
+
+                    if (current_page_.is_truncated) {
+                        list_next_page(_prop_map, current_page_.next_marker);
+                    }
+                }
+
+                _name = std::move(current_page_.entries[position_++]);
+                return SUCCESS();
+            }
+
+        private:
+
+            // libs3 only calls the list callback for a response with keys or common prefixes, so
+            // a page is the last one unless the callback says otherwise.
+            struct page {
+                bool is_truncated{false};
+                std::string next_marker;
+                std::string last_key;
+                std::vector<std::string> entries;
+                S3Status status{S3StatusOK};
+                S3BucketContext *pCtx{nullptr}; /* To enable more detailed error messages */
+            };
+
+            void list_next_page(irods::plugin_property_map& _prop_map, const std::string& _marker) {
+                // the hostname rotates through the configured hosts so it is chosen here
+                next_page_ = std::async(std::launch::async,
+                        [this, hostname = s3GetHostname(_prop_map), marker = _marker] {
+                            return list_page(hostname, marker);
+                        });
+            }
+
+            page list_page(const std::string& _hostname, const std::string& _marker) const {
+
+                S3ListBucketHandler list_bucket_handler = {
+                    {
+                        [] (const S3ResponseProperties *properties, void *callback_data) -> S3Status {
+                            return S3StatusOK;
+                        },
+                        [] (S3Status status, const S3ErrorDetails *error, void *callback_data) -> void {
+                            page *result = static_cast<page*>(callback_data);
+                            StoreAndLogStatus( status, error, __FUNCTION__, result->pCtx, &(result->status) );
+                        }
+                    },
+                    [] (int is_truncated, const char *next_marker, int contents_count,
+                            const S3ListBucketContent *contents, int common_prefixes_count,
+                            const char **common_prefixes, void *callback_data) -> S3Status {
+
+                        page *result = static_cast<page*>(callback_data);
+
+                        result->is_truncated = is_truncated;
+                        if (next_marker != nullptr && *next_marker != '\0') {
+                            result->next_marker = next_marker;
+                        }
+
+                        // an empty name marks the end of the listing
+                        const auto add_entry = [result](const std::string& _key) {
+                            std::string name = boost::filesystem::path(_key).filename().string();
+                            if (!name.empty()) {
+                                result->entries.push_back(std::move(name));
+                            }
+                        };
+
+                        for (int i = 0; i < contents_count; ++i) {
+                            result->last_key = contents[i].key;
+                            add_entry(contents[i].key);
+                        }
+
+                        for (int i = 0; i < common_prefixes_count; ++i) {
+                            // remove trailing slash
+                            std::string dir_name(common_prefixes[i]);
+                            result->last_key = dir_name;
+                            if('/' == dir_name.back()) {
+                                dir_name.pop_back();
+                            }
+                            add_entry(dir_name);
+                        }
+                        return S3StatusOK;
+                    }
+                };
+
+                S3BucketContext bucketContext = {};
+
+                bucketContext.bucketName = settings_.bucket.c_str();
+                bucketContext.protocol = settings_.protocol;
+                bucketContext.stsDate = settings_.sts_date;
+                bucketContext.uriStyle = settings_.uri_style;
+                bucketContext.accessKeyId = settings_.key_id.c_str();
+                bucketContext.secretAccessKey = settings_.access_key.c_str();
+                bucketContext.authRegion = settings_.region_name.c_str();
+                bucketContext.hostName = _hostname.c_str();
+
+                std::size_t retry_wait = settings_.retry_wait;
+                std::size_t retry_cnt = 0;
+                page result;
+                do {
+
+                    result = page{};
+                    result.pCtx = &bucketContext;
+
+                    if (settings_.list_objects_v2) {
+                        S3_list_objects_v2(&bucketContext,                            // S3BucketContext
+                                settings_.prefix.c_str(),                             // prefix
+                                _marker.empty() ? nullptr : _marker.c_str(),          // continuation token
+                                nullptr,                                              // start after
+                                "/",                                                  // delimiter
+                                PAGE_SIZE,                                            // max number returned
+                                nullptr,                                              // S3RequestContext
+                                0,                                                    // timeout
+                                &list_bucket_handler,                                 // S3ListBucketHandler
+                                &result                                               // void* callback data
+                                );
+                    } else {
+                        S3_list_bucket(&bucketContext,                                // S3BucketContext
+                                settings_.prefix.c_str(),                             // prefix
+                                _marker.empty() ? nullptr : _marker.c_str(),          // marker
+                                "/",                                                  // delimiter
+                                PAGE_SIZE,                                            // max number returned
+                                nullptr,                                              // S3RequestContext
+                                0,                                                    // timeout
+                                &list_bucket_handler,                                 // S3ListBucketHandler
+                                &result                                               // void* callback data
+                                );
+                    }
+
+                    if (result.status != S3StatusOK) {
+                        s3_sleep( retry_wait );
+                        retry_wait *= 2;
+                        if (retry_wait > settings_.max_retry_wait) {
+                            retry_wait = settings_.max_retry_wait;
+                        }
+                    }
+
+                } while ( (result.status != S3StatusOK) &&
+                        irods::experimental::io::s3_transport::S3_status_is_retryable(result.status) &&
+                        (++retry_cnt < settings_.retry_count_limit ) );
+
+                // ListObjectsV2 always returns a continuation token.  With ListObjects, NextMarker is
+                // only returned when a delimiter is used, otherwise the last key is the marker.
+                if (!settings_.list_objects_v2 && result.is_truncated && result.next_marker.empty()) {
+                    result.next_marker = result.last_key;
+                }
+
+                // without a marker the next list would start over, so this is the end
+                if (result.is_truncated && result.next_marker.empty()) {
+                    result.is_truncated = false;
+                }
+                result.pCtx = nullptr;
+
+                return result;
+            }
+
+            const list_settings settings_;
+            page current_page_;
+            std::size_t position_;
+            std::future<page> next_page_;
+            bool first_page_listed_;
+    }; // end class directory_listing
+
+    // The open listings of this thread keyed by prefix.  A listing is removed on closedir, when
+    // its last entry has been returned, or when too many are open.
+    class directory_listings {
+
+        public:
+
+            static constexpr std::size_t MAXIMUM_NUMBER_OF_LISTINGS{16};
+
+            std::shared_ptr<directory_listing> find(const std::string& _prefix) {
+                auto it = listings_.find(_prefix);
+                if (it == listings_.end()) {
+                    return nullptr;
+                }
+                it->second.last_used = ++counter_;
+                return it->second.listing;
+            }
+
+            void insert(const std::string& _prefix, std::shared_ptr<directory_listing> _listing) {
+
+                // drop the least recently used listing
+                if (listings_.size() >= MAXIMUM_NUMBER_OF_LISTINGS) {
+                    auto oldest = std::min_element(listings_.begin(), listings_.end(),
+                            [](const auto& _a, const auto& _b) { return _a.second.last_used < _b.second.last_used; });
+                    listings_.erase(oldest);
+                }
+
+                listings_[_prefix] = {std::move(_listing), ++counter_};
+            }
+
+            void remove(const std::string& _prefix) {
+                listings_.erase(_prefix);
+            }
+
+        private:
+
+            struct entry {
+                std::shared_ptr<directory_listing> listing;
+                std::uint64_t last_used;
+            };
+
+            std::map<std::string, entry> listings_;
+            std::uint64_t counter_{0};
+    }; // end class directory_listings
+
+    thread_local directory_listings open_directory_listings;
+
+    // Gets the prefix of the keys in the collection with a trailing slash.
+    irods::error get_directory_prefix(irods::plugin_context& _ctx, std::string& _bucket, std::string& _prefix) {
+
+        irods::collection_object_ptr fco = boost::dynamic_pointer_cast< irods::collection_object >( _ctx.fco() );
+        std::string path = fco->physical_path();
+
+        irods::error result = parseS3Path(path, _bucket, _prefix, _ctx.prop_map());
+        if(!result.ok()) {
+            return PASS(result);
+        }
+
+        // add a trailing slash if it is not there
+        if('/' != _prefix.back()) {
+             _prefix += "/";
+        }
+
+        return SUCCESS();
+    } // end get_directory_prefix
+
     // =-=-=-=-=-=-=-
     // interface for POSIX opendir
     irods::error s3_opendir_operation( irods::plugin_context& _ctx ) {
 
         if (is_cacheless_mode(_ctx.prop_map())) {
+
+            // start over if the collection was listed before
+            std::string bucket, prefix;
+            if (get_directory_prefix(_ctx, bucket, prefix).ok()) {
+                open_directory_listings.remove(prefix);
+            }
+
             return SUCCESS();
         } else {
             return ERROR(SYS_NOT_SUPPORTED,
@@ -1640,6 +2296,12 @@ namespace irods_s3 {
     irods::error s3_closedir_operation( irods::plugin_context& _ctx) {
 
         if (is_cacheless_mode(_ctx.prop_map())) {
+
+            std::string bucket, prefix;
+            if (get_directory_prefix(_ctx, bucket, prefix).ok()) {
+                open_directory_listings.remove(prefix);
+            }
+
             return SUCCESS();
         } else {
             return ERROR(SYS_NOT_SUPPORTED,
@@ -1658,196 +2320,60 @@ namespace irods_s3 {
 
             logger::debug("{}:{} ({}) [[{}]]", __FILE__, __LINE__, __FUNCTION__, std::hash<std::thread::id>{}(std::this_thread::get_id()));
 
-            struct readdir_callback_data {
-
-                struct query_results {
-
-                    query_results()
-                        : is_truncated(true)
-                        , next_marker("")
-                        , status(S3StatusOK)
-                        , pCtx(nullptr)
-                    {}
-
-                    bool is_truncated;
-                    std::list<std::string> returned_objects;
-                    std::list<std::string> returned_collections;
-                    std::string next_marker;
-                    S3Status status;
-                    S3BucketContext *pCtx; /* To enable more detailed error messages */
-                };
-
-                std::map<std::string, query_results> result_map;
-                std::string query_string;
-            };
-
-            S3ListBucketHandler list_bucket_handler = {
-                {
-                    [] (const S3ResponseProperties *properties, void *callback_data) -> S3Status {
-                        return S3StatusOK;
-                    },
-                    [] (S3Status status, const S3ErrorDetails *error, void *callback_data) -> void {
-
-                        readdir_callback_data *data = static_cast<readdir_callback_data*>(callback_data);
-                        std::string query_string = data->query_string;
-
-                        readdir_callback_data::query_results &results = data->result_map[query_string];
-                        StoreAndLogStatus( status, error, __FUNCTION__, results.pCtx, &(results.status) );
-                    }
-                },
-                [] (int is_truncated, const char *next_marker, int contents_count,
-                        const S3ListBucketContent *contents, int common_prefixes_count,
-                        const char **common_prefixes, void *callback_data) -> S3Status {
-
-                    readdir_callback_data *data = static_cast<readdir_callback_data*>(callback_data);
-                    std::string query_string = data->query_string;
-                    readdir_callback_data::query_results &results = data->result_map[query_string];
-
-                    results.is_truncated = is_truncated;
-                    results.next_marker = (next_marker == nullptr ? "" : next_marker);
-                    for (int i = 0; i < contents_count; ++i) {
-                        results.returned_objects.push_back(contents[i].key);
-                    }
-
-                    for (int i = 0; i < common_prefixes_count; ++i) {
-                        // remove trailing slash
-                        std::string dir_name(common_prefixes[i]);
-                        if('/' == dir_name.back()) {
-                            dir_name.pop_back();
-                        }
-                        results.returned_collections.push_back(dir_name);
-                    }
-                    return S3StatusOK;
-                }
-            };
-
-            irods::error result = SUCCESS();
-
-
             // check incoming parameters
             irods::error ret = s3CheckParams( _ctx );
             if (!ret.ok()) {
                 return PASS(ret);
             }
 
-            irods::collection_object_ptr fco = boost::dynamic_pointer_cast< irods::collection_object >( _ctx.fco() );
-            std::string path = fco->physical_path();
-
-            std::string bucket;
-            std::string key;
-            result = parseS3Path(path, bucket, key, _ctx.prop_map());
+            std::string bucket, search_key;
+            irods::error result = get_directory_prefix(_ctx, bucket, search_key);
             if(!result.ok()) {
                 return PASS(result);
             }
 
-            thread_local readdir_callback_data cb_data{ {}, "" };
-
-            // add a trailing slash if it is not there
-            std::string search_key = key;
-            if('/' != search_key.back()) {
-                 search_key += "/";
-            }
-            cb_data.query_string = search_key;
-
-            readdir_callback_data::query_results& data = cb_data.result_map[search_key];
-
-            // see if we need to get more data
-            if (data.returned_objects.size() == 0 && data.returned_collections.size() == 0 && data.is_truncated) {
-
-                std::size_t retry_count_limit = get_retry_count(_ctx.prop_map());
-                std::size_t retry_wait = get_retry_wait_time_sec(_ctx.prop_map());
-                std::size_t max_retry_wait = get_max_retry_wait_time_sec(_ctx.prop_map());
+            auto listing = open_directory_listings.find(search_key);
+            if (!listing) {
 
                 result = s3InitPerOperation( _ctx.prop_map() );
                 if(!result.ok()) {
                     return PASS(result);
                 }
 
-                std::string key_id, access_key;
-                result = s3GetAuthCredentials(_ctx.prop_map(), key_id, access_key);
+                directory_listing::list_settings settings;
+                result = s3GetAuthCredentials(_ctx.prop_map(), settings.key_id, settings.access_key);
                 if(!result.ok()) {
                     return PASS(result);
                 }
 
-                std::string region_name = get_region_name(_ctx.prop_map());
-
-                S3BucketContext bucketContext = {};
-
-                bucketContext.bucketName = bucket.c_str();
-                bucketContext.protocol = s3GetProto(_ctx.prop_map());
-                bucketContext.stsDate = s3GetSTSDate(_ctx.prop_map());
-                bucketContext.uriStyle = s3_get_uri_request_style(_ctx.prop_map());
-                bucketContext.accessKeyId = key_id.c_str();
-                bucketContext.secretAccessKey = access_key.c_str();
-                bucketContext.authRegion = region_name.c_str();
-
-                std::size_t retry_cnt = 0;
-                do {
-
-                    std::string&& hostname = s3GetHostname(_ctx.prop_map());
-                    bucketContext.hostName = hostname.c_str();
-                    data.pCtx = &bucketContext;
-
-                    S3_list_bucket(&bucketContext,                                       // S3BucketContext
-                            search_key.c_str(),                                          // prefix
-                            data.next_marker == "" ? nullptr : data.next_marker.c_str(), // marker
-                            "/",                                                         // delimiter
-                            1024,                                                        // max number returned
-                            nullptr,                                                     // S3RequestContext
-                            0,                                                           // timeout
-                            &list_bucket_handler,                                        // S3ListBucketHandler
-                            &cb_data                                                     // void* callback data
-                            );
-
-                    if (data.status != S3StatusOK) {
-                        s3_sleep( retry_wait );
-                        retry_wait *= 2;
-                        if (retry_wait > max_retry_wait) {
-                            retry_wait = max_retry_wait;
-                        }
-                    }
-
-                } while ( (data.status != S3StatusOK) &&
-                        irods::experimental::io::s3_transport::S3_status_is_retryable(data.status) &&
-                        (++retry_cnt < retry_count_limit ) );
-
-                if (data.status != S3StatusOK) {
-
-                    auto msg = fmt::format("[resource_name={}] - Error in S3 listing:  \"{}\"",
-                                get_resource_name(_ctx.prop_map()),
-                                search_key.c_str());
-
-                    if(data.status >= 0) {
-                        msg += fmt::format(" - \"{}\"", S3_get_status_name((S3Status)data.status));
-                    }
-
-                    return ERROR(S3_FILE_STAT_ERR, msg);
-                }
+                settings.bucket = bucket;
+                settings.prefix = search_key;
+                settings.region_name = get_region_name(_ctx.prop_map());
+                settings.protocol = s3GetProto(_ctx.prop_map());
+                settings.sts_date = s3GetSTSDate(_ctx.prop_map());
+                settings.uri_style = s3_get_uri_request_style(_ctx.prop_map());
+                settings.retry_count_limit = get_retry_count(_ctx.prop_map());
+                settings.retry_wait = get_retry_wait_time_sec(_ctx.prop_map());
+                settings.max_retry_wait = get_max_retry_wait_time_sec(_ctx.prop_map());
+                settings.list_objects_v2 = s3_list_objects_v2_enabled(_ctx.prop_map());
+
+                listing = std::make_shared<directory_listing>(std::move(settings));
+                open_directory_listings.insert(search_key, listing);
             }
 
-            *_dirent_ptr = nullptr;
-            if (data.returned_objects.size() > 0) {
-
-                std::string current_key = data.returned_objects.front();
-                data.returned_objects.pop_front();
-                *_dirent_ptr = ( rodsDirent_t* ) malloc( sizeof( rodsDirent_t ) );
-                boost::filesystem::path p(current_key.c_str());
-                current_key = p.filename().string();
-                strcpy((*_dirent_ptr)->d_name, current_key.c_str());
-                return result;
-            }
+            std::string current_key;
+            result = listing->next(_ctx.prop_map(), current_key);
 
-            if (data.returned_collections.size() > 0) {
+            *_dirent_ptr = nullptr;
 
-                std::string current_key = data.returned_collections.front();
-                data.returned_collections.pop_front();
-                *_dirent_ptr = ( rodsDirent_t* ) malloc( sizeof( rodsDirent_t ) );
-                boost::filesystem::path p(current_key.c_str());
-                current_key = p.filename().string();
-                strcpy((*_dirent_ptr)->d_name, current_key.c_str());
+            // the listing is finished so free it even if closedir is not called
+            if (!result.ok() || current_key.empty()) {
+                open_directory_listings.remove(search_key);
                 return result;
             }
 
+            *_dirent_ptr = ( rodsDirent_t* ) malloc( sizeof( rodsDirent_t ) );
+            strcpy((*_dirent_ptr)->d_name, current_key.c_str());
             return result;
 
         } else {
@@ -1898,11 +2424,21 @@ namespace irods_s3 {
                         resource_name), ret);
         }
 
+        // the source entry is removed by the unlink below, make sure nothing is left for the destination
+        if (!s3_get_checksum_on_upload_scheme(_ctx.prop_map()).empty()) {
+            cache_upload_checksum(_ctx.prop_map(), _new_file_name, "", "");
+        }
+        ret = cancel_deferred_delete(_ctx.prop_map(), _new_file_name);
+        if (!ret.ok()) {
+            return PASS(ret);
+        }
+
         if (!s3_copyobject_disabled(_ctx.prop_map())) {
             // copy the object to the new location
             ret = s3CopyFile(_ctx, object->physical_path(), _new_file_name, access_key, secret_access_key,
                     s3GetProto(_ctx.prop_map()), s3GetSTSDate(_ctx.prop_map()),
                     s3_get_uri_request_style(_ctx.prop_map()));
+            forget_object_metadata(_ctx.prop_map(), _new_file_name);
             if (!ret.ok()) {
                 // TODO: this is to maintain existing behavior but probably not necessary for error cases
                 object->physical_path(_new_file_name);
@@ -1928,14 +2464,6 @@ namespace irods_s3 {
             return ret;
         }
 
-        // read the buffer size from rods environment
-        rodsLong_t buf_size = irods::get_advanced_setting<const int>(irods::KW_CFG_TRANS_BUFFER_SIZE_FOR_PARA_TRANS) * 1024 * 1024;
-        char* buf = ( char* )malloc( buf_size );
-
-        const irods::at_scope_exit free_buf { [buf]() {
-            free(buf);
-        }};
-
         struct stat statbuf;
         ret = s3_file_stat_operation_with_flag_for_retry_on_not_found(_ctx, &statbuf, false);
         if (!ret.ok()) {
@@ -1947,68 +2475,20 @@ namespace irods_s3 {
                         resource_name, object->physical_path()), ret);
         }
 
-        std::string bucket_name;
-        std::string src_object_key;
-        std::string dest_object_key;
-        std::string&& hostname = s3GetHostname(_ctx.prop_map());
-
-        // get source object_key
-        ret = parseS3Path(object->physical_path(), bucket_name, src_object_key, _ctx.prop_map());
+        // CopyObject is not available so read the object through this server.  The ranged
+        // reads of the source overlap with the part uploads to the destination.
+        ret = s3_copy_object_pipelined(_ctx.prop_map(), object->physical_path(), _new_file_name,
+                statbuf.st_size, access_key, secret_access_key);
+        forget_object_metadata(_ctx.prop_map(), _new_file_name);
         if (!ret.ok()) {
-            return ret;
-        }
+            // TODO: this is to maintain existing behavior but probably not necessary for error cases
+            object->physical_path(_new_file_name);
 
-        // get destination object_key
-        ret = parseS3Path(_new_file_name, bucket_name, dest_object_key, _ctx.prop_map());
-        if (!ret.ok()) {
-            return ret;
+            return PASSMSG(fmt::format(
+                        "[resource_name={}] Failed to copy object from: \"{}\" to \"{}\".",
+                        resource_name, object->physical_path(), _new_file_name), ret);
         }
 
-        // read from source and write to destination
-        s3_transport_config src_s3_config;
-        src_s3_config.hostname = hostname;
-        src_s3_config.number_of_cache_transfer_threads = 1;
-        src_s3_config.number_of_client_transfer_threads = 1;
-        src_s3_config.bucket_name = bucket_name;
-        src_s3_config.access_key = access_key;
-        src_s3_config.secret_access_key = secret_access_key;
-        src_s3_config.shared_memory_timeout_in_seconds = 180;
-        src_s3_config.region_name = get_region_name(_ctx.prop_map());
-        src_s3_config.s3_protocol_str = s3GetProto(_ctx.prop_map());
-
-        s3_transport src_transport_object{src_s3_config};
-        idstream src_dstream_object{src_transport_object, src_object_key};
-
-        // get the source object size
-        off_t object_size = src_transport_object.get_existing_object_size();
-
-        s3_transport_config dest_s3_config;
-        dest_s3_config.hostname = hostname;
-        dest_s3_config.number_of_cache_transfer_threads = 1;
-        dest_s3_config.bucket_name = bucket_name;
-        dest_s3_config.access_key = access_key;
-        dest_s3_config.secret_access_key = secret_access_key;
-        dest_s3_config.shared_memory_timeout_in_seconds = 180;
-        dest_s3_config.region_name = get_region_name(_ctx.prop_map());
-        dest_s3_config.put_repl_flag = false;
-        dest_s3_config.object_size = object_size;
-        dest_s3_config.minimum_part_size = s3GetMPUChunksize(_ctx.prop_map());
-        dest_s3_config.circular_buffer_size = 2 * dest_s3_config.minimum_part_size;
-        dest_s3_config.s3_protocol_str = s3GetProto(_ctx.prop_map());
-
-        dest_s3_config.number_of_client_transfer_threads = 1;
-        s3_transport dest_transport_object{dest_s3_config};
-        odstream dest_dstream_object{dest_transport_object, dest_object_key};
-
-        // copy from src to dest
-        for (off_t offset = 0; offset < object_size; offset += buf_size) {
-            off_t read_write_size = (offset + buf_size) <= object_size ? buf_size : (object_size - offset);
-            src_dstream_object.read(buf, read_write_size);
-            dest_dstream_object.write(buf, read_write_size);
-        }
-        src_dstream_object.close();
-        dest_dstream_object.close();
-
         // delete the original file
         result = s3_file_unlink_operation(_ctx);
 
@@ -2055,7 +2535,6 @@ namespace irods_s3 {
                                              const char* _cache_file_name)
     {
         using irods::experimental::io::s3_transport::object_s3_status;
-        using irods::experimental::io::s3_transport::get_object_s3_status;
         using irods::experimental::io::s3_transport::handle_glacier_status;
 
         const auto resource_name = get_resource_name(_ctx.prop_map());
@@ -2074,18 +2553,12 @@ namespace irods_s3 {
                         resource_name), ret);
         }
 
-        std::string access_key;
-        std::string secret_access_key;
         irods::file_object_ptr object = boost::dynamic_pointer_cast<irods::file_object>(_ctx.fco());
 
         // stat the object and check/handle glacier status
 
-        S3BucketContext bucket_context = {};
-
-        std::string hostname = s3GetHostname(_ctx.prop_map()).c_str();
-        std::string region_name = get_region_name(_ctx.prop_map());
-
-        ret = s3GetAuthCredentials(_ctx.prop_map(), access_key, secret_access_key);
+        std::shared_ptr<const resource_config> config;
+        ret = get_resource_config(_ctx.prop_map(), config);
         if(!ret.ok()) {
             return PASS(ret);
         }
@@ -2097,21 +2570,15 @@ namespace irods_s3 {
             return PASS(ret);
         }
 
-        bucket_context.hostName         = hostname.c_str();
-        bucket_context.bucketName       = bucket_name.c_str();
-        bucket_context.authRegion       = region_name.c_str();
-        bucket_context.accessKeyId      = access_key.c_str();
-        bucket_context.secretAccessKey  = secret_access_key.c_str();
-        bucket_context.protocol         = s3GetProto(_ctx.prop_map());
-        bucket_context.stsDate          = s3GetSTSDate(_ctx.prop_map());
-        bucket_context.uriStyle         = s3_get_uri_request_style(_ctx.prop_map());
+        S3BucketContext bucket_context = config->bucket_context(bucket_name);
 
         // determine if the object exists
 
         object_s3_status object_status;
         std::string storage_class;
         std::int64_t object_size = 0;
-        ret = get_object_s3_status(object_key, bucket_context, object_size, object_status, storage_class);
+        ret = get_cached_object_s3_status(_ctx.prop_map(), object->physical_path(), object_key,
+                bucket_context, object_size, object_status, storage_class);
         if (!ret.ok()) {
             addRErrorMsg( &_ctx.comm()->rError, 0, ret.result().c_str());
             return PASS(ret);
@@ -2138,7 +2605,8 @@ namespace irods_s3 {
                         resource_name, object->physical_path(), object->size(), object_size));
         }
 
-        ret = s3GetFile( _cache_file_name, object->physical_path(), object_size, access_key, secret_access_key, _ctx.prop_map());
+        const s3_credentials& credentials = config->credentials();
+        ret = s3GetFile( _cache_file_name, object->physical_path(), object_size, credentials.key_id, credentials.access_key, _ctx.prop_map());
         if (!ret.ok()) {
             return PASSMSG(fmt::format(
                         "[resource_name={}] Failed to copy the S3 object: \"{}\" to the cache: \"{}\".",
@@ -2243,7 +2711,15 @@ namespace irods_s3 {
             object->physical_path(s3_key_name);
         }
 
+        ret = cancel_deferred_delete(_ctx.prop_map(), object->physical_path());
+        if (!ret.ok()) {
+            logger::error(ret.result());
+
+            return PASS(ret);
+        }
+
         ret = s3PutCopyFile(S3_PUTFILE, _cache_file_name, object->physical_path(), statbuf.st_size, key_id, access_key, _ctx.prop_map());
+        forget_object_metadata(_ctx.prop_map(), object->physical_path());
         if (!ret.ok()) {
             ret = PASSMSG(fmt::format(
                         "[resource_name={}] Failed to copy the cache file: \"{}\" to the S3 object: \"{}\".",
@@ -2402,7 +2878,9 @@ namespace irods_s3 {
 		return SUCCESS();
 	} // s3_notify_operation
 
-    irods::error s3_read_checksum_from_storage_device(irods::plugin_context& _ctx,
+    // Returns the checksum if S3 already has it, either saved when the object was uploaded or
+    // computed by the provider.  Returns SYS_NOT_SUPPORTED if it does not.
+    irods::error read_checksum_saved_in_s3(irods::plugin_context& _ctx,
             const std::string* _checksum_scheme,
             std::string* _returned_checksum) {
 
@@ -2420,16 +2898,36 @@ namespace irods_s3 {
                     *_checksum_scheme,
                     file_obj->logical_path()));
 
-        // if direct checksum read is not enabled, just return an error
-		if (!s3_direct_checksum_read_enabled(_ctx.prop_map())) {
-            return ERROR(SYS_NOT_SUPPORTED, fmt::format("direct checksum read is not enabled"));
-        }
-
         logger::debug("{}:{} ({}) _checksum_scheme={}", __FILE__, __LINE__, __func__, *_checksum_scheme);
 
         std::string checksum_scheme_lowercase = *_checksum_scheme;
         boost::algorithm::to_lower(checksum_scheme_lowercase);
 
+        // If the checksum was computed while the object was uploaded, use it.  First look in shared
+        // memory as the checksum is usually requested right after the upload, then in the metadata.
+        if (checksum_scheme_lowercase == s3_get_checksum_on_upload_scheme(_ctx.prop_map())) {
+
+            if (find_cached_upload_checksum(_ctx.prop_map(), file_obj->physical_path(),
+                        checksum_scheme_lowercase, *_returned_checksum)) {
+                logger::debug("{}:{} ({}) checksum [{}] found in shared memory", __FILE__, __LINE__, __func__, *_returned_checksum);
+                return SUCCESS();
+            }
+
+            std::string scheme;
+            std::string checksum;
+            irods::error ret = s3_get_upload_checksum_metadata(_ctx.prop_map(), file_obj->physical_path(), scheme, checksum);
+            if (ret.ok() && !checksum.empty() && boost::iequals(scheme, checksum_scheme_lowercase)) {
+                logger::debug("{}:{} ({}) checksum [{}] found in object metadata", __FILE__, __LINE__, __func__, checksum);
+                *_returned_checksum = checksum;
+                return SUCCESS();
+            }
+        }
+
+        // if direct checksum read is not enabled, just return an error
+		if (!s3_direct_checksum_read_enabled(_ctx.prop_map())) {
+            return ERROR(SYS_NOT_SUPPORTED, fmt::format("direct checksum read is not enabled"));
+        }
+
         // only continue if S3 provides the checksum scheme
         if (checksum_scheme_lowercase != "crc64nvme" &&
                checksum_scheme_lowercase != "sha1" &&
@@ -2446,26 +2944,15 @@ namespace irods_s3 {
             return PASS(ret);
         }
 
-        // get auth credentials
-        std::string key_id;
-        std::string access_key;
-        ret = s3GetAuthCredentials(_ctx.prop_map(), key_id, access_key);
+        // get the settings and credentials
+        std::shared_ptr<const resource_config> config;
+        ret = get_resource_config(_ctx.prop_map(), config);
         if(!ret.ok()) {
             return PASS(ret);
         }
 
         // set up the bucket context
-        S3BucketContext bucketContext = {};
-        bucketContext.bucketName = bucket.c_str();
-        bucketContext.protocol = s3GetProto(_ctx.prop_map());
-        bucketContext.stsDate = s3GetSTSDate(_ctx.prop_map());
-        bucketContext.uriStyle = s3_get_uri_request_style(_ctx.prop_map());
-        bucketContext.accessKeyId = key_id.c_str();
-        bucketContext.secretAccessKey = access_key.c_str();
-        std::string region_name = get_region_name(_ctx.prop_map());
-        bucketContext.authRegion = region_name.c_str();
-        std::string&& hostname = s3GetHostname(_ctx.prop_map());
-        bucketContext.hostName = hostname.c_str();
+        S3BucketContext bucketContext = config->bucket_context(bucket);
 
         // set up callbacks for s3_get_object_attributes
 
@@ -2606,5 +3093,32 @@ namespace irods_s3 {
 
         return generic_checksum_not_available_error;
 
+    } // read_checksum_saved_in_s3
+
+    irods::error s3_read_checksum_from_storage_device(irods::plugin_context& _ctx,
+            const std::string* _checksum_scheme,
+            std::string* _returned_checksum) {
+
+        irods::error ret = read_checksum_saved_in_s3(_ctx, _checksum_scheme, _returned_checksum);
+        if (ret.ok() || ret.code() != SYS_NOT_SUPPORTED || s3_get_checksum_read_threads(_ctx.prop_map()) == 0) {
+            return ret;
+        }
+
+        // Rather than have the server read the object sequentially, read it with concurrent
+        // ranged GETs.
+        irods::file_object_ptr file_obj = boost::dynamic_pointer_cast<irods::file_object>(_ctx.fco());
+        irods::error compute_ret = s3_compute_checksum_with_ranged_reads(_ctx.prop_map(), file_obj->physical_path(),
+                *_checksum_scheme, *_returned_checksum);
+        if (!compute_ret.ok()) {
+            // let the server compute it instead
+            logger::warn("[resource_name={}] Could not compute the checksum of [{}] with ranged reads. {}",
+                    get_resource_name(_ctx.prop_map()), file_obj->physical_path(), compute_ret.result());
+            _returned_checksum->clear();
+            return ret;
+        }
+
+        logger::debug("{}:{} ({}) checksum [{}] computed with ranged reads", __FILE__, __LINE__, __func__, *_returned_checksum);
+        return SUCCESS();
+
     } // s3_read_checksum
 }
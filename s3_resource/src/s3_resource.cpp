@@ -1,6 +1,9 @@
 // =-=-=-=-=-=-=-
 // local includes
 #include "irods/private/s3_resource/s3_resource.hpp"
+#include "irods/private/s3_resource/credential_provider.hpp"
+#include "irods/private/s3_resource/deferred_delete_queue.hpp"
+#include "irods/private/s3_resource/resource_config.hpp"
 #include "irods/private/s3_resource/s3_operations.hpp"
 #include "irods/private/s3_resource/s3_plugin_logging_category.hpp"
 #include "irods/private/s3_transport/logging_category.hpp"
@@ -18,6 +21,7 @@
 #include <irods/irods_stacktrace.hpp>
 #include <irods/irods_at_scope_exit.hpp>
 #include <irods/irods_server_properties.hpp>
+#include <irods/checksum.h>
 
 // =-=-=-=-=-=-=-
 // irods includes
@@ -44,6 +48,13 @@
 #include <tuple>
 #include <random>
 #include <unordered_map>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <future>
 
 // =-=-=-=-=-=-=-
 // boost includes
@@ -69,6 +80,7 @@
 #include <unistd.h>
 #endif
 #include <sys/types.h>
+#include <sys/select.h>
 #if defined(osx_platform)
 #include <sys/malloc.h>
 #else
@@ -118,8 +130,32 @@ using s3_logger = irods::experimental::log::logger<s3_plugin_logging_category>;
 
 //////////////////////////////////////////////////////////////////////
 // s3 specific functionality
-static bool S3Initialized = false; // so we only initialize the s3 library once
+static std::atomic<bool> S3Initialized{false}; // so we only initialize the s3 library once per process
+static boost::mutex g_s3InitLock;               // guards initialization and g_startedResourceCount
+static int g_startedResourceCount = 0;          // the library is deinitialized when the last resource stops
 static boost::mutex g_hostnameIdxLock;
+// Connection warm ups by resource name, guarded by g_s3InitLock.  Stopping the resource
+// cancels the warm up and waits for it before the library may be deinitialized.
+struct warm_up_thread
+{
+    warm_up_thread() = default;
+    warm_up_thread(warm_up_thread&&) = default;
+    warm_up_thread& operator=(warm_up_thread&&) = default;
+
+    // the process is exiting without the resource having been stopped
+    ~warm_up_thread()
+    {
+        if (thread.joinable()) {
+            cancelled->store(true);
+            thread.detach();
+        }
+    }
+
+    std::thread                        thread;
+    std::shared_ptr<std::atomic<bool>> cancelled;
+    std::future<void>                  done;
+};
+static std::map<std::string, warm_up_thread> g_warmUps;
 
 const std::string  s3_default_hostname{"S3_DEFAULT_HOSTNAME"};
 const std::string  s3_default_hostname_vector{"S3_DEFAULT_HOSTNAME_VECTOR"};
@@ -140,6 +176,9 @@ const std::string  s3_max_upload_size_mb{"S3_MAX_UPLOAD_SIZE_MB"};
 const std::string  s3_enable_mpu{"S3_ENABLE_MPU"};
 const std::string  s3_mpu_chunk{"S3_MPU_CHUNK"};
 const std::string  s3_mpu_threads{"S3_MPU_THREADS"};
+const std::string  s3_copy_part_size_mb{"S3_COPY_PART_SIZE_MB"};        //  part size used for server-side multipart copies
+const std::string  s3_copy_concurrency{"S3_COPY_CONCURRENCY"};          //  number of UploadPartCopy requests in flight at once
+const std::string  s3_checksum_read_threads{"S3_CHECKSUM_READ_THREADS"};  //  number of ranged GETs used to compute a checksum, 0 disables
 const std::string  s3_enable_md5{"S3_ENABLE_MD5"};
 const std::string  s3_server_encrypt{"S3_SERVER_ENCRYPT"};
 const std::string  s3_region_name{"S3_REGIONNAME"};
@@ -148,6 +187,17 @@ const std::string  REPL_POLICY_VAL{"reg_repl"};
 const std::string  s3_cache_dir{"S3_CACHE_DIR"};
 const std::string  s3_circular_buffer_size{"CIRCULAR_BUFFER_SIZE"};
 const std::string  s3_circular_buffer_timeout_seconds{"CIRCULAR_BUFFER_TIMEOUT_SECONDS"};
+const std::string  s3_small_object_upload_size_kb{"S3_SMALL_OBJECT_UPLOAD_SIZE_KB"};  //  single threaded puts up to this size are buffered in memory
+const std::string  s3_cache_io_uring{"S3_CACHE_IO_URING"};              //  read and write cache files through io_uring when available
+const std::string  s3_read_cache_size_mb{"S3_READ_CACHE_SIZE_MB"};      //  size of the block cache for cacheless reads, 0 disables
+const std::string  s3_read_page_size_kb{"S3_READ_PAGE_SIZE_KB"};        //  page size of the in memory cache for small cacheless reads, 0 disables
+const std::string  s3_read_merge_distance_kb{"S3_READ_MERGE_DISTANCE_KB"};  //  small reads this close together are merged into one GET
+const std::string  s3_sparse_cache_file{"S3_SPARSE_CACHE_FILE"};        //  only download and upload the parts of an object that are updated
+const std::string  s3_enable_list_objects_v2{"S3_ENABLE_LIST_OBJECTS_V2"};  //  If set to 0 the ListObjects (V1) API is used for listings.  Default is ListObjectsV2.
+const std::string  s3_deferred_delete{"S3_DEFERRED_DELETE"};            //  queue unlinks and delete the objects in batches in the background
+const std::string  s3_deferred_delete_queue_limit{"S3_DEFERRED_DELETE_QUEUE_LIMIT"};  //  unlinks are synchronous while more deletes than this are queued
+const std::string  s3_warm_up_connections{"S3_WARM_UP_CONNECTIONS"};    //  connections opened to each host when the resource starts, 0 disables
+const std::string  s3_metadata_cache_ttl_seconds{"S3_METADATA_CACHE_TTL_SECONDS"};  //  how long the results of HEAD requests are reused, 0 disables
 const std::string  s3_uri_request_style{"S3_URI_REQUEST_STYLE"};        //  either "path" or "virtual_hosted" - default "path"
 const std::string  s3_restoration_days{"S3_RESTORATION_DAYS"};          //  number of days sent to the RestoreObject operation
 const std::string  s3_restoration_tier{"S3_RESTORATION_TIER"};          //  either "standard", "bulk", or "expedited"
@@ -155,6 +205,7 @@ const std::string  s3_enable_copyobject{"S3_ENABLE_COPYOBJECT"};       //  If se
 const std::string  s3_non_data_transfer_timeout_seconds{"S3_NON_DATA_TRANSFER_TIMEOUT_SECONDS"};
 const std::string  enable_direct_checksum_read("ENABLE_DIRECT_CHECKSUM_READ");
 const std::string  enable_trailing_checksum_on_upload("ENABLE_TRAILING_CHECKSUM_ON_UPLOAD");
+const std::string  enable_checksum_on_upload("ENABLE_CHECKSUM_ON_UPLOAD");   //  compute the default hash scheme while uploading
 
 const std::string  s3_number_of_threads{"S3_NUMBER_OF_THREADS"};        //  to save number of threads
 const std::size_t  S3_DEFAULT_RETRY_WAIT_SECONDS = 2;
@@ -166,6 +217,20 @@ const unsigned int S3_DEFAULT_NON_DATA_TRANSFER_TIMEOUT_SECONDS = 300;
 constexpr int64_t  LOWER_BOUND_MAX_UPLOAD_SIZE_MB = 5;
 constexpr int64_t  UPPER_BOUND_MAX_UPLOAD_SIZE_MB = 5 * 1024 * 1024;
 constexpr int64_t  DEFAULT_MAX_UPLOAD_SIZE_MB = 5 * 1024;
+constexpr int64_t  DEFAULT_COPY_PART_SIZE_MB = 512;
+constexpr int      DEFAULT_COPY_CONCURRENCY = 32;
+constexpr int      MAXIMUM_COPY_CONCURRENCY = 256;
+constexpr int      MAXIMUM_CHECKSUM_READ_THREADS = 256;
+constexpr int64_t  MAXIMUM_NUMBER_OF_PARTS = 10000;
+constexpr int64_t  DEFAULT_SMALL_OBJECT_UPLOAD_SIZE_KB = 4 * 1024;
+constexpr int64_t  MAXIMUM_READ_PAGE_SIZE_KB = 16 * 1024;
+constexpr int64_t  DEFAULT_READ_MERGE_DISTANCE_KB = 1024;
+constexpr int64_t  MAXIMUM_READ_MERGE_DISTANCE_KB = 256 * 1024;
+constexpr std::size_t DEFAULT_DEFERRED_DELETE_QUEUE_LIMIT = 100000;
+constexpr int      MAXIMUM_WARM_UP_CONNECTIONS = 32;                    //  size of the libs3 request pool
+constexpr int      WARM_UP_TIMEOUT_MS = 2000;                           //  a host slower than this to answer is not warmed up
+constexpr int      WARM_UP_STOP_TIMEOUT_MS = 2 * WARM_UP_TIMEOUT_MS;    //  how long stopping the resource waits for a warm up
+constexpr int      MAXIMUM_METADATA_CACHE_TTL_SECONDS = 300;
 
 const std::string  S3_STORAGE_CLASS_KW{"S3_STORAGE_CLASS"};
 
@@ -378,6 +443,20 @@ S3Status responsePropertiesCallback(
     if (properties->xAmzRestore) {
        data->x_amz_restore = properties->xAmzRestore;
     }
+    if (properties->eTag) {
+        data->etag = properties->eTag;
+    }
+
+    // read the checksum saved when the object was uploaded
+    for (int i = 0; i < properties->metaDataCount; ++i) {
+        namespace s3t = irods::experimental::io::s3_transport;
+        const S3NameValue& meta = properties->metaData[i];
+        if (boost::iequals(meta.name, s3t::constants::UPLOAD_CHECKSUM_METADATA_NAME)) {
+            data->upload_checksum = meta.value;
+        } else if (boost::iequals(meta.name, s3t::constants::UPLOAD_CHECKSUM_SCHEME_METADATA_NAME)) {
+            data->upload_checksum_scheme = meta.value;
+        }
+    }
 
     return S3StatusOK;
 }
@@ -501,59 +580,8 @@ irods::error parseS3Path (
     return SUCCESS();
 } // parseS3Path
 
-irods::error readS3AuthInfo (
-    const std::string& _filename,
-    std::string& _rtn_key_id,
-    std::string& _rtn_access_key,
-    irods::plugin_property_map& _prop_map )
-{
-    irods::error ret;
-    char inbuf[MAX_NAME_LEN];
-    int lineLen, bytesCopied;
-    int linecnt = 0;
-    char access_key_id[S3_MAX_KEY_SIZE];
-    char secret_access_key[S3_MAX_KEY_SIZE];
-
-    FILE* fptr = fopen(_filename.c_str(), "r");
-
-    std::string resource_name = get_resource_name(_prop_map);
-    const auto close_fptr = irods::at_scope_exit{[fptr] { if (fptr) fclose(fptr); }};
-
-    if (!fptr) {
-        return ERROR(SYS_CONFIG_FILE_ERR, fmt::format(
-                     "[resource_name={}] Failed to open S3 auth file: \"{}\", errno = \"{}\".",
-                     resource_name, _filename, strerror(errno)));
-    }
-
-    while ((lineLen = getLine (fptr, inbuf, MAX_NAME_LEN)) > 0) {
-        char *inPtr = inbuf;
-        if (linecnt == 0) {
-            while ((bytesCopied = getStrInBuf (&inPtr, access_key_id, &lineLen, S3_MAX_KEY_SIZE)) > 0) {
-                linecnt ++;
-                break;
-            }
-        } else if (linecnt == 1) {
-            while ((bytesCopied = getStrInBuf (&inPtr, secret_access_key, &lineLen, S3_MAX_KEY_SIZE)) > 0) {
-                linecnt ++;
-                break;
-            }
-        }
-    }
-
-    if (linecnt != 2) {
-        return ERROR(SYS_CONFIG_FILE_ERR, fmt::format(
-                     "[resource_name={}] Read {} lines in the auth file. Expected 2.",
-                     resource_name, linecnt));
-    }
-
-    _rtn_key_id = access_key_id;
-    _rtn_access_key = secret_access_key;
-
-    return SUCCESS();
-} // readS3AuthInfo
-
 /// @brief Retrieves the auth info from the resource's specified auth file and set the appropriate
-/// fields in the property map
+/// fields in the property map.  The credential provider keeps the keys current afterwards.
 irods::error s3ReadAuthInfo(
     irods::plugin_property_map& _prop_map)
 {
@@ -567,15 +595,23 @@ irods::error s3ReadAuthInfo(
                        resource_name), ret);
     }
 
-    std::string key_id;
-    std::string access_key;
-    ret = readS3AuthInfo(auth_file, key_id, access_key, _prop_map);
+    ret = irods_s3::read_credentials(_prop_map, auth_file);
     if (!ret.ok()) {
         return PASSMSG(fmt::format(
                        "[resource_name={}] Failed reading the authorization credentials file.",
                        resource_name), ret);
     }
 
+    std::shared_ptr<irods_s3::credential_provider> provider;
+    ret = irods_s3::get_credential_provider(_prop_map, provider);
+    if (!ret.ok()) {
+        return PASS(ret);
+    }
+
+    const irods_s3::s3_credentials& credentials = provider->current();
+    const std::string& key_id = credentials.key_id;
+    const std::string& access_key = credentials.access_key;
+
     ret = _prop_map.set<std::string>(s3_key_id, key_id);
     if (!ret.ok()) {
         return PASSMSG(fmt::format(
@@ -633,10 +669,21 @@ irods::error s3Init (
     return SUCCESS();
 }
 
-// initialization done on every operation
+// Called at the start of every operation.  The S3 library is initialized once for the process
+// (normally when the resource starts) and kept until the last resource stops, so this only checks
+// a flag.  Initializing per operation tore down the pooled requests and their connections.
 irods::error s3InitPerOperation (
     irods::plugin_property_map& _prop_map ) {
 
+    if (S3Initialized.load(std::memory_order_acquire)) {
+        return SUCCESS();
+    }
+
+    boost::lock_guard<boost::mutex> lock(g_s3InitLock);
+    if (S3Initialized.load(std::memory_order_relaxed)) {
+        return SUCCESS();
+    }
+
     std::string resource_name = get_resource_name(_prop_map);
 
     std::size_t retry_count = S3_DEFAULT_RETRY_COUNT;
@@ -670,6 +717,7 @@ irods::error s3InitPerOperation (
                 s3_logger::error( "[resource_name={}] Failed to retrieve S3 region name from resource plugin properties, using 'us-east-1'", resource_name.c_str());
             }
 
+            S3Initialized.store(true, std::memory_order_release);
             return SUCCESS();
         }
 
@@ -809,6 +857,197 @@ ssize_t s3GetMPUThreads (
     return threads;
 }
 
+// returns the part size for server-side multipart copies (UploadPartCopy), in bytes
+// This is independent of S3_MPU_CHUNK as no data passes through this server during
+// a copy, so larger parts simply mean fewer requests.  It is also the threshold above
+// which a multipart copy is used instead of a single CopyObject.
+std::int64_t s3_get_copy_part_size(irods::plugin_property_map& _prop_map)
+{
+    std::int64_t max_megs = s3GetMaxUploadSizeMB(_prop_map);
+    std::int64_t megs = std::min(DEFAULT_COPY_PART_SIZE_MB, max_megs);
+
+    std::string part_size_str;
+    irods::error ret = _prop_map.get<std::string>(s3_copy_part_size_mb, part_size_str);
+    if (ret.ok()) {
+        try {
+            std::int64_t parse = boost::lexical_cast<std::int64_t>(part_size_str);
+            if (parse >= LOWER_BOUND_MAX_UPLOAD_SIZE_MB && parse <= max_megs) {
+                megs = parse;
+            } else {
+                std::string resource_name = get_resource_name(_prop_map);
+                s3_logger::warn("[resource_name={}] {} [{}] must be between {} and {}.  Using {}.",
+                        resource_name, s3_copy_part_size_mb, part_size_str, LOWER_BOUND_MAX_UPLOAD_SIZE_MB, max_megs, megs);
+            }
+        } catch ( const boost::bad_lexical_cast& ) {
+            std::string resource_name = get_resource_name(_prop_map);
+            s3_logger::error(
+                "[resource_name={}] failed to cast {} [{}] to a std::int64_t", resource_name,
+                s3_copy_part_size_mb, part_size_str);
+        }
+    }
+    return megs * 1024 * 1024;
+}
+
+// returns the number of UploadPartCopy requests that are kept in flight during a multipart copy
+int s3_get_copy_concurrency(irods::plugin_property_map& _prop_map)
+{
+    int concurrency = DEFAULT_COPY_CONCURRENCY;
+
+    std::string concurrency_str;
+    irods::error ret = _prop_map.get<std::string>(s3_copy_concurrency, concurrency_str);
+    if (ret.ok()) {
+        try {
+            int parse = boost::lexical_cast<int>(concurrency_str);
+            if (parse >= 1 && parse <= MAXIMUM_COPY_CONCURRENCY) {
+                concurrency = parse;
+            } else {
+                std::string resource_name = get_resource_name(_prop_map);
+                s3_logger::warn("[resource_name={}] {} [{}] must be between 1 and {}.  Using {}.",
+                        resource_name, s3_copy_concurrency, concurrency_str, MAXIMUM_COPY_CONCURRENCY, concurrency);
+            }
+        } catch ( const boost::bad_lexical_cast& ) {
+            std::string resource_name = get_resource_name(_prop_map);
+            s3_logger::error(
+                "[resource_name={}] failed to cast {} [{}] to an int", resource_name,
+                s3_copy_concurrency, concurrency_str);
+        }
+    }
+    return concurrency;
+}
+
+// returns the number of concurrent ranged GETs used to compute the checksum of an object when
+// S3 does not provide it.  Zero means the checksum is left to the server.
+int s3_get_checksum_read_threads(irods::plugin_property_map& _prop_map)
+{
+    int threads = 0;
+
+    std::string threads_str;
+    irods::error ret = _prop_map.get<std::string>(s3_checksum_read_threads, threads_str);
+    if (ret.ok()) {
+        try {
+            int parse = boost::lexical_cast<int>(threads_str);
+            if (parse >= 0 && parse <= MAXIMUM_CHECKSUM_READ_THREADS) {
+                threads = parse;
+            } else {
+                std::string resource_name = get_resource_name(_prop_map);
+                s3_logger::warn("[resource_name={}] {} [{}] must be between 0 and {}.  Using {}.",
+                        resource_name, s3_checksum_read_threads, threads_str, MAXIMUM_CHECKSUM_READ_THREADS, threads);
+            }
+        } catch ( const boost::bad_lexical_cast& ) {
+            std::string resource_name = get_resource_name(_prop_map);
+            s3_logger::error(
+                "[resource_name={}] failed to cast {} [{}] to an int", resource_name,
+                s3_checksum_read_threads, threads_str);
+        }
+    }
+    return threads;
+}
+
+// returns the size, in bytes, up to which a single threaded put is buffered in memory and
+// written with a single PUT on close rather than streamed through shared memory and an
+// upload thread.  Zero disables the small object fast path.
+std::int64_t s3_get_small_object_upload_size(irods::plugin_property_map& _prop_map)
+{
+    std::int64_t max_kb = s3GetMaxUploadSizeMB(_prop_map) * 1024;
+    std::int64_t kb = std::min(DEFAULT_SMALL_OBJECT_UPLOAD_SIZE_KB, max_kb);
+
+    std::string size_str;
+    irods::error ret = _prop_map.get<std::string>(s3_small_object_upload_size_kb, size_str);
+    if (ret.ok()) {
+        try {
+            std::int64_t parse = boost::lexical_cast<std::int64_t>(size_str);
+            if (parse >= 0 && parse <= max_kb) {
+                kb = parse;
+            } else {
+                std::string resource_name = get_resource_name(_prop_map);
+                s3_logger::warn("[resource_name={}] {} [{}] must be between 0 and {}.  Using {}.",
+                        resource_name, s3_small_object_upload_size_kb, size_str, max_kb, kb);
+            }
+        } catch ( const boost::bad_lexical_cast& ) {
+            std::string resource_name = get_resource_name(_prop_map);
+            s3_logger::error(
+                "[resource_name={}] failed to cast {} [{}] to a std::int64_t", resource_name,
+                s3_small_object_upload_size_kb, size_str);
+        }
+    }
+    return kb * 1024;
+}
+
+// s3_get_read_cache_size - returns the size of the read cache in bytes.  Default is 0 (disabled).
+std::int64_t s3_get_read_cache_size(irods::plugin_property_map& _prop_map)
+{
+    // the cache holds at most this many 4MB blocks
+    const std::int64_t max_mb = irods::experimental::io::s3_transport::read_cache_index::MAXIMUM_NUMBER_OF_BLOCKS *
+        (irods::experimental::io::s3_transport::read_cache::BLOCK_SIZE / (1024 * 1024));
+    std::int64_t mb = 0;
+
+    std::string size_str;
+    irods::error ret = _prop_map.get<std::string>(s3_read_cache_size_mb, size_str);
+    if (ret.ok()) {
+        try {
+            std::int64_t parse = boost::lexical_cast<std::int64_t>(size_str);
+            if (parse >= 0 && parse <= max_mb) {
+                mb = parse;
+            } else {
+                mb = parse < 0 ? 0 : max_mb;
+                std::string resource_name = get_resource_name(_prop_map);
+                s3_logger::warn("[resource_name={}] {} [{}] must be between 0 and {}.  Using {}.",
+                        resource_name, s3_read_cache_size_mb, size_str, max_mb, mb);
+            }
+        } catch ( const boost::bad_lexical_cast& ) {
+            std::string resource_name = get_resource_name(_prop_map);
+            s3_logger::error(
+                "[resource_name={}] failed to cast {} [{}] to a std::int64_t", resource_name,
+                s3_read_cache_size_mb, size_str);
+        }
+    }
+    return mb * 1024 * 1024;
+}
+
+// Returns the KB setting _name between 0 and _max_kb in bytes or _default_kb if it is not set
+// or is not valid
+static std::int64_t get_read_page_cache_setting(irods::plugin_property_map& _prop_map,
+        const std::string& _name, std::int64_t _default_kb, std::int64_t _max_kb)
+{
+    std::int64_t kb = _default_kb;
+
+    std::string size_str;
+    irods::error ret = _prop_map.get<std::string>(_name, size_str);
+    if (ret.ok()) {
+        try {
+            std::int64_t parse = boost::lexical_cast<std::int64_t>(size_str);
+            if (parse >= 0 && parse <= _max_kb) {
+                kb = parse;
+            } else {
+                std::string resource_name = get_resource_name(_prop_map);
+                s3_logger::warn("[resource_name={}] {} [{}] must be between 0 and {}.  Using {}.",
+                        resource_name, _name, size_str, _max_kb, kb);
+            }
+        } catch ( const boost::bad_lexical_cast& ) {
+            std::string resource_name = get_resource_name(_prop_map);
+            s3_logger::error(
+                "[resource_name={}] failed to cast {} [{}] to a std::int64_t", resource_name,
+                _name, size_str);
+        }
+    }
+    return kb * 1024;
+}
+
+// s3_get_read_page_size - returns the page size of the cache for small reads in bytes.
+// Default is 0 (disabled).
+std::int64_t s3_get_read_page_size(irods::plugin_property_map& _prop_map)
+{
+    return get_read_page_cache_setting(_prop_map, s3_read_page_size_kb, 0, MAXIMUM_READ_PAGE_SIZE_KB);
+}
+
+// s3_get_read_merge_distance - returns the distance in bytes within which small reads are
+// merged.  Default is 1MB.
+std::int64_t s3_get_read_merge_distance(irods::plugin_property_map& _prop_map)
+{
+    return get_read_page_cache_setting(_prop_map, s3_read_merge_distance_kb,
+            DEFAULT_READ_MERGE_DISTANCE_KB, MAXIMUM_READ_MERGE_DISTANCE_KB);
+}
+
 bool s3GetEnableMultiPartUpload (
     irods::plugin_property_map& _prop_map )
 {
@@ -1276,89 +1515,319 @@ bool s3_trailing_checksum_on_upload_enabled(
 	return enable_flag;
 } // end enable_trailing_checksum_on_upload
 
-irods::error s3GetFile(
-    const std::string& _filename,
-    const std::string& _s3ObjName,
-    rodsLong_t _fileSize,
-    const std::string& _key_id,
-    const std::string& _access_key,
-    irods::plugin_property_map& _prop_map )
+// s3_get_checksum_on_upload_scheme - returns the server's default hash scheme if
+// checksums are computed on upload, otherwise an empty string.  Default is disabled.
+std::string s3_get_checksum_on_upload_scheme(
+		irods::plugin_property_map& _prop_map )
 {
-    std::string resource_name = get_resource_name(_prop_map);
-
-    std::size_t retry_count_limit = get_retry_count(_prop_map);
-    std::size_t retry_wait = get_retry_wait_time_sec(_prop_map);
-    std::size_t max_retry_wait = get_max_retry_wait_time_sec(_prop_map);
-
-    std::string bucket;
-    std::string key;
-    auto ret = parseS3Path(_s3ObjName, bucket, key, _prop_map);
-    if (!ret.ok()) {
-        return PASSMSG(fmt::format(
-                    "[resource_name={}] Failed parsing the S3 bucket and key from the physical path: \"{}\".",
-                    resource_name, _s3ObjName), ret);
-    }
+	std::string enable_str;
 
-    ret = s3InitPerOperation( _prop_map );
-    if (!ret.ok()) {
-        return PASSMSG(fmt::format(
-                    "[resource_name={}] Failed to initialize the S3 system.",
-                    resource_name), ret);
-    }
+	irods::error ret = _prop_map.get< std::string >(
+			enable_checksum_on_upload,
+			enable_str );
+	if (!ret.ok() || "0" == enable_str) {
+		return "";
+	}
 
-    int cache_fd = -1;
-    cache_fd = open(_filename.c_str(), O_RDWR|O_CREAT|O_TRUNC, S_IRUSR|S_IWUSR);
-    if (-1 == cache_fd) {
-        return ERROR(UNIX_FILE_OPEN_ERR, fmt::format(
-                    "[resource_name={}] Failed to open the cache file: \"{}\".",
-                    resource_name, _filename));
-    }
+	std::string resource_name = get_resource_name(_prop_map);
+	if ("1" != enable_str) {
+		s3_logger::warn("[resource_name={}] Invalid value for {} of {}. The value should be 0 or 1. Defaulting to 0.",
+				resource_name, enable_checksum_on_upload, enable_str);
+		return "";
+	}
 
-    callback_data_t data;
-    S3BucketContext bucketContext{};
-    bucketContext.bucketName = bucket.c_str();
-    bucketContext.protocol = s3GetProto(_prop_map);
-    bucketContext.stsDate = s3GetSTSDate(_prop_map);
-    bucketContext.uriStyle = s3_get_uri_request_style(_prop_map);
-    bucketContext.accessKeyId = _key_id.c_str();
-    bucketContext.secretAccessKey = _access_key.c_str();
-    std::string authRegionStr = get_region_name(_prop_map);
-    bucketContext.authRegion = authRegionStr.c_str();
+	// this is the scheme iRODS uses when the client does not request one
+	std::string scheme{"sha256"};
+	try {
+		scheme = irods::get_server_property<const std::string>(irods::KW_CFG_DEFAULT_HASH_SCHEME);
+	}
+	catch (const irods::exception& e) {
+		s3_logger::debug("[resource_name={}] {} not found in server configuration, using {}.",
+				resource_name, irods::KW_CFG_DEFAULT_HASH_SCHEME, scheme);
+	}
+	boost::algorithm::to_lower(scheme);
+	return scheme;
+} // end s3_get_checksum_on_upload_scheme
 
-    std::int64_t chunksize = s3GetMPUChunksize( _prop_map );
+// s3_cache_io_uring_enabled - default is false
+bool s3_cache_io_uring_enabled(
+		irods::plugin_property_map& _prop_map )
+{
+	std::string enable_str;
+	bool enable_flag = false;
 
-    if ( _fileSize < chunksize ) {
-        S3GetObjectHandler getObjectHandler = {
-            { &responsePropertiesCallback, &responseCompleteCallback },
-            &getObjectDataCallback
-        };
+	irods::error ret = _prop_map.get< std::string >(
+			s3_cache_io_uring,
+			enable_str );
+	if (ret.ok()) {
+		// Only 0 = no, 1 = yes.
+		if ("0" != enable_str && "1" != enable_str) {
+			std::string resource_name = get_resource_name(_prop_map);
+			s3_logger::warn("[resource_name={}] Invalid value for {} of {}. The value should be 0 or 1. Defaulting to 0.",
+					resource_name, s3_cache_io_uring, enable_str);
+		}
+		else if ("1" == enable_str) {
+			enable_flag = true;
+		}
+	}
+	return enable_flag;
+} // end s3_cache_io_uring_enabled
 
-        std::size_t retry_cnt = 0;
-        do {
-            data = {};
-            data.prop_map_ptr = &_prop_map;
-            data.fd = cache_fd;
-            data.contentLength = data.originalContentLength = _fileSize;
-            std::uint64_t usStart = usNow();
-            std::string&& hostname = s3GetHostname(_prop_map);
-            bucketContext.hostName = hostname.c_str(); // Safe to do, this is a local copy of the data structure
-            data.pCtx = &bucketContext;
-            S3_get_object (&bucketContext, key.c_str(), NULL, 0, _fileSize, 0, 0, &getObjectHandler, &data);
-            std::uint64_t usEnd = usNow();
-            double bw = (_fileSize / (1024.0*1024.0)) / ( (usEnd - usStart) / 1000000.0 );
-            s3_logger::debug("GETBW={}", bw);
-            if (data.status != S3StatusOK) {
-                s3_sleep( retry_wait );
-                retry_wait *= 2;
-                if (retry_wait > max_retry_wait) {
-                    retry_wait = max_retry_wait;
-                }
-            }
-        } while ( (data.status != S3StatusOK) && S3_status_is_retryable(data.status) && (++retry_cnt <= retry_count_limit) );
+// s3_sparse_cache_file_enabled - default is false
+bool s3_sparse_cache_file_enabled(
+		irods::plugin_property_map& _prop_map )
+{
+	std::string enable_str;
+	bool enable_flag = false;
 
-        if (data.status != S3StatusOK) {
+	irods::error ret = _prop_map.get< std::string >(
+			s3_sparse_cache_file,
+			enable_str );
+	if (ret.ok()) {
+		// Only 0 = no, 1 = yes.
+		if ("0" != enable_str && "1" != enable_str) {
+			std::string resource_name = get_resource_name(_prop_map);
+			s3_logger::warn("[resource_name={}] Invalid value for {} of {}. The value should be 0 or 1. Defaulting to 0.",
+					resource_name, s3_sparse_cache_file, enable_str);
+		}
+		else if ("1" == enable_str) {
+			enable_flag = true;
+		}
+	}
+	return enable_flag;
+} // end s3_sparse_cache_file_enabled
 
-            auto msg = fmt::format("[resource_name={}]  {} - Error fetching the S3 object: \"{}\"",
+// s3_deferred_delete_enabled - default is false
+//
+// The journal is local to this server so deletes are only deferred in attached mode, and it
+// must survive restarts so S3_CACHE_DIR must be set rather than defaulting to the temporary
+// directory.  Otherwise unlinks delete the object synchronously.
+bool s3_deferred_delete_enabled(
+		irods::plugin_property_map& _prop_map )
+{
+	std::string enable_str;
+	bool enable_flag = false;
+
+	irods::error ret = _prop_map.get< std::string >(
+			s3_deferred_delete,
+			enable_str );
+	if (ret.ok()) {
+		// Only 0 = no, 1 = yes.
+		if ("0" != enable_str && "1" != enable_str) {
+			std::string resource_name = get_resource_name(_prop_map);
+			s3_logger::warn("[resource_name={}] Invalid value for {} of {}. The value should be 0 or 1. Defaulting to 0.",
+					resource_name, s3_deferred_delete, enable_str);
+		}
+		else if ("1" == enable_str) {
+			enable_flag = true;
+		}
+	}
+
+	if (enable_flag) {
+		const auto [cacheless_mode, attached_mode] = get_modes_from_properties(_prop_map);
+		std::string cache_dir_str;
+		if (!attached_mode) {
+			s3_logger::warn("[resource_name={}] {} is ignored in detached mode, deleting objects synchronously.",
+					get_resource_name(_prop_map), s3_deferred_delete);
+			enable_flag = false;
+		}
+		else if (!_prop_map.get< std::string >(s3_cache_dir, cache_dir_str).ok()) {
+			s3_logger::warn("[resource_name={}] {} requires {} to be set to a directory that persists across restarts, "
+					"deleting objects synchronously.", get_resource_name(_prop_map), s3_deferred_delete, s3_cache_dir);
+			enable_flag = false;
+		}
+	}
+	return enable_flag;
+} // end s3_deferred_delete_enabled
+
+// returns the number of queued deletes above which unlinks delete the object themselves
+std::size_t s3_get_deferred_delete_queue_limit(irods::plugin_property_map& _prop_map)
+{
+    std::size_t limit = DEFAULT_DEFERRED_DELETE_QUEUE_LIMIT;
+
+    std::string limit_str;
+    irods::error ret = _prop_map.get<std::string>(s3_deferred_delete_queue_limit, limit_str);
+    if (ret.ok()) {
+        try {
+            std::size_t parse = boost::lexical_cast<std::size_t>(limit_str);
+            if (parse >= 1) {
+                limit = parse;
+            } else {
+                std::string resource_name = get_resource_name(_prop_map);
+                s3_logger::warn("[resource_name={}] {} [{}] must be at least 1.  Using {}.",
+                        resource_name, s3_deferred_delete_queue_limit, limit_str, limit);
+            }
+        } catch ( const boost::bad_lexical_cast& ) {
+            std::string resource_name = get_resource_name(_prop_map);
+            s3_logger::error(
+                "[resource_name={}] failed to cast {} [{}] to an unsigned integer", resource_name,
+                s3_deferred_delete_queue_limit, limit_str);
+        }
+    }
+    return limit;
+}
+
+// returns the number of connections opened to each host when the resource starts
+int s3_get_warm_up_connections(irods::plugin_property_map& _prop_map)
+{
+    int connections = 0;
+
+    std::string connections_str;
+    irods::error ret = _prop_map.get<std::string>(s3_warm_up_connections, connections_str);
+    if (ret.ok()) {
+        try {
+            int parse = boost::lexical_cast<int>(connections_str);
+            if (parse >= 0 && parse <= MAXIMUM_WARM_UP_CONNECTIONS) {
+                connections = parse;
+            } else {
+                std::string resource_name = get_resource_name(_prop_map);
+                s3_logger::warn("[resource_name={}] {} [{}] must be between 0 and {}.  Using {}.",
+                        resource_name, s3_warm_up_connections, connections_str, MAXIMUM_WARM_UP_CONNECTIONS, connections);
+            }
+        } catch ( const boost::bad_lexical_cast& ) {
+            std::string resource_name = get_resource_name(_prop_map);
+            s3_logger::error(
+                "[resource_name={}] failed to cast {} [{}] to an int", resource_name,
+                s3_warm_up_connections, connections_str);
+        }
+    }
+    return connections;
+}
+
+// returns how long the result of a HEAD request is reused, 0 if it is not
+int s3_get_metadata_cache_ttl_seconds(irods::plugin_property_map& _prop_map)
+{
+    int ttl = 0;
+
+    std::string ttl_str;
+    irods::error ret = _prop_map.get<std::string>(s3_metadata_cache_ttl_seconds, ttl_str);
+    if (ret.ok()) {
+        try {
+            int parse = boost::lexical_cast<int>(ttl_str);
+            if (parse >= 0 && parse <= MAXIMUM_METADATA_CACHE_TTL_SECONDS) {
+                ttl = parse;
+            } else {
+                std::string resource_name = get_resource_name(_prop_map);
+                s3_logger::warn("[resource_name={}] {} [{}] must be between 0 and {}.  Using {}.",
+                        resource_name, s3_metadata_cache_ttl_seconds, ttl_str, MAXIMUM_METADATA_CACHE_TTL_SECONDS, ttl);
+            }
+        } catch ( const boost::bad_lexical_cast& ) {
+            std::string resource_name = get_resource_name(_prop_map);
+            s3_logger::error(
+                "[resource_name={}] failed to cast {} [{}] to an int", resource_name,
+                s3_metadata_cache_ttl_seconds, ttl_str);
+        }
+    }
+    return ttl;
+}
+
+// s3_list_objects_v2_enabled - default is true
+bool s3_list_objects_v2_enabled(
+		irods::plugin_property_map& _prop_map )
+{
+	std::string enable_str;
+	bool enable_flag = true;
+
+	irods::error ret = _prop_map.get< std::string >(
+			s3_enable_list_objects_v2,
+			enable_str );
+	if (ret.ok()) {
+		// Only 0 = no, 1 = yes.
+		if ("0" != enable_str && "1" != enable_str) {
+			std::string resource_name = get_resource_name(_prop_map);
+			s3_logger::warn("[resource_name={}] Invalid value for {} of {}. The value should be 0 or 1. Defaulting to 1.",
+					resource_name, s3_enable_list_objects_v2, enable_str);
+		}
+		else if ("0" == enable_str) {
+			enable_flag = false;
+		}
+	}
+	return enable_flag;
+} // end s3_list_objects_v2_enabled
+
+irods::error s3GetFile(
+    const std::string& _filename,
+    const std::string& _s3ObjName,
+    rodsLong_t _fileSize,
+    const std::string& _key_id,
+    const std::string& _access_key,
+    irods::plugin_property_map& _prop_map )
+{
+    std::string resource_name = get_resource_name(_prop_map);
+
+    std::size_t retry_count_limit = get_retry_count(_prop_map);
+    std::size_t retry_wait = get_retry_wait_time_sec(_prop_map);
+    std::size_t max_retry_wait = get_max_retry_wait_time_sec(_prop_map);
+
+    std::string bucket;
+    std::string key;
+    auto ret = parseS3Path(_s3ObjName, bucket, key, _prop_map);
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed parsing the S3 bucket and key from the physical path: \"{}\".",
+                    resource_name, _s3ObjName), ret);
+    }
+
+    ret = s3InitPerOperation( _prop_map );
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to initialize the S3 system.",
+                    resource_name), ret);
+    }
+
+    int cache_fd = -1;
+    cache_fd = open(_filename.c_str(), O_RDWR|O_CREAT|O_TRUNC, S_IRUSR|S_IWUSR);
+    if (-1 == cache_fd) {
+        return ERROR(UNIX_FILE_OPEN_ERR, fmt::format(
+                    "[resource_name={}] Failed to open the cache file: \"{}\".",
+                    resource_name, _filename));
+    }
+
+    callback_data_t data;
+    S3BucketContext bucketContext{};
+    bucketContext.bucketName = bucket.c_str();
+    bucketContext.protocol = s3GetProto(_prop_map);
+    bucketContext.stsDate = s3GetSTSDate(_prop_map);
+    bucketContext.uriStyle = s3_get_uri_request_style(_prop_map);
+    bucketContext.accessKeyId = _key_id.c_str();
+    bucketContext.secretAccessKey = _access_key.c_str();
+    std::string authRegionStr = get_region_name(_prop_map);
+    bucketContext.authRegion = authRegionStr.c_str();
+
+    std::int64_t chunksize = s3GetMPUChunksize( _prop_map );
+
+    if ( _fileSize < chunksize ) {
+        S3GetObjectHandler getObjectHandler = {
+            { &responsePropertiesCallback, &responseCompleteCallback },
+            &getObjectDataCallback
+        };
+
+        std::size_t retry_cnt = 0;
+        do {
+            data = {};
+            data.prop_map_ptr = &_prop_map;
+            data.fd = cache_fd;
+            data.contentLength = data.originalContentLength = _fileSize;
+            std::uint64_t usStart = usNow();
+            std::string&& hostname = s3GetHostname(_prop_map);
+            bucketContext.hostName = hostname.c_str(); // Safe to do, this is a local copy of the data structure
+            data.pCtx = &bucketContext;
+            S3_get_object (&bucketContext, key.c_str(), NULL, 0, _fileSize, 0, 0, &getObjectHandler, &data);
+            std::uint64_t usEnd = usNow();
+            double bw = (_fileSize / (1024.0*1024.0)) / ( (usEnd - usStart) / 1000000.0 );
+            s3_logger::debug("GETBW={}", bw);
+            if (data.status != S3StatusOK) {
+                s3_sleep( retry_wait );
+                retry_wait *= 2;
+                if (retry_wait > max_retry_wait) {
+                    retry_wait = max_retry_wait;
+                }
+            }
+        } while ( (data.status != S3StatusOK) && S3_status_is_retryable(data.status) && (++retry_cnt <= retry_count_limit) );
+
+        if (data.status != S3StatusOK) {
+
+            auto msg = fmt::format("[resource_name={}]  {} - Error fetching the S3 object: \"{}\"",
                     resource_name,
                     __FUNCTION__,
                     _s3ObjName);
@@ -1654,6 +2123,14 @@ static void mpuWorkerThread (
         g_mpuNext = g_mpuNext + 1;
         g_mpuLock.unlock();
 
+        // start reading this part of the cache file ahead of the upload
+        if (g_mpuData[seq-1].mode == S3_PUTFILE) {
+            posix_fadvise(g_mpuData[seq-1].put_object_data.fd,
+                    g_mpuData[seq-1].put_object_data.offset,
+                    g_mpuData[seq-1].put_object_data.contentLength,
+                    POSIX_FADV_WILLNEED);
+        }
+
         multipart_data_t partData;
         std::size_t retry_cnt = 0;
         do {
@@ -1788,6 +2265,11 @@ irods::error s3PutCopyFile(
                     resource_name, _filename));
     }
 
+    // The parts are read with pread() on this descriptor.  Advisory only.
+    if (_mode == S3_PUTFILE) {
+        posix_fadvise(cache_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
     callback_data_t data;
     S3BucketContext bucketContext{};
     bucketContext.bucketName = bucket.c_str();
@@ -2098,65 +2580,1365 @@ irods::error s3PutCopyFile(
 } // s3PutCopyFile
 
 
-/// @brief Function to copy the specified src file to the specified dest file
-irods::error s3CopyFile(
-    irods::plugin_context& _src_ctx,
-    const std::string& _src_file,
-    const std::string& _dest_file,
-    const std::string& _key_id,
-    const std::string& _access_key,
-    const S3Protocol _proto,
-    const S3STSDate _stsDate,
-    const S3UriStyle _s3_uri_style)
-{
-    std::string src_bucket;
-    std::string src_key;
-    std::string dest_bucket;
-    std::string dest_key;
+/******************* Multipart Initiate/Complete Helpers *****************************/
 
-    std::size_t retry_count_limit = get_retry_count(_src_ctx.prop_map());
-    std::size_t retry_wait = get_retry_wait_time_sec(_src_ctx.prop_map());
-    std::size_t max_retry_wait = get_max_retry_wait_time_sec(_src_ctx.prop_map());
+// Initiates a multipart upload of _key, retrying while the failure is retryable.
+// On success the upload id is left in _manager.upload_id and must be freed by the caller.
+static irods::error s3_initiate_multipart_with_retry(
+    irods::plugin_property_map& _prop_map,
+    S3BucketContext& _bucket_context,
+    const std::string& _key,
+    S3PutProperties* _put_props,
+    upload_manager_t& _manager,
+    int _error_code)
+{
+    std::string resource_name = get_resource_name(_prop_map);
 
-    std::string resource_name = get_resource_name(_src_ctx.prop_map());
+    std::size_t retry_count_limit = get_retry_count(_prop_map);
+    std::size_t retry_wait = get_retry_wait_time_sec(_prop_map);
+    std::size_t max_retry_wait = get_max_retry_wait_time_sec(_prop_map);
 
-    bool mpu_enabled = s3GetEnableMultiPartUpload(_src_ctx.prop_map());
+    std::size_t retry_cnt = 0;
+    S3MultipartInitialHandler mpuInitialHandler = { {mpuInitRespPropCB, mpuInitRespCompCB }, mpuInitXmlCB };
+    do {
+        std::string&& hostname = s3GetHostname(_prop_map);
+        _bucket_context.hostName = hostname.c_str(); // Safe to do, this is a local copy of the data structure
+        _manager.pCtx = &_bucket_context;
+        S3_initiate_multipart(&_bucket_context, _key.c_str(), _put_props, &mpuInitialHandler, NULL, 0, &_manager);
+        if (_manager.status != S3StatusOK) {
+            s3_sleep( retry_wait );
+            retry_wait *= 2;
+            if (retry_wait > max_retry_wait) {
+                retry_wait = max_retry_wait;
+            }
+        }
+    } while ( (_manager.status != S3StatusOK) && S3_status_is_retryable(_manager.status) && ( ++retry_cnt <= retry_count_limit));
+    if (_manager.upload_id == NULL || _manager.status != S3StatusOK) {
+        auto msg = fmt::format("[resource_name={}] {} - Error initiating multipart upload of the S3 object: \"{}\"",
+                resource_name,
+                __FUNCTION__,
+                _key);
 
-    // Check the size, and if too large punt to the multipart copy/put routine
-    struct stat statbuf = {};
-    auto ret = irods_s3::s3_file_stat_operation( _src_ctx, &statbuf );
-    if (!ret.ok()) {
-        return PASSMSG(fmt::format(
-                    "[resource_name={}] Unable to get original object size for source file name: \"{}\".",
-                    resource_name, _src_file), ret);
+        if(_manager.status >= 0) {
+            msg += fmt::format(" - \"{}\"", S3_get_status_name((S3Status)_manager.status));
+        }
+        s3_logger::error( msg );
+        return ERROR( _error_code, msg );
     }
+    return SUCCESS();
+}
 
-    // if we are too big for a copy then we must upload
-    // however, only do this is mpu is disabled
-    if ( mpu_enabled && statbuf.st_size > s3GetMaxUploadSizeMB(_src_ctx.prop_map()) * 1024 * 1024 ) {   // amazon allows copies up to 5 GB
-        return s3PutCopyFile( S3_COPYOBJECT, _src_file, _dest_file, statbuf.st_size, _key_id, _access_key, _src_ctx.prop_map() );
-    }
+// Completes the multipart upload in _manager by sending the part list in _xml,
+// retrying while the failure is retryable.
+static irods::error s3_complete_multipart_with_retry(
+    irods::plugin_property_map& _prop_map,
+    S3BucketContext& _bucket_context,
+    const std::string& _key,
+    std::string& _xml,
+    upload_manager_t& _manager,
+    int _error_code)
+{
+    std::string resource_name = get_resource_name(_prop_map);
 
-    // Note:  If file size > s3GetMaxUploadSizeMB() but multipart is disabled, it is not clear how to proceed.
-    // Go ahead and try a copy.
+    std::size_t retry_count_limit = get_retry_count(_prop_map);
+    std::size_t retry_wait = get_retry_wait_time_sec(_prop_map);
+    std::size_t max_retry_wait = get_max_retry_wait_time_sec(_prop_map);
+    unsigned int non_data_transfer_timeout_ms = get_non_data_transfer_timeout_seconds(_prop_map) * 1000;
 
-    // Parse the src file
-    ret = parseS3Path(_src_file, src_bucket, src_key, _src_ctx.prop_map());
-    if (!ret.ok()) {
-        return PASSMSG(fmt::format(
-                    "[resource_name={}] Failed to parse the source file name: \"{}\".",
-                    resource_name, _src_file), ret);
-    }
+    std::size_t retry_cnt = 0;
+    S3MultipartCommitHandler commit_handler = { {mpuCommitRespPropCB, mpuCommitRespCompCB }, mpuCommitXmlCB, NULL };
+    do {
+        // On partial error, need to restart XML send from the beginning
+        _manager.xml = _xml.data();
+        _manager.remaining = _xml.size();
+        _manager.offset = 0;
+        std::string&& hostname = s3GetHostname(_prop_map);
+        _bucket_context.hostName = hostname.c_str(); // Safe to do, this is a local copy of the data structure
+        _manager.pCtx = &_bucket_context;
+        S3_complete_multipart_upload(&_bucket_context, _key.c_str(), &commit_handler, _manager.upload_id, _manager.remaining,
+                nullptr, nullptr, non_data_transfer_timeout_ms, &_manager);
+        if (_manager.status != S3StatusOK) {
+            s3_sleep( retry_wait );
+            retry_wait *= 2;
+            if (retry_wait > max_retry_wait) {
+                retry_wait = max_retry_wait;
+            }
+        }
+    } while ((_manager.status != S3StatusOK) && S3_status_is_retryable(_manager.status) && ( ++retry_cnt <= retry_count_limit));
+    _manager.xml = NULL;
 
-    // Parse the dest file
-    ret = parseS3Path(_dest_file, dest_bucket, dest_key, _src_ctx.prop_map());
-    if (!ret.ok()) {
-        return PASSMSG(fmt::format(
-                    "[resource_name={}] Failed to parse the destination file name: \"{}\".",
-                    resource_name, _dest_file), ret);
+    if (_manager.status != S3StatusOK) {
+        auto msg = fmt::format("[resource_name={}] {} - Error completing the multipart upload of the S3 object: \"{}\"",
+                resource_name,
+                __FUNCTION__,
+                _key);
+
+        if(_manager.status >= 0) {
+            msg += fmt::format(" - \"{}\"", S3_get_status_name((S3Status)_manager.status));
+        }
+        s3_logger::error( msg );
+        return ERROR( _error_code, msg );
     }
+    return SUCCESS();
+}
 
-    callback_data_t data;
+
+/******************* Server-side Multipart Copy *****************************/
+
+// State for a single UploadPartCopy request.  These are driven through a libs3
+// request context so many parts can be in flight from a single thread.
+typedef struct copy_part
+{
+    int seq;
+    std::int64_t offset;
+    std::int64_t length;
+    std::size_t retry_cnt;
+    std::size_t retry_wait;
+    std::uint64_t not_before;          // usNow() timestamp before which a retry is not started
+    S3Status status;
+    std::string hostname;
+    S3BucketContext src_ctx;           // per-request copy so each part can use its own host
+    std::int64_t last_modified;
+    char etag[512];
+    std::vector<struct copy_part*> *completed;
+} copy_part_t;
+
+static S3Status copyPartRespPropCB (
+    const S3ResponseProperties *properties,
+    void *callbackData)
+{
+    return S3StatusOK;
+}
+
+static void copyPartRespCompCB (
+    S3Status status,
+    const S3ErrorDetails *error,
+    void *callbackData)
+{
+    copy_part_t *part = (copy_part_t *)callbackData;
+    StoreAndLogStatus( status, error, __FUNCTION__, &part->src_ctx, &part->status );
+    // Hand the part back to the copy loop which decides whether to retry it
+    part->completed->push_back(part);
+}
+
+/// @brief Copies an object with UploadPartCopy requests that are run concurrently through
+///        a libs3 request context.  The part size is chosen independently of S3_MPU_CHUNK
+///        as no data passes through this server.
+irods::error s3_copy_object_multipart(
+    irods::plugin_property_map& _prop_map,
+    const std::string& _src_file,
+    const std::string& _dest_file,
+    rodsLong_t _object_size,
+    const std::string& _key_id,
+    const std::string& _access_key)
+{
+    std::string src_bucket;
+    std::string src_key;
+    std::string dest_bucket;
+    std::string dest_key;
+
+    std::string resource_name = get_resource_name(_prop_map);
+
+    std::size_t retry_count_limit = get_retry_count(_prop_map);
+    std::size_t max_retry_wait = get_max_retry_wait_time_sec(_prop_map);
+
+    auto ret = parseS3Path(_src_file, src_bucket, src_key, _prop_map);
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to parse the source file name: \"{}\".",
+                    resource_name, _src_file), ret);
+    }
+
+    ret = parseS3Path(_dest_file, dest_bucket, dest_key, _prop_map);
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to parse the destination file name: \"{}\".",
+                    resource_name, _dest_file), ret);
+    }
+
+    ret = s3InitPerOperation( _prop_map );
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to initialize the S3 system.",
+                    resource_name), ret);
+    }
+
+    // Use the configured part size unless that would exceed the part count limit.
+    std::int64_t part_size = s3_get_copy_part_size(_prop_map);
+    std::int64_t max_part_size = s3GetMaxUploadSizeMB(_prop_map) * 1024 * 1024;
+    part_size = std::max<std::int64_t>(part_size, (_object_size + MAXIMUM_NUMBER_OF_PARTS - 1) / MAXIMUM_NUMBER_OF_PARTS);
+    if (part_size > max_part_size) {
+        return ERROR(S3_FILE_COPY_ERR, fmt::format(
+                    "[resource_name={}] Object \"{}\" of size {} is too large to copy within {} parts.",
+                    resource_name, _src_file, _object_size, MAXIMUM_NUMBER_OF_PARTS));
+    }
+    std::int64_t number_of_parts = (_object_size + part_size - 1) / part_size;
+    int concurrency = s3_get_copy_concurrency(_prop_map);
+
+    S3BucketContext bucketContext{};
+    bucketContext.bucketName = dest_bucket.c_str();
+    bucketContext.protocol = s3GetProto(_prop_map);
+    bucketContext.stsDate = s3GetSTSDate(_prop_map);
+    bucketContext.uriStyle = s3_get_uri_request_style(_prop_map);
+    bucketContext.accessKeyId = _key_id.c_str();
+    bucketContext.secretAccessKey = _access_key.c_str();
+    std::string authRegionStr = get_region_name(_prop_map);
+    bucketContext.authRegion = authRegionStr.c_str();
+
+    S3PutProperties putProps{};
+    putProps.useServerSideEncryption = s3GetServerEncrypt(_prop_map);
+    putProps.expires = -1;
+    putProps.xAmzDecodedContentLength = -1;
+    std::string storage_class = s3_get_storage_class_from_configuration(_prop_map);
+    putProps.xAmzStorageClass = storage_class.c_str();
+
+    upload_manager_t manager;
+    memset(&manager, 0, sizeof(manager));
+    const auto free_upload_id = irods::at_scope_exit{[&manager] { free(manager.upload_id); }};
+
+    ret = s3_initiate_multipart_with_retry(_prop_map, bucketContext, dest_key, &putProps, manager, S3_FILE_COPY_ERR);
+    if (!ret.ok()) {
+        return ret;
+    }
+
+    s3_logger::debug("[resource_name={}] Multipart copy: \"{}\" to \"{}\", size {}, {} parts of {} bytes, {} in flight",
+            resource_name, _src_file, _dest_file, _object_size, number_of_parts, part_size, concurrency);
+
+    // The completed list must outlive the request context as destroying the context
+    // calls the completion callback for any request still in flight.
+    std::vector<copy_part_t*> completed;
+    std::vector<copy_part_t> parts(number_of_parts);
+    std::deque<copy_part_t*> pending;
+    for (std::int64_t i = 0; i < number_of_parts; ++i) {
+        copy_part_t& part = parts[i];
+        part.seq = i + 1;
+        part.offset = i * part_size;
+        part.length = std::min<std::int64_t>(part_size, _object_size - part.offset);
+        part.retry_cnt = 0;
+        part.retry_wait = get_retry_wait_time_sec(_prop_map);
+        part.not_before = 0;
+        part.status = S3StatusOK;
+        part.src_ctx = bucketContext;
+        part.src_ctx.bucketName = src_bucket.c_str();
+        part.last_modified = 0;
+        part.etag[0] = '\0';
+        part.completed = &completed;
+        pending.push_back(&part);
+    }
+
+    S3RequestContext *request_context = nullptr;
+    S3Status status = S3_create_request_context(&request_context);
+    if (status != S3StatusOK) {
+        mpuCancel( &bucketContext, dest_key.c_str(), manager.upload_id, _prop_map );
+        return ERROR(S3_FILE_COPY_ERR, fmt::format(
+                    "[resource_name={}] Failed to create the S3 request context for copying \"{}\" - \"{}\"",
+                    resource_name, _src_file, S3_get_status_name(status)));
+    }
+    const auto destroy_request_context = irods::at_scope_exit{[&request_context] {
+        if (request_context) {
+            S3_destroy_request_context(request_context);
+        }
+    }};
+
+    S3ResponseHandler copyResponseHandler = { copyPartRespPropCB, copyPartRespCompCB };
+    irods::error result = SUCCESS();
+    std::int64_t parts_finished = 0;
+    int in_flight = 0;
+
+    std::uint64_t usStart = usNow();
+
+    while (parts_finished < number_of_parts && (result.ok() || in_flight > 0)) {
+
+        // Keep the pipe full.  Parts waiting out a retry delay are rotated to the back.
+        std::uint64_t now = usNow();
+        for (std::size_t n = pending.size(); result.ok() && in_flight < concurrency && n > 0; --n) {
+            copy_part_t *part = pending.front();
+            pending.pop_front();
+            if (part->not_before > now) {
+                pending.push_back(part);
+                continue;
+            }
+            part->status = S3StatusOK;
+            part->hostname = s3GetHostname(_prop_map);
+            part->src_ctx.hostName = part->hostname.c_str();
+            S3_copy_object_range(&part->src_ctx, src_key.c_str(), dest_bucket.c_str(), dest_key.c_str(),
+                                 part->seq, manager.upload_id,
+                                 part->offset, part->length,
+                                 nullptr,
+                                 &part->last_modified, sizeof(part->etag), part->etag,
+                                 request_context, 0, &copyResponseHandler, part);
+            ++in_flight;
+        }
+
+        if (in_flight > 0) {
+            fd_set read_fds, write_fds, except_fds;
+            FD_ZERO(&read_fds);
+            FD_ZERO(&write_fds);
+            FD_ZERO(&except_fds);
+            int max_fd = -1;
+            status = S3_get_request_context_fdsets(request_context, &read_fds, &write_fds, &except_fds, &max_fd);
+            if (status == S3StatusOK) {
+                // wake up at least every 100ms so delayed retries get started
+                std::int64_t timeout_ms = S3_get_request_context_timeout(request_context);
+                if (timeout_ms < 0 || timeout_ms > 100) {
+                    timeout_ms = 100;
+                }
+                if (max_fd != -1) {
+                    struct timeval tv = {timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+                    select(max_fd + 1, &read_fds, &write_fds, &except_fds, &tv);
+                } else if (timeout_ms > 0) {
+                    // curl has no sockets to wait on yet (for example while resolving or
+                    // between connections), so wait instead of spinning
+                    std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+                }
+            }
+            int requests_remaining = 0;
+            if (status == S3StatusOK) {
+                status = S3_runonce_request_context(request_context, &requests_remaining);
+            }
+            if (status != S3StatusOK) {
+                result = ERROR(S3_FILE_COPY_ERR, fmt::format(
+                            "[resource_name={}] Error running the S3 request context while copying \"{}\" - \"{}\"",
+                            resource_name, _src_file, S3_get_status_name(status)));
+                s3_logger::error(result.result());
+                break;
+            }
+        } else if (!pending.empty()) {
+            // everything left is waiting out a retry delay
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        for (copy_part_t *part : completed) {
+            --in_flight;
+            if (part->status == S3StatusOK) {
+                ++parts_finished;
+            } else if (result.ok() && S3_status_is_retryable(part->status) && ++part->retry_cnt <= retry_count_limit) {
+                s3_logger::debug("[resource_name={}] Multipart copy: retrying part {} of \"{}\" in {} seconds",
+                        resource_name, part->seq, _src_file, part->retry_wait);
+                part->not_before = usNow() + part->retry_wait * 1000000;
+                part->retry_wait = std::min(part->retry_wait * 2, max_retry_wait);
+                pending.push_back(part);
+            } else {
+                ++parts_finished;
+                if (result.ok()) {
+                    auto msg = fmt::format("[resource_name={}] {} - Error copying part {} of the S3 object: \"{}\" to \"{}\"",
+                            resource_name,
+                            __FUNCTION__,
+                            part->seq,
+                            _src_file,
+                            _dest_file);
+                    if (part->status >= 0) {
+                        msg += fmt::format(" - \"{}\"", S3_get_status_name(part->status));
+                    }
+                    s3_logger::error( msg );
+                    result = ERROR( S3_FILE_COPY_ERR, msg );
+                }
+            }
+        }
+        completed.clear();
+    }
+
+    // Destroy the context before completing or aborting the upload.  After an error parts may
+    // still be in flight, and destroying the context stops them so that an UploadPartCopy cannot
+    // land after the abort.
+    S3_destroy_request_context(request_context);
+    request_context = nullptr;
+
+    std::uint64_t usEnd = usNow();
+    double bw = (_object_size / (1024.0*1024.0)) / ( (usEnd - usStart) / 1000000.0 );
+    s3_logger::debug("MultipartCopyBW={}", bw);
+
+    if (result.ok()) {
+        s3_logger::debug("Multipart copy:  Completing key \"{}\"", dest_key);
+
+        std::string xml = "<CompleteMultipartUpload>\n";
+        for (const auto& part : parts) {
+            xml += fmt::format("<Part><PartNumber>{}</PartNumber><ETag>{}</ETag></Part>\n", part.seq, part.etag);
+        }
+        xml += "</CompleteMultipartUpload>\n";
+
+        result = s3_complete_multipart_with_retry(_prop_map, bucketContext, dest_key, xml, manager, S3_FILE_COPY_ERR);
+    }
+
+    if (!result.ok()) {
+        s3_logger::error("[resource_name={}] Cancelling multipart copy", resource_name);
+        mpuCancel( &bucketContext, dest_key.c_str(), manager.upload_id, _prop_map );
+    }
+
+    return result;
+} // s3_copy_object_multipart
+
+
+/******************* Client-side Pipelined Copy *****************************/
+
+// One part of an object in transit between the ranged GET that fills it and the
+// PUT or UploadPart that drains it.  The buffers are pooled so at most a fixed
+// number of parts are held in memory.
+typedef struct pipelined_copy_buffer
+{
+    int seq;
+    std::int64_t offset;       // offset of the part within the object
+    std::int64_t length;       // length of the part
+    std::int64_t transferred;  // bytes received from, or sent to, S3 by the current request
+    std::vector<char> data;
+    std::string etag;
+    S3BucketContext *pCtx;
+    S3Status status;
+} pipelined_copy_buffer_t;
+
+// State shared between the reader and writer threads of a pipelined copy
+typedef struct pipelined_copy
+{
+    irods::plugin_property_map *prop_map_ptr;
+    S3BucketContext src_ctx;
+    S3BucketContext dest_ctx;
+    const char *src_key;
+    const char *dest_key;
+    const char *upload_id;     // NULL when the object is written with a single PUT
+    S3PutProperties put_props;
+    std::int64_t object_size;
+    std::int64_t part_size;
+    std::int64_t number_of_parts;
+
+    boost::mutex lock;
+    boost::condition_variable buffer_freed;    // readers wait here for an empty buffer
+    boost::condition_variable buffer_filled;   // writers wait here for a filled buffer
+    std::vector<pipelined_copy_buffer_t*> free_buffers;
+    std::deque<pipelined_copy_buffer_t*> filled_buffers;
+    std::int64_t next_part;        // index of the next part to be read
+    std::int64_t parts_unread;     // parts not yet handed to the writers
+    std::vector<std::string> etags;
+    irods::error result;           // first error wins, mutex protected
+} pipelined_copy_t;
+
+static S3Status pipelinedGetDataCB (
+    int bufferSize,
+    const char *buffer,
+    void *callbackData)
+{
+    pipelined_copy_buffer_t *part = (pipelined_copy_buffer_t *)callbackData;
+    if (bufferSize < 0 || part->transferred + bufferSize > part->length) {
+        return S3StatusAbortedByCallback;
+    }
+    memcpy(part->data.data() + part->transferred, buffer, bufferSize);
+    part->transferred += bufferSize;
+    return S3StatusOK;
+}
+
+static int pipelinedPutDataCB (
+    int bufferSize,
+    char *buffer,
+    void *callbackData)
+{
+    pipelined_copy_buffer_t *part = (pipelined_copy_buffer_t *)callbackData;
+    std::int64_t length = std::min<std::int64_t>(bufferSize, part->length - part->transferred);
+    memcpy(buffer, part->data.data() + part->transferred, length);
+    part->transferred += length;
+    return (int)length;
+}
+
+static S3Status pipelinedRespPropCB (
+    const S3ResponseProperties *properties,
+    void *callbackData)
+{
+    pipelined_copy_buffer_t *part = (pipelined_copy_buffer_t *)callbackData;
+    if (properties->eTag) {
+        part->etag = properties->eTag;
+    }
+    return S3StatusOK;
+}
+
+static void pipelinedRespCompCB (
+    S3Status status,
+    const S3ErrorDetails *error,
+    void *callbackData)
+{
+    pipelined_copy_buffer_t *part = (pipelined_copy_buffer_t *)callbackData;
+    StoreAndLogStatus( status, error, __FUNCTION__, part->pCtx, &(part->status) );
+}
+
+/* Reads (ranged GET) or writes (PUT/UploadPart) a single buffer, retrying as configured */
+static S3Status pipelined_copy_transfer(
+    pipelined_copy_t& _copy,
+    pipelined_copy_buffer_t& _part,
+    bool _read)
+{
+    irods::plugin_property_map& _prop_map = *_copy.prop_map_ptr;
+    S3BucketContext bucketContext = _read ? _copy.src_ctx : _copy.dest_ctx;
+
+    std::size_t retry_count_limit = get_retry_count(_prop_map);
+    std::size_t retry_wait = get_retry_wait_time_sec(_prop_map);
+    std::size_t max_retry_wait = get_max_retry_wait_time_sec(_prop_map);
+
+    S3GetObjectHandler getObjectHandler = { {pipelinedRespPropCB, pipelinedRespCompCB }, pipelinedGetDataCB };
+    S3PutObjectHandler putObjectHandler = { {pipelinedRespPropCB, pipelinedRespCompCB }, pipelinedPutDataCB };
+
+    std::size_t retry_cnt = 0;
+    do {
+        _part.transferred = 0;
+        _part.etag.clear();
+        _part.status = S3StatusOK;
+        _part.pCtx = &bucketContext;
+        std::string&& hostname = s3GetHostname(_prop_map);
+        bucketContext.hostName = hostname.c_str(); // Safe to do, this is a local copy of the data structure
+
+        if (_read) {
+            S3_get_object(&bucketContext, _copy.src_key, NULL, _part.offset, _part.length, 0, 0, &getObjectHandler, &_part);
+            if (_part.status == S3StatusOK && _part.transferred != _part.length) {
+                s3_logger::error("[resource_name={}] Pipelined copy: short read of part {} of \"{}\", received {} of {} bytes",
+                        get_resource_name(_prop_map), _part.seq, _copy.src_key, _part.transferred, _part.length);
+                _part.status = S3StatusConnectionFailed;
+            }
+        } else if (_copy.upload_id == NULL) {
+            S3_put_object(&bucketContext, _copy.dest_key, _part.length, &_copy.put_props, 0, 0, &putObjectHandler, &_part);
+        } else {
+            S3PutProperties putProps{};
+            putProps.expires = -1;
+            putProps.xAmzDecodedContentLength = -1;
+            S3_upload_part(&bucketContext, _copy.dest_key, &putProps, &putObjectHandler, _part.seq, _copy.upload_id,
+                    _part.length, 0, 0, &_part);
+        }
+
+        if (_part.status != S3StatusOK) {
+            s3_sleep( retry_wait );
+            retry_wait *= 2;
+            if (retry_wait > max_retry_wait) {
+                retry_wait = max_retry_wait;
+            }
+        }
+    } while ((_part.status != S3StatusOK) && S3_status_is_retryable(_part.status) && (++retry_cnt <= retry_count_limit));
+
+    _part.pCtx = NULL;
+    return _part.status;
+}
+
+/* Records the first failure of a pipelined copy and wakes every thread so they can exit */
+static void pipelined_copy_fail(
+    pipelined_copy_t& _copy,
+    pipelined_copy_buffer_t& _part,
+    bool _read)
+{
+    // caller holds _copy.lock
+    if (_copy.result.ok()) {
+        auto msg = fmt::format("[resource_name={}] {} - Error {} part {} of the S3 object: \"{}\"",
+                get_resource_name(*_copy.prop_map_ptr),
+                __FUNCTION__,
+                _read ? "reading" : "writing",
+                _part.seq,
+                _read ? _copy.src_key : _copy.dest_key);
+        if (_part.status >= 0) {
+            msg += fmt::format(" - \"{}\"", S3_get_status_name(_part.status));
+        }
+        s3_logger::error( msg );
+        _copy.result = ERROR( _read ? S3_GET_ERROR : S3_PUT_ERROR, msg );
+    }
+    _copy.buffer_freed.notify_all();
+    _copy.buffer_filled.notify_all();
+}
+
+/* Reader thread, fills free buffers with ranged GETs from the source object */
+static void pipelinedCopyReaderThread (
+    pipelined_copy_t *copy)
+{
+    while (true) {
+        pipelined_copy_buffer_t *part = NULL;
+        {
+            boost::unique_lock<boost::mutex> lock(copy->lock);
+            copy->buffer_freed.wait(lock, [copy] {
+                return !copy->result.ok() || copy->next_part >= copy->number_of_parts || !copy->free_buffers.empty();
+            });
+            if (!copy->result.ok() || copy->next_part >= copy->number_of_parts) {
+                return;
+            }
+            part = copy->free_buffers.back();
+            copy->free_buffers.pop_back();
+            part->seq = copy->next_part + 1;
+            part->offset = copy->next_part * copy->part_size;
+            part->length = std::min<std::int64_t>(copy->part_size, copy->object_size - part->offset);
+            ++copy->next_part;
+        }
+
+        S3Status status = pipelined_copy_transfer(*copy, *part, true);
+
+        boost::lock_guard<boost::mutex> lock(copy->lock);
+        if (status != S3StatusOK) {
+            copy->free_buffers.push_back(part);
+            pipelined_copy_fail(*copy, *part, true);
+            return;
+        }
+        copy->filled_buffers.push_back(part);
+        if (--copy->parts_unread == 0) {
+            // let idle writers see that nothing more is coming
+            copy->buffer_filled.notify_all();
+        } else {
+            copy->buffer_filled.notify_one();
+        }
+    }
+}
+
+/* Writer thread, drains filled buffers into the destination object */
+static void pipelinedCopyWriterThread (
+    pipelined_copy_t *copy)
+{
+    while (true) {
+        pipelined_copy_buffer_t *part = NULL;
+        {
+            boost::unique_lock<boost::mutex> lock(copy->lock);
+            copy->buffer_filled.wait(lock, [copy] {
+                return !copy->result.ok() || !copy->filled_buffers.empty() || copy->parts_unread == 0;
+            });
+            if (!copy->result.ok() || copy->filled_buffers.empty()) {
+                return;
+            }
+            part = copy->filled_buffers.front();
+            copy->filled_buffers.pop_front();
+        }
+
+        S3Status status = pipelined_copy_transfer(*copy, *part, false);
+
+        boost::lock_guard<boost::mutex> lock(copy->lock);
+        copy->free_buffers.push_back(part);
+        if (status != S3StatusOK) {
+            pipelined_copy_fail(*copy, *part, false);
+            return;
+        }
+        copy->etags[part->seq - 1] = part->etag;
+        copy->buffer_freed.notify_one();
+    }
+}
+
+/// @brief Copies an object through this server for providers that do not support CopyObject.
+///        Ranged GETs of the source run concurrently with the UploadParts of the destination,
+///        connected through a bounded pool of part sized buffers, so reading and writing overlap.
+irods::error s3_copy_object_pipelined(
+    irods::plugin_property_map& _prop_map,
+    const std::string& _src_file,
+    const std::string& _dest_file,
+    rodsLong_t _object_size,
+    const std::string& _key_id,
+    const std::string& _access_key)
+{
+    std::string src_bucket;
+    std::string src_key;
+    std::string dest_bucket;
+    std::string dest_key;
+
+    std::string resource_name = get_resource_name(_prop_map);
+
+    auto ret = parseS3Path(_src_file, src_bucket, src_key, _prop_map);
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to parse the source file name: \"{}\".",
+                    resource_name, _src_file), ret);
+    }
+
+    ret = parseS3Path(_dest_file, dest_bucket, dest_key, _prop_map);
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to parse the destination file name: \"{}\".",
+                    resource_name, _dest_file), ret);
+    }
+
+    ret = s3InitPerOperation( _prop_map );
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to initialize the S3 system.",
+                    resource_name), ret);
+    }
+
+    // Parts are S3_MPU_CHUNK sized unless that would exceed the part count limit.
+    std::int64_t part_size = s3GetMPUChunksize(_prop_map);
+    std::int64_t max_part_size = s3GetMaxUploadSizeMB(_prop_map) * 1024 * 1024;
+    part_size = std::max<std::int64_t>(part_size, (_object_size + MAXIMUM_NUMBER_OF_PARTS - 1) / MAXIMUM_NUMBER_OF_PARTS);
+    if (part_size > max_part_size) {
+        return ERROR(S3_FILE_COPY_ERR, fmt::format(
+                    "[resource_name={}] Object \"{}\" of size {} is too large to copy within {} parts.",
+                    resource_name, _src_file, _object_size, MAXIMUM_NUMBER_OF_PARTS));
+    }
+
+    pipelined_copy_t copy;
+    copy.prop_map_ptr = &_prop_map;
+    copy.object_size = _object_size;
+    copy.part_size = part_size;
+    // an empty object is still written with a single (empty) PUT
+    copy.number_of_parts = std::max<std::int64_t>(1, (_object_size + part_size - 1) / part_size);
+    copy.next_part = 0;
+    copy.parts_unread = copy.number_of_parts;
+    copy.etags.resize(copy.number_of_parts);
+    copy.result = SUCCESS();
+    copy.src_key = src_key.c_str();
+    copy.dest_key = dest_key.c_str();
+    copy.upload_id = NULL;
+
+    S3BucketContext bucketContext{};
+    bucketContext.bucketName = dest_bucket.c_str();
+    bucketContext.protocol = s3GetProto(_prop_map);
+    bucketContext.stsDate = s3GetSTSDate(_prop_map);
+    bucketContext.uriStyle = s3_get_uri_request_style(_prop_map);
+    bucketContext.accessKeyId = _key_id.c_str();
+    bucketContext.secretAccessKey = _access_key.c_str();
+    std::string authRegionStr = get_region_name(_prop_map);
+    bucketContext.authRegion = authRegionStr.c_str();
+    copy.dest_ctx = bucketContext;
+    copy.src_ctx = bucketContext;
+    copy.src_ctx.bucketName = src_bucket.c_str();
+
+    copy.put_props = S3PutProperties{};
+    copy.put_props.useServerSideEncryption = s3GetServerEncrypt(_prop_map);
+    copy.put_props.expires = -1;
+    copy.put_props.xAmzDecodedContentLength = -1;
+    std::string storage_class = s3_get_storage_class_from_configuration(_prop_map);
+    copy.put_props.xAmzStorageClass = storage_class.c_str();
+
+    upload_manager_t manager;
+    memset(&manager, 0, sizeof(manager));
+    const auto free_upload_id = irods::at_scope_exit{[&manager] { free(manager.upload_id); }};
+
+    if (copy.number_of_parts > 1) {
+        ret = s3_initiate_multipart_with_retry(_prop_map, bucketContext, dest_key, &copy.put_props, manager, S3_FILE_COPY_ERR);
+        if (!ret.ok()) {
+            return ret;
+        }
+        copy.upload_id = manager.upload_id;
+    }
+
+    // S3_MPU_THREADS readers and as many writers.  Each side has a buffer to work on while
+    // the other side works on its own.  Buffering is bounded by 2 * S3_MPU_THREADS buffers of
+    // S3_MPU_CHUNK bytes.  Parts grow past S3_MPU_CHUNK for objects that would otherwise need
+    // more than 10,000 parts, and then fewer buffers (and threads to fill them) are used,
+    // down to a single part in memory.
+    const std::int64_t mpu_threads = s3GetMPUThreads(_prop_map);
+    const std::int64_t maximum_buffered_bytes = 2 * mpu_threads * s3GetMPUChunksize(_prop_map);
+    std::int64_t number_of_buffers = std::min<std::int64_t>(2 * mpu_threads, copy.number_of_parts);
+    number_of_buffers = std::clamp<std::int64_t>(maximum_buffered_bytes / part_size, 1, number_of_buffers);
+    std::int64_t number_of_threads = std::clamp<std::int64_t>(number_of_buffers / 2, 1, mpu_threads);
+    std::vector<pipelined_copy_buffer_t> buffers(number_of_buffers);
+    for (auto& buffer : buffers) {
+        buffer.data.resize(std::min<std::int64_t>(part_size, _object_size));
+        copy.free_buffers.push_back(&buffer);
+    }
+
+    s3_logger::debug("[resource_name={}] Pipelined copy: \"{}\" to \"{}\", size {}, {} parts of {} bytes, {} buffers, {} threads per direction",
+            resource_name, _src_file, _dest_file, _object_size, copy.number_of_parts, part_size, number_of_buffers, number_of_threads);
+
+    std::uint64_t usStart = usNow();
+
+    std::vector<boost::thread> threads;
+    for (std::int64_t i = 0; i < number_of_threads; ++i) {
+        threads.emplace_back(pipelinedCopyReaderThread, &copy);
+        threads.emplace_back(pipelinedCopyWriterThread, &copy);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::uint64_t usEnd = usNow();
+    double bw = (_object_size / (1024.0*1024.0)) / ( (usEnd - usStart) / 1000000.0 );
+    s3_logger::debug("PipelinedCopyBW={}", bw);
+
+    irods::error result = copy.result;
+    if (result.ok() && copy.upload_id != NULL) {
+        s3_logger::debug("Pipelined copy:  Completing key \"{}\"", dest_key);
+
+        std::string xml = "<CompleteMultipartUpload>\n";
+        for (std::int64_t i = 0; i < copy.number_of_parts; ++i) {
+            xml += fmt::format("<Part><PartNumber>{}</PartNumber><ETag>{}</ETag></Part>\n", i + 1, copy.etags[i]);
+        }
+        xml += "</CompleteMultipartUpload>\n";
+
+        result = s3_complete_multipart_with_retry(_prop_map, bucketContext, dest_key, xml, manager, S3_FILE_COPY_ERR);
+    }
+
+    if (!result.ok() && copy.upload_id != NULL) {
+        s3_logger::error("[resource_name={}] Cancelling pipelined copy", resource_name);
+        mpuCancel( &bucketContext, dest_key.c_str(), manager.upload_id, _prop_map );
+    }
+
+    return result;
+} // s3_copy_object_pipelined
+
+typedef struct delete_objects
+{
+    S3Status status;
+    const S3BucketContext* pCtx;
+    std::vector<std::pair<std::string, S3Status>> failed;   // key and status
+} delete_objects_t;
+
+static S3Status deleteObjectsKeyCB (
+    const char *key,
+    S3Status status,
+    const char *errorCode,
+    const char *errorMessage,
+    void *callbackData)
+{
+    delete_objects_t *data = (delete_objects_t*)callbackData;
+    if (status != S3StatusOK && status != S3StatusErrorNoSuchKey) {
+        s3_logger::error( "  Failed to delete key \"{}\": {} - {}", key, errorCode ? errorCode : "",
+                errorMessage ? errorMessage : "");
+        data->failed.emplace_back(key, status);
+    }
+    return S3StatusOK;
+}
+
+static void deleteObjectsRespCompCB (
+    S3Status status,
+    const S3ErrorDetails *error,
+    void *callbackData)
+{
+    delete_objects_t *data = (delete_objects_t*)callbackData;
+    StoreAndLogStatus( status, error, __FUNCTION__, data->pCtx, &(data->status) );
+}
+
+irods::error s3_delete_objects(
+    irods::plugin_property_map& _prop_map,
+    const std::vector<std::string>& _files,
+    std::vector<std::pair<std::string, S3Status>>& _failed)
+{
+    std::string resource_name = get_resource_name(_prop_map);
+
+    if (_files.empty()) {
+        return SUCCESS();
+    }
+
+    auto ret = s3InitPerOperation( _prop_map );
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to initialize the S3 system.",
+                    resource_name), ret);
+    }
+
+    std::string key_id;
+    std::string access_key;
+    ret = s3GetAuthCredentials(_prop_map, key_id, access_key);
+    if (!ret.ok()) {
+        return PASS(ret);
+    }
+
+    // bucket -> key -> file, so that failed keys can be reported by file
+    std::map<std::string, std::map<std::string, std::string>> keys_by_bucket;
+    for (const auto& file : _files) {
+        std::string bucket;
+        std::string key;
+        ret = parseS3Path(file, bucket, key, _prop_map);
+        if (!ret.ok()) {
+            return PASSMSG(fmt::format(
+                        "[resource_name={}] Failed to parse the file name: \"{}\".",
+                        resource_name, file), ret);
+        }
+        keys_by_bucket[bucket].emplace(key, file);
+    }
+
+    std::size_t retry_count_limit = get_retry_count(_prop_map);
+    std::size_t max_retry_wait = get_max_retry_wait_time_sec(_prop_map);
+    int timeout_ms = get_non_data_transfer_timeout_seconds(_prop_map) * 1000;
+
+    std::string region_name = get_region_name(_prop_map);
+
+    S3BucketContext bucketContext = {};
+    bucketContext.protocol = s3GetProto(_prop_map);
+    bucketContext.stsDate = s3GetSTSDate(_prop_map);
+    bucketContext.uriStyle = s3_get_uri_request_style(_prop_map);
+    bucketContext.accessKeyId = key_id.c_str();
+    bucketContext.secretAccessKey = access_key.c_str();
+    bucketContext.authRegion = region_name.c_str();
+
+    S3DeleteObjectsHandler deleteObjectsHandler = { { 0, deleteObjectsRespCompCB }, deleteObjectsKeyCB };
+
+    // set when the provider turns out not to support Multi-Object Delete
+    bool delete_one_by_one = false;
+
+    for (const auto& [bucket, keys] : keys_by_bucket) {
+        bucketContext.bucketName = bucket.c_str();
+
+        for (auto batch_begin = keys.begin(); batch_begin != keys.end(); ) {
+            std::vector<const char*> batch;
+            auto batch_end = batch_begin;
+            for (; batch_end != keys.end() && batch.size() < S3_MAX_DELETE_OBJECTS_COUNT; ++batch_end) {
+                batch.push_back(batch_end->first.c_str());
+            }
+
+            delete_objects_t data{S3StatusOK, nullptr, {}};
+            if (!delete_one_by_one) {
+                std::size_t retry_cnt = 0;
+                std::size_t retry_wait = get_retry_wait_time_sec(_prop_map);
+                do {
+                    data.status = S3StatusOK;
+                    data.failed.clear();
+                    std::string&& hostname = s3GetHostname(_prop_map);
+                    bucketContext.hostName = hostname.c_str();
+                    data.pCtx = &bucketContext;
+                    S3_delete_objects(&bucketContext, batch.size(), batch.data(), 1, nullptr, timeout_ms,
+                            &deleteObjectsHandler, &data);
+                    if (data.status != S3StatusOK) {
+                        s3_sleep( retry_wait );
+                        retry_wait *= 2;
+                        if (retry_wait > max_retry_wait) {
+                            retry_wait = max_retry_wait;
+                        }
+                    }
+                } while ( (data.status != S3StatusOK) && S3_status_is_retryable(data.status) && ( ++retry_cnt <= retry_count_limit));
+
+                if (data.status == S3StatusErrorNotImplemented || data.status == S3StatusErrorMethodNotAllowed) {
+                    s3_logger::info("[resource_name={}] Multi-Object Delete is not supported, deleting objects one at a time.",
+                            resource_name);
+                    delete_one_by_one = true;
+                }
+                else if (data.status != S3StatusOK) {
+                    auto msg = fmt::format("[resource_name={}] {} - Error deleting {} objects in bucket \"{}\"",
+                            resource_name, __FUNCTION__, batch.size(), bucket);
+                    if (data.status >= 0) {
+                        msg += fmt::format(" - \"{}\"", S3_get_status_name(data.status));
+                    }
+                    s3_logger::error( msg );
+                    return ERROR(S3_FILE_UNLINK_ERR, msg);
+                }
+            }
+
+            if (delete_one_by_one) {
+                data.failed.clear();
+                S3ResponseHandler responseHandler = { 0, &responseCompleteCallback };
+                for (const char* key : batch) {
+                    callback_data_t key_data;
+                    std::string&& hostname = s3GetHostname(_prop_map);
+                    bucketContext.hostName = hostname.c_str();
+                    key_data.pCtx = &bucketContext;
+                    S3_delete_object(&bucketContext, key, nullptr, timeout_ms, &responseHandler, &key_data);
+                    if (key_data.status != S3StatusOK && key_data.status != S3StatusHttpErrorNotFound &&
+                            key_data.status != S3StatusErrorNoSuchKey) {
+                        data.failed.emplace_back(key, key_data.status);
+                    }
+                }
+            }
+
+            for (const auto& [key, status] : data.failed) {
+                auto file = keys.find(key);
+                _failed.emplace_back(file != keys.end() ? file->second : key, status);
+            }
+
+            batch_begin = batch_end;
+        }
+    }
+
+    return SUCCESS();
+} // s3_delete_objects
+
+
+/******************* Parallel Checksum *****************************/
+
+// One range of an object being checksummed.  For CRC64/NVME each range is hashed as it
+// arrives and the CRCs are combined, otherwise the range is buffered until the hashing
+// thread reaches it.
+typedef struct checksum_range
+{
+    int seq;
+    std::int64_t offset;       // offset of the range within the object
+    std::int64_t length;       // length of the range
+    std::int64_t transferred;  // bytes received by the current request
+    std::uint64_t crc;         // CRC64/NVME of the bytes received, when combining
+    std::vector<char> data;    // the bytes received when hashing in order, empty when combining
+    S3BucketContext *pCtx;
+    S3Status status;
+} checksum_range_t;
+
+// State shared between the reader threads and the hashing thread of a parallel checksum
+typedef struct parallel_checksum
+{
+    irods::plugin_property_map *prop_map_ptr;
+    S3BucketContext ctx;
+    const char *key;
+    std::int64_t object_size;
+    std::int64_t range_size;
+    std::int64_t number_of_ranges;
+    bool combine;                  // the ranges are hashed independently and combined
+
+    boost::mutex lock;
+    boost::condition_variable buffer_freed;    // readers wait here for an empty buffer
+    boost::condition_variable range_filled;    // the hashing thread waits here for the next range
+    std::vector<checksum_range_t*> free_buffers;
+    std::map<int, checksum_range_t*> filled_ranges;  // by seq, not yet hashed
+    std::int64_t next_range;       // index of the next range to be read
+    std::vector<std::uint64_t> crcs;   // CRC of each range, when combining
+    irods::error result;           // first error wins, mutex protected
+} parallel_checksum_t;
+
+static S3Status checksumRangeGetDataCB (
+    int bufferSize,
+    const char *buffer,
+    void *callbackData)
+{
+    checksum_range_t *range = (checksum_range_t *)callbackData;
+    if (bufferSize < 0 || range->transferred + bufferSize > range->length) {
+        return S3StatusAbortedByCallback;
+    }
+    if (range->data.empty()) {
+        range->crc = irods::experimental::io::s3_transport::crc64_nvme_update(range->crc, {buffer, static_cast<std::size_t>(bufferSize)});
+    } else {
+        memcpy(range->data.data() + range->transferred, buffer, bufferSize);
+    }
+    range->transferred += bufferSize;
+    return S3StatusOK;
+}
+
+static S3Status checksumRangeRespPropCB (
+    const S3ResponseProperties *properties,
+    void *callbackData)
+{
+    return S3StatusOK;
+}
+
+static void checksumRangeRespCompCB (
+    S3Status status,
+    const S3ErrorDetails *error,
+    void *callbackData)
+{
+    checksum_range_t *range = (checksum_range_t *)callbackData;
+    StoreAndLogStatus( status, error, __FUNCTION__, range->pCtx, &(range->status) );
+}
+
+/* Reads a single range with a ranged GET, retrying as configured */
+static S3Status checksum_range_get(
+    parallel_checksum_t& _checksum,
+    checksum_range_t& _range)
+{
+    irods::plugin_property_map& _prop_map = *_checksum.prop_map_ptr;
+    S3BucketContext bucketContext = _checksum.ctx;
+
+    std::size_t retry_count_limit = get_retry_count(_prop_map);
+    std::size_t retry_wait = get_retry_wait_time_sec(_prop_map);
+    std::size_t max_retry_wait = get_max_retry_wait_time_sec(_prop_map);
+
+    S3GetObjectHandler getObjectHandler = { {checksumRangeRespPropCB, checksumRangeRespCompCB }, checksumRangeGetDataCB };
+
+    std::size_t retry_cnt = 0;
+    do {
+        _range.transferred = 0;
+        _range.crc = 0;
+        _range.status = S3StatusOK;
+        _range.pCtx = &bucketContext;
+        std::string&& hostname = s3GetHostname(_prop_map);
+        bucketContext.hostName = hostname.c_str(); // Safe to do, this is a local copy of the data structure
+
+        S3_get_object(&bucketContext, _checksum.key, NULL, _range.offset, _range.length, 0, 0, &getObjectHandler, &_range);
+        if (_range.status == S3StatusOK && _range.transferred != _range.length) {
+            s3_logger::error("[resource_name={}] Parallel checksum: short read of range {} of \"{}\", received {} of {} bytes",
+                    get_resource_name(_prop_map), _range.seq, _checksum.key, _range.transferred, _range.length);
+            _range.status = S3StatusConnectionFailed;
+        }
+
+        if (_range.status != S3StatusOK) {
+            s3_sleep( retry_wait );
+            retry_wait *= 2;
+            if (retry_wait > max_retry_wait) {
+                retry_wait = max_retry_wait;
+            }
+        }
+    } while ((_range.status != S3StatusOK) && S3_status_is_retryable(_range.status) && (++retry_cnt <= retry_count_limit));
+
+    _range.pCtx = NULL;
+    return _range.status;
+}
+
+/* Reader thread, fetches the next unread range until all have been read */
+static void checksumReaderThread (
+    parallel_checksum_t *checksum)
+{
+    // when combining, the range is hashed as it arrives and no buffer is needed
+    checksum_range_t unbuffered_range{};
+
+    while (true) {
+        checksum_range_t *range = &unbuffered_range;
+        {
+            boost::unique_lock<boost::mutex> lock(checksum->lock);
+            checksum->buffer_freed.wait(lock, [checksum] {
+                return !checksum->result.ok() || checksum->next_range >= checksum->number_of_ranges ||
+                    checksum->combine || !checksum->free_buffers.empty();
+            });
+            if (!checksum->result.ok() || checksum->next_range >= checksum->number_of_ranges) {
+                return;
+            }
+            if (!checksum->combine) {
+                range = checksum->free_buffers.back();
+                checksum->free_buffers.pop_back();
+            }
+            range->seq = checksum->next_range + 1;
+            range->offset = checksum->next_range * checksum->range_size;
+            range->length = std::min<std::int64_t>(checksum->range_size, checksum->object_size - range->offset);
+            ++checksum->next_range;
+        }
+
+        S3Status status = checksum_range_get(*checksum, *range);
+
+        boost::lock_guard<boost::mutex> lock(checksum->lock);
+        if (status != S3StatusOK) {
+            if (!checksum->combine) {
+                checksum->free_buffers.push_back(range);
+            }
+            if (checksum->result.ok()) {
+                auto msg = fmt::format("[resource_name={}] {} - Error reading range {} of the S3 object: \"{}\"",
+                        get_resource_name(*checksum->prop_map_ptr), __FUNCTION__, range->seq, checksum->key);
+                if (status >= 0) {
+                    msg += fmt::format(" - \"{}\"", S3_get_status_name(status));
+                }
+                s3_logger::error( msg );
+                checksum->result = ERROR( S3_GET_ERROR, msg );
+            }
+            checksum->buffer_freed.notify_all();
+            checksum->range_filled.notify_all();
+            return;
+        }
+        if (checksum->combine) {
+            checksum->crcs[range->seq - 1] = range->crc;
+        } else {
+            checksum->filled_ranges[range->seq] = range;
+            checksum->range_filled.notify_one();
+        }
+    }
+}
+
+/// @brief Computes the checksum of an object with concurrent ranged GETs.  CRC64/NVME ranges
+///        are hashed independently and combined.  Other schemes can not be combined so the
+///        ranges are read ahead into a bounded pool of buffers and hashed in order by the
+///        calling thread.
+irods::error s3_compute_checksum_with_ranged_reads(
+    irods::plugin_property_map& _prop_map,
+    const std::string& _file,
+    const std::string& _scheme,
+    std::string& _checksum)
+{
+    namespace s3t = irods::experimental::io::s3_transport;
+
+    std::string bucket;
+    std::string key;
+    std::string key_id;
+    std::string access_key;
+
+    std::string resource_name = get_resource_name(_prop_map);
+
+    irods::error ret = parseS3Path(_file, bucket, key, _prop_map);
+    if (!ret.ok()) {
+        return PASS(ret);
+    }
+
+    ret = s3GetAuthCredentials(_prop_map, key_id, access_key);
+    if (!ret.ok()) {
+        return PASS(ret);
+    }
+
+    const bool combine = boost::iequals(_scheme, "crc64nvme");
+    irods::Hasher hasher;
+    if (!combine) {
+        ret = irods::getHasher(_scheme, hasher);
+        if (!ret.ok()) {
+            return ERROR(SYS_NOT_SUPPORTED, fmt::format("[resource_name={}] checksum scheme [{}] is not supported",
+                        resource_name, _scheme));
+        }
+    }
+
+    ret = s3InitPerOperation( _prop_map );
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to initialize the S3 system.",
+                    resource_name), ret);
+    }
+
+    parallel_checksum_t checksum;
+    checksum.prop_map_ptr = &_prop_map;
+    checksum.ctx = S3BucketContext{};
+    checksum.ctx.bucketName = bucket.c_str();
+    checksum.ctx.protocol = s3GetProto(_prop_map);
+    checksum.ctx.stsDate = s3GetSTSDate(_prop_map);
+    checksum.ctx.uriStyle = s3_get_uri_request_style(_prop_map);
+    checksum.ctx.accessKeyId = key_id.c_str();
+    checksum.ctx.secretAccessKey = access_key.c_str();
+    std::string region_name = get_region_name(_prop_map);
+    checksum.ctx.authRegion = region_name.c_str();
+    checksum.key = key.c_str();
+    checksum.combine = combine;
+    checksum.result = SUCCESS();
+
+    // the size of the object as S3 has it
+    {
+        S3ResponseHandler headObjectHandler = { &responsePropertiesCallback, &responseCompleteCallback };
+        std::size_t retry_count_limit = get_retry_count(_prop_map);
+        std::size_t retry_wait = get_retry_wait_time_sec(_prop_map);
+        std::size_t max_retry_wait = get_max_retry_wait_time_sec(_prop_map);
+
+        S3BucketContext bucketContext = checksum.ctx;
+        callback_data_t data;
+        std::size_t retry_cnt = 0;
+        do {
+            data = {};
+            data.prop_map_ptr = &_prop_map;
+            std::string&& hostname = s3GetHostname(_prop_map);
+            bucketContext.hostName = hostname.c_str(); // Safe to do, this is a local copy of the data structure
+            data.pCtx = &bucketContext;
+            S3_head_object(&bucketContext, key.c_str(), 0, 0, &headObjectHandler, &data);
+            if (data.status != S3StatusOK) {
+                s3_sleep( retry_wait );
+                retry_wait *= 2;
+                if (retry_wait > max_retry_wait) {
+                    retry_wait = max_retry_wait;
+                }
+            }
+        } while ( (data.status != S3StatusOK) && S3_status_is_retryable(data.status) && (++retry_cnt <= retry_count_limit) );
+
+        if (data.status != S3StatusOK) {
+            return ERROR(S3_FILE_STAT_ERR, fmt::format("[resource_name={}] {} - Error stat'ing the S3 object: \"{}\" - \"{}\"",
+                        resource_name, __FUNCTION__, _file, S3_get_status_name(data.status)));
+        }
+        checksum.object_size = savedProperties.contentLength;
+    }
+
+    std::int64_t number_of_threads = s3_get_checksum_read_threads(_prop_map);
+    checksum.range_size = s3GetMPUChunksize(_prop_map);
+    checksum.number_of_ranges = (checksum.object_size + checksum.range_size - 1) / checksum.range_size;
+    checksum.next_range = 0;
+    number_of_threads = std::max<std::int64_t>(1, std::min(number_of_threads, checksum.number_of_ranges));
+
+    // When hashing in order each reader has a buffer to fill while the hashing thread works
+    // through another, so memory use is bounded by 2 * S3_CHECKSUM_READ_THREADS * S3_MPU_CHUNK.
+    std::vector<checksum_range_t> buffers;
+    if (combine) {
+        checksum.crcs.resize(checksum.number_of_ranges);
+    } else {
+        buffers.resize(std::min<std::int64_t>(2 * number_of_threads, checksum.number_of_ranges));
+        for (auto& buffer : buffers) {
+            buffer.data.resize(std::min<std::int64_t>(checksum.range_size, checksum.object_size));
+            checksum.free_buffers.push_back(&buffer);
+        }
+    }
+
+    s3_logger::debug("[resource_name={}] Parallel checksum: \"{}\" scheme {}, size {}, {} ranges of {} bytes, {} threads",
+            resource_name, _file, _scheme, checksum.object_size, checksum.number_of_ranges, checksum.range_size, number_of_threads);
+
+    std::uint64_t usStart = usNow();
+
+    std::vector<boost::thread> threads;
+    for (std::int64_t i = 0; i < number_of_threads; ++i) {
+        threads.emplace_back(checksumReaderThread, &checksum);
+    }
+
+    // hash the buffered ranges in order as they arrive
+    if (!combine) {
+        for (int seq = 1; seq <= checksum.number_of_ranges; ++seq) {
+            checksum_range_t *range = NULL;
+            {
+                boost::unique_lock<boost::mutex> lock(checksum.lock);
+                checksum.range_filled.wait(lock, [&checksum, seq] {
+                    return !checksum.result.ok() || checksum.filled_ranges.count(seq) > 0;
+                });
+                if (!checksum.result.ok()) {
+                    break;
+                }
+                range = checksum.filled_ranges[seq];
+                checksum.filled_ranges.erase(seq);
+            }
+
+            // irods::Hasher only accepts a std::string
+            hasher.update(std::string(range->data.data(), range->length));
+
+            boost::lock_guard<boost::mutex> lock(checksum.lock);
+            checksum.free_buffers.push_back(range);
+            checksum.buffer_freed.notify_one();
+        }
+
+        // let readers waiting for a buffer see that every range has been read
+        boost::lock_guard<boost::mutex> lock(checksum.lock);
+        checksum.buffer_freed.notify_all();
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::uint64_t usEnd = usNow();
+    double bw = (checksum.object_size / (1024.0*1024.0)) / ( (usEnd - usStart) / 1000000.0 );
+    s3_logger::debug("ParallelChecksumBW={}", bw);
+
+    if (!checksum.result.ok()) {
+        return checksum.result;
+    }
+
+    if (combine) {
+        std::uint64_t crc = 0;
+        for (std::int64_t i = 0; i < checksum.number_of_ranges; ++i) {
+            std::int64_t length = std::min<std::int64_t>(checksum.range_size, checksum.object_size - i * checksum.range_size);
+            crc = s3t::crc64_nvme_combine(crc, checksum.crcs[i], length);
+        }
+#ifdef IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+        std::string prefix(CRC64NVME_CHKSUM_PREFIX);
+#else
+        std::string prefix("crc64nvme:");
+#endif // IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+        _checksum = prefix + s3t::encode_crc64_nvme_checksum(crc);
+    } else {
+        hasher.digest(_checksum);
+    }
+
+    return SUCCESS();
+} // s3_compute_checksum_with_ranged_reads
+
+
+/// @brief Function to copy the specified src file to the specified dest file
+irods::error s3CopyFile(
+    irods::plugin_context& _src_ctx,
+    const std::string& _src_file,
+    const std::string& _dest_file,
+    const std::string& _key_id,
+    const std::string& _access_key,
+    const S3Protocol _proto,
+    const S3STSDate _stsDate,
+    const S3UriStyle _s3_uri_style)
+{
+    std::string src_bucket;
+    std::string src_key;
+    std::string dest_bucket;
+    std::string dest_key;
+
+    std::size_t retry_count_limit = get_retry_count(_src_ctx.prop_map());
+    std::size_t retry_wait = get_retry_wait_time_sec(_src_ctx.prop_map());
+    std::size_t max_retry_wait = get_max_retry_wait_time_sec(_src_ctx.prop_map());
+
+    std::string resource_name = get_resource_name(_src_ctx.prop_map());
+
+    bool mpu_enabled = s3GetEnableMultiPartUpload(_src_ctx.prop_map());
+
+    // Check the size, and if too large punt to the multipart copy/put routine
+    struct stat statbuf = {};
+    auto ret = irods_s3::s3_file_stat_operation( _src_ctx, &statbuf );
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Unable to get original object size for source file name: \"{}\".",
+                    resource_name, _src_file), ret);
+    }
+
+    // Objects larger than a single copy part are copied in parallel with UploadPartCopy.
+    // The copy part size never exceeds s3GetMaxUploadSizeMB() so this also covers objects
+    // that are too large for CopyObject (amazon allows copies up to 5 GB).
+    if ( mpu_enabled && statbuf.st_size > s3_get_copy_part_size(_src_ctx.prop_map()) ) {
+        return s3_copy_object_multipart( _src_ctx.prop_map(), _src_file, _dest_file, statbuf.st_size, _key_id, _access_key );
+    }
+
+    // Note:  If file size > s3GetMaxUploadSizeMB() but multipart is disabled, it is not clear how to proceed.
+    // Go ahead and try a copy.
+
+    // Parse the src file
+    ret = parseS3Path(_src_file, src_bucket, src_key, _src_ctx.prop_map());
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to parse the source file name: \"{}\".",
+                    resource_name, _src_file), ret);
+    }
+
+    // Parse the dest file
+    ret = parseS3Path(_dest_file, dest_bucket, dest_key, _src_ctx.prop_map());
+    if (!ret.ok()) {
+        return PASSMSG(fmt::format(
+                    "[resource_name={}] Failed to parse the destination file name: \"{}\".",
+                    resource_name, _dest_file), ret);
+    }
+
+    callback_data_t data;
     data.prop_map_ptr = &_src_ctx.prop_map();
     S3BucketContext bucketContext;
     std::int64_t lastModified;
@@ -2216,6 +3998,137 @@ irods::error s3CopyFile(
     return ret;
 } // s3CopyFile
 
+irods::error s3_get_upload_checksum_metadata(
+    irods::plugin_property_map& _prop_map,
+    const std::string& _file,
+    std::string& _scheme,
+    std::string& _checksum)
+{
+    std::string bucket;
+    std::string key;
+
+    irods::error ret = parseS3Path(_file, bucket, key, _prop_map);
+    if (!ret.ok()) {
+        return PASS(ret);
+    }
+
+    std::shared_ptr<const irods_s3::resource_config> config;
+    ret = irods_s3::get_resource_config(_prop_map, config);
+    if (!ret.ok()) {
+        return PASS(ret);
+    }
+
+    std::size_t retry_wait = config->retry_wait;
+
+    S3BucketContext bucketContext = config->bucket_context(bucket);
+
+    S3ResponseHandler headObjectHandler = { &responsePropertiesCallback, &responseCompleteCallbackIgnoreLoggingNotFound };
+
+    callback_data_t data;
+    std::size_t retry_cnt = 0;
+    do {
+        data = {};
+        data.prop_map_ptr = &_prop_map;
+        bucketContext.hostName = config->next_hostname().c_str(); // Safe to do, this is a local copy of the data structure
+        data.pCtx = &bucketContext;
+        S3_head_object(&bucketContext, key.c_str(), 0, 0, &headObjectHandler, &data);
+        if (data.status != S3StatusOK) {
+            s3_sleep( retry_wait );
+            retry_wait *= 2;
+            if (retry_wait > config->max_retry_wait) {
+                retry_wait = config->max_retry_wait;
+            }
+        }
+    } while ( (data.status != S3StatusOK) && S3_status_is_retryable(data.status) && (++retry_cnt <= config->retry_count_limit) );
+
+    if (data.status != S3StatusOK) {
+        return ERROR(S3_FILE_STAT_ERR, fmt::format("[resource_name={}] {} - Error stat'ing the S3 object: \"{}\" - \"{}\"",
+                    config->resource_name, __FUNCTION__, _file, S3_get_status_name(data.status)));
+    }
+
+    _scheme = data.upload_checksum_scheme;
+    _checksum = data.upload_checksum;
+    return SUCCESS();
+} // s3_get_upload_checksum_metadata
+
+irods::error s3_put_upload_checksum_metadata(
+    irods::plugin_property_map& _prop_map,
+    const std::string& _file,
+    const std::string& _etag,
+    const std::string& _scheme,
+    const std::string& _checksum)
+{
+    namespace s3t = irods::experimental::io::s3_transport;
+
+    std::string bucket;
+    std::string key;
+
+    irods::error ret = parseS3Path(_file, bucket, key, _prop_map);
+    if (!ret.ok()) {
+        return PASS(ret);
+    }
+
+    std::shared_ptr<const irods_s3::resource_config> config;
+    ret = irods_s3::get_resource_config(_prop_map, config);
+    if (!ret.ok()) {
+        return PASS(ret);
+    }
+
+    std::size_t retry_wait = config->retry_wait;
+
+    S3BucketContext bucketContext = config->bucket_context(bucket);
+
+    S3ResponseHandler responseHandler = { &responsePropertiesCallback, &responseCompleteCallback };
+
+    // Replacing the metadata replaces everything set when the object was created so
+    // send the storage class and encryption setting again.
+    std::string storage_class = s3_get_storage_class_from_configuration(_prop_map);
+    S3NameValue metadata[2] = {
+        { s3t::constants::UPLOAD_CHECKSUM_METADATA_NAME.c_str(), _checksum.c_str() },
+        { s3t::constants::UPLOAD_CHECKSUM_SCHEME_METADATA_NAME.c_str(), _scheme.c_str() }
+    };
+    S3PutProperties putProps;
+    memset(&putProps, 0, sizeof(S3PutProperties));
+    putProps.expires = -1;
+    putProps.useServerSideEncryption = s3GetServerEncrypt(_prop_map);
+    putProps.xAmzStorageClass = storage_class.c_str();
+    putProps.metaDataCount = 2;
+    putProps.metaData = metadata;
+    putProps.xAmzCopySourceIfMatch = _etag.c_str();
+
+    callback_data_t data;
+    std::int64_t lastModified;
+    char eTag[256];
+    std::size_t retry_cnt = 0;
+    do {
+        data = {};
+        data.prop_map_ptr = &_prop_map;
+        bucketContext.hostName = config->next_hostname().c_str(); // Safe to do, this is a local copy of the data structure
+        data.pCtx = &bucketContext;
+        S3_copy_object(&bucketContext, key.c_str(), bucket.c_str(), key.c_str(), &putProps, &lastModified, sizeof(eTag), eTag, 0,
+                0, &responseHandler, &data);
+        if (data.status != S3StatusOK) {
+            s3_sleep( retry_wait );
+            retry_wait *= 2;
+            if (retry_wait > config->max_retry_wait) {
+                retry_wait = config->max_retry_wait;
+            }
+        }
+    } while ( (data.status != S3StatusOK) && S3_status_is_retryable(data.status) && (++retry_cnt <= config->retry_count_limit) );
+
+    if (data.status == S3StatusErrorPreconditionFailed) {
+        return ERROR(S3_FILE_COPY_ERR, fmt::format("[resource_name={}] {} - Not saving the checksum in the metadata of S3 object: \"{}\", "
+                    "it was written again after the upload.", config->resource_name, __FUNCTION__, _file));
+    }
+
+    if (data.status != S3StatusOK) {
+        return ERROR(S3_FILE_COPY_ERR, fmt::format("[resource_name={}] {} - Error saving the checksum in the metadata of S3 object: \"{}\" - \"{}\"",
+                    config->resource_name, __FUNCTION__, _file, S3_get_status_name(data.status)));
+    }
+
+    return SUCCESS();
+} // s3_put_upload_checksum_metadata
+
 irods::error s3GetAuthCredentials(
     irods::plugin_property_map& _prop_map,
     std::string& _rtn_key_id,
@@ -2224,6 +4137,15 @@ irods::error s3GetAuthCredentials(
     std::string key_id;
     std::string access_key;
 
+    // the keys read most recently
+    std::shared_ptr<irods_s3::credential_provider> provider;
+    if (irods_s3::get_credential_provider(_prop_map, provider).ok()) {
+        const irods_s3::s3_credentials& credentials = provider->current();
+        _rtn_key_id = credentials.key_id;
+        _rtn_access_key = credentials.access_key;
+        return SUCCESS();
+    }
+
     std::string resource_name = get_resource_name(_prop_map);
 
     auto ret = _prop_map.get<std::string>(s3_key_id, key_id);
@@ -2263,6 +4185,124 @@ irods::error s3CheckParams(irods::plugin_context& _ctx )
     return ret;
 } // Check Params
 
+struct warm_up_request
+{
+    S3Status                 status{S3StatusOK};
+    const std::atomic<bool>* cancelled{nullptr};
+};
+
+static void warm_up_response_complete_callback(
+    S3Status status,
+    const S3ErrorDetails *error,
+    void *callbackData)
+{
+    // Any answer from the server will do, the connection is what we are after.
+    static_cast<warm_up_request*>(callbackData)->status = status;
+}
+
+static int warm_up_abort_callback(void *callbackData)
+{
+    return static_cast<warm_up_request*>(callbackData)->cancelled->load() ? 1 : 0;
+}
+
+// Precomputes today's signing key and opens _connections keep-alive connections to each
+// host, all hosts at once.  The requests are blocking requests made from separate threads so
+// that each connection is left in the libs3 request pool when the request is released.
+// Connections opened through a curl multi handle belong to the multi handle and would be lost.
+// The requests are aborted when _cancelled is set.  _done is set when the warm up returns.
+static void warm_up_connections(
+    irods::plugin_property_map _prop_map,
+    int _connections,
+    std::shared_ptr<std::atomic<bool>> _cancelled,
+    std::promise<void> _done)
+{
+    const auto signal_done = irods::at_scope_exit{[&_done] { _done.set_value(); }};
+
+    std::string resource_name = get_resource_name(_prop_map);
+
+    std::string key_id;
+    std::string access_key;
+    irods::error ret = s3GetAuthCredentials(_prop_map, key_id, access_key);
+    if (!ret.ok()) {
+        s3_logger::warn("[resource_name={}] Skipping connection warm up.  {}", resource_name, ret.result());
+        return;
+    }
+
+    std::string region_name = get_region_name(_prop_map);
+    S3Status status = S3_precompute_signing_key(access_key.c_str(), region_name.c_str());
+    if (status != S3StatusOK) {
+        s3_logger::warn("[resource_name={}] Failed to precompute the signing key.  {}",
+                resource_name, S3_get_status_name(status));
+    }
+
+    std::string vault_path;
+    std::string bucket;
+    std::string key;
+    ret = _prop_map.get<std::string>(irods::RESOURCE_PATH, vault_path);
+    if (ret.ok()) {
+        // the vault path may be just the bucket
+        ret = parseS3Path(vault_path + "/", bucket, key, _prop_map);
+    }
+    if (!ret.ok()) {
+        s3_logger::warn("[resource_name={}] Skipping connection warm up.  {}", resource_name, ret.result());
+        return;
+    }
+
+    std::vector<std::string> hostname_vector;
+    _prop_map.get<std::vector<std::string>>(s3_default_hostname_vector, hostname_vector);
+
+    S3BucketContext bucketContext = {};
+    bucketContext.bucketName = bucket.c_str();
+    bucketContext.protocol = s3GetProto(_prop_map);
+    bucketContext.stsDate = s3GetSTSDate(_prop_map);
+    bucketContext.uriStyle = s3_get_uri_request_style(_prop_map);
+    bucketContext.accessKeyId = key_id.c_str();
+    bucketContext.secretAccessKey = access_key.c_str();
+    bucketContext.authRegion = region_name.c_str();
+
+    std::vector<S3BucketContext> host_contexts(hostname_vector.size(), bucketContext);
+    std::vector<std::vector<warm_up_request>> requests(hostname_vector.size(),
+            std::vector<warm_up_request>(_connections, warm_up_request{S3StatusOK, _cancelled.get()}));
+
+    std::uint64_t start = usNow();
+    std::vector<std::thread> threads;
+    for (std::size_t h = 0; h < hostname_vector.size(); ++h) {
+        host_contexts[h].hostName = hostname_vector[h].c_str();
+        for (int i = 0; i < _connections; ++i) {
+            threads.emplace_back([&host_contexts, &requests, &_cancelled, h, i] {
+                if (_cancelled->load()) {
+                    return;
+                }
+                S3ResponseHandler handler = { nullptr, &warm_up_response_complete_callback };
+                S3_head_object_ex(&host_contexts[h], nullptr, nullptr, WARM_UP_TIMEOUT_MS, &handler,
+                        &warm_up_abort_callback, &requests[h][i]);
+            });
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (_cancelled->load()) {
+        s3_logger::debug("[resource_name={}] The connection warm up was cancelled.", resource_name);
+        return;
+    }
+
+    for (std::size_t h = 0; h < hostname_vector.size(); ++h) {
+        // statuses from S3StatusErrorAccessDenied on come from the server so the connection was made
+        auto failed = std::count_if(requests[h].begin(), requests[h].end(), [](const warm_up_request& r) {
+            return r.status != S3StatusOK && r.status < S3StatusErrorAccessDenied;
+        });
+        if (failed > 0) {
+            s3_logger::warn("[resource_name={}] {} of {} warm up connections to {} failed.",
+                    resource_name, failed, _connections, hostname_vector[h]);
+        }
+    }
+
+    s3_logger::debug("[resource_name={}] Warmed up {} connections to {} hosts in {} us.",
+            resource_name, _connections, hostname_vector.size(), usNow() - start);
+} // warm_up_connections
+
 /// @brief Start up operation - Initialize the S3 library and set the auth fields in the properties.
 irods:: error s3StartOperation(irods::plugin_property_map& _prop_map)
 {
@@ -2296,6 +4336,47 @@ irods:: error s3StartOperation(irods::plugin_property_map& _prop_map)
         return ret;
     }
 
+    // parse the settings every request needs once, the operations share the snapshot
+    std::shared_ptr<const irods_s3::resource_config> config;
+    ret = irods_s3::get_resource_config(_prop_map, config);
+    if (!ret.ok()) {
+        ret = PASSMSG(fmt::format(
+                        "[resource_name={}] Failed to read the S3 resource settings.",
+                        resource_name), ret);
+        return ret;
+    }
+
+    // Initialize the S3 library for the life of the process.  A failure is not fatal here, the
+    // operations try again.
+    {
+        boost::lock_guard<boost::mutex> lock(g_s3InitLock);
+        ++g_startedResourceCount;
+    }
+    ret = s3InitPerOperation( _prop_map );
+    if (!ret.ok()) {
+        s3_logger::error("[resource_name={}] Failed to initialize the S3 library.  {}",
+                resource_name, ret.result());
+    }
+
+    // pick up deletes queued by agents that exited before sending them
+    irods_s3::start_deferred_delete_worker(_prop_map);
+
+    // open connections and compute the signing key in the background so the resource is not
+    // held up by slow hosts
+    int warm_up_connections_per_host = s3_get_warm_up_connections(_prop_map);
+    if (warm_up_connections_per_host > 0 && S3Initialized) {
+        boost::lock_guard<boost::mutex> lock(g_s3InitLock);
+        if (0 == g_warmUps.count(resource_name)) {
+            auto cancelled = std::make_shared<std::atomic<bool>>(false);
+            std::promise<void> done;
+            auto& warm_up = g_warmUps[resource_name];
+            warm_up.cancelled = cancelled;
+            warm_up.done = done.get_future();
+            warm_up.thread = std::thread{warm_up_connections, _prop_map, warm_up_connections_per_host,
+                    cancelled, std::move(done)};
+        }
+    }
+
     bool attached_mode = true, cacheless_mode = false;
     std::tie(cacheless_mode, attached_mode) = get_modes_from_properties(_prop_map);
 
@@ -2348,7 +4429,43 @@ irods:: error s3StartOperation(irods::plugin_property_map& _prop_map)
 /// and remove system resources
 irods::error s3StopOperation(irods::plugin_property_map& _prop_map)
 {
-    if(S3Initialized) {
+    irods_s3::stop_deferred_delete_worker(_prop_map);
+
+    const std::string resource_name = get_resource_name(_prop_map);
+
+    // Cancel the warm up and wait for it.  Requests it has not sent are skipped and the ones in
+    // flight are aborted.
+    warm_up_thread warm_up;
+    {
+        boost::lock_guard<boost::mutex> lock(g_s3InitLock);
+        auto it = g_warmUps.find(resource_name);
+        if (it != g_warmUps.end()) {
+            it->second.cancelled->store(true);
+            warm_up = std::move(it->second);
+            g_warmUps.erase(it);
+        }
+    }
+
+    if (warm_up.thread.joinable()) {
+        if (std::future_status::ready ==
+                warm_up.done.wait_for(std::chrono::milliseconds(WARM_UP_STOP_TIMEOUT_MS))) {
+            warm_up.thread.join();
+        }
+        else {
+            // The library must outlive the warm up so the count of this resource is kept.
+            s3_logger::warn("[resource_name={}] The connection warm up did not stop within {} ms.  "
+                    "Leaving the S3 library initialized.", resource_name, WARM_UP_STOP_TIMEOUT_MS);
+            warm_up.thread.detach();
+            return SUCCESS();
+        }
+    }
+
+    boost::lock_guard<boost::mutex> lock(g_s3InitLock);
+
+    if (g_startedResourceCount > 0) {
+        --g_startedResourceCount;
+    }
+    if(0 == g_startedResourceCount && S3Initialized) {
         S3Initialized = false;
 
         S3_deinitialize();
@@ -0,0 +1,49 @@
+#ifndef IRODS_S3_TRANSPORT_CACHE_FILE_READER_HPP
+#define IRODS_S3_TRANSPORT_CACHE_FILE_READER_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace irods::experimental::io::s3_transport
+{
+    // Read only view of a cache file that is shared by all of the threads flushing it to S3.
+    // Reads are positional (pread) so the threads do not share a file position and do not
+    // need their own stream.  The kernel is told the file is read sequentially and each part
+    // can ask for its range to be read ahead before it is uploaded.
+    class cache_file_reader
+    {
+        public:
+
+            explicit cache_file_reader(const std::string& _path);
+            ~cache_file_reader();
+
+            cache_file_reader(const cache_file_reader&) = delete;
+            auto operator=(const cache_file_reader&) -> cache_file_reader& = delete;
+
+            auto is_open() const noexcept -> bool
+            {
+                return fd_ != -1;
+            }
+
+            auto fd() const noexcept -> int
+            {
+                return fd_;
+            }
+
+            // size of the file in bytes or -1 on error
+            auto size() const noexcept -> std::int64_t;
+
+            // Read up to _length bytes at _offset into _buffer.  Only returns fewer than
+            // _length bytes at the end of the file.  Returns -1 on error.
+            auto read(std::int64_t _offset, char* _buffer, std::int64_t _length) const noexcept -> std::int64_t;
+
+            // Hint that [_offset, _offset + _length) will be read soon
+            void will_need(std::int64_t _offset, std::int64_t _length) const noexcept;
+
+        private:
+
+            int fd_;
+    }; // class cache_file_reader
+} // namespace irods::experimental::io::s3_transport
+
+#endif // IRODS_S3_TRANSPORT_CACHE_FILE_READER_HPP
@@ -0,0 +1,42 @@
+#ifndef IRODS_S3_TRANSPORT_CACHE_FILE_WRITER_HPP
+#define IRODS_S3_TRANSPORT_CACHE_FILE_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace irods::experimental::io::s3_transport
+{
+    // Write only view of a cache file that is shared by all of the threads downloading an
+    // object into it.  The file is truncated once when it is opened, unless _truncate is false,
+    // and each thread writes its own range with positional writes (pwrite).
+    class cache_file_writer
+    {
+        public:
+
+            explicit cache_file_writer(const std::string& _path, bool _truncate = true);
+            ~cache_file_writer();
+
+            cache_file_writer(const cache_file_writer&) = delete;
+            auto operator=(const cache_file_writer&) -> cache_file_writer& = delete;
+
+            auto is_open() const noexcept -> bool
+            {
+                return fd_ != -1;
+            }
+
+            auto fd() const noexcept -> int
+            {
+                return fd_;
+            }
+
+            // Write all _length bytes at _offset.  Returns false on error.
+            auto write(std::int64_t _offset, const char* _data, std::size_t _length) const noexcept -> bool;
+
+        private:
+
+            int fd_;
+    }; // class cache_file_writer
+} // namespace irods::experimental::io::s3_transport
+
+#endif // IRODS_S3_TRANSPORT_CACHE_FILE_WRITER_HPP
@@ -13,6 +13,8 @@
 #include <ctime>
 #include <fstream>
 #include <cstring>
+#include <memory>
+#include <algorithm>
 
 // boost includes
 #include <boost/algorithm/string/predicate.hpp>
@@ -35,7 +37,10 @@
 #include "irods/private/s3_transport/multipart_shared_data.hpp"
 #include "irods/private/s3_transport/types.hpp"
 #include "irods/private/s3_transport/logging_category.hpp"
-#include "irods/irods_hasher_factory.hpp"
+#include "irods/private/s3_transport/crc64_nvme.hpp"
+#include "irods/private/s3_transport/cache_file_reader.hpp"
+#include "irods/private/s3_transport/cache_file_writer.hpp"
+#include "irods/private/s3_transport/io_uring_file_io.hpp"
 
 // iRODS includes
 #include <irods/library_features.h>
@@ -142,51 +147,54 @@ namespace irods::experimental::io::s3_transport
             {
                 assert(libs3_buffer_size >= 0);
 
-                if (!cache_fstream.is_open()) {
-                    cache_fstream.open(filename.c_str(), std::ios_base::out);
-                }
-
-                if (!cache_fstream) {
+                if (!cache_file || !cache_file->is_open()) {
                     logger::error("{}:{} ({}) [[{}]] could not open cache file",
                             __FILE__, __LINE__, __func__, this->thread_identifier);
                     return S3StatusAbortedByCallback;
                 }
 
                 // writing output to cache file
-                cache_fstream.seekp(this->offset);
-                cache_fstream.write(libs3_buffer, libs3_buffer_size);
+                const bool wrote = io_uring
+                    ? io_uring->write(cache_file->fd(), this->offset, libs3_buffer, libs3_buffer_size)
+                    : cache_file->write(this->offset, libs3_buffer, libs3_buffer_size);
 
-                auto wrote = static_cast<std::int64_t>(cache_fstream.tellp()) - this->offset;
-                if (wrote>0) {
-                    this->offset += wrote;
-                    this->bytes_read_from_s3 += wrote;
+                if (!wrote) {
+                    logger::error("{}:{} ({}) [[{}]] failed to write to cache file",
+                            __FILE__, __LINE__, __func__, this->thread_identifier);
+                    return S3StatusAbortedByCallback;
                 }
 
-                return ((wrote < static_cast<decltype(wrote)>(libs3_buffer_size)) ?
-                        S3StatusAbortedByCallback : libs3_types::status_ok);
+                this->offset += libs3_buffer_size;
+                this->bytes_read_from_s3 += libs3_buffer_size;
+
+                return libs3_types::status_ok;
 
             }
 
-            ~callback_for_read_from_s3_to_cache() {
-                if (cache_fstream.is_open()) {
-                    cache_fstream.close();
-                }
-            };
+            // the writer is shared by all of the download threads
+            void set_cache_file_writer(std::shared_ptr<const cache_file_writer> _cache_file)
+            {
+                cache_file = std::move(_cache_file);
+            }
 
-            void set_and_open_cache_file(std::string& f)
+            // Write the cache file through io_uring.  Returns false, leaving the writes
+            // synchronous, if the ring can not be created.
+            bool enable_io_uring()
             {
-                filename = f;
-                cache_fstream.open(filename.c_str(), std::ios_base::out);
-                if (!cache_fstream) {
-                    logger::error("{}:{} ({}) [[{}]] could not open cache file",
-                            __FILE__, __LINE__, __func__, this->thread_identifier);
-                }
+                io_uring = io_uring_file_io::create();
+                return io_uring != nullptr;
+            }
+
+            // Wait for the writes still queued in the ring.  Returns false if any failed.
+            bool finish_writes()
+            {
+                return !io_uring || io_uring->wait_for_writes();
             }
 
         private:
 
-            std::string   filename;
-            std::ofstream cache_fstream;
+            std::shared_ptr<const cache_file_writer> cache_file;
+            std::unique_ptr<io_uring_file_io>        io_uring;
 
     };
 
@@ -241,6 +249,82 @@ namespace irods::experimental::io::s3_transport
 
     };
 
+    // Reads one range of the object and scatters it into the buffers of the ranges it covers.
+    // Bytes between the ranges are discarded.
+    class callback_for_read_from_s3_to_ranges : public callback_for_read_from_s3_base
+    {
+
+        public:
+
+            struct segment
+            {
+                std::int64_t            offset;   // relative to the start of the GET
+                std::int64_t            length;
+                libs3_types::char_type *buffer;
+            };
+
+            explicit callback_for_read_from_s3_to_ranges(libs3_types::bucket_context& _saved_bucket_context)
+                : callback_for_read_from_s3_base{_saved_bucket_context}
+                , segments{}
+                , first_segment{0}
+            {}
+
+            libs3_types::status callback_implementation(int libs3_buffer_size,
+                                                        const libs3_types::char_type *libs3_buffer)
+            {
+                assert(libs3_buffer_size >= 0);
+
+                const std::int64_t start = this->offset;
+                const std::int64_t end = start + libs3_buffer_size;
+
+                if (end > this->content_length) {
+                    return S3StatusAbortedByCallback;
+                }
+
+                // the segments are sorted by offset, skip the ones that are complete
+                while (first_segment < segments.size() &&
+                        segments[first_segment].offset + segments[first_segment].length <= start) {
+                    ++first_segment;
+                }
+
+                for (std::size_t i = first_segment; i < segments.size() && segments[i].offset < end; ++i) {
+                    const auto& s = segments[i];
+                    const std::int64_t copy_start = std::max(start, s.offset);
+                    const std::int64_t copy_end = std::min(end, s.offset + s.length);
+                    if (copy_start < copy_end) {
+                        memcpy(s.buffer + (copy_start - s.offset), libs3_buffer + (copy_start - start), copy_end - copy_start);
+                    }
+                }
+
+                this->offset = end;
+                this->bytes_read_from_s3 += libs3_buffer_size;
+
+                return libs3_types::status_ok;
+            }
+
+            ~callback_for_read_from_s3_to_ranges() {};
+
+            void add_segment(std::int64_t _offset, std::int64_t _length, libs3_types::char_type* _buffer)
+            {
+                segments.push_back({_offset, _length, _buffer});
+            }
+
+            // reset before the GET is sent or retried
+            void restart()
+            {
+                this->offset = 0;
+                this->bytes_read_from_s3 = 0;
+                this->status = libs3_types::status_ok;
+                first_segment = 0;
+            }
+
+        private:
+
+            std::vector<segment> segments;
+            std::size_t          first_segment;
+
+    };
+
     namespace s3_head_object_callback
     {
         libs3_types::status on_response_properties (const libs3_types::response_properties *properties,
@@ -251,6 +335,17 @@ namespace irods::experimental::io::s3_transport
                                        void *callback_data);
     }
 
+    // callbacks for S3_copy_object_range, callback_data is a data_for_copy_part_callback
+    namespace s3_copy_part_callback
+    {
+        libs3_types::status on_response_properties (const libs3_types::response_properties *properties,
+                                                    void *callback_data);
+
+        void on_response_complete (libs3_types::status status,
+                                       const libs3_types::error_details *error,
+                                       void *callback_data);
+    }
+
     namespace s3_upload
     {
 
@@ -277,11 +372,8 @@ namespace irods::experimental::io::s3_transport
                     , transport_object_ptr{nullptr}
                     , calculate_crc64_nvme{false}
                     , trailing_checksum_value{}
-                {
-#ifdef IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
-                    irods::getHasher(irods::CRC64NVME_NAME.data(), hasher);
-#endif
-                }
+                    , hasher{}
+                {}
 
 
                 virtual int callback_implementation(int libs3_buffer_size,
@@ -300,7 +392,7 @@ namespace irods::experimental::io::s3_transport
                         static_cast<callback_for_write_to_s3_base*>(callback_data);
 
                     // just touch shmem so we know we are active
-                    if (data->callback_counter++ % 10000 == 0) {
+                    if (data->callback_counter++ % 10000 == 0 && !data->shmem_key.empty()) {
                         auto shmem_key =  data->shmem_key;
                         auto shared_memory_timeout_in_seconds = data->shared_memory_timeout_in_seconds;
 
@@ -315,6 +407,9 @@ namespace irods::experimental::io::s3_transport
                 static libs3_types::status on_response_properties(const libs3_types::response_properties *properties,
                                                                   void *callback_data)
                 {
+                    callback_for_write_to_s3_base *data =
+                        static_cast<callback_for_write_to_s3_base*>(callback_data);
+                    data->manager.etag = properties->eTag ? properties->eTag : "";
                     return libs3_types::status_ok;
                 }
 
@@ -359,7 +454,7 @@ namespace irods::experimental::io::s3_transport
                 s3_transport<CharT>*         transport_object_ptr;
                 bool                         calculate_crc64_nvme;
                 std::string                  trailing_checksum_value;  // Stores checksum for trailing headers callback
-                irods::Hasher                hasher;
+                crc64_nvme_hasher            hasher;                   // CRC64/NVME of the bytes sent for this part
         };
 
         template <typename CharT>
@@ -379,11 +474,7 @@ namespace irods::experimental::io::s3_transport
 
                     assert(libs3_buffer_size >= 0);
 
-                    if (!cache_fstream.is_open()) {
-                        cache_fstream.open(filename.c_str(), std::ios_base::in);
-                    }
-
-                    if (!cache_fstream) {
+                    if (!cache_file || !cache_file->is_open()) {
                         logger::error("{}:{} ({}) [[{}]] could not open cache file",
                                 __FILE__, __LINE__, __func__, this->thread_identifier);
                         return S3StatusAbortedByCallback;
@@ -395,17 +486,17 @@ namespace irods::experimental::io::s3_transport
                         ? static_cast<std::int64_t>(libs3_buffer_size)
                         : this->content_length - this->bytes_written;
 
-                    cache_fstream.seekg(this->offset);
-                    cache_fstream.read(libs3_buffer, length_to_read_from_cache);
-
-                    auto bytes_read_from_cache = static_cast<std::int64_t>(cache_fstream.tellg()) - this->offset;
+                    auto bytes_read_from_cache = io_uring
+                        ? io_uring->read(cache_file->fd(), this->offset, libs3_buffer, length_to_read_from_cache,
+                                this->offset + (this->content_length - this->bytes_written))
+                        : cache_file->read(this->offset, libs3_buffer, length_to_read_from_cache);
                     if (bytes_read_from_cache > 0) {
                         this->offset += bytes_read_from_cache;
                         this->bytes_written += bytes_read_from_cache;
 
                         // Update hasher for trailing checksum calculation
                         if (this->calculate_crc64_nvme) {
-                            this->hasher.update(std::string(libs3_buffer, bytes_read_from_cache));
+                            this->hasher.update({libs3_buffer, static_cast<std::size_t>(bytes_read_from_cache)});
                         }
                     }
 
@@ -415,26 +506,24 @@ namespace irods::experimental::io::s3_transport
 
                 void post_success_cleanup() {}
 
-                ~callback_for_write_from_cache_to_s3() {
-                    if (cache_fstream.is_open()) {
-                        cache_fstream.close();
-                    }
-                };
+                // the reader is shared by all of the parts of the flush
+                void set_cache_file_reader(std::shared_ptr<const cache_file_reader> _cache_file)
+                {
+                    cache_file = std::move(_cache_file);
+                }
 
-                void set_and_open_cache_file(std::string& f)
+                // Read the cache file through io_uring, reading ahead of libs3.  Returns false,
+                // leaving the reads synchronous, if the ring can not be created.
+                bool enable_io_uring()
                 {
-                    filename = f;
-                    cache_fstream.open(filename.c_str(), std::ios_base::in);
-                    if (!cache_fstream) {
-                        logger::error("{}:{} ({}) [[{}]] could not open cache file",
-                                __FILE__, __LINE__, __func__, this->thread_identifier);
-                    }
+                    io_uring = io_uring_file_io::create();
+                    return io_uring != nullptr;
                 }
 
             private:
 
-                std::string   filename;
-                std::ifstream cache_fstream;
+                std::shared_ptr<const cache_file_reader> cache_file;
+                std::unique_ptr<io_uring_file_io>        io_uring;
 
         };
 
@@ -509,7 +598,7 @@ namespace irods::experimental::io::s3_transport
                     }
 
                     if (this->calculate_crc64_nvme) {
-                        this->hasher.update(std::string(libs3_buffer, bytes_to_return));
+                        this->hasher.update({libs3_buffer, static_cast<std::size_t>(bytes_to_return)});
                     }
                     this->bytes_written += bytes_to_return;
 
@@ -536,6 +625,54 @@ namespace irods::experimental::io::s3_transport
 
         };
 
+        // Uploads an object that was accumulated in memory by the small object fast path
+        template <typename CharT>
+        class callback_for_write_from_memory_to_s3 : public callback_for_write_to_s3_base<CharT>
+        {
+
+            public:
+
+                callback_for_write_from_memory_to_s3(libs3_types::bucket_context& _saved_bucket_context,
+                                                     upload_manager& _manager,
+                                                     const std::vector<CharT>& _buffer)
+                    : callback_for_write_to_s3_base<CharT>{_saved_bucket_context, _manager}
+                    , buffer{_buffer}
+                {}
+
+                int callback_implementation(int libs3_buffer_size,
+                                            libs3_types::buffer_type libs3_buffer)
+                {
+                    assert(libs3_buffer_size >= 0);
+
+                    // if we've already written the expected number of bytes, just return 0 which will
+                    // trigger the completion
+                    if (this->content_length <= this->bytes_written) {
+                        return 0;
+                    }
+
+                    auto bytes_to_return =
+                        libs3_buffer_size < this->content_length - this->bytes_written
+                        ? libs3_buffer_size
+                        : this->content_length - this->bytes_written;
+
+                    std::memcpy(libs3_buffer, buffer.data() + this->bytes_written, bytes_to_return);
+
+                    if (this->calculate_crc64_nvme) {
+                        this->hasher.update({libs3_buffer, static_cast<std::size_t>(bytes_to_return)});
+                    }
+                    this->bytes_written += bytes_to_return;
+
+                    return bytes_to_return;
+                }
+
+                void post_success_cleanup() {}
+
+                ~callback_for_write_from_memory_to_s3() {};
+
+                const std::vector<CharT>& buffer;
+
+        };
+
     } // end namespace s3_upload
 
     namespace s3_multipart_upload
@@ -570,6 +707,11 @@ namespace irods::experimental::io::s3_transport
                                          const libs3_types::error_details *error,
                                          void *callback_data);
 
+            // saves the ETag of the completed object in the upload_manager
+            libs3_types::status on_commit_response (const libs3_types::char_type* location,
+                                                    const libs3_types::char_type* etag,
+                                                    void *callback_data);
+
         } // end namespace commit_callback
 
         template <typename CharT>
@@ -596,11 +738,8 @@ namespace irods::experimental::io::s3_transport
                     , transport_object_ptr{nullptr}
                     , calculate_crc64_nvme{false}
                     , trailing_checksum_value{}
-                {
-#ifdef IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
-                    irods::getHasher(irods::CRC64NVME_NAME.data(), hasher);
-#endif
-                }
+                    , hasher{}
+                {}
 
 
                 virtual int callback_implementation(int libs3_buffer_size,
@@ -718,7 +857,7 @@ namespace irods::experimental::io::s3_transport
                 s3_transport<CharT>*         transport_object_ptr;
                 bool                         calculate_crc64_nvme;
                 std::string                  trailing_checksum_value;  // Stores checksum for trailing headers callback
-                irods::Hasher                hasher;
+                crc64_nvme_hasher            hasher;                   // CRC64/NVME of the bytes sent for this part
 
         };
 
@@ -739,11 +878,7 @@ namespace irods::experimental::io::s3_transport
 
                     assert(libs3_buffer_size >= 0);
 
-                    if (!cache_fstream.is_open()) {
-                        cache_fstream.open(filename.c_str(), std::ios_base::in);
-                    }
-
-                    if (!cache_fstream) {
+                    if (!cache_file || !cache_file->is_open()) {
                         logger::error("{}:{} ({}) [[{}]] could not open cache file",
                                 __FILE__, __LINE__, __func__, this->thread_identifier);
                         return 0;
@@ -755,17 +890,17 @@ namespace irods::experimental::io::s3_transport
                         ? static_cast<std::int64_t>(libs3_buffer_size)
                         : this->content_length - this->bytes_written;
 
-                    cache_fstream.seekg(this->offset);
-                    cache_fstream.read(libs3_buffer, length_to_read_from_cache);
-
-                    auto bytes_read_from_cache = static_cast<std::int64_t>(cache_fstream.tellg()) - this->offset;
+                    auto bytes_read_from_cache = io_uring
+                        ? io_uring->read(cache_file->fd(), this->offset, libs3_buffer, length_to_read_from_cache,
+                                this->offset + (this->content_length - this->bytes_written))
+                        : cache_file->read(this->offset, libs3_buffer, length_to_read_from_cache);
                     if (bytes_read_from_cache > 0) {
                         this->offset += bytes_read_from_cache;
                         this->bytes_written += bytes_read_from_cache;
 
                         // Update hasher for trailing checksum calculation
                         if (this->calculate_crc64_nvme) {
-                            this->hasher.update(std::string(libs3_buffer, bytes_read_from_cache));
+                            this->hasher.update({libs3_buffer, static_cast<std::size_t>(bytes_read_from_cache)});
                         }
                     }
 
@@ -774,28 +909,26 @@ namespace irods::experimental::io::s3_transport
 
                 }
 
-                ~callback_for_write_from_cache_to_s3() {
-                    if (cache_fstream.is_open()) {
-                        cache_fstream.close();
-                    }
-                };
+                // the reader is shared by all of the parts of the flush
+                void set_cache_file_reader(std::shared_ptr<const cache_file_reader> _cache_file)
+                {
+                    cache_file = std::move(_cache_file);
+                }
 
-                void set_and_open_cache_file(std::string& f)
+                // Read the cache file through io_uring, reading ahead of libs3.  Returns false,
+                // leaving the reads synchronous, if the ring can not be created.
+                bool enable_io_uring()
                 {
-                    filename = f;
-                    cache_fstream.open(filename.c_str(), std::ios_base::in);
-                    if (!cache_fstream) {
-                        logger::error("{}:{} ({}) [[{}]] could not open cache file",
-                                __FILE__, __LINE__, __func__, this->thread_identifier);
-                    }
+                    io_uring = io_uring_file_io::create();
+                    return io_uring != nullptr;
                 }
 
                 void post_success_cleanup() {}
 
             private:
 
-                std::string   filename;
-                std::ifstream cache_fstream;
+                std::shared_ptr<const cache_file_reader> cache_file;
+                std::unique_ptr<io_uring_file_io>        io_uring;
 
         };
 
@@ -875,7 +1008,7 @@ namespace irods::experimental::io::s3_transport
                     }
 
                     if (this->calculate_crc64_nvme) {
-                        this->hasher.update(std::string(libs3_buffer, bytes_to_return));
+                        this->hasher.update({libs3_buffer, static_cast<std::size_t>(bytes_to_return)});
                     }
                     this->bytes_written += bytes_to_return;
 
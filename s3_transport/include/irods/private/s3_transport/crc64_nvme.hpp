@@ -0,0 +1,66 @@
+#ifndef IRODS_S3_TRANSPORT_CRC64_NVME_HPP
+#define IRODS_S3_TRANSPORT_CRC64_NVME_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace irods::experimental::io::s3_transport
+{
+    // Continue the CRC64/NVME _crc over _data and return the new CRC.  Start with 0.  The CRC
+    // of consecutive buffers is the same as the CRC of those buffers concatenated, so data can
+    // be hashed as it arrives without being copied.
+    //
+    // This uses carry-less multiplication (VPCLMULQDQ or PCLMULQDQ) when the CPU supports it
+    // and falls back to a slice-by-8 table otherwise.
+    auto crc64_nvme_update(std::uint64_t _crc, std::span<const char> _data) -> std::uint64_t;
+
+    // Same as crc64_nvme_update() but always uses the table implementation.  Used to verify
+    // and benchmark the accelerated implementations.
+    auto crc64_nvme_update_portable(std::uint64_t _crc, std::span<const char> _data) -> std::uint64_t;
+
+    // The name of the implementation crc64_nvme_update() uses on this CPU
+    // ("vpclmulqdq", "pclmulqdq", or "portable").
+    auto crc64_nvme_implementation() -> const char*;
+
+    // Combine the CRC64/NVME of two adjacent byte ranges.  _crc1 covers the first range and
+    // _crc2 covers the _len2 bytes immediately following it.  The result is the CRC64/NVME
+    // of both ranges.
+    auto crc64_nvme_combine(std::uint64_t _crc1, std::uint64_t _crc2, std::uint64_t _len2) -> std::uint64_t;
+
+    // Running CRC64/NVME of the bytes passed to update()
+    class crc64_nvme_hasher
+    {
+        public:
+
+            void update(std::span<const char> _data)
+            {
+                crc_ = crc64_nvme_update(crc_, _data);
+                length_ += _data.size();
+            }
+
+            void reset()
+            {
+                crc_ = 0;
+                length_ = 0;
+            }
+
+            auto value() const -> std::uint64_t
+            {
+                return crc_;
+            }
+
+            // number of bytes hashed since the last reset()
+            auto length() const -> std::uint64_t
+            {
+                return length_;
+            }
+
+        private:
+
+            std::uint64_t crc_{0};
+            std::uint64_t length_{0};
+    }; // class crc64_nvme_hasher
+} // namespace irods::experimental::io::s3_transport
+
+#endif // IRODS_S3_TRANSPORT_CRC64_NVME_HPP
@@ -0,0 +1,130 @@
+#ifndef IRODS_S3_TRANSPORT_IO_URING_FILE_IO_HPP
+#define IRODS_S3_TRANSPORT_IO_URING_FILE_IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <sys/uio.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace irods::experimental::io::s3_transport
+{
+    // Positional reads and writes of cache files through an io_uring owned by one transfer
+    // thread.  Data is staged in a small set of buffers registered with the kernel so that
+    // the disk I/O runs while the thread is busy with the network:
+    //
+    //   - write() copies into a buffer and only submits it once it is full, so the many small
+    //     pieces libs3 hands over become one write per buffer.
+    //   - read() keeps the buffers reading ahead of the caller up to the end of its range.
+    //
+    // An instance is used for either reads or writes, not both, and is not thread safe.
+    class io_uring_file_io
+    {
+        public:
+
+            static constexpr unsigned int DEFAULT_QUEUE_DEPTH = 8;
+            static constexpr std::size_t  DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+            // True if this kernel lets the process create an io_uring.  Checked once.
+            static auto is_supported() noexcept -> bool;
+
+            // A ring with the default sizes, or null if one can not be created, in which case
+            // use pread/pwrite instead.
+            static auto create() -> std::unique_ptr<io_uring_file_io>;
+
+            io_uring_file_io(unsigned int _queue_depth = DEFAULT_QUEUE_DEPTH,
+                             std::size_t _buffer_size = DEFAULT_BUFFER_SIZE);
+            ~io_uring_file_io();
+
+            io_uring_file_io(const io_uring_file_io&) = delete;
+            auto operator=(const io_uring_file_io&) -> io_uring_file_io& = delete;
+
+            // False if the ring could not be created, in which case use pread/pwrite instead
+            auto is_open() const noexcept -> bool
+            {
+                return ring_fd_ != -1;
+            }
+
+            // Write _length bytes at _offset.  The bytes are copied so _data may be reused on
+            // return.  Returns false if a write submitted earlier has failed.
+            auto write(int _fd, std::int64_t _offset, const char* _data, std::size_t _length) -> bool;
+
+            // Submit anything still staged and wait for all writes.  Returns false if any write
+            // failed since the last call.
+            auto wait_for_writes() -> bool;
+
+            // Read up to _length bytes at _offset into _buffer and read ahead of it up to _end.
+            // Sequential reads are served from the read ahead; any other offset discards it.
+            // Returns the number of bytes read, 0 at end of file, or -1 on error.
+            auto read(int _fd, std::int64_t _offset, char* _buffer, std::size_t _length, std::int64_t _end) -> std::int64_t;
+
+        private:
+
+            enum class slot_state { free, staging, in_flight, complete };
+
+            struct slot
+            {
+                char*         data{nullptr};
+                int           fd{-1};
+                std::int64_t  offset{0};
+                std::size_t   length{0};    // bytes staged to write or requested to read
+                std::int64_t  result{0};    // bytes transferred or -errno
+                std::size_t   consumed{0};  // bytes of a read already returned
+                bool          is_write{false};
+                slot_state    state{slot_state::free};
+            };
+
+            auto setup(unsigned int _queue_depth) -> bool;
+            void teardown() noexcept;
+            void abandon_buffers() noexcept;
+
+            auto acquire_slot() -> int;
+            void submit(int _slot);
+            void submit_staged();
+            auto wait_for_completion() -> bool;
+            void reap();
+            void complete_write(slot& _slot);
+            void discard_read_ahead();
+
+            int          ring_fd_{-1};
+            std::size_t  buffer_size_;
+            bool         buffers_registered_{false};
+
+            void*        sq_ring_{nullptr};
+            std::size_t  sq_ring_size_{0};
+            void*        cq_ring_{nullptr};
+            std::size_t  cq_ring_size_{0};
+            io_uring_sqe* sqes_{nullptr};
+            std::size_t  sqes_size_{0};
+
+            unsigned int* sq_head_{nullptr};
+            unsigned int* sq_tail_{nullptr};
+            unsigned int* sq_mask_{nullptr};
+            unsigned int* sq_array_{nullptr};
+            unsigned int* cq_head_{nullptr};
+            unsigned int* cq_tail_{nullptr};
+            unsigned int* cq_mask_{nullptr};
+            io_uring_cqe* cqes_{nullptr};
+
+            char*             buffers_{nullptr};
+            std::vector<slot> slots_;
+            std::unique_ptr<iovec[]> iovecs_;
+            unsigned int      in_flight_{0};
+
+            // writing
+            int          staging_slot_{-1};
+            bool         write_failed_{false};
+
+            // reading, the slots holding read ahead in file order
+            std::deque<int> read_ahead_;
+            int             read_fd_{-1};
+            std::int64_t    next_read_offset_{0};
+    }; // class io_uring_file_io
+} // namespace irods::experimental::io::s3_transport
+
+#endif // IRODS_S3_TRANSPORT_IO_URING_FILE_IO_HPP
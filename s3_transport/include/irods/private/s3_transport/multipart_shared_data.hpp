@@ -63,6 +63,11 @@ namespace irods::experimental::io::s3_transport::shared_data
             , checksum_vector{allocator}
 			, part_size_vector{allocator}
             , first_open_has_trunc_flag{false}
+            , upload_checksum_ranges{allocator}
+            , upload_checksum_incomplete{false}
+            , sparse_cache_part_size{0}
+            , sparse_cache_part_states{allocator}
+            , sparse_cache_etag{allocator}
         {}
 
         bool can_delete() {
@@ -89,6 +94,22 @@ namespace irods::experimental::io::s3_transport::shared_data
         // this is set so that multiple processes that are used to write to the file don't download the file
         // to cache if the trunc flag is not set.
         bool                                  first_open_has_trunc_flag;
+
+        // When computing the checksum during upload, each thread saves the offset, length, and
+        // CRC64/NVME of the range it wrote here on close so that the last thread to close can
+        // combine them.  The incomplete flag is set if any thread could not compute its part.
+        interprocess_types::uint64_t_vector   upload_checksum_ranges;
+        bool                                  upload_checksum_incomplete;
+
+        // When the cache file is sparse (config::sparse_cache_file_enabled) this is the part size
+        // and there is one sparse_cache_part_state per part of the object that existed when the
+        // cache file was created.  Zero when the whole object was downloaded to the cache file.
+        std::int64_t                          sparse_cache_part_size;
+        interprocess_types::uint64_t_vector   sparse_cache_part_states;
+
+        // The ETag of the object when the sparse cache file was created.  Parts are only
+        // downloaded or copied from the object while it still has this ETag.
+        interprocess_types::shm_char_string   sparse_cache_etag;
     };
 
 }
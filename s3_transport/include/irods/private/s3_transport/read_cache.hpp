@@ -0,0 +1,308 @@
+#ifndef IRODS_S3_TRANSPORT_READ_CACHE_HPP
+#define IRODS_S3_TRANSPORT_READ_CACHE_HPP
+
+#include <boost/interprocess/sync/named_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+#include "irods/private/s3_transport/managed_shared_memory_object.hpp"
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+
+namespace irods::experimental::io::s3_transport
+{
+    // Index of the blocks held by the read cache.  It lives in shared memory so every agent on
+    // the server shares one cache per cache directory.  Blocks are identified by the object
+    // (bucket and key), the version of the object (ETag, size and Last-Modified) and the block
+    // number within the object.  This is an open addressing hash table with linear probing.
+    //
+    // The used slots are also on two doubly linked lists of slot numbers, so that neither
+    // eviction nor invalidation scans the table:
+    //   - the LRU list, least recently used first
+    //   - the list of the object bucket their object hashes to, so the blocks of an object are
+    //     found among the few objects that share its bucket
+    struct read_cache_index
+    {
+        static constexpr std::size_t NUMBER_OF_SLOTS{65536};
+
+        // keep the table at most half full
+        static constexpr std::size_t MAXIMUM_NUMBER_OF_BLOCKS{NUMBER_OF_SLOTS / 2};
+
+        static constexpr std::size_t NUMBER_OF_OBJECT_BUCKETS{4096};
+
+        // the end of a list
+        static constexpr std::uint32_t NIL{UINT32_MAX};
+
+        enum class slot_state : std::uint8_t { empty, used, deleted };
+
+        struct slot
+        {
+            std::uint64_t object_id;
+            std::uint64_t version_id;
+            std::uint64_t block;
+            std::uint32_t length;
+            std::uint32_t lru_prev;
+            std::uint32_t lru_next;
+            std::uint32_t bucket_prev;
+            std::uint32_t bucket_next;
+            slot_state    state;
+        };
+
+        explicit read_cache_index(const irods::experimental::interprocess::shared_memory::void_allocator& allocator)
+            : ref_count{0}
+            , loaded{false}
+            , number_used{0}
+            , number_deleted{0}
+            , bytes_used{0}
+            , hits{0}
+            , misses{0}
+            , insertions{0}
+            , evictions{0}
+            , last_statistics_export{0}
+            , lru_head{NIL}
+            , lru_tail{NIL}
+            , bucket_heads{}
+            , slots{}
+        {
+            bucket_heads.fill(NIL);
+        }
+
+        // the index must outlive the agents that filled it
+        bool can_delete() {
+            return false;
+        }
+
+        slot* find(std::uint64_t _object_id, std::uint64_t _version_id, std::uint64_t _block)
+        {
+            for (std::size_t i = 0, s = home(_object_id, _version_id, _block); i < NUMBER_OF_SLOTS; ++i, s = (s + 1) % NUMBER_OF_SLOTS) {
+                slot& e = slots[s];
+                if (e.state == slot_state::empty) {
+                    return nullptr;
+                }
+                if (e.state == slot_state::used && e.object_id == _object_id &&
+                        e.version_id == _version_id && e.block == _block) {
+                    return &e;
+                }
+            }
+            return nullptr;
+        }
+
+        // The caller makes sure the block is not already present and there is room for it
+        slot& insert(std::uint64_t _object_id, std::uint64_t _version_id, std::uint64_t _block, std::uint32_t _length)
+        {
+            if (number_used + number_deleted >= NUMBER_OF_SLOTS * 3 / 4) {
+                rehash();
+            }
+
+            slot& e = place(slot{_object_id, _version_id, _block, _length, NIL, NIL, NIL, NIL, slot_state::used});
+            ++number_used;
+            bytes_used += _length;
+            return e;
+        }
+
+        void erase(slot& _slot)
+        {
+            unlink(index_of(_slot));
+            bytes_used -= _slot.length;
+            --number_used;
+            ++number_deleted;
+            _slot.state = slot_state::deleted;
+        }
+
+        // move the slot to the most recently used end of the LRU list
+        void touch(slot& _slot)
+        {
+            const auto s = index_of(_slot);
+            if (s == lru_tail) {
+                return;
+            }
+            unlink_lru(s);
+            link_lru(s);
+        }
+
+        slot* least_recently_used()
+        {
+            return lru_head == NIL ? nullptr : &slots[lru_head];
+        }
+
+        // the first slot on the list of the bucket _object_id hashes to, follow bucket_next
+        std::uint32_t first_in_bucket(std::uint64_t _object_id) const
+        {
+            return bucket_heads[bucket_of(_object_id)];
+        }
+
+        // reinsert every used slot to clear out the deleted ones, keeping the LRU order
+        void rehash()
+        {
+            auto used = std::make_unique<slot[]>(number_used);
+            std::size_t n = 0;
+            for (auto s = lru_head; s != NIL; s = slots[s].lru_next) {
+                used[n++] = slots[s];
+            }
+            for (auto& e : slots) {
+                e.state = slot_state::empty;
+            }
+            number_deleted = 0;
+            lru_head = lru_tail = NIL;
+            bucket_heads.fill(NIL);
+            for (std::size_t i = 0; i < n; ++i) {
+                place(used[i]);
+            }
+        }
+
+        static std::size_t home(std::uint64_t _object_id, std::uint64_t _version_id, std::uint64_t _block)
+        {
+            std::uint64_t h = _object_id ^ (_version_id * 0x9e3779b97f4a7c15ULL) ^ (_block * 0xc2b2ae3d27d4eb4fULL);
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            return static_cast<std::size_t>(h % NUMBER_OF_SLOTS);
+        }
+
+        static std::size_t bucket_of(std::uint64_t _object_id)
+        {
+            return static_cast<std::size_t>((_object_id ^ (_object_id >> 32)) % NUMBER_OF_OBJECT_BUCKETS);
+        }
+
+        std::uint32_t index_of(const slot& _slot) const
+        {
+            return static_cast<std::uint32_t>(&_slot - slots.data());
+        }
+
+        // put a used slot in the table and at the ends of its lists
+        slot& place(const slot& _slot)
+        {
+            std::size_t s = home(_slot.object_id, _slot.version_id, _slot.block);
+            while (slots[s].state == slot_state::used) {
+                s = (s + 1) % NUMBER_OF_SLOTS;
+            }
+
+            if (slots[s].state == slot_state::deleted) {
+                --number_deleted;
+            }
+            slots[s] = _slot;
+
+            const auto i = static_cast<std::uint32_t>(s);
+            link_lru(i);
+
+            auto& head = bucket_heads[bucket_of(_slot.object_id)];
+            slots[i].bucket_prev = NIL;
+            slots[i].bucket_next = head;
+            if (head != NIL) {
+                slots[head].bucket_prev = i;
+            }
+            head = i;
+
+            return slots[s];
+        }
+
+        void link_lru(std::uint32_t _s)
+        {
+            slots[_s].lru_prev = lru_tail;
+            slots[_s].lru_next = NIL;
+            (lru_tail == NIL ? lru_head : slots[lru_tail].lru_next) = _s;
+            lru_tail = _s;
+        }
+
+        void unlink_lru(std::uint32_t _s)
+        {
+            const slot& e = slots[_s];
+            (e.lru_prev == NIL ? lru_head : slots[e.lru_prev].lru_next) = e.lru_next;
+            (e.lru_next == NIL ? lru_tail : slots[e.lru_next].lru_prev) = e.lru_prev;
+        }
+
+        void unlink(std::uint32_t _s)
+        {
+            unlink_lru(_s);
+
+            const slot& e = slots[_s];
+            (e.bucket_prev == NIL ? bucket_heads[bucket_of(e.object_id)] : slots[e.bucket_prev].bucket_next) = e.bucket_next;
+            if (e.bucket_next != NIL) {
+                slots[e.bucket_next].bucket_prev = e.bucket_prev;
+            }
+        }
+
+        int           ref_count;
+        bool          loaded;        // the blocks already in the cache directory have been indexed
+        std::size_t   number_used;
+        std::size_t   number_deleted;
+        std::uint64_t bytes_used;
+        std::uint64_t hits;
+        std::uint64_t misses;
+        std::uint64_t insertions;
+        std::uint64_t evictions;
+        time_t        last_statistics_export;
+        std::uint32_t lru_head;
+        std::uint32_t lru_tail;
+        std::array<std::uint32_t, NUMBER_OF_OBJECT_BUCKETS> bucket_heads;
+        std::array<slot, NUMBER_OF_SLOTS> slots;
+    }; // struct read_cache_index
+
+    // A size bounded cache of object blocks under the cache directory that persists between
+    // opens, agents and server restarts.  Used in cacheless mode to serve repeated reads of the
+    // same object without going back to S3.  Each block is a file named after its object,
+    // version and block number so the index can be rebuilt from the directory.
+    class read_cache
+    {
+        public:
+
+            static constexpr std::int64_t BLOCK_SIZE{4 * 1024 * 1024};
+
+            struct statistics
+            {
+                std::uint64_t hits;
+                std::uint64_t misses;
+                std::uint64_t insertions;
+                std::uint64_t evictions;
+                std::uint64_t bytes_used;
+                std::uint64_t number_of_blocks;
+            };
+
+            read_cache(const std::string& _cache_directory, std::int64_t _maximum_size);
+            ~read_cache();
+
+            read_cache(const read_cache&) = delete;
+            auto operator=(const read_cache&) -> read_cache& = delete;
+
+            static auto make_object_id(const std::string& _bucket, const std::string& _key) -> std::uint64_t;
+            static auto make_version_id(const std::string& _etag, std::int64_t _size, std::int64_t _last_modified) -> std::uint64_t;
+
+            // Copy _length bytes starting _offset bytes into the block to _buffer.  Returns the
+            // number of bytes copied or -1 if the block is not cached.
+            auto read(std::uint64_t _object_id, std::uint64_t _version_id, std::uint64_t _block,
+                      std::int64_t _offset, char* _buffer, std::int64_t _length) -> std::int64_t;
+
+            // Add a block downloaded from S3, evicting the least recently used blocks to make room
+            void store(std::uint64_t _object_id, std::uint64_t _version_id, std::uint64_t _block,
+                       const char* _data, std::int64_t _length);
+
+            // Remove the blocks of every other version of the object
+            void invalidate_other_versions(std::uint64_t _object_id, std::uint64_t _version_id);
+
+            auto get_statistics() const -> statistics;
+
+            // Write the statistics to the file "statistics.json" in the cache directory, at most
+            // once a minute
+            void export_statistics();
+
+        private:
+
+            using named_shared_memory_object =
+                irods::experimental::interprocess::shared_memory::named_shared_memory_object<read_cache_index>;
+
+            auto block_path(std::uint64_t _object_id, std::uint64_t _version_id, std::uint64_t _block) const -> std::string;
+            void load(read_cache_index& _index);
+            void make_room(read_cache_index& _index, std::uint64_t _length);
+            void remove_block(read_cache_index& _index, read_cache_index::slot& _slot);
+
+            std::string   directory_;
+            std::uint64_t maximum_number_of_blocks_;
+            std::uint64_t maximum_bytes_;
+            std::unique_ptr<named_shared_memory_object> shm_obj_;
+    }; // class read_cache
+} // namespace irods::experimental::io::s3_transport
+
+#endif // IRODS_S3_TRANSPORT_READ_CACHE_HPP
@@ -0,0 +1,81 @@
+#ifndef IRODS_S3_TRANSPORT_READ_PAGE_CACHE_HPP
+#define IRODS_S3_TRANSPORT_READ_PAGE_CACHE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace irods::experimental::io::s3_transport
+{
+    // Small in memory cache of aligned pages of one object, used by a single transport to serve
+    // small random reads (for example HDF5 or NetCDF metadata and chunk reads) without a GET per
+    // read.  A read that misses fetches the aligned pages that cover it with one ranged GET.  When
+    // the miss is within the merge distance of the previous miss, the reads are assumed to be
+    // clustered and the GET is extended to cover the merge distance past the read so that the
+    // following nearby reads are served from memory.
+    class read_page_cache
+    {
+        public:
+
+            static constexpr std::size_t MAXIMUM_NUMBER_OF_PAGES{64};
+
+            struct statistics
+            {
+                std::uint64_t hits;
+                std::uint64_t misses;
+                std::uint64_t requests;
+                std::uint64_t bytes_requested;
+            };
+
+            // Reads _length bytes at _offset of the object into _buffer.  Returns the number of
+            // bytes read, which is less than _length only on error.
+            using fetch_function = std::function<std::int64_t(char* _buffer, std::int64_t _offset, std::int64_t _length)>;
+
+            read_page_cache(std::int64_t _page_size, std::int64_t _merge_distance, std::int64_t _object_size);
+
+            read_page_cache(const read_page_cache&) = delete;
+            auto operator=(const read_page_cache&) -> read_page_cache& = delete;
+
+            // Copy up to _length bytes at _offset to _buffer, fetching missing pages with _fetch.
+            // Returns fewer than _length bytes at the end of the object and -1 if nothing could
+            // be read because a fetch failed.
+            auto read(std::int64_t _offset, char* _buffer, std::int64_t _length, const fetch_function& _fetch) -> std::int64_t;
+
+            auto page_size() const noexcept -> std::int64_t
+            {
+                return page_size_;
+            }
+
+            auto get_statistics() const noexcept -> statistics
+            {
+                return statistics_;
+            }
+
+        private:
+
+            struct page
+            {
+                std::int64_t      number;
+                std::vector<char> data;
+            };
+
+            auto find(std::int64_t _page_number) -> page*;
+            auto fetch(std::int64_t _position, std::int64_t _length, const fetch_function& _fetch) -> bool;
+            auto insert(std::int64_t _page_number) -> page&;
+
+            std::int64_t page_size_;
+            std::int64_t merge_distance_;
+            std::int64_t object_size_;
+            std::int64_t last_miss_position_;
+            statistics   statistics_;
+
+            // most recently used first
+            std::list<page> pages_;
+            std::unordered_map<std::int64_t, std::list<page>::iterator> page_map_;
+            std::vector<char> fetch_buffer_;
+    }; // class read_page_cache
+} // namespace irods::experimental::io::s3_transport
+
+#endif // IRODS_S3_TRANSPORT_READ_PAGE_CACHE_HPP
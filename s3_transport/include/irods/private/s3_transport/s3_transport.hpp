@@ -26,6 +26,7 @@
 #include <thread>
 #include <vector>
 #include <cstdio>
+#include <cstring>
 #include <ios>
 #include <iostream>
 #include <mutex>
@@ -34,8 +35,14 @@
 #include <ctime>
 #include <chrono>
 #include <utility>
+#include <algorithm>
+#include <array>
+#include <memory>
 #include <fmt/format.h>
 
+#include <sys/stat.h>
+#include <unistd.h>
+
 // boost includes
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/interprocess/containers/vector.hpp>
@@ -59,7 +66,12 @@
 #include "irods/private/s3_transport/types.hpp"
 #include "irods/private/s3_transport/util.hpp"
 #include "irods/private/s3_transport/callbacks.hpp"
+#include "irods/private/s3_transport/crc64_nvme.hpp"
+#include "irods/private/s3_transport/cache_file_reader.hpp"
+#include "irods/private/s3_transport/read_cache.hpp"
+#include "irods/private/s3_transport/read_page_cache.hpp"
 #include "irods/private/s3_transport/logging_category.hpp"
+#include "irods/irods_hasher_factory.hpp"
 
 extern const unsigned int S3_DEFAULT_NON_DATA_TRANSFER_TIMEOUT_SECONDS;
 
@@ -92,6 +104,15 @@ namespace irods::experimental::io::s3_transport
             object_s3_status& object_status,
             std::string& storage_class);
 
+    // Same as above and also returns the ETag and Last-Modified time of the object
+    irods::error get_object_s3_status(const std::string& object_key,
+            libs3_types::bucket_context& bucket_context,
+            std::int64_t& object_size,
+            object_s3_status& object_status,
+            std::string& storage_class,
+            std::string& etag,
+            time_t& last_modified);
+
     irods::error handle_glacier_status(const std::string& object_key,
             libs3_types::bucket_context& bucket_context,
             const unsigned int restoration_days,
@@ -142,6 +163,17 @@ namespace irods::experimental::io::s3_transport
             , non_data_transfer_timeout_seconds{S3_DEFAULT_NON_DATA_TRANSFER_TIMEOUT_SECONDS}
             , s3_storage_class{S3_DEFAULT_STORAGE_CLASS}
             , trailing_checksum_on_upload_enabled{false}
+            , small_object_upload_size_limit{0}
+            , upload_checksum_scheme{}
+            , cache_io_uring_enabled{false}
+            , read_cache_size{0}
+            , read_page_size{0}
+            , read_merge_distance{0}
+            , sparse_cache_file_enabled{false}
+            , append_with_copy_enabled{false}
+            , existing_object_size{UNKNOWN_OBJECT_SIZE}
+            , existing_object_etag{}
+            , existing_object_last_modified{0}
         {}
 
         std::int64_t object_size;
@@ -191,6 +223,50 @@ namespace irods::experimental::io::s3_transport
         unsigned int non_data_transfer_timeout_seconds;
         std::string  s3_storage_class;
         bool         trailing_checksum_on_upload_enabled;
+
+        // A single threaded full upload (put_repl_flag) of an object of known size no larger than
+        // this is buffered in memory and written with a single PUT on close.  This bypasses
+        // shared memory, the circular buffer, and the upload thread.  Zero disables this.
+        std::int64_t small_object_upload_size_limit;
+
+        // When not empty, the iRODS hash scheme (for example "sha256") computed over the bytes as
+        // they are written.  Ranges written by parallel client threads can only be combined when
+        // this is "crc64nvme".  See s3_transport::get_upload_checksum().
+        std::string  upload_checksum_scheme;
+
+        // Read and write cache files through io_uring when the kernel allows it so that disk
+        // I/O overlaps the network.  Falls back to pread/pwrite otherwise.
+        bool         cache_io_uring_enabled;
+
+        // When greater than zero, objects opened read only in cacheless mode are read through a
+        // block cache of at most this many bytes under cache_directory.  See read_cache.
+        std::int64_t read_cache_size;
+
+        // When greater than zero, reads smaller than this from objects opened read only in
+        // cacheless mode are served from a small in memory cache of pages of this size.  Misses
+        // within read_merge_distance bytes of the previous miss read ahead to the merge distance.
+        // See read_page_cache.
+        std::int64_t read_page_size;
+        std::int64_t read_merge_distance;
+
+        // When true, an existing object opened for update without the trunc flag is not downloaded
+        // to the cache file when it is opened.  Parts are downloaded when they are first read or
+        // written and on close the parts that were not modified are copied within S3 with
+        // UploadPartCopy.  Requires multipart uploads.
+        bool         sparse_cache_file_enabled;
+
+        // When true, an existing object opened for append is handled with a sparse cache file
+        // even if sparse_cache_file_enabled is false.  The existing object is copied within S3
+        // and only the appended bytes are uploaded.  The copy fails if the object was replaced
+        // after it was opened.
+        bool         append_with_copy_enabled;
+
+        // When existing_object_size is not UNKNOWN_OBJECT_SIZE, the caller did a HEAD of the object
+        // a moment ago and found it in S3 (not archived).  The transport uses these values rather
+        // than sending its own HEAD when the object is opened.
+        std::int64_t existing_object_size;
+        std::string  existing_object_etag;
+        time_t       existing_object_last_modified;
     };
 
 
@@ -208,6 +284,15 @@ namespace irods::experimental::io::s3_transport
         using off_type    = typename traits_type::off_type;
         // clang-format on
 
+        // One range of a vectored read.  See receive_ranges().
+        struct read_range
+        {
+            off_type        offset;
+            std::streamsize length;
+            char_type*      buffer;
+            std::streamsize bytes_read;
+        };
+
     private:
 
         using named_shared_memory_object =
@@ -222,6 +307,10 @@ namespace irods::experimental::io::s3_transport
         inline static constexpr auto translation_error             = -1;
         inline static const     auto seek_error                    = pos_type{off_type{-1}};
 
+        // Vectored reads
+        inline static constexpr std::int64_t maximum_range_gap                 = 64 * 1024;
+        inline static constexpr std::size_t  maximum_concurrent_range_requests = 16;
+
         // clang-format on
 
     public:
@@ -243,12 +332,29 @@ namespace irods::experimental::io::s3_transport
             , mode_{static_cast<std::ios_base::openmode>(0)}
             , file_offset_{0}
             , existing_object_size_{config::UNKNOWN_OBJECT_SIZE}
+            , existing_object_etag_{}
+            , existing_object_last_modified_{0}
+            , read_cache_{}
+            , read_cache_object_id_{0}
+            , read_cache_version_id_{0}
+            , read_page_cache_{}
+            , sparse_cache_part_size_{0}
             , download_to_cache_{true}
             , use_cache_{true}
+            , use_small_object_buffer_{false}
             , object_must_exist_{false}
             , bucket_context_{}
             , upload_manager_{bucket_context_}
             , last_file_to_close_{false}
+            , upload_hasher_{}
+            , upload_crc64_nvme_hasher_{}
+            , upload_checksum_active_{false}
+            , upload_checksum_start_offset_{-1}
+            , upload_checksum_length_{0}
+            , upload_range_digest_{}
+            , upload_checksum_{}
+            , upload_checksum_in_metadata_{false}
+            , upload_etag_{}
             , error_{SUCCESS()}
         {
 
@@ -299,14 +405,7 @@ namespace irods::experimental::io::s3_transport
                 }
             }
 
-            // each process must initialize and deinitiatize.
-            {
-                std::lock_guard<std::mutex> lock(s3_initialized_counter_mutex_);
-                if (--s3_initialized_counter_ == 0) {
-                    S3_deinitialize();
-                }
-            }
-
+            release_small_object_buffer();
         }
 
         off_t get_offset() {
@@ -406,6 +505,38 @@ namespace irods::experimental::io::s3_transport
 
             fd_ = uninitialized_file_descriptor;
 
+            if (read_cache_) {
+                const auto stats = read_cache_->get_statistics();
+                logger::debug("{}:{} ({}) [[{}]] read cache [hits={}][misses={}][insertions={}][evictions={}][bytes_used={}]",
+                        __FILE__, __LINE__, __func__, get_thread_identifier(),
+                        stats.hits, stats.misses, stats.insertions, stats.evictions, stats.bytes_used);
+                read_cache_->export_statistics();
+                read_cache_.reset();
+            }
+
+            if (read_page_cache_) {
+                const auto stats = read_page_cache_->get_statistics();
+                logger::debug("{}:{} ({}) [[{}]] read page cache [hits={}][misses={}][requests={}][bytes_requested={}]",
+                        __FILE__, __LINE__, __func__, get_thread_identifier(),
+                        stats.hits, stats.misses, stats.requests, stats.bytes_requested);
+                read_page_cache_.reset();
+            }
+
+            // Small object fast path.  Nothing else has this object open so just upload the buffer.
+            if (use_small_object_buffer_) {
+                last_file_to_close_ = true;
+                if (upload_checksum_active_ && upload_checksum_covers_object(static_cast<std::int64_t>(small_object_buffer_.size()))) {
+                    digest_upload_checksum(upload_checksum_);
+                }
+                if (!this->get_error().ok()) {
+                    return_value = false;
+                } else if (error_codes::SUCCESS != s3_upload_file()) {
+                    return_value = false;
+                }
+                release_small_object_buffer();
+                return return_value;
+            }
+
             // If the size == 0 and we were not using cache, the call to send() did not
             // pass through transport.  Call send here
             if ((mode_ & std::ios_base::out) && !use_cache_ && config_.object_size == 0) {
@@ -446,6 +577,8 @@ namespace irods::experimental::io::s3_transport
                     data.file_open_counter -= 1;
                 }
 
+                this->save_upload_checksum_range(data);
+
                 logger::debug("{}:{} ({}) [[{}]] close AFTER decrement file_open_counter = {}",
                     __FILE__, __LINE__, __func__, this->get_thread_identifier(), data.file_open_counter);
 
@@ -470,6 +603,9 @@ namespace irods::experimental::io::s3_transport
                     // reset flag indicating that a previous open had the trunc flag set
                     data.first_open_has_trunc_flag = false;
 
+                    // done before the cache flush so the checksum can be stored with the object
+                    this->combine_upload_checksum_ranges(data);
+
                     if (this->use_cache_) {
 
                         rv = additional_processing_enum::DO_FLUSH_CACHE_FILE;
@@ -528,6 +664,13 @@ namespace irods::experimental::io::s3_transport
         {
             if (use_cache_) {
                 auto position_before_read = cache_fstream_.tellg();
+
+                // download the parts of a sparse cache file that have not been read or written yet
+                if (sparse_cache_part_size_ > 0 &&
+                        !download_sparse_cache_parts(position_before_read, _buffer_size, false)) {
+                    return 0;
+                }
+
                 cache_fstream_.read(_buffer, _buffer_size);
                 return cache_fstream_.tellg() - position_before_read;
             }
@@ -547,6 +690,20 @@ namespace irods::experimental::io::s3_transport
         std::streamsize send(const char_type* _buffer,
                              std::streamsize _buffer_size) override
         {
+            update_upload_checksum(_buffer, _buffer_size);
+
+            // Small object fast path.  Accumulate the bytes, they are uploaded on close.
+            if (use_small_object_buffer_) {
+                if (static_cast<std::int64_t>(small_object_buffer_.size()) + _buffer_size > config_.max_single_part_upload_size) {
+                    logger::error("{}:{} ({}) [[{}]] write exceeds the maximum single part upload size",
+                            __FILE__, __LINE__, __func__, get_thread_identifier());
+                    this->set_error(ERROR(S3_PUT_ERROR, "Write exceeds the maximum single part upload size."));
+                    return 0;
+                }
+                small_object_buffer_.insert(small_object_buffer_.end(), _buffer, _buffer + _buffer_size);
+                return _buffer_size;
+            }
+
             thread_local std::ofstream tmp;
 
             named_shared_memory_object shm_obj{shmem_key_,
@@ -555,13 +712,21 @@ namespace irods::experimental::io::s3_transport
 
             if (use_cache_) {
 
+                // Appends only write past the end of the original object which is never
+                // downloaded.  Otherwise the parts must be downloaded before they are written.
+                if (sparse_cache_part_size_ > 0 && !(mode_ & std::ios_base::app) &&
+                        !download_sparse_cache_parts(cache_fstream_.tellp(), _buffer_size, true)) {
+                    return 0;
+                }
+
                 named_shared_memory_object shm_obj{shmem_key_,
                     config_.shared_memory_timeout_in_seconds,
                     constants::MAX_S3_SHMEM_SIZE};
 
-                return shm_obj.atomic_exec([this, _buffer, _buffer_size](auto& data) {
+                return shm_obj.atomic_exec([this, _buffer, _buffer_size](auto&) {
 
                     std::streamoff position_before_write = this->cache_fstream_.tellp();
+
                     this->cache_fstream_.write(_buffer, _buffer_size);
                     this->cache_fstream_.flush();
 
@@ -758,6 +923,32 @@ namespace irods::experimental::io::s3_transport
             return use_cache_;
         }
 
+        // used for unit testing
+        bool get_use_small_object_buffer() {
+            return use_small_object_buffer_;
+        }
+
+        // The checksum (in iRODS format) of the object computed while it was written.  This is only
+        // available to the transport that was the last to close, when config::upload_checksum_scheme
+        // is set, and when every byte of the object was written sequentially within each thread's range.
+        // Otherwise this is empty.
+        const std::string& get_upload_checksum() const {
+            return upload_checksum_;
+        }
+
+        // True if get_upload_checksum() was stored in the object's metadata when it was uploaded.
+        // This is only possible when the upload started after all of the data was written, for
+        // example when flushing the cache file.
+        bool is_upload_checksum_in_object_metadata() const {
+            return upload_checksum_in_metadata_;
+        }
+
+        // The ETag S3 returned when this transport uploaded the object or completed its multipart
+        // upload.  Empty if this transport did not finish the upload or the response had no ETag.
+        const std::string& get_upload_etag() const {
+            return upload_etag_;
+        }
+
         void set_error(const irods::error& e) {
             std::lock_guard<std::mutex> lock(error_mutex_);
             error_ = e;
@@ -837,6 +1028,51 @@ namespace irods::experimental::io::s3_transport
             return existing_object_size_;
         }
 
+        // Vectored read.  Reads each range into its buffer and sets bytes_read, which is less
+        // than length only at the end of the object or on error.  Ranges that are adjacent,
+        // overlap, or are close together are merged into one ranged GET and the GETs are sent
+        // concurrently.  The data is written directly into the buffers of the ranges.
+        //
+        // The read position is not changed so this can be called on the transport of an open
+        // dstream.  Returns the total number of bytes read.  On error the error is set.
+        std::streamsize receive_ranges(std::vector<read_range>& _ranges)
+        {
+            for (auto& r : _ranges) {
+                r.bytes_read = 0;
+            }
+
+            if (!is_open()) {
+                return 0;
+            }
+
+            std::streamsize total_bytes = 0;
+
+            if (use_cache_) {
+                const auto position = cache_fstream_.tellg();
+                for (auto& r : _ranges) {
+                    cache_fstream_.clear();
+                    cache_fstream_.seekg(r.offset);
+                    cache_fstream_.read(r.buffer, r.length);
+                    r.bytes_read = cache_fstream_.gcount();
+                    total_bytes += r.bytes_read;
+                }
+                cache_fstream_.clear();
+                cache_fstream_.seekg(position);
+                return total_bytes;
+            }
+
+            // the local caches serve the ranges themselves
+            if (read_cache_ || read_page_cache_ || existing_object_size_ == config::UNKNOWN_OBJECT_SIZE) {
+                for (auto& r : _ranges) {
+                    r.bytes_read = s3_download_part_worker_routine(r.buffer, r.length, r.offset);
+                    total_bytes += r.bytes_read;
+                }
+                return total_bytes;
+            }
+
+            return receive_ranges_from_s3(_ranges);
+        }
+
         bool is_cache_file_open() {
 
             if (!use_cache_) {
@@ -879,16 +1115,19 @@ namespace irods::experimental::io::s3_transport
 
         auto get_cache_file_size() -> std::int64_t
         {
-            std::fstream fs(cache_file_path_);
-            if (!fs || !fs.is_open()) {
-                logger::error("{}:{} ({}) [[{}]] could not open cache file to get size",
+            if (cache_file_reader_) {
+                const auto cache_file_size = cache_file_reader_->size();
+                return cache_file_size < 0 ? 0 : cache_file_size;
+            }
+
+            struct stat st{};
+            if (stat(cache_file_path_.c_str(), &st) != 0) {
+                logger::error("{}:{} ({}) [[{}]] could not stat cache file to get size",
                         __FILE__, __LINE__, __func__, get_thread_identifier());
                 return 0;
             }
 
-            fs.seekp(0, std::ios_base::end);
-            auto cache_file_size = fs.tellp();
-            return static_cast<std::int64_t>(cache_file_size) < 0 ? 0 : static_cast<std::int64_t>(cache_file_size);
+            return static_cast<std::int64_t>(st.st_size);
         }
 
         bool begin_multipart_upload(named_shared_memory_object& shm_obj)
@@ -965,6 +1204,15 @@ namespace irods::experimental::io::s3_transport
             // first thread/process will spawn multiple threads to download object to cache
             if (start_download) {
 
+                if (use_sparse_cache_file(s3_object_size)) {
+                    return create_sparse_cache_file(shm_obj, s3_object_size);
+                }
+
+                shm_obj.atomic_exec([](auto& data) {
+                    data.sparse_cache_part_size = 0;
+                    data.sparse_cache_part_states.clear();
+                });
+
                 // download the object to a cache file
 
                 std::int64_t disk_space_available = bf::space(config_.cache_directory).available;
@@ -992,6 +1240,17 @@ namespace irods::experimental::io::s3_transport
 
                 std::int64_t part_size = s3_object_size / number_of_cache_transfer_threads;
 
+                // All of the download threads write the cache file through this one descriptor.
+                cache_file_writer_ = std::make_shared<cache_file_writer>(cache_file_path_);
+                if (!cache_file_writer_->is_open()) {
+                    logger::error("{}:{} ({}) [[{}]] Could not open cache file {}.",
+                            __FILE__, __LINE__, __func__, get_thread_identifier(), cache_file_path_);
+                    cache_file_writer_.reset();
+                    return shm_obj.atomic_exec([](auto& data) {
+                        return data.cache_file_download_progress = cache_file_download_status::FAILED;
+                    });
+                }
+
                 irods::thread_pool threads{static_cast<int>(number_of_cache_transfer_threads)};
 
                 for (unsigned int thr_id= 0; thr_id < number_of_cache_transfer_threads; ++thr_id) {
@@ -1019,6 +1278,7 @@ namespace irods::experimental::io::s3_transport
                     });
                 }
                 threads.join();
+                cache_file_writer_.reset();
 
                 if (bytes_downloaded != s3_object_size) {
                     logger::error("{}:{} ({}) [[{}]] Failed downloading to cache - bytes_downloaded ({}) != s3_object_size ({}).",
@@ -1057,24 +1317,16 @@ namespace irods::experimental::io::s3_transport
             bf::path cache_file =  bf::path(config_.cache_directory) / bf::path(object_key_ + "-cache");
             cache_file_path_ = cache_file.string();
 
-            // calculate the part size
-            std::ifstream ifs;
-            ifs.open(cache_file_path_.c_str(), std::ios::out);
-            if (!ifs || !ifs.is_open()) {
-                logger::error("{}:{} ({}) [[{}]] Failed to open cache file.",
-                        __FILE__, __LINE__, __func__, get_thread_identifier());
-                return error_codes::UPLOAD_FILE_ERROR;
+            sparse_cache_part_size_ = shm_obj.atomic_exec([](auto& data) { return data.sparse_cache_part_size; });
+            if (sparse_cache_part_size_ > 0) {
+                bool upload_whole_file = false;
+                return_value = flush_sparse_cache_file(shm_obj, upload_whole_file);
+                if (!upload_whole_file || error_codes::SUCCESS != return_value) {
+                    return return_value;
+                }
             }
 
-            ifs.seekg(0, std::ios_base::end);
-            std::int64_t cache_file_size = static_cast<std::int64_t>(ifs.tellg());
-            ifs.close();
-
-            logger::debug("{}:{} ({}) [[{}]] cache_file_size is {}",
-                    __FILE__, __LINE__, __func__, get_thread_identifier(), cache_file_size);
-            logger::debug("{}:{} ({}) [[{}]] number_of_cache_transfer_threads is {}",
-                    __FILE__, __LINE__, __func__, get_thread_identifier(), config_.number_of_cache_transfer_threads);
-
+            // checked before the cache file is opened so that these returns leave nothing open
             if (config_.number_of_cache_transfer_threads == 0) {
                 logger::error("{}:{} ({}) [[{}]] number_of_cache_transfer_threads set to an invalid value (0).",
                         __FILE__, __LINE__, __func__, get_thread_identifier());
@@ -1087,6 +1339,29 @@ namespace irods::experimental::io::s3_transport
                 return error_codes::UPLOAD_FILE_ERROR;
             }
 
+            // All of the part uploads read the cache file through this one descriptor.
+            cache_file_reader_ = std::make_shared<cache_file_reader>(cache_file_path_);
+            if (!cache_file_reader_->is_open()) {
+                logger::error("{}:{} ({}) [[{}]] Failed to open cache file.",
+                        __FILE__, __LINE__, __func__, get_thread_identifier());
+                cache_file_reader_.reset();
+                return error_codes::UPLOAD_FILE_ERROR;
+            }
+
+            // calculate the part size
+            std::int64_t cache_file_size = cache_file_reader_->size();
+            if (cache_file_size < 0) {
+                logger::error("{}:{} ({}) [[{}]] Failed to get the size of the cache file.",
+                        __FILE__, __LINE__, __func__, get_thread_identifier());
+                cache_file_reader_.reset();
+                return error_codes::UPLOAD_FILE_ERROR;
+            }
+
+            logger::debug("{}:{} ({}) [[{}]] cache_file_size is {}",
+                    __FILE__, __LINE__, __func__, get_thread_identifier(), cache_file_size);
+            logger::debug("{}:{} ({}) [[{}]] number_of_cache_transfer_threads is {}",
+                    __FILE__, __LINE__, __func__, get_thread_identifier(), config_.number_of_cache_transfer_threads);
+
             // each part must be at least 5MB in size so adjust number_of_cache_transfer_threads accordingly
             std::int64_t minimum_part_size = config_.minimum_part_size;
             config_.number_of_cache_transfer_threads
@@ -1186,6 +1461,8 @@ namespace irods::experimental::io::s3_transport
                 }
             } // while
 
+            cache_file_reader_.reset();
+
             // remove cache file
             logger::debug("{}:{} ({}) [[{}]] removing cache file {}",
                     __FILE__, __LINE__, __func__, this->get_thread_identifier(), cache_file_path_.c_str());
@@ -1195,145 +1472,557 @@ namespace irods::experimental::io::s3_transport
             // already locked so just exec()
             shm_obj.atomic_exec([](auto& data) {
                     data.cache_file_download_progress = cache_file_download_status::NOT_STARTED;
+                    data.sparse_cache_part_size = 0;
+                    data.sparse_cache_part_states.clear();
                     return data.cache_file_download_progress;
             });
 
             return return_value;
         }
 
-        bool is_full_upload() {
-            //return config_.put_repl_flag;
+        // A sparse cache file is only used when the object is opened for update or append, it spans
+        // at least two parts, and the parts can be copied.  The trailing checksum on upload needs
+        // the data of every part so it can not be used.  The ETag of the object must be known so
+        // that parts are only copied or downloaded from the object that was opened.  Otherwise the
+        // object is downloaded to the cache file.
+        bool use_sparse_cache_file(std::int64_t s3_object_size)
+        {
             using std::ios_base;
+
             const auto m = mode_ & ~(ios_base::ate | ios_base::binary);
-            return (ios_base::out == m && config_.number_of_client_transfer_threads > 1) ||
-                (ios_base::out | ios_base::trunc) == m;
-            //return ( (O_CREAT | O_WRONLY | O_TRUNC) == open_flags );
+            const bool update = ios_base::out == m || (ios_base::out | ios_base::in) == m;
+            const bool append = ios_base::app == m || (ios_base::out | ios_base::app) == m ||
+                (ios_base::out | ios_base::in | ios_base::app) == m || (ios_base::in | ios_base::app) == m;
+
+            return ((update && config_.sparse_cache_file_enabled) ||
+                    (append && (config_.sparse_cache_file_enabled || config_.append_with_copy_enabled))) &&
+                config_.multipart_enabled &&
+                !config_.trailing_checksum_on_upload_enabled &&
+                !existing_object_etag_.empty() &&
+                s3_object_size > get_sparse_cache_part_size(s3_object_size);
         }
 
-        // This populates the following flags based on the open mode (mode_).
-        //   - use_cache_         - Always set to true in the following circumstances
-        //                          * The object was not opened in read only mode and one of the following are true:
-        //                            * the number of transfer threads > 1 and MPU is disabled
-        //                            * the part sizes would be less than the minimum number allowed
-        //                            * the put_repl_flag is false indicating no predictable full file write
-        //                            * do not know the object size
-        //                         - Otherwise set to false
-        //
-        //   - download_to_cache_ - Set to true unless one of the following is true:
-        //                             * the object is opened in read only mode
-        //                             * the trunc flag is set
-        //   - object_must_exist_ - See table "Action if file does not exist" in the table at the
-        //                          following link: https://en.cppreference.com/w/cpp/io/basic_filebuf/open
-        void populate_open_mode_flags() noexcept
+        // The part size leaves room for the object to double in size without going over the
+        // maximum number of parts.  Rounded up to a MiB.
+        std::int64_t get_sparse_cache_part_size(std::int64_t s3_object_size)
         {
+            const std::int64_t mb = 1024 * 1024;
+            const std::int64_t maximum_number_of_parts = constants::MAXIMUM_NUMBER_ETAGS_PER_UPLOAD / 2;
+            const std::int64_t part_size = std::max<std::int64_t>(config_.minimum_part_size,
+                    (s3_object_size + maximum_number_of_parts - 1) / maximum_number_of_parts);
+            return (part_size + mb - 1) / mb * mb;
+        }
 
-            using std::ios_base;
+        // Create a cache file with the size of the object without downloading it.  Parts are
+        // downloaded by download_sparse_cache_parts() when they are first read or written.
+        cache_file_download_status create_sparse_cache_file(named_shared_memory_object& shm_obj,
+                std::int64_t s3_object_size)
+        {
+            const std::int64_t part_size = get_sparse_cache_part_size(s3_object_size);
+            const std::int64_t number_of_parts = (s3_object_size + part_size - 1) / part_size;
 
-            const auto m = mode_ & ~(ios_base::ate | ios_base::binary);
+            logger::debug("{}:{} ({}) [[{}]] creating sparse cache file {} [object_size={}][part_size={}]",
+                    __FILE__, __LINE__, __func__, get_thread_identifier(), cache_file_path_, s3_object_size, part_size);
 
-            // read only, do not use cache
-            if (ios_base::in == m) {
-                download_to_cache_ = false;
-                use_cache_ = false;
-                object_must_exist_ = true;
+            {
+                cache_file_writer writer{cache_file_path_};
+                if (!writer.is_open() || ::ftruncate(writer.fd(), s3_object_size) != 0) {
+                    logger::error("{}:{} ({}) [[{}]] Could not create sparse cache file {}.  {}",
+                            __FILE__, __LINE__, __func__, get_thread_identifier(), cache_file_path_, strerror(errno));
+                    return shm_obj.atomic_exec([](auto& data) {
+                        return data.cache_file_download_progress = cache_file_download_status::FAILED;
+                    });
+                }
             }
-            // put_repl_flag is a contract that says the full file will be written in a similar
-            // manner as iput.
-            else if (config_.put_repl_flag) {
-                download_to_cache_ = false;
-                use_cache_ = false;
-                object_must_exist_ = false;
 
-                // override for cases where we must use cache
-                //   1. If we don't know the file size.
-                //   2. If we don't know the # of threads.
-                //   3. If we have > 1 thread and multipart is disabled
-                //   4. If doing multipart upload file size < #threads * minimum part size
-                if ( config_.object_size == 0 || config_.object_size == config::UNKNOWN_OBJECT_SIZE ||
-                        ( config_.number_of_client_transfer_threads <= 0 ) ||
-                        ( config_.number_of_client_transfer_threads > 1 && !config_.multipart_enabled ) ||
-                        ( config_.number_of_client_transfer_threads > 1 &&
-                          config_.object_size < static_cast<std::int64_t>(config_.number_of_client_transfer_threads) *
-                          static_cast<std::int64_t>(config_.minimum_part_size))) {
-                    use_cache_ = true;
+            return shm_obj.atomic_exec([this, part_size, number_of_parts](auto& data) {
+                try {
+                    data.sparse_cache_part_states.assign(number_of_parts,
+                            static_cast<std::uint64_t>(sparse_cache_part_state::NOT_DOWNLOADED));
+                    data.sparse_cache_etag = this->existing_object_etag_.c_str();
+                } catch (boost::interprocess::bad_alloc &biba) {
+                    this->set_error(ERROR(S3_GET_ERROR, "Error on allocation of the sparse cache part states in shared memory."));
+                    data.last_error_code = error_codes::BAD_ALLOC;
+                    return data.cache_file_download_progress = cache_file_download_status::FAILED;
                 }
+                data.sparse_cache_part_size = part_size;
+                return data.cache_file_download_progress = cache_file_download_status::SUCCESS;
+            });
+        }
+
+        // Download the parts of a sparse cache file that cover [offset, offset + length) and have
+        // not been downloaded.  If modify is true the parts are marked as modified.  Only the bytes
+        // of the original object are downloaded so bytes appended to the cache file are never
+        // overwritten.  A part is claimed with shared memory locked and downloaded with it unlocked
+        // so other threads are not blocked for the download.  A thread that needs a part that
+        // another thread is downloading waits for it.  Must not be called with shared memory locked.
+        bool download_sparse_cache_parts(std::int64_t offset, std::int64_t length, bool modify)
+        {
+            if (sparse_cache_part_size_ <= 0 || offset < 0 || length <= 0) {
+                return true;
             }
-            // config_.put_repl_flag not set.  This means we may have random access.  Must
-            // use cache.
-            else {
 
-                download_to_cache_ = true;
-                use_cache_ = true;
+            named_shared_memory_object shm_obj{shmem_key_,
+                config_.shared_memory_timeout_in_seconds,
+                constants::MAX_S3_SHMEM_SIZE};
 
-                if (ios_base::out == m) {
-                    object_must_exist_ = false;
-                }
-                else if ((ios_base::out | ios_base::trunc) == m) {
-                    download_to_cache_ = false;
-                    object_must_exist_ = false;
-                }
-                else if (ios_base::app == m || (ios_base::out | ios_base::app) == m) {
-                    object_must_exist_ = false;
-                }
-                else if ((ios_base::out | ios_base::in) == m) {
-                    object_must_exist_ = true;
-                }
-                else if ((ios_base::out | ios_base::in | ios_base::trunc) == m) {
-                    download_to_cache_ = false;
-                    object_must_exist_ = false;
-                }
-                else if ((ios_base::out | ios_base::in | ios_base::app) == m ||
-                         (ios_base::in | ios_base::app) == m)
-                {
-                    object_must_exist_ = false;
-                }
+            const std::int64_t number_of_parts = shm_obj.atomic_exec([](auto& data) {
+                return static_cast<std::int64_t>(data.sparse_cache_part_states.size());
+            });
 
-            }
+            const std::int64_t first_part = offset / sparse_cache_part_size_;
+            const std::int64_t last_part = std::min<std::int64_t>((offset + length - 1) / sparse_cache_part_size_,
+                    number_of_parts - 1);
 
-        }  // end populate_open_mode_flags
+            for (std::int64_t part = first_part; part <= last_part; ++part) {
 
-        bool seek_to_end_if_required(std::ios_base::openmode _mode)
-        {
-            if (std::ios_base::ate & _mode) {
-                if (seek_error == seekpos(0, std::ios_base::end)) {
-                    this->set_error(ERROR(UNIX_FILE_LSEEK_ERR, "Failed to seek on S3 cache file"));
-                    return false;
+                const auto wait_deadline = std::chrono::steady_clock::now() +
+                    std::chrono::seconds(config_.shared_memory_timeout_in_seconds);
+
+                while (true) {
+
+                    const std::int64_t part_offset = part * sparse_cache_part_size_;
+                    std::int64_t part_length = 0;
+                    std::string etag;
+
+                    // claim the part if it has not been downloaded
+                    const auto state = shm_obj.atomic_exec([this, part, part_offset, modify, &part_length, &etag](auto& data) {
+                        auto& part_state = data.sparse_cache_part_states[part];
+                        if (part_state == static_cast<std::uint64_t>(sparse_cache_part_state::NOT_DOWNLOADED)) {
+                            part_state = static_cast<std::uint64_t>(sparse_cache_part_state::DOWNLOADING);
+                            part_length = std::min(this->sparse_cache_part_size_, data.existing_object_size - part_offset);
+                            etag = data.sparse_cache_etag.c_str();
+                            return sparse_cache_part_state::NOT_DOWNLOADED;
+                        }
+                        if (modify && part_state == static_cast<std::uint64_t>(sparse_cache_part_state::DOWNLOADED)) {
+                            part_state = static_cast<std::uint64_t>(sparse_cache_part_state::MODIFIED);
+                        }
+                        return static_cast<sparse_cache_part_state>(part_state);
+                    });
+
+                    if (state == sparse_cache_part_state::DOWNLOADING) {
+                        if (std::chrono::steady_clock::now() > wait_deadline) {
+                            logger::error("{}:{} ({}) [[{}]] Timed out waiting for part {} of sparse cache file {}",
+                                    __FILE__, __LINE__, __func__, get_thread_identifier(), part, cache_file_path_);
+                            this->set_error(ERROR(S3_GET_ERROR, "Timed out waiting for part of sparse cache file"));
+                            return false;
+                        }
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                        continue;
+                    }
+
+                    if (state != sparse_cache_part_state::NOT_DOWNLOADED) {
+                        break;
+                    }
+
+                    logger::debug("{}:{} ({}) [[{}]] downloading part {} of sparse cache file [offset={}][length={}]",
+                            __FILE__, __LINE__, __func__, get_thread_identifier(), part, part_offset, part_length);
+
+                    if (!cache_file_writer_) {
+                        cache_file_writer_ = std::make_shared<cache_file_writer>(cache_file_path_, false);
+                    }
+
+                    const bool downloaded = cache_file_writer_->is_open() &&
+                        s3_download_part_worker_routine(nullptr, part_length, part_offset, false, true, etag.c_str()) == part_length;
+
+                    // a part that failed is released so that another thread may download it
+                    shm_obj.atomic_exec([part, modify, downloaded](auto& data) {
+                        const auto new_state = !downloaded ? sparse_cache_part_state::NOT_DOWNLOADED
+                            : modify ? sparse_cache_part_state::MODIFIED
+                            : sparse_cache_part_state::DOWNLOADED;
+                        data.sparse_cache_part_states[part] = static_cast<std::uint64_t>(new_state);
+                    });
+
+                    if (!downloaded) {
+                        logger::error("{}:{} ({}) [[{}]] Failed to download part {} of sparse cache file {}",
+                                __FILE__, __LINE__, __func__, get_thread_identifier(), part, cache_file_path_);
+                        cache_file_writer_.reset();
+                        this->set_error(ERROR(S3_GET_ERROR, "Failed to download part of sparse cache file"));
+                        return false;
+                    }
+                    break;
                 }
             }
 
+            cache_file_writer_.reset();
             return true;
-        }  // end seek_to_end_if_required
+        }
 
-        template <typename Function>
-        bool open_impl(const filesystem::path& _p,
-                       std::ios_base::openmode _mode,
-                       Function _func)
+        // Upload a sparse cache file with a multipart upload.  Parts that were not modified are
+        // copied from the existing object with UploadPartCopy and only the others are uploaded
+        // from the cache file.  If the object grew past the part limit or shrank, all parts are
+        // downloaded and upload_whole_file is set so that the cache file is flushed as usual.
+        error_codes flush_sparse_cache_file(named_shared_memory_object& shm_obj, bool& upload_whole_file)
         {
-            namespace bi = boost::interprocess;
             namespace types = shared_data::interprocess_types;
-            namespace bf = boost::filesystem;
 
-            logger::debug("{}:{} ({}) [[{}]] [_mode & in = {}][_mode & out = {}]"
-                "[_mode & trunc = {}][_mode & app = {}][_mode & ate = {}]"
-                "[_mode & binary = {}]",
-                __FILE__, __LINE__, __func__, get_thread_identifier(),
-                (_mode & std::ios_base::in) == std::ios_base::in,
-                (_mode & std::ios_base::out) == std::ios_base::out,
-                (_mode & std::ios_base::trunc) == std::ios_base::trunc,
-                (_mode & std::ios_base::app) == std::ios_base::app,
-                (_mode & std::ios_base::ate) == std::ios_base::ate,
-                (_mode & std::ios_base::binary) == std::ios_base::binary);
+            const std::int64_t part_size = sparse_cache_part_size_;
 
-			// Issue 2204 - If this is read-only, we don't care about number_of_client_transfer_threads
-			// as there is no post-processing needed like flushing cache file or completing multipart except
-			// for deleting shared memory.
-			//
-			// In this case we can just use the open/close up/down counter. This is used to delete shared
-			// memory once the counter goes to zero. However, if the counter prematurely goes to zero (due to order of
-			// open/read/closes) and the shared memory is deleted it doesn't cause a problem in the read-only case.
-			//
-			// The number_of_client_transfer_threads is wrong when iRODS does a read after write for a checksum
-			// operation. At the point where we are determining the number of transfer threads it is not clear
+            std::int64_t existing_object_size = 0;
+            std::vector<std::uint64_t> states;
+            std::string source_etag;
+            shm_obj.atomic_exec([&existing_object_size, &states, &source_etag](auto& data) {
+                existing_object_size = data.existing_object_size;
+                states.assign(data.sparse_cache_part_states.begin(), data.sparse_cache_part_states.end());
+                source_etag = data.sparse_cache_etag.c_str();
+            });
+
+            struct stat st{};
+            if (::stat(cache_file_path_.c_str(), &st) != 0) {
+                logger::error("{}:{} ({}) [[{}]] Failed to get the size of the cache file.",
+                        __FILE__, __LINE__, __func__, get_thread_identifier());
+                return error_codes::UPLOAD_FILE_ERROR;
+            }
+            const std::int64_t cache_file_size = st.st_size;
+
+            const auto is_modified = [](auto state) { return state == static_cast<std::uint64_t>(sparse_cache_part_state::MODIFIED); };
+
+            // The parts of the existing object keep their layout and are copied unless they were
+            // written.  The bytes added past the end of the existing object are uploaded in parts
+            // that follow, so appending never downloads the existing object.
+            struct sparse_part
+            {
+                std::int64_t offset;
+                std::int64_t length;
+                bool         copy;
+            };
+            std::vector<sparse_part> parts;
+
+            for (std::int64_t part = 0; part < static_cast<std::int64_t>(states.size()); ++part) {
+                const std::int64_t offset = part * part_size;
+                parts.push_back({offset, std::min(part_size, existing_object_size - offset), !is_modified(states[part])});
+            }
+
+            // All parts but the last must be at least the minimum part size.  The last part of the
+            // existing object may be smaller so when bytes were added it is joined to the part before it.
+            if (cache_file_size > existing_object_size && parts.size() > 1 && parts.back().length < config_.minimum_part_size) {
+                auto& previous = parts[parts.size() - 2];
+                previous.length += parts.back().length;
+                previous.copy = previous.copy && parts.back().copy;
+                parts.pop_back();
+            }
+
+            for (std::int64_t offset = existing_object_size; offset < cache_file_size; offset += part_size) {
+                parts.push_back({offset, std::min(part_size, cache_file_size - offset), false});
+            }
+
+            if (cache_file_size < existing_object_size || static_cast<std::int64_t>(parts.size()) > constants::MAXIMUM_NUMBER_ETAGS_PER_UPLOAD) {
+                logger::debug("{}:{} ({}) [[{}]] sparse cache file can not be flushed in parts, downloading the remaining parts",
+                        __FILE__, __LINE__, __func__, get_thread_identifier());
+                upload_whole_file = true;
+                const bool downloaded = download_sparse_cache_parts(0, existing_object_size, false);
+
+                // downloading whole parts may have written past the end of a cache file that shrank
+                if (!downloaded || ::truncate(cache_file_path_.c_str(), cache_file_size) != 0) {
+                    return error_codes::DOWNLOAD_FILE_ERROR;
+                }
+                return error_codes::SUCCESS;
+            }
+
+            error_codes return_value = error_codes::SUCCESS;
+
+            if (cache_file_size == existing_object_size && std::none_of(states.begin(), states.end(), is_modified)) {
+
+                logger::debug("{}:{} ({}) [[{}]] sparse cache file was not modified, nothing to upload",
+                        __FILE__, __LINE__, __func__, get_thread_identifier());
+
+            } else {
+
+                // the parts that are uploaded must be in the cache file
+                const bool downloaded = std::all_of(parts.begin(), parts.end(), [this](const auto& part) {
+                    return part.copy || this->download_sparse_cache_parts(part.offset, part.length, false);
+                });
+
+                // clear the ETags of a previous upload
+                const bool reset = downloaded && shm_obj.atomic_exec([this, &shm_obj](auto& data) {
+                    try {
+                        data.etags.clear();
+                        data.etags.resize(constants::MAXIMUM_NUMBER_ETAGS_PER_UPLOAD, types::shm_char_string("", shm_obj.get_allocator()));
+                        data.checksum_vector.resize(constants::MAXIMUM_NUMBER_ETAGS_PER_UPLOAD);
+                        data.part_size_vector.resize(constants::MAXIMUM_NUMBER_ETAGS_PER_UPLOAD);
+                    } catch (boost::interprocess::bad_alloc &biba) {
+                        this->set_error(ERROR(S3_PUT_ERROR, "Error on reallocation of etags, checksum, or part size vectors in shared memory."));
+                        data.last_error_code = error_codes::BAD_ALLOC;
+                        return false;
+                    }
+                    return true;
+                });
+
+                if (!reset) {
+                    return_value = error_codes::UPLOAD_FILE_ERROR;
+                } else if (error_codes::SUCCESS != initiate_multipart_upload()) {
+                    return_value = error_codes::INITIATE_MULTIPART_UPLOAD_ERROR;
+                } else {
+
+                    const std::string upload_id = shm_obj.atomic_exec([](auto& data) { return std::string{data.upload_id.c_str()}; });
+
+                    // All of the part uploads read the cache file through this one descriptor.
+                    cache_file_reader_ = std::make_shared<cache_file_reader>(cache_file_path_);
+
+                    const auto number_of_threads = std::max<int>(1, config_.number_of_cache_transfer_threads);
+                    std::int64_t bytes_copied = 0;
+
+                    irods::thread_pool flush_threads{number_of_threads};
+                    for (std::size_t i = 0; i < parts.size(); ++i) {
+                        const off_t offset = parts[i].offset;
+                        const std::int64_t length = parts[i].length;
+                        const unsigned int part_number = i + 1;
+
+                        if (parts[i].copy) {
+                            bytes_copied += length;
+                            irods::thread_pool::post(flush_threads, [this, part_number, offset, length, &upload_id, &source_etag] () {
+                                s3_copy_part_worker_routine(part_number, offset, length, upload_id, source_etag);
+                            });
+                        } else {
+                            irods::thread_pool::post(flush_threads, [this, part_number, offset, length] () {
+                                s3_upload_part_worker_routine(true, part_number, length, offset);
+                            });
+                        }
+                    }
+                    flush_threads.join();
+
+                    logger::debug("{}:{} ({}) [[{}]] sparse cache file flushed [parts={}][bytes_copied={}][bytes_uploaded={}]",
+                            __FILE__, __LINE__, __func__, get_thread_identifier(), parts.size(), bytes_copied,
+                            cache_file_size - bytes_copied);
+
+                    return_value = complete_multipart_upload();
+                    cache_file_reader_.reset();
+                }
+            }
+
+            logger::debug("{}:{} ({}) [[{}]] removing cache file {}",
+                    __FILE__, __LINE__, __func__, this->get_thread_identifier(), cache_file_path_.c_str());
+            std::remove(cache_file_path_.c_str());
+
+            shm_obj.atomic_exec([](auto& data) {
+                data.cache_file_download_progress = cache_file_download_status::NOT_STARTED;
+                data.sparse_cache_part_size = 0;
+                data.sparse_cache_part_states.clear();
+            });
+
+            return return_value;
+        } // end flush_sparse_cache_file
+
+        // Copy [offset, offset + length) of the existing object to part part_number of the
+        // multipart upload with UploadPartCopy.  The copy fails if the ETag of the object is no
+        // longer source_etag, in which case the object was replaced after it was opened.
+        void s3_copy_part_worker_routine(unsigned int part_number, std::int64_t offset, std::int64_t length,
+                const std::string& upload_id, const std::string& source_etag)
+        {
+            named_shared_memory_object shm_obj{shmem_key_,
+                config_.shared_memory_timeout_in_seconds,
+                constants::MAX_S3_SHMEM_SIZE};
+
+            S3ResponseHandler copy_part_handler = {
+                s3_copy_part_callback::on_response_properties,
+                s3_copy_part_callback::on_response_complete
+            };
+
+            S3PutProperties put_props{};
+            put_props.expires = -1;
+            put_props.xAmzDecodedContentLength = -1;
+            put_props.xAmzCopySourceIfMatch = source_etag.c_str();
+
+            data_for_copy_part_callback data{bucket_context_};
+            std::array<char, constants::BYTES_PER_ETAG + 1> etag{};
+            std::int64_t last_modified = 0;
+
+            unsigned int retry_cnt = 0;
+            int retry_wait_seconds = config_.retry_wait_seconds;
+
+            do {
+                data.status = libs3_types::status_ok;
+                etag[0] = '\0';
+
+                logger::debug("{}:{} ({}) [[{}]] Multipart:  Copy part {} of key \"{}\" [offset={}][length={}]",
+                        __FILE__, __LINE__, __func__, get_thread_identifier(), part_number, object_key_, offset, length);
+
+                S3_copy_object_range(&bucket_context_, object_key_.c_str(), bucket_context_.bucketName,
+                        object_key_.c_str(), part_number, upload_id.c_str(), offset, length, &put_props,
+                        &last_modified, etag.size(), etag.data(), nullptr, 0, &copy_part_handler, &data);
+
+                if (data.status != libs3_types::status_ok) {
+                    s3_sleep( retry_wait_seconds );
+                    retry_wait_seconds *= 2;
+                    if (retry_wait_seconds > config_.max_retry_wait_seconds) {
+                        retry_wait_seconds = config_.max_retry_wait_seconds;
+                    }
+                }
+
+            } while ((data.status != libs3_types::status_ok)
+                    && irods::experimental::io::s3_transport::S3_status_is_retryable(data.status)
+                    && (++retry_cnt <= config_.retry_count_limit));
+
+            shm_obj.atomic_exec([this, &data, &etag, part_number](auto& shared_data) {
+                if (data.status == S3StatusErrorPreconditionFailed) {
+                    const auto msg = fmt::format("Failed to copy part {} of \"{}\" - the object was replaced after it was opened",
+                            part_number, object_key_);
+                    logger::error("{}:{} ({}) [[{}]] {}", __FILE__, __LINE__, __func__, get_thread_identifier(), msg);
+                    this->set_error(ERROR(S3_PUT_ERROR, msg.c_str()));
+                    shared_data.last_error_code = error_codes::UPLOAD_FILE_ERROR;
+                    return;
+                }
+                if (data.status != libs3_types::status_ok || etag[0] == '\0') {
+                    const auto msg = fmt::format("Failed to copy part {} of \"{}\" - \"{}\"",
+                            part_number, object_key_, S3_get_status_name(data.status));
+                    logger::error("{}:{} ({}) [[{}]] {}", __FILE__, __LINE__, __func__, get_thread_identifier(), msg);
+                    this->set_error(ERROR(S3_PUT_ERROR, msg.c_str()));
+                    shared_data.last_error_code = error_codes::UPLOAD_FILE_ERROR;
+                    return;
+                }
+                shared_data.etags[part_number - 1] = etag.data();
+            });
+        } // end s3_copy_part_worker_routine
+
+        bool is_full_upload() {
+            //return config_.put_repl_flag;
+            using std::ios_base;
+            const auto m = mode_ & ~(ios_base::ate | ios_base::binary);
+            return (ios_base::out == m && config_.number_of_client_transfer_threads > 1) ||
+                (ios_base::out | ios_base::trunc) == m;
+            //return ( (O_CREAT | O_WRONLY | O_TRUNC) == open_flags );
+        }
+
+        // This populates the following flags based on the open mode (mode_).
+        //   - use_cache_         - Always set to true in the following circumstances
+        //                          * The object was not opened in read only mode and one of the following are true:
+        //                            * the number of transfer threads > 1 and MPU is disabled
+        //                            * the part sizes would be less than the minimum number allowed
+        //                            * the put_repl_flag is false indicating no predictable full file write
+        //                            * do not know the object size
+        //                         - Otherwise set to false
+        //
+        //   - use_small_object_buffer_ - Set to true for a single threaded full upload
+        //                          (put_repl_flag) of a known object size that is no larger than
+        //                          small_object_upload_size_limit.  The object is then buffered in
+        //                          memory and written with a single PUT on close.
+        //
+        //   - download_to_cache_ - Set to true unless one of the following is true:
+        //                             * the object is opened in read only mode
+        //                             * the trunc flag is set
+        //   - object_must_exist_ - See table "Action if file does not exist" in the table at the
+        //                          following link: https://en.cppreference.com/w/cpp/io/basic_filebuf/open
+        void populate_open_mode_flags() noexcept
+        {
+
+            using std::ios_base;
+
+            const auto m = mode_ & ~(ios_base::ate | ios_base::binary);
+
+            // read only, do not use cache
+            if (ios_base::in == m) {
+                download_to_cache_ = false;
+                use_cache_ = false;
+                use_small_object_buffer_ = false;
+                object_must_exist_ = true;
+            }
+            // put_repl_flag is a contract that says the full file will be written in a similar
+            // manner as iput.
+            else if (config_.put_repl_flag) {
+                download_to_cache_ = false;
+                use_cache_ = false;
+                object_must_exist_ = false;
+
+                // override for cases where we must use cache
+                //   1. If we don't know the file size.
+                //   2. If we don't know the # of threads.
+                //   3. If we have > 1 thread and multipart is disabled
+                //   4. If doing multipart upload file size < #threads * minimum part size
+                if ( config_.object_size == 0 || config_.object_size == config::UNKNOWN_OBJECT_SIZE ||
+                        ( config_.number_of_client_transfer_threads <= 0 ) ||
+                        ( config_.number_of_client_transfer_threads > 1 && !config_.multipart_enabled ) ||
+                        ( config_.number_of_client_transfer_threads > 1 &&
+                          config_.object_size < static_cast<std::int64_t>(config_.number_of_client_transfer_threads) *
+                          static_cast<std::int64_t>(config_.minimum_part_size))) {
+                    use_cache_ = true;
+                }
+
+                // A single thread writing a small object of known size is the only writer of that
+                // object so it can be buffered in this process.
+                use_small_object_buffer_ = !use_cache_
+                    && config_.number_of_client_transfer_threads == 1
+                    && config_.object_size > 0
+                    && config_.object_size <= config_.small_object_upload_size_limit
+                    && config_.object_size <= config_.max_single_part_upload_size
+                    && is_full_upload();
+            }
+            // config_.put_repl_flag not set.  This means we may have random access.  Must
+            // use cache.
+            else {
+
+                download_to_cache_ = true;
+                use_cache_ = true;
+                use_small_object_buffer_ = false;
+
+                if (ios_base::out == m) {
+                    object_must_exist_ = false;
+                }
+                else if ((ios_base::out | ios_base::trunc) == m) {
+                    download_to_cache_ = false;
+                    object_must_exist_ = false;
+                }
+                else if (ios_base::app == m || (ios_base::out | ios_base::app) == m) {
+                    object_must_exist_ = false;
+                }
+                else if ((ios_base::out | ios_base::in) == m) {
+                    object_must_exist_ = true;
+                }
+                else if ((ios_base::out | ios_base::in | ios_base::trunc) == m) {
+                    download_to_cache_ = false;
+                    object_must_exist_ = false;
+                }
+                else if ((ios_base::out | ios_base::in | ios_base::app) == m ||
+                         (ios_base::in | ios_base::app) == m)
+                {
+                    object_must_exist_ = false;
+                }
+
+            }
+
+        }  // end populate_open_mode_flags
+
+        bool seek_to_end_if_required(std::ios_base::openmode _mode)
+        {
+            if (std::ios_base::ate & _mode) {
+                if (seek_error == seekpos(0, std::ios_base::end)) {
+                    this->set_error(ERROR(UNIX_FILE_LSEEK_ERR, "Failed to seek on S3 cache file"));
+                    return false;
+                }
+            }
+
+            return true;
+        }  // end seek_to_end_if_required
+
+        template <typename Function>
+        bool open_impl(const filesystem::path& _p,
+                       std::ios_base::openmode _mode,
+                       Function _func)
+        {
+            namespace bi = boost::interprocess;
+            namespace types = shared_data::interprocess_types;
+            namespace bf = boost::filesystem;
+
+            logger::debug("{}:{} ({}) [[{}]] [_mode & in = {}][_mode & out = {}]"
+                "[_mode & trunc = {}][_mode & app = {}][_mode & ate = {}]"
+                "[_mode & binary = {}]",
+                __FILE__, __LINE__, __func__, get_thread_identifier(),
+                (_mode & std::ios_base::in) == std::ios_base::in,
+                (_mode & std::ios_base::out) == std::ios_base::out,
+                (_mode & std::ios_base::trunc) == std::ios_base::trunc,
+                (_mode & std::ios_base::app) == std::ios_base::app,
+                (_mode & std::ios_base::ate) == std::ios_base::ate,
+                (_mode & std::ios_base::binary) == std::ios_base::binary);
+
+			// Issue 2204 - If this is read-only, we don't care about number_of_client_transfer_threads
+			// as there is no post-processing needed like flushing cache file or completing multipart except
+			// for deleting shared memory.
+			//
+			// In this case we can just use the open/close up/down counter. This is used to delete shared
+			// memory once the counter goes to zero. However, if the counter prematurely goes to zero (due to order of
+			// open/read/closes) and the shared memory is deleted it doesn't cause a problem in the read-only case.
+			//
+			// The number_of_client_transfer_threads is wrong when iRODS does a read after write for a checksum
+			// operation. At the point where we are determining the number of transfer threads it is not clear
 			// that we are doing a read after write as the open mode is not updated between the write and the read.
 			// By this point we have figured out we are doing the read after write and have updated the open flags.
 			if (!(_mode & std::ios_base::out)) {
@@ -1351,6 +2040,8 @@ namespace irods::experimental::io::s3_transport
 
             populate_open_mode_flags();
 
+            begin_upload_checksum();
+
             logger::debug("{}:{} ({}) [[{}]] [object_key_ = {}][use_cache_ = {}]"
                 "[download_to_cache_ = {}]",
                 __FILE__, __LINE__, __func__, get_thread_identifier(),
@@ -1368,8 +2059,8 @@ namespace irods::experimental::io::s3_transport
 
             // each process must intitialize S3
             {
-                std::lock_guard<std::mutex> lock(s3_initialized_counter_mutex_);
-                if (s3_initialized_counter_ == 0) {
+                std::lock_guard<std::mutex> lock(s3_initialized_mutex_);
+                if (!s3_initialized_) {
 
                     int flags = S3_INIT_ALL;
 
@@ -1379,8 +2070,30 @@ namespace irods::experimental::io::s3_transport
                         this->set_error(ERROR(S3_INIT_ERROR, "S3_initialize returned error"));
                         return false;
                     }
+                    s3_initialized_ = true;
                 }
-                ++s3_initialized_counter_;
+            }
+
+            // Small object fast path.  No other thread or process writes this object so shared
+            // memory is not needed.  Just create our own fd and a buffer to hold the object.
+            if (use_small_object_buffer_) {
+
+                const auto fd = this->file_descriptor_counter_++;
+
+                if (fd < minimum_valid_file_descriptor) {
+                    this->set_error(ERROR(SYS_FILE_DESC_OUT_OF_RANGE, "S3 file descriptor was out of range"));
+                    return false;
+                }
+
+                this->fd_ = fd;
+                acquire_small_object_buffer();
+
+                if (!this->seek_to_end_if_required(mode_)) {
+                    this->set_error(ERROR(UNIX_FILE_LSEEK_ERR, "Failed to seek in s3_transport"));
+                    return false;
+                }
+
+                return true;
             }
 
             // only allow open/close to run one at a time for this object
@@ -1409,6 +2122,10 @@ namespace irods::experimental::io::s3_transport
                         data.etags.clear();
                         data.checksum_vector.clear();
                         data.part_size_vector.clear();
+                        data.upload_checksum_ranges.clear();
+                        data.upload_checksum_incomplete = false;
+                        data.sparse_cache_part_size = 0;
+                        data.sparse_cache_part_states.clear();
                         data.last_error_code = error_codes::SUCCESS;
                         data.circular_buffer_read_timeout = false;
                     }
@@ -1440,8 +2157,15 @@ namespace irods::experimental::io::s3_transport
                     // just read the object size from shmem
                     if (data.cache_file_download_progress == cache_file_download_status::SUCCESS) {
                         object_status = object_s3_status::IN_S3;
+                    } else if (config_.existing_object_size != config::UNKNOWN_OBJECT_SIZE) {
+                        object_status = object_s3_status::IN_S3;
+                        s3_object_size = config_.existing_object_size;
+                        existing_object_etag_ = config_.existing_object_etag;
+                        existing_object_last_modified_ = config_.existing_object_last_modified;
+                        data.existing_object_size = s3_object_size;
                     } else {
-                        irods::error ret = get_object_s3_status(object_key_, bucket_context_, s3_object_size, object_status, storage_class);
+                        irods::error ret = get_object_s3_status(object_key_, bucket_context_, s3_object_size, object_status,
+                                storage_class, existing_object_etag_, existing_object_last_modified_);
                         if (!ret.ok()) {
                             return_value = false;
                             this->set_error(ret);
@@ -1477,6 +2201,8 @@ namespace irods::experimental::io::s3_transport
                         return_value = false;
                         return;
                     }
+
+                    this->sparse_cache_part_size_ = data.sparse_cache_part_size;
                 }
 
                 if (this->use_cache_) {
@@ -1519,73 +2245,316 @@ namespace irods::experimental::io::s3_transport
 							mode = mode_ & ~std::ios_base::trunc;
 						}
 
-						// Try opening for read and write. If it fails, create the file then open for read/write.
-                        cache_fstream_.open(cache_file_path_.c_str(), mode | std::ios_base::in | std::ios_base::out);
-                        if (!cache_fstream_.is_open()) {
-                            logger::debug("{}:{} ({}) [[{}]] opened cache file {} with create [trunc_flag={}]", __FILE__, __LINE__, __func__, get_thread_identifier(), cache_file_path_.c_str(), trunc_flag);
-                            // file may not exist, open with std::ios_base::out to create then with in/out
-                            cache_fstream_.open(cache_file_path_.c_str(), std::ios_base::out);
-                            cache_fstream_.close();
-                            cache_fstream_.open(cache_file_path_.c_str(), mode | std::ios_base::in | std::ios_base::out);
-                        } else {
-                            logger::debug("{}:{} ({}) [[{}]] opened cache file {} [trunc_flag={}]", __FILE__, __LINE__, __func__, get_thread_identifier(), cache_file_path_.c_str(), trunc_flag);
-                        }
+                        // Parts of a sparse cache file are downloaded with positional writes so the
+                        // stream must not hold a copy of the file in its buffer.
+                        if (sparse_cache_part_size_ > 0) {
+                            cache_fstream_.rdbuf()->pubsetbuf(nullptr, 0);
+                        }
+
+						// Try opening for read and write. If it fails, create the file then open for read/write.
+                        cache_fstream_.open(cache_file_path_.c_str(), mode | std::ios_base::in | std::ios_base::out);
+                        if (!cache_fstream_.is_open()) {
+                            logger::debug("{}:{} ({}) [[{}]] opened cache file {} with create [trunc_flag={}]", __FILE__, __LINE__, __func__, get_thread_identifier(), cache_file_path_.c_str(), trunc_flag);
+                            // file may not exist, open with std::ios_base::out to create then with in/out
+                            cache_fstream_.open(cache_file_path_.c_str(), std::ios_base::out);
+                            cache_fstream_.close();
+                            cache_fstream_.open(cache_file_path_.c_str(), mode | std::ios_base::in | std::ios_base::out);
+                        } else {
+                            logger::debug("{}:{} ({}) [[{}]] opened cache file {} [trunc_flag={}]", __FILE__, __LINE__, __func__, get_thread_identifier(), cache_file_path_.c_str(), trunc_flag);
+                        }
+
+                        if (!cache_fstream_ || !cache_fstream_.is_open()) {
+                            logger::error("{}:{} ({}) [[{}]] Failed to open cache file {}, error={} open_mode: [app={}][binary={}][in={}][out={}][trunc={}][ate={}]",
+                                    __FILE__, __LINE__, __func__, this->get_thread_identifier(), cache_file_path_.c_str(), strerror(errno),
+                                    (mode & std::ios::app) != 0,
+                                    (mode & std::ios::binary) != 0,
+                                    (mode & std::ios::in) != 0,
+                                    (mode & std::ios::out) != 0,
+                                    (mode & std::ios::trunc) != 0,
+                                    (mode & std::ios::ate) != 0
+                                    );
+                            this->set_error(ERROR(UNIX_FILE_OPEN_ERR, "Failed to open S3 cache file"));
+                            return_value = false;
+                            return;
+                        }
+
+                        if (!this->seek_to_end_if_required(this->mode_)) {
+                            this->set_error(ERROR(UNIX_FILE_LSEEK_ERR, "Failed to seek on cache file"));
+                            return_value = false;
+                            return;
+                        }
+                    }
+
+                } else {
+
+                    // not using cache, just create our own fd
+
+                    const auto fd = this->file_descriptor_counter_++;
+
+                    if (fd < minimum_valid_file_descriptor) {
+                        this->set_error(ERROR(SYS_FILE_DESC_OUT_OF_RANGE, "S3 file descriptor was out of range"));
+                        return_value = false;
+                        return;
+                    }
+
+                    this->fd_ = fd;
+
+                    if (!this->seek_to_end_if_required(mode_)) {
+                        this->set_error(ERROR(UNIX_FILE_LSEEK_ERR, "Failed to seek in s3_transport"));
+                        return_value = false;
+                        return;
+                    }
+                }
+
+                // set the number of threads to close to the number of client transfer threads
+                // this will count down as closes happen
+                if (data.threads_remaining_to_close == 0) {
+                    data.threads_remaining_to_close = this->config_.number_of_client_transfer_threads;
+                }
+
+
+            });  // end atomic exec
+
+            if (return_value) {
+                open_read_cache();
+            }
+
+            return return_value;
+
+        }  // end open_impl
+
+        // Use the read cache if it is enabled and the object is opened read only without the cache
+        // file.  The version of the object is identified by the ETag, size, and Last-Modified time
+        // returned by the HEAD done in open so blocks of an object that has since been overwritten
+        // are never used.  Otherwise use the read page cache if it is enabled.
+        void open_read_cache()
+        {
+            const auto read_only = (mode_ & ~(std::ios_base::ate | std::ios_base::binary)) == std::ios_base::in;
+
+            if (use_cache_ || !read_only || existing_object_size_ == config::UNKNOWN_OBJECT_SIZE) {
+                return;
+            }
+
+            if (config_.read_page_size > 0 && (config_.read_cache_size <= 0 || existing_object_etag_.empty())) {
+                read_page_cache_ = std::make_unique<read_page_cache>(config_.read_page_size,
+                        config_.read_merge_distance, existing_object_size_);
+                return;
+            }
+
+            if (config_.read_cache_size <= 0 || existing_object_etag_.empty()) {
+                return;
+            }
+
+            try {
+                read_cache_ = std::make_unique<read_cache>(config_.cache_directory, config_.read_cache_size);
+                read_cache_object_id_ = read_cache::make_object_id(config_.bucket_name, object_key_);
+                read_cache_version_id_ = read_cache::make_version_id(existing_object_etag_,
+                        existing_object_size_, existing_object_last_modified_);
+                read_cache_->invalidate_other_versions(read_cache_object_id_, read_cache_version_id_);
+            } catch (const std::exception& e) {
+                // reads still work without the cache
+                logger::warn("{}:{} ({}) [[{}]] Could not open the read cache in {}.  {}",
+                        __FILE__, __LINE__, __func__, get_thread_identifier(), config_.cache_directory, e.what());
+                read_cache_.reset();
+            }
+        }
+
+        // Read from the read cache.  Blocks that are not cached are downloaded whole and added to
+        // the cache.  The range must already be clamped to the size of the object.
+        std::streamsize read_through_cache(char_type* buffer, std::int64_t length, off_t offset, bool shmem_already_locked)
+        {
+            std::vector<char_type> block_buffer;
+            std::int64_t bytes_copied = 0;
+
+            while (bytes_copied < length) {
+                const std::int64_t position = offset + bytes_copied;
+                const std::uint64_t block = position / read_cache::BLOCK_SIZE;
+                const std::int64_t offset_in_block = position % read_cache::BLOCK_SIZE;
+                const std::int64_t bytes_this_block = std::min(length - bytes_copied, read_cache::BLOCK_SIZE - offset_in_block);
+
+                std::int64_t bytes = read_cache_->read(read_cache_object_id_, read_cache_version_id_, block,
+                        offset_in_block, buffer + bytes_copied, bytes_this_block);
+
+                if (bytes < 0) {
+                    const std::int64_t block_offset = block * read_cache::BLOCK_SIZE;
+                    const std::int64_t block_length = std::min(read_cache::BLOCK_SIZE, existing_object_size_ - block_offset);
+
+                    block_buffer.resize(block_length);
+                    const auto downloaded = s3_download_part_worker_routine(block_buffer.data(), block_length,
+                            block_offset, shmem_already_locked, false);
+                    if (downloaded != block_length) {
+                        // the error has been set
+                        break;
+                    }
+
+                    read_cache_->store(read_cache_object_id_, read_cache_version_id_, block, block_buffer.data(), block_length);
+                    std::memcpy(buffer + bytes_copied, block_buffer.data() + offset_in_block, bytes_this_block);
+                    bytes = bytes_this_block;
+                }
+
+                if (bytes == 0) {
+                    break;
+                }
+
+                bytes_copied += bytes;
+            }
+
+            return static_cast<std::streamsize>(bytes_copied);
+        } // end read_through_cache
+
+        // Sort and merge the ranges and download them concurrently through one request context
+        std::streamsize receive_ranges_from_s3(std::vector<read_range>& _ranges)
+        {
+            struct range_request
+            {
+                std::int64_t                                          start;
+                std::int64_t                                          end;
+                std::vector<std::size_t>                              ranges;
+                std::unique_ptr<callback_for_read_from_s3_to_ranges> callback;
+                bool                                                  complete;
+            };
+
+            // sort the ranges that are in the object
+            std::vector<std::size_t> order;
+            for (std::size_t i = 0; i < _ranges.size(); ++i) {
+                if (_ranges[i].offset >= 0 && _ranges[i].length > 0 && _ranges[i].offset < existing_object_size_) {
+                    order.push_back(i);
+                }
+            }
+            std::sort(order.begin(), order.end(), [&_ranges](auto a, auto b) { return _ranges[a].offset < _ranges[b].offset; });
+
+            std::vector<range_request> requests;
+            for (auto i : order) {
+                const std::int64_t start = _ranges[i].offset;
+                const std::int64_t end = std::min<std::int64_t>(start + _ranges[i].length, existing_object_size_);
+                if (requests.empty() || start > requests.back().end + maximum_range_gap) {
+                    requests.push_back({start, end, {}, nullptr, false});
+                }
+                auto& request = requests.back();
+                request.end = std::max(request.end, end);
+                request.ranges.push_back(i);
+            }
+
+            for (auto& request : requests) {
+                request.callback = std::make_unique<callback_for_read_from_s3_to_ranges>(bucket_context_);
+                request.callback->content_length = request.end - request.start;
+                request.callback->thread_identifier = get_thread_identifier();
+                request.callback->shmem_key = shmem_key_;
+                request.callback->shared_memory_timeout_in_seconds = config_.shared_memory_timeout_in_seconds;
+                for (auto i : request.ranges) {
+                    const std::int64_t end = std::min<std::int64_t>(_ranges[i].offset + _ranges[i].length, existing_object_size_);
+                    request.callback->add_segment(_ranges[i].offset - request.start, end - _ranges[i].offset, _ranges[i].buffer);
+                }
+            }
 
-                        if (!cache_fstream_ || !cache_fstream_.is_open()) {
-                            logger::error("{}:{} ({}) [[{}]] Failed to open cache file {}, error={} open_mode: [app={}][binary={}][in={}][out={}][trunc={}][ate={}]",
-                                    __FILE__, __LINE__, __func__, this->get_thread_identifier(), cache_file_path_.c_str(), strerror(errno),
-                                    (mode & std::ios::app) != 0,
-                                    (mode & std::ios::binary) != 0,
-                                    (mode & std::ios::in) != 0,
-                                    (mode & std::ios::out) != 0,
-                                    (mode & std::ios::trunc) != 0,
-                                    (mode & std::ios::ate) != 0
-                                    );
-                            this->set_error(ERROR(UNIX_FILE_OPEN_ERR, "Failed to open S3 cache file"));
-                            return_value = false;
-                            return;
-                        }
+            S3GetObjectHandler get_object_handler = {
+                {
+                    callback_for_read_from_s3_base::on_response_properties,
+                    callback_for_read_from_s3_base::on_response_completion
+                },
+                callback_for_read_from_s3_base::invoke_callback
+            };
 
-                        if (!this->seek_to_end_if_required(this->mode_)) {
-                            this->set_error(ERROR(UNIX_FILE_LSEEK_ERR, "Failed to seek on cache file"));
-                            return_value = false;
-                            return;
-                        }
+            unsigned int retry_cnt = 0;
+            int retry_wait_seconds = config_.retry_wait_seconds;
+            libs3_types::status last_status = libs3_types::status_ok;
+
+            while (true) {
+
+                std::vector<range_request*> pending;
+                for (auto& request : requests) {
+                    if (!request.complete) {
+                        pending.push_back(&request);
                     }
+                }
 
-                } else {
+                for (std::size_t batch_start = 0; batch_start < pending.size(); batch_start += maximum_concurrent_range_requests) {
+                    const auto batch_end = std::min(pending.size(), batch_start + maximum_concurrent_range_requests);
 
-                    // not using cache, just create our own fd
+                    S3RequestContext* request_context = nullptr;
+                    if (S3_create_request_context(&request_context) != libs3_types::status_ok) {
+                        this->set_error(ERROR(S3_GET_ERROR, "Failed to create an S3 request context"));
+                        return 0;
+                    }
 
-                    const auto fd = this->file_descriptor_counter_++;
+                    for (auto i = batch_start; i < batch_end; ++i) {
+                        auto& request = *pending[i];
+                        request.callback->restart();
 
-                    if (fd < minimum_valid_file_descriptor) {
-                        this->set_error(ERROR(SYS_FILE_DESC_OUT_OF_RANGE, "S3 file descriptor was out of range"));
-                        return_value = false;
-                        return;
+                        logger::debug("{}:{} ({}) [[{}]] Multirange:  Start range key \"{}\", offset {}, len {}",
+                                __FILE__, __LINE__, __func__, get_thread_identifier(), object_key_,
+                                request.start, request.end - request.start);
+
+                        S3_get_object(&bucket_context_, object_key_.c_str(), NULL,
+                                request.start, request.end - request.start, request_context, 0,
+                                &get_object_handler, request.callback.get());
                     }
 
-                    this->fd_ = fd;
+                    S3_runall_request_context(request_context);
+                    S3_destroy_request_context(request_context);
+                }
 
-                    if (!this->seek_to_end_if_required(mode_)) {
-                        this->set_error(ERROR(UNIX_FILE_LSEEK_ERR, "Failed to seek in s3_transport"));
-                        return_value = false;
-                        return;
+                bool retryable = true;
+                for (auto* request : pending) {
+                    const auto& callback = *request->callback;
+                    request->complete = callback.status == libs3_types::status_ok &&
+                        callback.bytes_read_from_s3 == callback.content_length;
+                    if (!request->complete) {
+                        last_status = callback.status;
+                        retryable = retryable && (callback.status == libs3_types::status_ok ||
+                                irods::experimental::io::s3_transport::S3_status_is_retryable(callback.status));
                     }
                 }
 
-                // set the number of threads to close to the number of client transfer threads
-                // this will count down as closes happen
-                if (data.threads_remaining_to_close == 0) {
-                    data.threads_remaining_to_close = this->config_.number_of_client_transfer_threads;
+                if (std::all_of(pending.begin(), pending.end(), [](auto* r) { return r->complete; }) ||
+                        !retryable || ++retry_cnt > config_.retry_count_limit) {
+                    break;
                 }
 
+                s3_sleep( retry_wait_seconds );
+                retry_wait_seconds *= 2;
+                if (retry_wait_seconds > config_.max_retry_wait_seconds) {
+                    retry_wait_seconds = config_.max_retry_wait_seconds;
+                }
+            }
 
-            });  // end atomic exec
+            std::streamsize total_bytes = 0;
+            bool failed = false;
+            for (const auto& request : requests) {
+                if (!request.complete) {
+                    failed = true;
+                    continue;
+                }
+                for (auto i : request.ranges) {
+                    _ranges[i].bytes_read = std::min<std::int64_t>(_ranges[i].length, existing_object_size_ - _ranges[i].offset);
+                    total_bytes += _ranges[i].bytes_read;
+                }
+            }
 
-            return return_value;
+            if (failed) {
+                auto msg = fmt::format(" - Error getting ranges of the S3 object: \"{}\"", object_key_);
+                if (last_status >= 0) {
+                    msg += fmt::format(" - \"{}\"", S3_get_status_name(last_status));
+                }
+                logger::debug("{}:{} ({}) [[{}]] {}", __FILE__, __LINE__, __func__, get_thread_identifier(), msg);
+                this->set_error(ERROR(S3_GET_ERROR, msg.c_str()));
+            }
 
-        }  // end open_impl
+            return total_bytes;
+        } // end receive_ranges_from_s3
+
+        // Read from the read page cache.  Missing pages are downloaded with one ranged GET.
+        std::streamsize read_through_page_cache(char_type* buffer, std::int64_t length, off_t offset, bool shmem_already_locked)
+        {
+            const auto bytes = read_page_cache_->read(offset, buffer, length,
+                    [this, shmem_already_locked](char* _buffer, std::int64_t _offset, std::int64_t _length) -> std::int64_t
+                    {
+                        return s3_download_part_worker_routine(_buffer, _length, _offset, shmem_already_locked, false);
+                    });
+
+            // the error has been set
+            return static_cast<std::streamsize>(bytes < 0 ? 0 : bytes);
+        } // end read_through_page_cache
 
         error_codes initiate_multipart_upload()
         {
@@ -1613,6 +2582,10 @@ namespace irods::experimental::io::s3_transport
             }
 #endif // IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
 
+            // When flushing the cache file the checksum is already known so save it with the object
+            S3NameValue checksum_metadata[2];
+            set_upload_checksum_metadata(put_props, checksum_metadata);
+
             upload_manager_.remaining = 0;
             upload_manager_.offset  = 0;
             upload_manager_.xml = "";
@@ -1674,6 +2647,8 @@ namespace irods::experimental::io::s3_transport
                 upload_manager_.remaining = 0;
                 upload_manager_.offset  = 0;
 
+                this->upload_checksum_in_metadata_ = !this->upload_checksum_.empty();
+
                 return error_codes::SUCCESS;
 
             });
@@ -1759,19 +2734,7 @@ namespace irods::experimental::io::s3_transport
                             i < data.checksum_vector.size() &&
                             data.checksum_vector[i] != 0) {
 
-                            // Convert uint64_t checksum to big-endian bytes
-                            unsigned char checksum_bytes[8];
-                            uint64_t checksum_val = data.checksum_vector[i];
-                            for (int j = 0; j < 8; ++j) {
-                                checksum_bytes[7 - j] = static_cast<unsigned char>(checksum_val & 0xFF);
-                                checksum_val >>= 8;
-                            }
-
-                            // Base64 encode the checksum
-                            unsigned long encoded_len = 16;  // 8 bytes -> 12 chars + padding
-                            unsigned char encoded_checksum[16]{};
-                            base64_encode(checksum_bytes, 8, encoded_checksum, &encoded_len);
-                            std::string checksum_b64(reinterpret_cast<char*>(encoded_checksum), encoded_len);
+                            std::string checksum_b64 = encode_crc64_nvme_checksum(data.checksum_vector[i]);
 
                             xml += fmt::format("<Part><PartNumber>{}</PartNumber><ETag>{}</ETag><ChecksumCRC64NVME>{}</ChecksumCRC64NVME></Part>\n",
                                     i + 1, data.etags[i], checksum_b64);
@@ -1794,7 +2757,8 @@ namespace irods::experimental::io::s3_transport
                     S3MultipartCommitHandler commit_handler
                         = { {s3_multipart_upload::commit_callback::on_response_properties,
                              s3_multipart_upload::commit_callback::on_response_completion },
-                            s3_multipart_upload::commit_callback::on_response, nullptr };
+                            s3_multipart_upload::commit_callback::on_response,
+                            s3_multipart_upload::commit_callback::on_commit_response };
 
                     do {
                         // On partial error, need to restart XML send from the beginning
@@ -1802,6 +2766,7 @@ namespace irods::experimental::io::s3_transport
                         upload_manager_.xml = xml.c_str();
 
                         upload_manager_.offset = 0;
+                        upload_manager_.etag.clear();
                         S3_complete_multipart_upload(&bucket_context_,
                                 object_key_.c_str(),
                                 &commit_handler,
@@ -1848,6 +2813,9 @@ namespace irods::experimental::io::s3_transport
                         this->set_error(ERROR(S3_PUT_ERROR, msg.c_str()));
                         return error_codes::COMPLETE_MULTIPART_UPLOAD_ERROR;
                     }
+
+                    // empty if the completion timed out
+                    this->upload_etag_ = upload_manager_.etag;
                 }
 
                 if (error_codes::SUCCESS != data.last_error_code && "" != data.upload_id ) {
@@ -1877,6 +2845,9 @@ namespace irods::experimental::io::s3_transport
         //                            provided the current offset (file_offset_) is used.
         //     shmem_already_locked - If provided and true then no locking is done in shmem.
         //                            The default is false (with shmem locking).
+        //     use_read_cache       - If false, a read into a buffer goes to S3 even when the read cache
+        //                            or read page cache is open.  The default is true.
+        //     if_match_etag        - If not null the download fails unless the object has this ETag.
         //
         //         Note:  The mutex is recursive but when reading from cache this is called by newly created
         //                threads and thus we need the flag if shmem is already locked.
@@ -1884,7 +2855,9 @@ namespace irods::experimental::io::s3_transport
         std::streamsize s3_download_part_worker_routine(char_type *buffer,
                 std::int64_t length,
                 off_t offset = -1,
-                bool shmem_already_locked = false)
+                bool shmem_already_locked = false,
+                bool use_read_cache = true,
+                const char* if_match_etag = nullptr)
         {
             namespace bi = boost::interprocess;
             namespace types = shared_data::interprocess_types;
@@ -1909,8 +2882,12 @@ namespace irods::experimental::io::s3_transport
                 // Download to cache
                 read_callback.reset(new callback_for_read_from_s3_to_cache
                         (bucket_context_));
-                static_cast<callback_for_read_from_s3_to_cache*>
-                    (read_callback.get())->set_and_open_cache_file(cache_file_path_);
+                auto cache_callback = static_cast<callback_for_read_from_s3_to_cache*>(read_callback.get());
+                cache_callback->set_cache_file_writer(cache_file_writer_);
+                if (config_.cache_io_uring_enabled && !cache_callback->enable_io_uring()) {
+                    logger::debug("{}:{} ({}) [[{}]] io_uring is not available, writing the cache file with pwrite",
+                            __FILE__, __LINE__, __func__, get_thread_identifier());
+                }
             } else {
                 // Download to buffer
 
@@ -1929,6 +2906,15 @@ namespace irods::experimental::io::s3_transport
                     }
                 }
 
+                if (read_cache_ && use_read_cache) {
+                    return read_through_cache(buffer, length, offset, shmem_already_locked);
+                }
+
+                // only small reads benefit from the page cache
+                if (read_page_cache_ && use_read_cache && length < read_page_cache_->page_size()) {
+                    return read_through_page_cache(buffer, length, offset, shmem_already_locked);
+                }
+
                 read_callback.reset(new callback_for_read_from_s3_to_buffer(bucket_context_));
                 static_cast<callback_for_read_from_s3_to_buffer*>(read_callback.get())
                     ->set_output_buffer(buffer);
@@ -1938,6 +2924,8 @@ namespace irods::experimental::io::s3_transport
             }
             read_callback->content_length = length;
             read_callback->thread_identifier = get_thread_identifier();
+
+            S3GetConditions get_conditions{-1, -1, if_match_etag, nullptr};
             read_callback->shmem_key = shmem_key_;
             read_callback->shared_memory_timeout_in_seconds = config_.shared_memory_timeout_in_seconds;
 
@@ -1964,10 +2952,21 @@ namespace irods::experimental::io::s3_transport
 
                 std::uint64_t start_microseconds = get_time_in_microseconds();
 
-                S3_get_object( &bucket_context_, object_key_.c_str(), NULL,
+                S3_get_object( &bucket_context_, object_key_.c_str(), if_match_etag ? &get_conditions : NULL,
                         offset, read_callback->content_length, 0, 0,
                         &get_object_handler, read_callback.get() );
 
+                // the last writes to the cache file may still be queued
+                if (buffer == nullptr &&
+                        !static_cast<callback_for_read_from_s3_to_cache*>(read_callback.get())->finish_writes()) {
+                    logger::error("{}:{} ({}) [[{}]] failed to write to cache file",
+                            __FILE__, __LINE__, __func__, get_thread_identifier());
+                    if (read_callback->status == libs3_types::status_ok) {
+                        read_callback->status = S3StatusAbortedByCallback;
+                    }
+                    read_callback->bytes_read_from_s3 = 0;
+                }
+
                 std::uint64_t end_microseconds = get_time_in_microseconds();
                 double bw = (read_callback->content_length / (1024.0*1024.0)) /
                     ( (end_microseconds - start_microseconds) / 1000000.0 );
@@ -2126,7 +3125,14 @@ namespace irods::experimental::io::s3_transport
                     static_cast<s3_multipart_upload::callback_for_write_from_cache_to_s3<CharT>*>
                     (write_callback.get());
 
-                write_callback_from_cache->set_and_open_cache_file(cache_file_path_);
+                write_callback_from_cache->set_cache_file_reader(cache_file_reader_);
+                if (config_.cache_io_uring_enabled && !write_callback_from_cache->enable_io_uring()) {
+                    logger::debug("{}:{} ({}) [[{}]] io_uring is not available, reading the cache file with pread",
+                            __FILE__, __LINE__, __func__, get_thread_identifier());
+                }
+
+                // start reading this part ahead of the upload
+                cache_file_reader_->will_need(file_offset, bytes_this_thread);
 
                 content_length = bytes_this_thread;
                 start_part_number = end_part_number = part_number;
@@ -2206,12 +3212,9 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
 
                             // Get the checksum from the hasher (accumulated during data upload).
                             // Store in cb->trailing_checksum_value so it outlives this lambda call.
-                            cb->hasher.digest(cb->trailing_checksum_value);
+                            cb->trailing_checksum_value = encode_crc64_nvme_checksum(cb->hasher.value());
                             logger::debug("{}:{} ({}) checksum from hasher: [{}]", __FILE__, __LINE__, __func__, cb->trailing_checksum_value);
 
-                            // Remove the "crc64nvme:" prefix from the checksum string
-                            remove_checksum_prefix(cb->trailing_checksum_value, irods::CRC64NVME_NAME + ":");
-
                             headers[0].name = "x-amz-checksum-crc64nvme";
                             headers[0].value = cb->trailing_checksum_value.c_str();
                             logger::debug("{}:{} ({}) part trailing checksum header: {}={}",
@@ -2297,11 +3300,7 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
 
                             // Reset bytes_written and hasher for retry
                             write_callback->bytes_written = 0;
-#ifdef IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
-                            if (config_.trailing_checksum_on_upload_enabled) {
-                                irods::getHasher(irods::CRC64NVME_NAME.data(), write_callback->hasher);
-                            }
-#endif // IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+                            write_callback->hasher.reset();
                         }
                     }
 
@@ -2333,59 +3332,17 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
                     break;
                 }
 
-                // save the checksum
-                std::string checksum_str;
-#ifdef IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
-                write_callback->hasher.digest(checksum_str);
-                logger::debug("{}:{} ({}) checksum_str=[{}]", __FILE__, __LINE__, __func__, checksum_str);
-
-                // delete the "crc64nvme:" prefix from the checksum string
-                if (checksum_str.length() > irods::CRC64NVME_NAME.length() + 1) {
-                   checksum_str = checksum_str.substr(irods::CRC64NVME_NAME.length() + 1);
-                } else {
-                    checksum_str = "";
-                }
-#endif // IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
-
-                // save the actual part size and decoded checksum to shared memory
+                // save the actual part size and checksum to shared memory
                 auto actual_part_size = write_callback->content_length;
-                shm_obj.atomic_exec([&checksum_str, part_number, actual_part_size](auto& data) {
+                std::uint64_t part_checksum = config_.trailing_checksum_on_upload_enabled ? write_callback->hasher.value() : 0;
+                shm_obj.atomic_exec([part_checksum, part_number, actual_part_size](auto& data) {
                     // save actual part size (not bytes_this_thread which is total for the thread)
                     data.part_size_vector[part_number-1] = actual_part_size;
-
-                    // decode checksum as uint64_t and save it
-			        if (!checksum_str.empty()) {
-                        unsigned long out_len = 8;
-						unsigned char response[8]{};
-                        auto err = base64_decode(reinterpret_cast<const unsigned char*>(checksum_str.c_str()),
-                                     checksum_str.size(),
-                                     reinterpret_cast<unsigned char*>(response),
-                                     &out_len);
-                        if (err < 0) {
-                            logger::error("{}:{} ({}) Base64 decoding of [{}] failed.",
-					    			__FILE__, __LINE__, __func__, checksum_str);
-                            data.checksum_vector[part_number-1] = 0;
-							return;
-						}
-
-						// The checksum was stored in big endian format before the base64 encoding.
-						// Convert this back to a uint64_t by interpreting the 8 bytes as big endian.
-						uint64_t val = 0;
-						for (int i = 0; i < 8; ++i) {
-						    val += (response[i]) * (static_cast<uint64_t>(0x01) << ((7-i) * 8));
-						}
-                        data.checksum_vector[part_number-1] = val;
-					} else {
-                        data.checksum_vector[part_number-1] = 0;
-					}
+                    data.checksum_vector[part_number-1] = part_checksum;
                 });
 
-#ifdef IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
                 // Reset hasher for next part
-                if (config_.trailing_checksum_on_upload_enabled) {
-                    irods::getHasher(irods::CRC64NVME_NAME.data(), write_callback->hasher);
-                }
-#endif // IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+                write_callback->hasher.reset();
 
             } // for
 
@@ -2409,6 +3366,8 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
 
             do {
 
+                upload_manager_.etag.clear();
+
                 S3PutObjectHandler put_object_handler = {
                     {
                         s3_upload::callback_for_write_to_s3_base<CharT>::on_response_properties,
@@ -2429,11 +3388,27 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
                         static_cast<s3_upload::callback_for_write_from_cache_to_s3<CharT>*>
                         (write_callback.get());
 
-                    write_callback_from_cache->set_and_open_cache_file(cache_file_path_);
+                    write_callback_from_cache->set_cache_file_reader(cache_file_reader_);
+                    if (config_.cache_io_uring_enabled && !write_callback_from_cache->enable_io_uring()) {
+                        logger::debug("{}:{} ({}) [[{}]] io_uring is not available, reading the cache file with pread",
+                                __FILE__, __LINE__, __func__, get_thread_identifier());
+                    }
 
                     write_callback->content_length = get_cache_file_size();
                     write_callback->offset = 0;
 
+                    cache_file_reader_->will_need(0, write_callback->content_length);
+
+
+                } else if (use_small_object_buffer_) {
+
+                    // Read from the in-memory small object buffer
+
+                    write_callback.reset(new
+                            s3_upload::callback_for_write_from_memory_to_s3<CharT>(
+                                bucket_context_, upload_manager_, small_object_buffer_));
+
+                    write_callback->content_length = small_object_buffer_.size();
 
                 } else {
 
@@ -2450,7 +3425,9 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
                 write_callback->enable_md5 = config_.enable_md5_flag;
                 write_callback->thread_identifier = get_thread_identifier();
                 write_callback->object_key = object_key_;
-                write_callback->shmem_key = shmem_key_;
+                // the small object fast path does not use shared memory, an empty key tells
+                // the callback not to touch it
+                write_callback->shmem_key = use_small_object_buffer_ ? std::string{} : shmem_key_;
                 write_callback->shared_memory_timeout_in_seconds = config_.shared_memory_timeout_in_seconds;
                 write_callback->transport_object_ptr = this;
 
@@ -2461,6 +3438,10 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
                 put_props.xAmzStorageClass = config_.s3_storage_class.c_str();
                 put_props.xAmzDecodedContentLength = -1;
 
+                // If the data was written before the upload started the checksum is known, save it with the object
+                S3NameValue checksum_metadata[2];
+                set_upload_checksum_metadata(put_props, checksum_metadata);
+
                 // zero out bytes_written in case of failure and re-run
                 write_callback->bytes_written = 0;
 
@@ -2479,15 +3460,11 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
                         // Cast void* back to the callback object type
                         auto* cb = static_cast<s3_upload::callback_for_write_to_s3_base<CharT>*>(callbackData);
 
-                        // Get the checksum from the hasher (accumulated during data upload)
                         // Get the checksum from the hasher (accumulated during data upload).
                         // Store in cb->trailing_checksum_value so it outlives this lambda call.
-                        cb->hasher.digest(cb->trailing_checksum_value);
+                        cb->trailing_checksum_value = encode_crc64_nvme_checksum(cb->hasher.value());
                         logger::debug("{}:{} ({}) checksum from hasher: [{}]", __FILE__, __LINE__, __func__, cb->trailing_checksum_value);
 
-                        // Remove the "crc64nvme:" prefix from the checksum string
-                        remove_checksum_prefix(cb->trailing_checksum_value, irods::CRC64NVME_NAME + ":");
-
                         headers[0].name = "x-amz-checksum-crc64nvme";
                         headers[0].value = cb->trailing_checksum_value.c_str();
                         logger::debug("{}:{} ({}) trailing checksum header: {}={}",
@@ -2543,13 +3520,15 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
                 if (write_callback->status != libs3_types::status_ok) {
 
                     // Check for a timeout reading from circular buffer.  If we got one then bypass retries.
-                    named_shared_memory_object shm_obj{shmem_key_,
-                        config_.shared_memory_timeout_in_seconds,
-                        constants::MAX_S3_SHMEM_SIZE};
+                    if (!use_small_object_buffer_) {
+                        named_shared_memory_object shm_obj{shmem_key_,
+                            config_.shared_memory_timeout_in_seconds,
+                            constants::MAX_S3_SHMEM_SIZE};
 
-                    circular_buffer_read_timeout =  shm_obj.atomic_exec([](auto& data) {
-                        return data.circular_buffer_read_timeout;
-                    });
+                        circular_buffer_read_timeout =  shm_obj.atomic_exec([](auto& data) {
+                            return data.circular_buffer_read_timeout;
+                        });
+                    }
 
                     // break out of do/while if we timed out reading from circular buffer
                     if (circular_buffer_read_timeout) {
@@ -2573,11 +3552,265 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
                 return error_codes::UPLOAD_FILE_ERROR;
             }
 
+            upload_checksum_in_metadata_ = !upload_checksum_.empty();
+            upload_etag_ = upload_manager_.etag;
 
             return error_codes::SUCCESS;
 
         } // end s3_upload_file
 
+        // Takes a buffer for the small object fast path from the pool, or creates one
+        void acquire_small_object_buffer()
+        {
+            {
+                std::lock_guard<std::mutex> lock(small_object_buffer_pool_mutex_);
+                if (!small_object_buffer_pool_.empty()) {
+                    small_object_buffer_ = std::move(small_object_buffer_pool_.back());
+                    small_object_buffer_pool_.pop_back();
+                }
+            }
+            small_object_buffer_.clear();
+            small_object_buffer_.reserve(config_.object_size);
+        }
+
+        // Returns the small object buffer to the pool so the next small object does not allocate
+        void release_small_object_buffer()
+        {
+            if (small_object_buffer_.capacity() == 0) {
+                return;
+            }
+            small_object_buffer_.clear();
+            {
+                std::lock_guard<std::mutex> lock(small_object_buffer_pool_mutex_);
+                if (small_object_buffer_pool_.size() < maximum_small_object_buffer_pool_size) {
+                    small_object_buffer_pool_.push_back(std::move(small_object_buffer_));
+                }
+            }
+            small_object_buffer_ = buffer_type{};
+        }
+
+        // Start computing the checksum of the bytes written by this transport if it was requested
+        // and it can be used.  Ranges written by parallel threads can only be combined for CRC64/NVME.
+        void begin_upload_checksum()
+        {
+            upload_checksum_active_ = false;
+            upload_checksum_start_offset_ = -1;
+            upload_checksum_length_ = 0;
+            upload_range_digest_.clear();
+            upload_checksum_.clear();
+            upload_checksum_in_metadata_ = false;
+            upload_etag_.clear();
+
+            if (config_.upload_checksum_scheme.empty() || !(mode_ & std::ios_base::out)) {
+                return;
+            }
+
+            if (config_.number_of_client_transfer_threads > 1 && !is_upload_checksum_combinable()) {
+                logger::debug("{}:{} ({}) [[{}]] checksum scheme [{}] can not be combined across {} threads, not computing it on upload",
+                        __FILE__, __LINE__, __func__, get_thread_identifier(),
+                        config_.upload_checksum_scheme, config_.number_of_client_transfer_threads);
+                return;
+            }
+
+            // CRC64/NVME is computed directly on the written buffers
+            upload_crc64_nvme_hasher_.reset();
+            if (is_upload_checksum_combinable()) {
+                upload_checksum_active_ = true;
+                return;
+            }
+
+            irods::error ret = irods::getHasher(config_.upload_checksum_scheme, upload_hasher_);
+            if (!ret.ok()) {
+                logger::warn("{}:{} ({}) [[{}]] checksum scheme [{}] is not available, not computing it on upload",
+                        __FILE__, __LINE__, __func__, get_thread_identifier(), config_.upload_checksum_scheme);
+                return;
+            }
+
+            upload_checksum_active_ = true;
+        }
+
+        bool is_upload_checksum_combinable() const
+        {
+#ifdef IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+            return boost::iequals(config_.upload_checksum_scheme, irods::CRC64NVME_NAME);
+#else
+            return false;
+#endif // IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+        }
+
+        // Hash the bytes being written.  Hashing stops if a write is not contiguous with the previous one.
+        void update_upload_checksum(const char_type* _buffer, std::streamsize _buffer_size)
+        {
+            if (!upload_checksum_active_ || _buffer_size <= 0) {
+                return;
+            }
+
+            // The offset of this write.  Without a cache file, send() does not move the file offset
+            // so it only changes if there was a seek.
+            std::int64_t position;
+            if (use_small_object_buffer_) {
+                position = static_cast<std::int64_t>(small_object_buffer_.size());
+            } else if (use_cache_) {
+                position = static_cast<std::int64_t>(cache_fstream_.tellp());
+            } else {
+                position = get_file_offset() + upload_checksum_length_;
+            }
+
+            if (upload_checksum_start_offset_ < 0) {
+                upload_checksum_start_offset_ = position;
+            } else if (position != upload_checksum_start_offset_ + upload_checksum_length_) {
+                logger::debug("{}:{} ({}) [[{}]] write at offset {} is not sequential, not computing the checksum on upload",
+                        __FILE__, __LINE__, __func__, get_thread_identifier(), position);
+                upload_checksum_active_ = false;
+                return;
+            }
+
+            if (is_upload_checksum_combinable()) {
+                upload_crc64_nvme_hasher_.update({_buffer, static_cast<std::size_t>(_buffer_size)});
+            } else {
+                // irods::Hasher only accepts a std::string
+                upload_hasher_.update(std::string(_buffer, _buffer_size));
+            }
+            upload_checksum_length_ += _buffer_size;
+        }
+
+        // The checksum, in iRODS format, of the bytes hashed by this transport
+        void digest_upload_checksum(std::string& _digest)
+        {
+#ifdef IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+            if (is_upload_checksum_combinable()) {
+                _digest = irods::CRC64NVME_NAME + ":" + encode_crc64_nvme_checksum(upload_crc64_nvme_hasher_.value());
+                return;
+            }
+#endif // IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+            upload_hasher_.digest(_digest);
+        }
+
+        // True if the bytes hashed by this transport are the complete object
+        bool upload_checksum_covers_object(std::int64_t _object_size) const
+        {
+            return upload_checksum_length_ == _object_size &&
+                (upload_checksum_start_offset_ == 0 || upload_checksum_length_ == 0);
+        }
+
+        // Called on close.  Save the range hashed by this transport to shared memory.
+        template <typename SharedData>
+        void save_upload_checksum_range(SharedData& data)
+        {
+            if (config_.upload_checksum_scheme.empty() || !(mode_ & std::ios_base::out)) {
+                return;
+            }
+
+            if (!upload_checksum_active_) {
+                data.upload_checksum_incomplete = true;
+                return;
+            }
+
+            // nothing was written by this thread
+            if (upload_checksum_length_ == 0) {
+                return;
+            }
+
+            digest_upload_checksum(upload_range_digest_);
+
+            std::uint64_t crc = is_upload_checksum_combinable() ? upload_crc64_nvme_hasher_.value() : 0;
+
+            if (data.upload_checksum_ranges.size() >= 3 * constants::MAXIMUM_NUMBER_UPLOAD_CHECKSUM_RANGES) {
+                data.upload_checksum_incomplete = true;
+                return;
+            }
+
+            data.upload_checksum_ranges.push_back(upload_checksum_start_offset_);
+            data.upload_checksum_ranges.push_back(upload_checksum_length_);
+            data.upload_checksum_ranges.push_back(crc);
+        }
+
+        // Called by the last transport to close.  Combine the ranges saved by all of the transports
+        // into the checksum of the object if they cover the object from beginning to end.
+        template <typename SharedData>
+        void combine_upload_checksum_ranges(SharedData& data)
+        {
+            upload_checksum_.clear();
+
+            if (config_.upload_checksum_scheme.empty() || !(mode_ & std::ios_base::out)) {
+                return;
+            }
+
+            std::vector<std::array<std::uint64_t, 3>> ranges;
+            for (std::size_t i = 0; i + 2 < data.upload_checksum_ranges.size(); i += 3) {
+                ranges.push_back({data.upload_checksum_ranges[i],
+                        data.upload_checksum_ranges[i+1],
+                        data.upload_checksum_ranges[i+2]});
+            }
+            bool incomplete = data.upload_checksum_incomplete;
+
+            // clear for the next upload of this object
+            data.upload_checksum_ranges.clear();
+            data.upload_checksum_incomplete = false;
+
+            if (incomplete || !upload_checksum_active_) {
+                return;
+            }
+
+            std::int64_t object_size = use_cache_ ? get_cache_file_size() : config_.object_size;
+
+            // empty object, nothing was hashed
+            if (ranges.empty()) {
+                if (object_size == 0) {
+                    digest_upload_checksum(upload_checksum_);
+                }
+                return;
+            }
+
+            std::sort(ranges.begin(), ranges.end());
+
+            std::uint64_t end_of_ranges = 0;
+            for (const auto& range : ranges) {
+                if (range[0] != end_of_ranges) {
+                    return;
+                }
+                end_of_ranges += range[1];
+            }
+
+            if (object_size != config::UNKNOWN_OBJECT_SIZE && static_cast<std::uint64_t>(object_size) != end_of_ranges) {
+                return;
+            }
+
+            if (!is_upload_checksum_combinable()) {
+                // only one range, make sure it is ours
+                if (ranges.size() == 1 && upload_checksum_start_offset_ == 0 && !upload_range_digest_.empty()) {
+                    upload_checksum_ = upload_range_digest_;
+                }
+                return;
+            }
+
+#ifdef IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+            std::uint64_t crc = ranges[0][2];
+            for (std::size_t i = 1; i < ranges.size(); ++i) {
+                crc = crc64_nvme_combine(crc, ranges[i][2], ranges[i][1]);
+            }
+            upload_checksum_ = irods::CRC64NVME_NAME + ":" + encode_crc64_nvme_checksum(crc);
+
+            logger::debug("{}:{} ({}) [[{}]] combined {} ranges into checksum {}",
+                    __FILE__, __LINE__, __func__, get_thread_identifier(), ranges.size(), upload_checksum_);
+#endif // IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+        }
+
+        // Add the upload checksum, if it is known, to the user metadata of the put properties.
+        // _metadata must outlive the request.
+        void set_upload_checksum_metadata(S3PutProperties& _put_props, S3NameValue (&_metadata)[2])
+        {
+            if (upload_checksum_.empty()) {
+                return;
+            }
+            _metadata[0].name  = constants::UPLOAD_CHECKSUM_METADATA_NAME.c_str();
+            _metadata[0].value = upload_checksum_.c_str();
+            _metadata[1].name  = constants::UPLOAD_CHECKSUM_SCHEME_METADATA_NAME.c_str();
+            _metadata[1].value = config_.upload_checksum_scheme.c_str();
+            _put_props.metaDataCount = 2;
+            _put_props.metaData = _metadata;
+        }
+
         bool use_streaming_multipart() {
 
             assert(config_.circular_buffer_size / 2 <= std::numeric_limits<std::uint64_t>::max());
@@ -2610,11 +3843,25 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
         inline static std::mutex     file_offset_mutex_;
         off_t                        file_offset_;
         std::int64_t                 existing_object_size_;
+        std::string                  existing_object_etag_;
+        time_t                       existing_object_last_modified_;
+
+        // only set when the object is read through the read cache
+        std::unique_ptr<read_cache>  read_cache_;
+        std::uint64_t                read_cache_object_id_;
+        std::uint64_t                read_cache_version_id_;
+
+        // only set when small reads are served from memory
+        std::unique_ptr<read_page_cache> read_page_cache_;
+
+        // part size of a sparse cache file or zero if the whole object is in the cache file
+        std::int64_t                 sparse_cache_part_size_;
 
 
         // operational modes based on input flags
         bool                         download_to_cache_;
         bool                         use_cache_;
+        bool                         use_small_object_buffer_;
         bool                         object_must_exist_;
 
         libs3_types::bucket_context  bucket_context_;
@@ -2626,16 +3873,30 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
         std::string                  cache_file_path_;
         std::fstream                 cache_fstream_;
 
+        // only set while the cache file is being flushed
+        std::shared_ptr<cache_file_reader>
+                                     cache_file_reader_;
+
+        // only set while the object is being downloaded to the cache file
+        std::shared_ptr<cache_file_writer>
+                                     cache_file_writer_;
+
         inline static int            file_descriptor_counter_ = minimum_valid_file_descriptor;
 
-        // This counter keeps track of whether this process has initialized
-        // S3 and how many threads in the process are active.  The first thread (counter=0)
-        // intitializes S3 and the last thread (counter decremented to 0) deinitializes.
-        // If we are in a multithreaded / single process environment the
-        // initialization will run only once.  If we are in a multiprocess
-        // environment it will run multiple times.
-        inline static int            s3_initialized_counter_ = 0;
-        inline static std::mutex     s3_initialized_counter_mutex_;
+        // Buffers for the small object fast path are recycled between transports in this
+        // process so that writing many small objects does not allocate a buffer per object.
+        static constexpr std::size_t maximum_small_object_buffer_pool_size = 8;
+        inline static std::mutex     small_object_buffer_pool_mutex_;
+        inline static std::vector<buffer_type>
+                                     small_object_buffer_pool_;
+        buffer_type                  small_object_buffer_;
+
+        // Whether this process has initialized S3.  The first open initializes it and the
+        // initialization is kept for the life of the process.  Deinitializing when the last
+        // transport closed threw away the pooled requests (and their connections) that the
+        // next open would need again.
+        inline static bool           s3_initialized_ = false;
+        inline static std::mutex     s3_initialized_mutex_;
 
         inline static std::mutex     region_name_mutex_;
         inline static std::mutex     bytes_this_thread_mutex_;
@@ -2643,6 +3904,19 @@ logger::debug( "{}:{} ({}) [[{}]] write_callback->content_length is set to {} ",
         // this is set to true when the last file closes
         bool                         last_file_to_close_;
 
+        // checksum computed while writing, see config::upload_checksum_scheme
+        irods::Hasher                upload_hasher_;
+        crc64_nvme_hasher            upload_crc64_nvme_hasher_;
+        bool                         upload_checksum_active_;
+        std::int64_t                 upload_checksum_start_offset_;
+        std::int64_t                 upload_checksum_length_;
+        std::string                  upload_range_digest_;
+        std::string                  upload_checksum_;
+        bool                         upload_checksum_in_metadata_;
+
+        // ETag returned when this transport completed the upload, see get_upload_etag()
+        std::string                  upload_etag_;
+
         // when an error occurs this is set to something other than SUCCESS()
         inline static std::mutex     error_mutex_;
         irods::error                 error_;
@@ -4,6 +4,8 @@
 #include "irods/private/s3_transport/circular_buffer.hpp"
 #include "libs3/libs3.h"
 
+#include <cstdint>
+
 namespace irods::experimental::io::s3_transport
 {
 
@@ -41,6 +43,15 @@ namespace irods::experimental::io::s3_transport
         FAILED
     };
 
+    // State of a part of a sparse cache file
+    enum class sparse_cache_part_state : std::uint64_t
+    {
+        NOT_DOWNLOADED,  // the part is still only in S3
+        DOWNLOADED,      // the part has been downloaded to the cache file
+        MODIFIED,        // the part has been downloaded and written to
+        DOWNLOADING      // a thread is downloading the part without holding the lock
+    };
+
 } // irods::experimental::io::s3_transport
 
 #endif // S3_TRANSPORT_TYPES_HPP
@@ -62,13 +62,25 @@ namespace irods::experimental::io::s3_transport
         //
         // Each part (maximum count of MAXIMUM_NUMBER_ETAGS_PER_UPLOAD) can have an ETAG, 8 bytes for part size,
 		// and 8 bytes for CRC64/NVME checksum
+        //
+        // Each client transfer thread (maximum count of MAXIMUM_NUMBER_UPLOAD_CHECKSUM_RANGES) that
+        // computes the upload checksum saves the offset, length, and CRC64/NVME of its range.  This is
+        // doubled to leave room for the vector to grow.
+        static const std::int64_t            MAXIMUM_NUMBER_UPLOAD_CHECKSUM_RANGES{256};
+
         static constexpr std::int64_t  MAX_S3_SHMEM_SIZE{100*sizeof(void*) +
 			sizeof(shared_data::multipart_shared_data) +
 			MAXIMUM_NUMBER_ETAGS_PER_UPLOAD * (BYTES_PER_ETAG + 16 + 1) +
+			MAXIMUM_NUMBER_UPLOAD_CHECKSUM_RANGES * 3 * sizeof(std::uint64_t) * 2 +
+			MAXIMUM_NUMBER_ETAGS_PER_UPLOAD * sizeof(std::uint64_t) +
 			UPLOAD_ID_SIZE + 1};
 
         static const int                DEFAULT_SHARED_MEMORY_TIMEOUT_IN_SECONDS{900};
         inline static const std::string SHARED_MEMORY_KEY_PREFIX{"irods_s3_transport-shm-"};
+
+        // S3 user metadata (x-amz-meta-*) holding the checksum computed while the object was uploaded
+        inline static const std::string UPLOAD_CHECKSUM_METADATA_NAME{"irods-checksum"};
+        inline static const std::string UPLOAD_CHECKSUM_SCHEME_METADATA_NAME{"irods-checksum-scheme"};
     };
 
     void print_bucket_context( const libs3_types::bucket_context& bucket_context );
@@ -84,6 +96,11 @@ namespace irods::experimental::io::s3_transport
     // If the prefix is not detected the checksum_str is unaltered.
     void remove_checksum_prefix(std::string& checksum_str, const std::string& checksum_prefix);
 
+    // Convert between a CRC64/NVME value and the base64 encoding of its big endian bytes,
+    // which is how both S3 and iRODS (after the "crc64nvme:" prefix) represent it.
+    auto decode_crc64_nvme_checksum(const std::string& _checksum_str, std::uint64_t& _crc) -> bool;
+    auto encode_crc64_nvme_checksum(std::uint64_t _crc) -> std::string;
+
     // Sleep between _s / 2 and _s seconds.
     // The random addition ensures that threads don't all cluster up and retry
     // at the same time (dogpile effect)
@@ -114,6 +131,9 @@ namespace irods::experimental::io::s3_transport
         std::string              object_key;
         std::string              shmem_key;
         time_t                   shared_memory_timeout_in_seconds;
+
+        /* ETag of the object returned by the single part PUT or the multipart completion */
+        std::string              etag;
     };
 
     struct data_for_write_callback
@@ -148,6 +168,7 @@ namespace irods::experimental::io::s3_transport
         explicit data_for_head_callback(libs3_types::bucket_context& _bucket_context)
             : last_modified{0}
             , content_length{0}
+            , etag{}
             , x_amz_storage_class{}   // for glacier
             , x_amz_restore{}         // for glacier
             , status{libs3_types::status_ok}
@@ -156,12 +177,24 @@ namespace irods::experimental::io::s3_transport
 
         time_t                             last_modified;
         std::int64_t                       content_length;
+        std::string                        etag;
         std::string                        x_amz_storage_class;
         std::string                        x_amz_restore;
         libs3_types::status                status;
         libs3_types::bucket_context&       bucket_context;
     };
 
+    struct data_for_copy_part_callback
+    {
+        explicit data_for_copy_part_callback(libs3_types::bucket_context& _bucket_context)
+            : status{libs3_types::status_ok}
+            , bucket_context{_bucket_context}
+        {}
+
+        libs3_types::status                status;
+        libs3_types::bucket_context&       bucket_context;
+    };
+
 } // irods::experimental::io::s3_transport
 
 #endif // S3_TRANSPORT_UTIL_HPP
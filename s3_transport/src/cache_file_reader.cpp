@@ -0,0 +1,65 @@
+#include "irods/private/s3_transport/cache_file_reader.hpp"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace irods::experimental::io::s3_transport
+{
+    cache_file_reader::cache_file_reader(const std::string& _path)
+        : fd_{::open(_path.c_str(), O_RDONLY | O_CLOEXEC)}
+    {
+        if (fd_ != -1) {
+            // advisory only, ignore failures
+            ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+    }
+
+    cache_file_reader::~cache_file_reader()
+    {
+        if (fd_ != -1) {
+            ::close(fd_);
+        }
+    }
+
+    auto cache_file_reader::size() const noexcept -> std::int64_t
+    {
+        struct stat st{};
+        if (fd_ == -1 || ::fstat(fd_, &st) != 0) {
+            return -1;
+        }
+        return static_cast<std::int64_t>(st.st_size);
+    }
+
+    auto cache_file_reader::read(std::int64_t _offset, char* _buffer, std::int64_t _length) const noexcept -> std::int64_t
+    {
+        if (fd_ == -1 || _offset < 0 || _length < 0) {
+            return -1;
+        }
+
+        std::int64_t total = 0;
+        while (total < _length) {
+            const ssize_t n = ::pread(fd_, _buffer + total, static_cast<std::size_t>(_length - total), _offset + total);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            if (n == 0) {
+                break; // end of file
+            }
+            total += n;
+        }
+        return total;
+    }
+
+    void cache_file_reader::will_need(std::int64_t _offset, std::int64_t _length) const noexcept
+    {
+        if (fd_ != -1 && _offset >= 0 && _length > 0) {
+            ::posix_fadvise(fd_, _offset, _length, POSIX_FADV_WILLNEED);
+        }
+    }
+} // namespace irods::experimental::io::s3_transport
@@ -0,0 +1,42 @@
+#include "irods/private/s3_transport/cache_file_writer.hpp"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace irods::experimental::io::s3_transport
+{
+    cache_file_writer::cache_file_writer(const std::string& _path, bool _truncate)
+        : fd_{::open(_path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (_truncate ? O_TRUNC : 0), 0666)}
+    {
+    }
+
+    cache_file_writer::~cache_file_writer()
+    {
+        if (fd_ != -1) {
+            ::close(fd_);
+        }
+    }
+
+    auto cache_file_writer::write(std::int64_t _offset, const char* _data, std::size_t _length) const noexcept -> bool
+    {
+        if (fd_ == -1 || _offset < 0) {
+            return false;
+        }
+
+        while (_length > 0) {
+            const ssize_t n = ::pwrite(fd_, _data, _length, _offset);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            _data += n;
+            _offset += n;
+            _length -= n;
+        }
+        return true;
+    }
+} // namespace irods::experimental::io::s3_transport
@@ -0,0 +1,344 @@
+// CRC64/NVME (reflected polynomial 0x9a6c9329ac4bc9b5, initial value and final xor of all ones).
+//
+// The accelerated implementations fold 128 bit blocks of the message together with carry-less
+// multiplication, as described in "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+// Instruction" (Intel, 2009).  The folded 128 bits are finished with the table implementation,
+// which avoids the Barrett reduction constants.
+
+#include "irods/private/s3_transport/crc64_nvme.hpp"
+
+#include <array>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define S3_TRANSPORT_CRC64_NVME_CLMUL
+#  include <immintrin.h>
+#endif
+
+namespace irods::experimental::io::s3_transport
+{
+    namespace
+    {
+        // reflected CRC64/NVME polynomial
+        constexpr std::uint64_t crc64_nvme_polynomial = 0x9a6c9329ac4bc9b5ULL;
+
+        using crc64_table_type = std::array<std::array<std::uint64_t, 256>, 8>;
+
+        constexpr crc64_table_type make_crc64_nvme_table()
+        {
+            crc64_table_type table{};
+            for (std::uint64_t i = 0; i < 256; ++i) {
+                std::uint64_t crc = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    crc = (crc & 1) ? (crc >> 1) ^ crc64_nvme_polynomial : crc >> 1;
+                }
+                table[0][i] = crc;
+            }
+            for (std::size_t k = 1; k < 8; ++k) {
+                for (std::size_t i = 0; i < 256; ++i) {
+                    table[k][i] = (table[k-1][i] >> 8) ^ table[0][table[k-1][i] & 0xff];
+                }
+            }
+            return table;
+        }
+
+        constexpr crc64_table_type crc64_nvme_table = make_crc64_nvme_table();
+
+        // Table driven CRC (slice-by-8) on the CRC register, which is the CRC without the
+        // initial and final inversion.
+        std::uint64_t crc64_nvme_table_update(std::uint64_t _reg, const unsigned char* _data, std::size_t _length)
+        {
+            const auto& t = crc64_nvme_table;
+
+            while (_length >= 8) {
+                std::uint64_t word = 0;
+                for (int i = 7; i >= 0; --i) {
+                    word = (word << 8) | _data[i];
+                }
+                _reg ^= word;
+                _reg = t[7][_reg & 0xff] ^ t[6][(_reg >> 8) & 0xff] ^
+                       t[5][(_reg >> 16) & 0xff] ^ t[4][(_reg >> 24) & 0xff] ^
+                       t[3][(_reg >> 32) & 0xff] ^ t[2][(_reg >> 40) & 0xff] ^
+                       t[1][(_reg >> 48) & 0xff] ^ t[0][_reg >> 56];
+                _data += 8;
+                _length -= 8;
+            }
+
+            while (_length > 0) {
+                _reg = t[0][(_reg ^ *_data) & 0xff] ^ (_reg >> 8);
+                ++_data;
+                --_length;
+            }
+
+            return _reg;
+        }
+
+        std::uint64_t crc64_nvme_portable(std::uint64_t _crc, const unsigned char* _data, std::size_t _length)
+        {
+            return ~crc64_nvme_table_update(~_crc, _data, _length);
+        }
+
+#ifdef S3_TRANSPORT_CRC64_NVME_CLMUL
+        // x^_n mod P in the reflected bit order used by the folding constants
+        constexpr std::uint64_t crc64_nvme_x_pow_mod(unsigned int _n)
+        {
+            constexpr std::uint64_t normal_polynomial = 0xad93d23594c93659ULL;
+            std::uint64_t value = 1;
+            for (unsigned int i = 0; i < _n; ++i) {
+                value = (value & 0x8000000000000000ULL) ? (value << 1) ^ normal_polynomial : value << 1;
+            }
+
+            std::uint64_t reflected = 0;
+            for (int i = 0; i < 64; ++i) {
+                reflected |= ((value >> i) & 1) << (63 - i);
+            }
+            return reflected;
+        }
+
+        // Constants to fold a 128 bit block forward by _bits bits.  The low half of the block holds
+        // the higher powers of x.  The product of two reflected 64 bit values is one bit short of
+        // a reflected 128 bit value, which is why the exponents are one less than might be expected.
+        struct fold_constants
+        {
+            std::uint64_t low;
+            std::uint64_t high;
+        };
+
+        constexpr fold_constants make_fold_constants(unsigned int _bits)
+        {
+            return {crc64_nvme_x_pow_mod(_bits + 63), crc64_nvme_x_pow_mod(_bits - 1)};
+        }
+
+        constexpr fold_constants fold_by_128  = make_fold_constants(128);
+        constexpr fold_constants fold_by_256  = make_fold_constants(256);
+        constexpr fold_constants fold_by_512  = make_fold_constants(512);
+        constexpr fold_constants fold_by_1024 = make_fold_constants(1024);
+
+        __attribute__((target("pclmul,sse2")))
+        inline __m128i fold_128(__m128i _block, __m128i _constants)
+        {
+            return _mm_xor_si128(_mm_clmulepi64_si128(_block, _constants, 0x00),
+                                 _mm_clmulepi64_si128(_block, _constants, 0x11));
+        }
+
+        __attribute__((target("pclmul,sse2")))
+        inline __m128i load_128(const unsigned char* _data)
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(_data));
+        }
+
+        // Fold the remaining 16 byte blocks into _x, then finish with the table.
+        __attribute__((target("pclmul,sse2")))
+        std::uint64_t crc64_nvme_finish(__m128i _x, const unsigned char* _data, std::size_t _length)
+        {
+            const __m128i k128 = _mm_set_epi64x(fold_by_128.high, fold_by_128.low);
+
+            while (_length >= 16) {
+                _x = _mm_xor_si128(fold_128(_x, k128), load_128(_data));
+                _data += 16;
+                _length -= 16;
+            }
+
+            alignas(16) unsigned char folded[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(folded), _x);
+
+            std::uint64_t reg = crc64_nvme_table_update(0, folded, sizeof(folded));
+            return ~crc64_nvme_table_update(reg, _data, _length);
+        }
+
+        __attribute__((target("pclmul,sse2")))
+        std::uint64_t crc64_nvme_pclmul(std::uint64_t _crc, const unsigned char* _data, std::size_t _length)
+        {
+            if (_length < 64) {
+                return crc64_nvme_portable(_crc, _data, _length);
+            }
+
+            const __m128i k128 = _mm_set_epi64x(fold_by_128.high, fold_by_128.low);
+            const __m128i k512 = _mm_set_epi64x(fold_by_512.high, fold_by_512.low);
+
+            __m128i x0 = _mm_xor_si128(load_128(_data), _mm_cvtsi64_si128(static_cast<long long>(~_crc)));
+            __m128i x1 = load_128(_data + 16);
+            __m128i x2 = load_128(_data + 32);
+            __m128i x3 = load_128(_data + 48);
+            _data += 64;
+            _length -= 64;
+
+            while (_length >= 64) {
+                x0 = _mm_xor_si128(fold_128(x0, k512), load_128(_data));
+                x1 = _mm_xor_si128(fold_128(x1, k512), load_128(_data + 16));
+                x2 = _mm_xor_si128(fold_128(x2, k512), load_128(_data + 32));
+                x3 = _mm_xor_si128(fold_128(x3, k512), load_128(_data + 48));
+                _data += 64;
+                _length -= 64;
+            }
+
+            x1 = _mm_xor_si128(fold_128(x0, k128), x1);
+            x2 = _mm_xor_si128(fold_128(x1, k128), x2);
+            x3 = _mm_xor_si128(fold_128(x2, k128), x3);
+
+            return crc64_nvme_finish(x3, _data, _length);
+        }
+
+        __attribute__((target("vpclmulqdq,pclmul,avx2")))
+        inline __m256i fold_256(__m256i _block, __m256i _constants)
+        {
+            return _mm256_xor_si256(_mm256_clmulepi64_epi128(_block, _constants, 0x00),
+                                    _mm256_clmulepi64_epi128(_block, _constants, 0x11));
+        }
+
+        __attribute__((target("vpclmulqdq,pclmul,avx2")))
+        inline __m256i load_256(const unsigned char* _data)
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_data));
+        }
+
+        // Same as crc64_nvme_pclmul() with two 128 bit blocks per register
+        __attribute__((target("vpclmulqdq,pclmul,avx2")))
+        std::uint64_t crc64_nvme_vpclmul(std::uint64_t _crc, const unsigned char* _data, std::size_t _length)
+        {
+            if (_length < 256) {
+                return crc64_nvme_pclmul(_crc, _data, _length);
+            }
+
+            const __m256i k256  = _mm256_set_epi64x(fold_by_256.high, fold_by_256.low,
+                                                    fold_by_256.high, fold_by_256.low);
+            const __m256i k1024 = _mm256_set_epi64x(fold_by_1024.high, fold_by_1024.low,
+                                                    fold_by_1024.high, fold_by_1024.low);
+
+            __m256i y0 = _mm256_xor_si256(load_256(_data),
+                    _mm256_set_epi64x(0, 0, 0, static_cast<long long>(~_crc)));
+            __m256i y1 = load_256(_data + 32);
+            __m256i y2 = load_256(_data + 64);
+            __m256i y3 = load_256(_data + 96);
+            _data += 128;
+            _length -= 128;
+
+            while (_length >= 128) {
+                y0 = _mm256_xor_si256(fold_256(y0, k1024), load_256(_data));
+                y1 = _mm256_xor_si256(fold_256(y1, k1024), load_256(_data + 32));
+                y2 = _mm256_xor_si256(fold_256(y2, k1024), load_256(_data + 64));
+                y3 = _mm256_xor_si256(fold_256(y3, k1024), load_256(_data + 96));
+                _data += 128;
+                _length -= 128;
+            }
+
+            y1 = _mm256_xor_si256(fold_256(y0, k256), y1);
+            y2 = _mm256_xor_si256(fold_256(y1, k256), y2);
+            y3 = _mm256_xor_si256(fold_256(y2, k256), y3);
+
+            const __m128i k128 = _mm_set_epi64x(fold_by_128.high, fold_by_128.low);
+            __m128i x = _mm_xor_si128(fold_128(_mm256_castsi256_si128(y3), k128),
+                                      _mm256_extracti128_si256(y3, 1));
+
+            return crc64_nvme_finish(x, _data, _length);
+        }
+#endif // S3_TRANSPORT_CRC64_NVME_CLMUL
+
+        using crc64_nvme_function = std::uint64_t (*)(std::uint64_t, const unsigned char*, std::size_t);
+
+        struct crc64_nvme_dispatch
+        {
+            crc64_nvme_function function;
+            const char*         name;
+        };
+
+        const crc64_nvme_dispatch& get_crc64_nvme_dispatch()
+        {
+            static const crc64_nvme_dispatch dispatch = []() -> crc64_nvme_dispatch {
+#ifdef S3_TRANSPORT_CRC64_NVME_CLMUL
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("vpclmulqdq") && __builtin_cpu_supports("avx2")) {
+                    return {crc64_nvme_vpclmul, "vpclmulqdq"};
+                }
+                if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse2")) {
+                    return {crc64_nvme_pclmul, "pclmulqdq"};
+                }
+#endif // S3_TRANSPORT_CRC64_NVME_CLMUL
+                return {crc64_nvme_portable, "portable"};
+            }();
+            return dispatch;
+        }
+
+        std::uint64_t gf2_matrix_times(const std::uint64_t* _mat, std::uint64_t _vec)
+        {
+            std::uint64_t sum = 0;
+            while (_vec) {
+                if (_vec & 1) {
+                    sum ^= *_mat;
+                }
+                _vec >>= 1;
+                ++_mat;
+            }
+            return sum;
+        }
+
+        void gf2_matrix_square(std::uint64_t* _square, const std::uint64_t* _mat)
+        {
+            for (int n = 0; n < 64; ++n) {
+                _square[n] = gf2_matrix_times(_mat, _mat[n]);
+            }
+        }
+    } // namespace
+
+    std::uint64_t crc64_nvme_update(std::uint64_t _crc, std::span<const char> _data)
+    {
+        return get_crc64_nvme_dispatch().function(_crc,
+                reinterpret_cast<const unsigned char*>(_data.data()), _data.size());
+    } // end crc64_nvme_update
+
+    std::uint64_t crc64_nvme_update_portable(std::uint64_t _crc, std::span<const char> _data)
+    {
+        return crc64_nvme_portable(_crc, reinterpret_cast<const unsigned char*>(_data.data()), _data.size());
+    } // end crc64_nvme_update_portable
+
+    const char* crc64_nvme_implementation()
+    {
+        return get_crc64_nvme_dispatch().name;
+    } // end crc64_nvme_implementation
+
+    // This is the zlib crc32_combine() algorithm applied to the 64 bit polynomial.  The operator
+    // that appends a single zero bit to the CRC is squared repeatedly to append _len2 zero bytes
+    // to _crc1, which is then xor'ed with _crc2.
+    std::uint64_t crc64_nvme_combine(std::uint64_t _crc1, std::uint64_t _crc2, std::uint64_t _len2)
+    {
+        if (_len2 == 0) {
+            return _crc1;
+        }
+
+        std::uint64_t even[64];    // even-power-of-two zeros operator
+        std::uint64_t odd[64];     // odd-power-of-two zeros operator
+
+        // put operator for one zero bit in odd
+        odd[0] = crc64_nvme_polynomial;
+        std::uint64_t row = 1;
+        for (int n = 1; n < 64; ++n) {
+            odd[n] = row;
+            row <<= 1;
+        }
+
+        // put operator for two zero bits in even, then four zero bits in odd
+        gf2_matrix_square(even, odd);
+        gf2_matrix_square(odd, even);
+
+        // apply len2 zeros to crc1 (first square will put the operator for one
+        // zero byte, eight zero bits, in even)
+        do {
+            gf2_matrix_square(even, odd);
+            if (_len2 & 1) {
+                _crc1 = gf2_matrix_times(even, _crc1);
+            }
+            _len2 >>= 1;
+
+            if (_len2 == 0) {
+                break;
+            }
+
+            gf2_matrix_square(odd, even);
+            if (_len2 & 1) {
+                _crc1 = gf2_matrix_times(odd, _crc1);
+            }
+            _len2 >>= 1;
+        } while (_len2 != 0);
+
+        return _crc1 ^ _crc2;
+    } // end crc64_nvme_combine
+} // namespace irods::experimental::io::s3_transport
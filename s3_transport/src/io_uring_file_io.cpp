@@ -0,0 +1,564 @@
+// A minimal io_uring driver using the raw system calls so that liburing is not required.  See
+// io_uring_setup(2) and io_uring_enter(2) for the ring layout used here.
+
+#include "irods/private/s3_transport/io_uring_file_io.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#  define S3_TRANSPORT_IO_URING
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#endif
+
+namespace irods::experimental::io::s3_transport
+{
+    namespace
+    {
+        // pwrite all of _length bytes, false on error
+        auto write_all(int _fd, std::int64_t _offset, const char* _data, std::size_t _length) -> bool
+        {
+            while (_length > 0) {
+                const ssize_t n = ::pwrite(_fd, _data, _length, _offset);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+                _data += n;
+                _offset += n;
+                _length -= n;
+            }
+            return true;
+        }
+
+        // pread up to _length bytes, only short at the end of the file, -1 on error
+        auto read_all(int _fd, std::int64_t _offset, char* _data, std::size_t _length) -> std::int64_t
+        {
+            std::int64_t total = 0;
+            while (static_cast<std::size_t>(total) < _length) {
+                const ssize_t n = ::pread(_fd, _data + total, _length - total, _offset + total);
+                if (n < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return -1;
+                }
+                if (n == 0) {
+                    break;
+                }
+                total += n;
+            }
+            return total;
+        }
+
+#ifdef S3_TRANSPORT_IO_URING
+        auto sys_io_uring_setup(unsigned int _entries, io_uring_params* _params) -> int
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_setup, _entries, _params));
+        }
+
+        auto sys_io_uring_enter(int _fd, unsigned int _to_submit, unsigned int _min_complete, unsigned int _flags) -> int
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, _fd, _to_submit, _min_complete, _flags, nullptr, 0));
+        }
+
+        auto sys_io_uring_register(int _fd, unsigned int _opcode, const void* _arg, unsigned int _nr_args) -> int
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_register, _fd, _opcode, _arg, _nr_args));
+        }
+
+        auto load_acquire(const unsigned int* _p) -> unsigned int
+        {
+            return std::atomic_ref<const unsigned int>{*_p}.load(std::memory_order_acquire);
+        }
+
+        void store_release(unsigned int* _p, unsigned int _value)
+        {
+            std::atomic_ref<unsigned int>{*_p}.store(_value, std::memory_order_release);
+        }
+#endif // S3_TRANSPORT_IO_URING
+    } // namespace
+
+    auto io_uring_file_io::is_supported() noexcept -> bool
+    {
+#ifdef S3_TRANSPORT_IO_URING
+        // Kernels before 5.1, seccomp filters, and kernel.io_uring_disabled all make this fail.
+        static const bool supported = [] {
+            io_uring_params params{};
+            const int fd = sys_io_uring_setup(1, &params);
+            if (fd < 0) {
+                return false;
+            }
+            ::close(fd);
+            return true;
+        }();
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    auto io_uring_file_io::create() -> std::unique_ptr<io_uring_file_io>
+    {
+        auto ring = std::make_unique<io_uring_file_io>();
+        if (!ring->is_open()) {
+            return nullptr;
+        }
+        return ring;
+    }
+
+    io_uring_file_io::io_uring_file_io(unsigned int _queue_depth, std::size_t _buffer_size)
+        : buffer_size_{_buffer_size}
+    {
+        if (_queue_depth == 0 || _buffer_size == 0 || !is_supported()) {
+            return;
+        }
+
+        if (!setup(_queue_depth)) {
+            teardown();
+        }
+    }
+
+    io_uring_file_io::~io_uring_file_io()
+    {
+        if (is_open()) {
+            // the kernel may still be using the buffers
+            while (in_flight_ > 0 && wait_for_completion()) {}
+
+            if (in_flight_ > 0) {
+                abandon_buffers();
+            }
+        }
+        teardown();
+    }
+
+    auto io_uring_file_io::setup(unsigned int _queue_depth) -> bool
+    {
+#ifdef S3_TRANSPORT_IO_URING
+        io_uring_params params{};
+        ring_fd_ = sys_io_uring_setup(_queue_depth, &params);
+        if (ring_fd_ < 0) {
+            ring_fd_ = -1;
+            return false;
+        }
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED) {
+            sq_ring_ = nullptr;
+            return false;
+        }
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            cq_ring_ = sq_ring_;
+        }
+        else {
+            cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring_fd_, IORING_OFF_CQ_RING);
+            if (cq_ring_ == MAP_FAILED) {
+                cq_ring_ = nullptr;
+                return false;
+            }
+        }
+
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<char*>(sq_ring_);
+        sq_head_  = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+        sq_tail_  = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+        sq_mask_  = reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+
+        auto* cq = static_cast<char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+        cqes_    = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // one buffer per submission queue entry so a free buffer always has a free entry
+        const unsigned int number_of_slots = params.sq_entries;
+        buffer_size_ = (buffer_size_ + 4095) / 4096 * 4096;
+        buffers_ = static_cast<char*>(std::aligned_alloc(4096, buffer_size_ * number_of_slots));
+        if (!buffers_) {
+            return false;
+        }
+
+        slots_.resize(number_of_slots);
+        iovecs_.reset(new iovec[number_of_slots]);
+        for (unsigned int i = 0; i < number_of_slots; ++i) {
+            slots_[i].data = buffers_ + i * buffer_size_;
+            iovecs_[i] = {slots_[i].data, buffer_size_};
+        }
+
+        // Registered buffers save pinning the pages on every request.  This fails where the
+        // locked memory limit is low, in which case the buffers are passed with each request.
+        buffers_registered_ = sys_io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS,
+                iovecs_.get(), number_of_slots) == 0;
+
+        return true;
+#else
+        (void) _queue_depth;
+        return false;
+#endif
+    }
+
+    void io_uring_file_io::teardown() noexcept
+    {
+#ifdef S3_TRANSPORT_IO_URING
+        if (sqes_) {
+            ::munmap(sqes_, sqes_size_);
+        }
+        if (cq_ring_ && cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_ring_size_);
+        }
+        if (sq_ring_) {
+            ::munmap(sq_ring_, sq_ring_size_);
+        }
+#endif
+        sqes_ = nullptr;
+        cq_ring_ = sq_ring_ = nullptr;
+
+        if (ring_fd_ != -1) {
+            ::close(ring_fd_);
+            ring_fd_ = -1;
+        }
+
+        std::free(buffers_);
+        buffers_ = nullptr;
+        slots_.clear();
+        iovecs_.reset();
+        read_ahead_.clear();
+        in_flight_ = 0;
+        staging_slot_ = -1;
+    }
+
+    void io_uring_file_io::abandon_buffers() noexcept
+    {
+        // Waiting for the ring failed with requests still in flight.  Closing the ring does not
+        // wait for them either, so the kernel may still write to the buffers (or read the iovecs)
+        // after this object is gone.  Leave them allocated rather than hand the memory back.
+        buffers_ = nullptr;
+        static_cast<void>(iovecs_.release());
+    }
+
+    auto io_uring_file_io::acquire_slot() -> int
+    {
+        while (true) {
+            for (std::size_t i = 0; i < slots_.size(); ++i) {
+                if (slots_[i].state == slot_state::free) {
+                    slots_[i].offset = 0;
+                    slots_[i].length = 0;
+                    slots_[i].result = 0;
+                    slots_[i].consumed = 0;
+                    return static_cast<int>(i);
+                }
+            }
+            if (in_flight_ == 0 || !wait_for_completion()) {
+                return -1;
+            }
+        }
+    }
+
+    void io_uring_file_io::submit(int _slot)
+    {
+#ifdef S3_TRANSPORT_IO_URING
+        slot& s = slots_[_slot];
+
+        const unsigned int tail = *sq_tail_;
+        const unsigned int index = tail & *sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+
+        if (buffers_registered_) {
+            sqe.opcode = s.is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+            sqe.addr = reinterpret_cast<std::uint64_t>(s.data);
+            sqe.len = static_cast<std::uint32_t>(s.length);
+            sqe.buf_index = static_cast<std::uint16_t>(_slot);
+        }
+        else {
+            // the iovec must stay valid until the request completes
+            iovecs_[_slot].iov_len = s.length;
+            sqe.opcode = s.is_write ? IORING_OP_WRITEV : IORING_OP_READV;
+            sqe.addr = reinterpret_cast<std::uint64_t>(&iovecs_[_slot]);
+            sqe.len = 1;
+        }
+        sqe.fd = s.fd;
+        sqe.off = static_cast<std::uint64_t>(s.offset);
+        sqe.user_data = static_cast<std::uint64_t>(_slot);
+
+        sq_array_[index] = index;
+        store_release(sq_tail_, tail + 1);
+
+        s.state = slot_state::in_flight;
+        ++in_flight_;
+
+        int rc;
+        do {
+            rc = sys_io_uring_enter(ring_fd_, 1, 0, 0);
+        } while (rc < 0 && errno == EINTR);
+
+        if (rc < 0) {
+            // The kernel did not take the entry.  Take it back and do the I/O here.
+            store_release(sq_tail_, tail);
+            --in_flight_;
+            if (s.is_write) {
+                s.result = write_all(s.fd, s.offset, s.data, s.length) ? static_cast<std::int64_t>(s.length) : -errno;
+                s.state = slot_state::complete;
+                complete_write(s);
+            }
+            else {
+                s.result = read_all(s.fd, s.offset, s.data, s.length);
+                if (s.result < 0) {
+                    s.result = -errno;
+                }
+                s.state = slot_state::complete;
+            }
+        }
+#else
+        (void) _slot;
+#endif
+    }
+
+    void io_uring_file_io::submit_staged()
+    {
+        if (staging_slot_ == -1) {
+            return;
+        }
+        const int s = staging_slot_;
+        staging_slot_ = -1;
+        if (slots_[s].length == 0) {
+            slots_[s].state = slot_state::free;
+            return;
+        }
+        submit(s);
+    }
+
+    auto io_uring_file_io::wait_for_completion() -> bool
+    {
+#ifdef S3_TRANSPORT_IO_URING
+        if (in_flight_ == 0) {
+            return false;
+        }
+
+        const unsigned int before = in_flight_;
+        reap();
+        while (in_flight_ == before) {
+            const int rc = sys_io_uring_enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+            if (rc < 0 && errno != EINTR) {
+                return false;
+            }
+            reap();
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void io_uring_file_io::reap()
+    {
+#ifdef S3_TRANSPORT_IO_URING
+        unsigned int head = *cq_head_;
+        const unsigned int tail = load_acquire(cq_tail_);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            slot& s = slots_[static_cast<std::size_t>(cqe.user_data)];
+            s.result = cqe.res;
+            s.state = slot_state::complete;
+            --in_flight_;
+            if (s.is_write) {
+                complete_write(s);
+            }
+            ++head;
+        }
+        store_release(cq_head_, head);
+#endif
+    }
+
+    void io_uring_file_io::complete_write(slot& _slot)
+    {
+        if (_slot.result < 0) {
+            write_failed_ = true;
+        }
+        else if (static_cast<std::size_t>(_slot.result) < _slot.length) {
+            // finish a short write here
+            const auto done = static_cast<std::size_t>(_slot.result);
+            if (!write_all(_slot.fd, _slot.offset + done, _slot.data + done, _slot.length - done)) {
+                write_failed_ = true;
+            }
+        }
+        _slot.state = slot_state::free;
+    }
+
+    auto io_uring_file_io::write(int _fd, std::int64_t _offset, const char* _data, std::size_t _length) -> bool
+    {
+        if (!is_open()) {
+            return write_all(_fd, _offset, _data, _length);
+        }
+
+        while (_length > 0) {
+            if (staging_slot_ != -1) {
+                const slot& s = slots_[staging_slot_];
+                if (s.fd != _fd || s.offset + static_cast<std::int64_t>(s.length) != _offset) {
+                    submit_staged();
+                }
+            }
+
+            if (staging_slot_ == -1) {
+                staging_slot_ = acquire_slot();
+                if (staging_slot_ == -1) {
+                    write_failed_ = true;
+                    return false;
+                }
+                slot& s = slots_[staging_slot_];
+                s.fd = _fd;
+                s.offset = _offset;
+                s.is_write = true;
+                s.state = slot_state::staging;
+            }
+
+            slot& s = slots_[staging_slot_];
+            const std::size_t n = std::min(_length, buffer_size_ - s.length);
+            std::memcpy(s.data + s.length, _data, n);
+            s.length += n;
+            _data += n;
+            _offset += static_cast<std::int64_t>(n);
+            _length -= n;
+
+            if (s.length == buffer_size_) {
+                submit_staged();
+            }
+        }
+
+        return !write_failed_;
+    }
+
+    auto io_uring_file_io::wait_for_writes() -> bool
+    {
+        if (is_open()) {
+            submit_staged();
+            while (in_flight_ > 0) {
+                if (!wait_for_completion()) {
+                    write_failed_ = true;
+                    break;
+                }
+            }
+        }
+
+        const bool ok = !write_failed_;
+        write_failed_ = false;
+        return ok;
+    }
+
+    void io_uring_file_io::discard_read_ahead()
+    {
+        for (int i : read_ahead_) {
+            while (slots_[i].state == slot_state::in_flight && wait_for_completion()) {}
+
+            // a slot still in flight is not reused, the kernel may yet read into it
+            if (slots_[i].state != slot_state::in_flight) {
+                slots_[i].state = slot_state::free;
+            }
+        }
+        read_ahead_.clear();
+    }
+
+    auto io_uring_file_io::read(int _fd, std::int64_t _offset, char* _buffer, std::size_t _length, std::int64_t _end) -> std::int64_t
+    {
+        if (!is_open()) {
+            return read_all(_fd, _offset, _buffer, _length);
+        }
+
+        if (!read_ahead_.empty()) {
+            const slot& head = slots_[read_ahead_.front()];
+            if (read_fd_ != _fd || head.offset + static_cast<std::int64_t>(head.consumed) != _offset) {
+                discard_read_ahead();
+            }
+        }
+
+        if (read_ahead_.empty()) {
+            read_fd_ = _fd;
+            next_read_offset_ = _offset;
+        }
+
+        // keep every free buffer reading ahead
+        while (next_read_offset_ < _end) {
+            auto it = std::find_if(slots_.begin(), slots_.end(),
+                    [](const slot& s) { return s.state == slot_state::free; });
+            if (it == slots_.end()) {
+                break;
+            }
+            const int i = static_cast<int>(it - slots_.begin());
+            slot& s = slots_[i];
+            s.fd = _fd;
+            s.offset = next_read_offset_;
+            s.length = static_cast<std::size_t>(std::min<std::int64_t>(buffer_size_, _end - next_read_offset_));
+            s.result = 0;
+            s.consumed = 0;
+            s.is_write = false;
+            read_ahead_.push_back(i);
+            next_read_offset_ += static_cast<std::int64_t>(s.length);
+            submit(i);
+        }
+
+        // nothing to read ahead, _offset is at or past _end
+        if (read_ahead_.empty()) {
+            return read_all(_fd, _offset, _buffer, _length);
+        }
+
+        const int i = read_ahead_.front();
+        slot& s = slots_[i];
+        while (s.state == slot_state::in_flight) {
+            if (!wait_for_completion()) {
+                discard_read_ahead();
+                return -1;
+            }
+        }
+
+        if (s.result < 0) {
+            errno = static_cast<int>(-s.result);
+            discard_read_ahead();
+            return -1;
+        }
+
+        const auto available = static_cast<std::size_t>(s.result) - s.consumed;
+        const std::size_t n = std::min(_length, available);
+        std::memcpy(_buffer, s.data + s.consumed, n);
+        s.consumed += n;
+
+        if (s.consumed == static_cast<std::size_t>(s.result)) {
+            if (static_cast<std::size_t>(s.result) < s.length) {
+                // end of file or a short read, the read ahead after it is not contiguous
+                discard_read_ahead();
+            }
+            else {
+                s.state = slot_state::free;
+                read_ahead_.pop_front();
+            }
+        }
+
+        return static_cast<std::int64_t>(n);
+    }
+} // namespace irods::experimental::io::s3_transport
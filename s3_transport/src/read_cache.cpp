@@ -0,0 +1,288 @@
+#include "irods/private/s3_transport/read_cache.hpp"
+#include "irods/private/s3_transport/logging_category.hpp"
+
+#include <fmt/format.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace irods::experimental::io::s3_transport
+{
+    namespace
+    {
+        namespace log = irods::experimental::log;
+        using logger = log::logger<s3_transport_logging_category>;
+
+        const std::string READ_CACHE_SHMEM_KEY_PREFIX{"irods_s3-read-cache-"};
+        constexpr time_t READ_CACHE_SHMEM_TIMEOUT_IN_SECONDS{30*24*60*60};
+        constexpr std::uint64_t READ_CACHE_SHMEM_SIZE{100*sizeof(void*) + sizeof(read_cache_index)};
+        constexpr time_t STATISTICS_EXPORT_INTERVAL_IN_SECONDS{60};
+        const char* const STATISTICS_FILE_NAME{"statistics.json"};
+
+        // 64 bit FNV-1a, stable between processes and builds unlike std::hash
+        auto fnv1a(std::uint64_t _hash, const std::string& _s) -> std::uint64_t
+        {
+            for (unsigned char c : _s) {
+                _hash ^= c;
+                _hash *= 0x100000001b3ULL;
+            }
+            // separate the fields so ("ab", "c") and ("a", "bc") differ
+            _hash ^= 0xff;
+            _hash *= 0x100000001b3ULL;
+            return _hash;
+        }
+
+        constexpr std::uint64_t FNV1A_OFFSET_BASIS{0xcbf29ce484222325ULL};
+    } // namespace
+
+    read_cache::read_cache(const std::string& _cache_directory, std::int64_t _maximum_size)
+        : directory_{(boost::filesystem::path(_cache_directory) / "read_cache").string()}
+        , maximum_number_of_blocks_{std::min<std::uint64_t>(read_cache_index::MAXIMUM_NUMBER_OF_BLOCKS,
+                std::max<std::int64_t>(_maximum_size / BLOCK_SIZE, 1))}
+        , maximum_bytes_{static_cast<std::uint64_t>(std::max<std::int64_t>(_maximum_size, BLOCK_SIZE))}
+        , shm_obj_{}
+    {
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(directory_, ec);
+        if (ec) {
+            logger::error("{}:{} ({}) could not create read cache directory {}: {}",
+                    __FILE__, __LINE__, __func__, directory_, ec.message());
+        }
+
+        shm_obj_ = std::make_unique<named_shared_memory_object>(
+                READ_CACHE_SHMEM_KEY_PREFIX + std::to_string(fnv1a(FNV1A_OFFSET_BASIS, directory_)),
+                READ_CACHE_SHMEM_TIMEOUT_IN_SECONDS,
+                READ_CACHE_SHMEM_SIZE);
+
+        shm_obj_->atomic_exec([this](auto& index) {
+            if (!index.loaded) {
+                load(index);
+                index.loaded = true;
+            }
+        });
+    }
+
+    read_cache::~read_cache() = default;
+
+    auto read_cache::make_object_id(const std::string& _bucket, const std::string& _key) -> std::uint64_t
+    {
+        return fnv1a(fnv1a(FNV1A_OFFSET_BASIS, _bucket), _key);
+    }
+
+    auto read_cache::make_version_id(const std::string& _etag, std::int64_t _size, std::int64_t _last_modified) -> std::uint64_t
+    {
+        return fnv1a(fnv1a(fnv1a(FNV1A_OFFSET_BASIS, _etag), std::to_string(_size)), std::to_string(_last_modified));
+    }
+
+    auto read_cache::block_path(std::uint64_t _object_id, std::uint64_t _version_id, std::uint64_t _block) const -> std::string
+    {
+        return fmt::format("{}/{:016x}-{:016x}-{:x}", directory_, _object_id, _version_id, _block);
+    }
+
+    // Index the blocks left in the directory by earlier agents, for example before a restart.
+    // Anything else in the directory is a partly written block and is removed.
+    void read_cache::load(read_cache_index& _index)
+    {
+        namespace bf = boost::filesystem;
+
+        boost::system::error_code ec;
+        for (bf::directory_iterator it{directory_, ec}, end; !ec && it != end; it.increment(ec)) {
+            const std::string name = it->path().filename().string();
+            if (name == STATISTICS_FILE_NAME) {
+                continue;
+            }
+
+            std::uint64_t object_id = 0;
+            std::uint64_t version_id = 0;
+            std::uint64_t block = 0;
+            int consumed = 0;
+            boost::system::error_code size_ec;
+            const auto size = bf::file_size(it->path(), size_ec);
+
+            const bool is_block = std::sscanf(name.c_str(), "%16" SCNx64 "-%16" SCNx64 "-%" SCNx64 "%n",
+                        &object_id, &version_id, &block, &consumed) == 3 &&
+                    static_cast<std::size_t>(consumed) == name.size() &&
+                    !size_ec && size > 0 && size <= static_cast<std::uintmax_t>(BLOCK_SIZE);
+
+            if (!is_block || _index.find(object_id, version_id, block)) {
+                bf::remove(it->path(), size_ec);
+                continue;
+            }
+
+            make_room(_index, size);
+            _index.insert(object_id, version_id, block, static_cast<std::uint32_t>(size));
+        }
+    }
+
+    void read_cache::remove_block(read_cache_index& _index, read_cache_index::slot& _slot)
+    {
+        ::unlink(block_path(_slot.object_id, _slot.version_id, _slot.block).c_str());
+        _index.erase(_slot);
+    }
+
+    void read_cache::make_room(read_cache_index& _index, std::uint64_t _length)
+    {
+        while (_index.number_used > 0 &&
+                (_index.number_used >= maximum_number_of_blocks_ || _index.bytes_used + _length > maximum_bytes_)) {
+            remove_block(_index, *_index.least_recently_used());
+            ++_index.evictions;
+        }
+    }
+
+    auto read_cache::read(std::uint64_t _object_id, std::uint64_t _version_id, std::uint64_t _block,
+                          std::int64_t _offset, char* _buffer, std::int64_t _length) -> std::int64_t
+    {
+        const bool found = shm_obj_->atomic_exec([&](auto& index) {
+            auto* slot = index.find(_object_id, _version_id, _block);
+            if (!slot || _offset + _length > static_cast<std::int64_t>(slot->length)) {
+                ++index.misses;
+                return false;
+            }
+            index.touch(*slot);
+            ++index.hits;
+            return true;
+        });
+
+        if (!found) {
+            return -1;
+        }
+
+        // The block may be evicted by another agent from here on.  A block file that has been
+        // opened can still be read after it is removed.
+        const int fd = ::open(block_path(_object_id, _version_id, _block).c_str(), O_RDONLY | O_CLOEXEC);
+        std::int64_t total = 0;
+        if (fd != -1) {
+            while (total < _length) {
+                const ssize_t n = ::pread(fd, _buffer + total, _length - total, _offset + total);
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    break;
+                }
+                total += n;
+            }
+            ::close(fd);
+        }
+
+        if (total == _length) {
+            return total;
+        }
+
+        // count it as a miss and drop the entry if it is still there
+        shm_obj_->atomic_exec([&](auto& index) {
+            --index.hits;
+            ++index.misses;
+            if (auto* slot = index.find(_object_id, _version_id, _block)) {
+                remove_block(index, *slot);
+            }
+        });
+        return -1;
+    }
+
+    void read_cache::store(std::uint64_t _object_id, std::uint64_t _version_id, std::uint64_t _block,
+                           const char* _data, std::int64_t _length)
+    {
+        if (_length <= 0 || _length > BLOCK_SIZE) {
+            return;
+        }
+
+        // Write the block to a temporary file and rename it so that a block file is always
+        // complete.  Agents that store the same block at the same time write the same bytes.
+        const std::string path = block_path(_object_id, _version_id, _block);
+        const std::string temporary_path = fmt::format("{}.{}.{}.tmp", path, ::getpid(),
+                std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        const int fd = ::open(temporary_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd == -1) {
+            logger::debug("{}:{} ({}) could not create read cache block {}", __FILE__, __LINE__, __func__, temporary_path);
+            return;
+        }
+
+        std::int64_t total = 0;
+        while (total < _length) {
+            const ssize_t n = ::write(fd, _data + total, _length - total);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            total += n;
+        }
+        const bool written = ::close(fd) == 0 && total == _length;
+
+        if (!written || ::rename(temporary_path.c_str(), path.c_str()) != 0) {
+            logger::debug("{}:{} ({}) could not write read cache block {}", __FILE__, __LINE__, __func__, path);
+            ::unlink(temporary_path.c_str());
+            return;
+        }
+
+        shm_obj_->atomic_exec([&](auto& index) {
+            if (index.find(_object_id, _version_id, _block)) {
+                return;
+            }
+            make_room(index, _length);
+            index.insert(_object_id, _version_id, _block, static_cast<std::uint32_t>(_length));
+            ++index.insertions;
+        });
+    }
+
+    void read_cache::invalidate_other_versions(std::uint64_t _object_id, std::uint64_t _version_id)
+    {
+        shm_obj_->atomic_exec([&](auto& index) {
+            for (auto s = index.first_in_bucket(_object_id); s != read_cache_index::NIL; ) {
+                auto& slot = index.slots[s];
+                s = slot.bucket_next;
+                if (slot.object_id == _object_id && slot.version_id != _version_id) {
+                    remove_block(index, slot);
+                }
+            }
+        });
+    }
+
+    auto read_cache::get_statistics() const -> statistics
+    {
+        return shm_obj_->atomic_exec([](auto& index) {
+            return statistics{index.hits, index.misses, index.insertions, index.evictions,
+                index.bytes_used, index.number_used};
+        });
+    }
+
+    void read_cache::export_statistics()
+    {
+        const time_t now = time(nullptr);
+        const bool export_now = shm_obj_->atomic_exec([now](auto& index) {
+            if (now - index.last_statistics_export < STATISTICS_EXPORT_INTERVAL_IN_SECONDS) {
+                return false;
+            }
+            index.last_statistics_export = now;
+            return true;
+        });
+
+        if (!export_now) {
+            return;
+        }
+
+        const auto s = get_statistics();
+        const std::string path = fmt::format("{}/{}", directory_, STATISTICS_FILE_NAME);
+        const std::string temporary_path = fmt::format("{}.{}.tmp", path, ::getpid());
+        if (std::FILE* f = std::fopen(temporary_path.c_str(), "w")) {
+            fmt::print(f, "{{\"time\": {}, \"hits\": {}, \"misses\": {}, \"insertions\": {}, \"evictions\": {}, "
+                          "\"bytes_used\": {}, \"number_of_blocks\": {}, \"maximum_bytes\": {}}}\n",
+                    now, s.hits, s.misses, s.insertions, s.evictions, s.bytes_used, s.number_of_blocks, maximum_bytes_);
+            if (std::fclose(f) == 0 && std::rename(temporary_path.c_str(), path.c_str()) == 0) {
+                return;
+            }
+        }
+        std::remove(temporary_path.c_str());
+    }
+} // namespace irods::experimental::io::s3_transport
@@ -0,0 +1,131 @@
+#include "irods/private/s3_transport/read_page_cache.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+namespace irods::experimental::io::s3_transport
+{
+    read_page_cache::read_page_cache(std::int64_t _page_size, std::int64_t _merge_distance, std::int64_t _object_size)
+        : page_size_{std::max<std::int64_t>(_page_size, 1)}
+        , merge_distance_{std::max<std::int64_t>(_merge_distance, 0)}
+        , object_size_{_object_size}
+        , last_miss_position_{-1}
+        , statistics_{}
+        , pages_{}
+        , page_map_{}
+        , fetch_buffer_{}
+    {
+    }
+
+    auto read_page_cache::read(std::int64_t _offset, char* _buffer, std::int64_t _length, const fetch_function& _fetch) -> std::int64_t
+    {
+        if (_offset < 0 || _length < 0) {
+            return -1;
+        }
+
+        std::int64_t bytes_copied = 0;
+
+        while (bytes_copied < _length && _offset + bytes_copied < object_size_) {
+            const std::int64_t position = _offset + bytes_copied;
+            const std::int64_t page_number = position / page_size_;
+
+            page* p = find(page_number);
+            if (p) {
+                ++statistics_.hits;
+            } else {
+                ++statistics_.misses;
+                if (!fetch(position, _length - bytes_copied, _fetch)) {
+                    return bytes_copied > 0 ? bytes_copied : -1;
+                }
+                p = find(page_number);
+            }
+
+            const std::int64_t offset_in_page = position - page_number * page_size_;
+            const std::int64_t bytes = std::min(_length - bytes_copied,
+                    static_cast<std::int64_t>(p->data.size()) - offset_in_page);
+            if (bytes <= 0) {
+                break;
+            }
+
+            std::memcpy(_buffer + bytes_copied, p->data.data() + offset_in_page, bytes);
+            bytes_copied += bytes;
+        }
+
+        return bytes_copied;
+    }
+
+    auto read_page_cache::find(std::int64_t _page_number) -> page*
+    {
+        auto it = page_map_.find(_page_number);
+        if (it == page_map_.end()) {
+            return nullptr;
+        }
+
+        // move to the front
+        pages_.splice(pages_.begin(), pages_, it->second);
+        return &*it->second;
+    }
+
+    auto read_page_cache::fetch(std::int64_t _position, std::int64_t _length, const fetch_function& _fetch) -> bool
+    {
+        std::int64_t end = std::min(_position + _length, object_size_);
+
+        // a miss close to the previous one, read ahead to cover the reads that are likely to follow
+        if (last_miss_position_ >= 0 && std::abs(_position - last_miss_position_) <= merge_distance_) {
+            end = std::max(end, std::min(_position + merge_distance_, object_size_));
+        }
+        last_miss_position_ = _position;
+
+        // leave room in the cache for the pages that are already cached
+        const std::int64_t first_page = _position / page_size_;
+        std::int64_t last_page = (end - 1) / page_size_;
+        last_page = std::min<std::int64_t>(last_page, first_page + MAXIMUM_NUMBER_OF_PAGES / 2 - 1);
+
+        // do not download pages at the end of the range that are already cached
+        while (last_page > first_page && page_map_.count(last_page) > 0) {
+            --last_page;
+        }
+
+        const std::int64_t range_offset = first_page * page_size_;
+        const std::int64_t range_length = std::min((last_page + 1) * page_size_, object_size_) - range_offset;
+
+        fetch_buffer_.resize(range_length);
+        ++statistics_.requests;
+        statistics_.bytes_requested += range_length;
+        if (_fetch(fetch_buffer_.data(), range_offset, range_length) != range_length) {
+            return false;
+        }
+
+        for (std::int64_t page_number = first_page; page_number <= last_page; ++page_number) {
+            const std::int64_t offset_in_range = (page_number - first_page) * page_size_;
+            const std::int64_t bytes = std::min(page_size_, range_length - offset_in_range);
+            auto& p = insert(page_number);
+            p.data.assign(fetch_buffer_.data() + offset_in_range, fetch_buffer_.data() + offset_in_range + bytes);
+        }
+
+        return true;
+    }
+
+    auto read_page_cache::insert(std::int64_t _page_number) -> page&
+    {
+        if (auto* p = find(_page_number)) {
+            return *p;
+        }
+
+        // reuse the least recently used page when full
+        if (pages_.size() >= MAXIMUM_NUMBER_OF_PAGES) {
+            auto last = std::prev(pages_.end());
+            page_map_.erase(last->number);
+            pages_.splice(pages_.begin(), pages_, last);
+        } else {
+            pages_.emplace_front();
+        }
+
+        auto& p = pages_.front();
+        p.number = _page_number;
+        page_map_[_page_number] = pages_.begin();
+        return p;
+    }
+} // namespace irods::experimental::io::s3_transport
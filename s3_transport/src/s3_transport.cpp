@@ -59,6 +59,20 @@ namespace irods::experimental::io::s3_transport
             object_s3_status& object_status,
             std::string& storage_class) {
 
+        std::string etag;
+        time_t last_modified = 0;
+        return get_object_s3_status(object_key, bucket_context, object_size, object_status, storage_class,
+                etag, last_modified);
+    } // end get_object_s3_status
+
+    irods::error get_object_s3_status(const std::string& object_key,
+            libs3_types::bucket_context& bucket_context,
+            std::int64_t& object_size,
+            object_s3_status& object_status,
+            std::string& storage_class,
+            std::string& etag,
+            time_t& last_modified) {
+
         data_for_head_callback data(bucket_context);
 
         S3ResponseHandler head_object_handler = { &s3_head_object_callback::on_response_properties,
@@ -72,6 +86,8 @@ namespace irods::experimental::io::s3_transport
         }
 
         object_size = data.content_length;
+        etag = data.etag;
+        last_modified = data.last_modified;
 
         // Note that GLACIER_IR does not need or accept restoration
         if (boost::iequals(data.x_amz_storage_class, S3_STORAGE_CLASS_GLACIER) ||
@@ -322,6 +338,38 @@ namespace irods::experimental::io::s3_transport
         }
     } // end remove_checksum_prefix
 
+
+    bool decode_crc64_nvme_checksum(const std::string& _checksum_str, std::uint64_t& _crc)
+    {
+        unsigned long out_len = 8;
+        unsigned char bytes[8]{};
+        if (base64_decode(reinterpret_cast<const unsigned char*>(_checksum_str.c_str()),
+                    _checksum_str.size(), bytes, &out_len) < 0 || out_len != 8) {
+            return false;
+        }
+
+        // the bytes are big endian
+        _crc = 0;
+        for (int i = 0; i < 8; ++i) {
+            _crc = (_crc << 8) | bytes[i];
+        }
+        return true;
+    } // end decode_crc64_nvme_checksum
+
+    std::string encode_crc64_nvme_checksum(std::uint64_t _crc)
+    {
+        unsigned char bytes[8];
+        for (int i = 7; i >= 0; --i) {
+            bytes[i] = static_cast<unsigned char>(_crc & 0xFF);
+            _crc >>= 8;
+        }
+
+        unsigned long encoded_len = 16;
+        unsigned char encoded[16]{};
+        base64_encode(bytes, 8, encoded, &encoded_len);
+        return std::string(reinterpret_cast<char*>(encoded), encoded_len);
+    } // end encode_crc64_nvme_checksum
+
     // Returns timestamp in usec for delta-t comparisons
     // std::uint64_t provides plenty of headroom
     std::uint64_t get_time_in_microseconds()
@@ -353,6 +401,10 @@ namespace irods::experimental::io::s3_transport
 
             data_for_head_callback *data = (data_for_head_callback*)callback_data;
             data->content_length = properties->contentLength;
+            data->last_modified = properties->lastModified;
+            if (properties->eTag) {
+                data->etag = properties->eTag;
+            }
 
             // read the headers used by GLACIER
             if (properties->xAmzStorageClass) {
@@ -377,6 +429,25 @@ namespace irods::experimental::io::s3_transport
 
     }
 
+    namespace s3_copy_part_callback
+    {
+        libs3_types::status on_response_properties (const libs3_types::response_properties *properties,
+                                                    void *callback_data)
+        {
+            // the ETag of the part is returned in the response body
+            return libs3_types::status_ok;
+        }
+
+        void on_response_complete (libs3_types::status status,
+                                   const libs3_types::error_details *error,
+                                   void *callback_data)
+        {
+            data_for_copy_part_callback *data = (data_for_copy_part_callback*)callback_data;
+            store_and_log_status( status, error, "s3_copy_part_callback::on_response_complete", data->bucket_context,
+                    data->status );
+        }
+    }
+
     namespace s3_upload
     {
 
@@ -589,6 +660,14 @@ namespace irods::experimental::io::s3_transport
                 // The WorkerThread will note that status!=OK and act appropriately (retry or fail)
             } // end response_completion
 
+            libs3_types::status on_commit_response (const libs3_types::char_type* location,
+                                                    const libs3_types::char_type* etag,
+                                                    void *callback_data)
+            {
+                upload_manager *manager = (upload_manager *)callback_data;
+                manager->etag = etag ? etag : "";
+                return libs3_types::status_ok;
+            } // end on_commit_response
 
         } // end namespace commit_callback
 
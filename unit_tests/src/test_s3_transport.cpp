@@ -2,6 +2,11 @@
 
 #include "irods/private/s3_transport/s3_transport.hpp"
 #include "irods/private/s3_transport/util.hpp"
+#include "irods/private/s3_transport/crc64_nvme.hpp"
+#include "irods/private/s3_transport/cache_file_reader.hpp"
+#include "irods/private/s3_transport/io_uring_file_io.hpp"
+#include "irods/private/s3_transport/read_cache.hpp"
+#include "irods/private/s3_transport/read_page_cache.hpp"
 #include "irods/private/s3_transport/multipart_shared_data.hpp"
 #include "irods/private/s3_transport/logging_category.hpp"
 
@@ -16,6 +21,9 @@
 #include <thread>
 #include <chrono>
 #include <sys/wait.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <stdexcept>
 #include <cstdio>
 #include <chrono>
@@ -24,6 +32,11 @@
 #include <string_view>
 #include <fmt/format.h>
 #include <filesystem>
+#include <span>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <cstring>
 
 // to run the following unit tests, the aws command line utility needs to be available in
 // the path and "aws configure" needs to be run to set up the keys
@@ -401,7 +414,8 @@ void read_write_on_file(const char *hostname,
                         const int thread_count,
                         int thread_number,
                         const char *comparison_filename,
-                        std::ios_base::openmode open_modes)
+                        std::ios_base::openmode open_modes,
+                        bool sparse_cache_file)
 {
 
     fmt::print("{}:{} ({}) [[{}]] [open file for read/write]\n",
@@ -426,6 +440,7 @@ void read_write_on_file(const char *hostname,
     s3_config.region_name = "us-east-1";
     s3_config.cache_directory = ".";
     s3_config.circular_buffer_size = 10*1024*1024;
+    s3_config.sparse_cache_file_enabled = sparse_cache_file;
 
     s3_transport tp1{s3_config};
     dstream ds1{tp1, std::string(object_prefix)+filename, open_modes};
@@ -679,7 +694,8 @@ void do_read_write_thread(const std::string& bucket_name,
                           const std::string& object_prefix,
                           const std::string& keyfile,
                           int thread_count,
-                          std::ios_base::openmode open_modes = std::ios_base::in | std::ios_base::out)
+                          std::ios_base::openmode open_modes = std::ios_base::in | std::ios_base::out,
+                          bool sparse_cache_file = false)
 {
 
     std::string access_key, secret_access_key;
@@ -695,12 +711,12 @@ void do_read_write_thread(const std::string& bucket_name,
 
         irods::thread_pool::post(writer_threads, [bucket_name, access_key,
                 secret_access_key, filename, object_prefix, thread_count, thread_number,
-                comparison_filename, open_modes] () {
+                comparison_filename, open_modes, sparse_cache_file] () {
 
 
             read_write_on_file(hostname.c_str(), bucket_name.c_str(), access_key.c_str(), secret_access_key.c_str(),
                     filename.c_str(), object_prefix.c_str(), thread_count, thread_number, comparison_filename.c_str(),
-                    open_modes);
+                    open_modes, sparse_cache_file);
         });
     }
 
@@ -756,6 +772,267 @@ void test_seek_end(const std::string& bucket_name,
     fmt::print("CLOSE DONE");
 }
 
+void test_existing_object_metadata(const std::string& bucket_name,
+                                   const std::string& filename,
+                                   const std::string& object_prefix,
+                                   const std::string& keyfile)
+{
+
+    std::string access_key, secret_access_key;
+    read_keys(keyfile, access_key, secret_access_key);
+
+    download_stage_and_cleanup(bucket_name, filename, object_prefix);
+
+    std::ifstream in(filename, std::ifstream::binary);
+    std::string contents{std::istreambuf_iterator<char>(in), {}};
+    const auto file_size = static_cast<std::int64_t>(contents.size());
+
+    s3_transport_config s3_config;
+    s3_config.hostname = hostname;
+    s3_config.number_of_cache_transfer_threads = 1;
+    s3_config.number_of_client_transfer_threads = 1;
+    s3_config.bucket_name = bucket_name;
+    s3_config.access_key = access_key;
+    s3_config.secret_access_key = secret_access_key;
+    s3_config.shared_memory_timeout_in_seconds = 20;
+    s3_config.put_repl_flag = true;
+    s3_config.region_name = "us-east-1";
+
+    // the transport takes the size it is given rather than sending a HEAD
+    s3_config.existing_object_size = file_size - 1;
+
+    s3_transport tp{s3_config};
+    dstream ds{tp, std::string(object_prefix)+filename, std::ios_base::in};
+    REQUIRE(ds.is_open());
+
+    ds.seekg(0, std::ios_base::end);
+    CHECK(ds.tellg() == file_size - 1);
+
+    ds.seekg(0);
+    std::string buffer(file_size - 1, '\0');
+    ds.read(buffer.data(), buffer.size());
+    CHECK(buffer == contents.substr(0, file_size - 1));
+
+    ds.close();
+}
+
+void test_receive_ranges(const std::string& bucket_name,
+                         const std::string& filename,
+                         const std::string& object_prefix,
+                         const std::string& keyfile)
+{
+
+    std::string access_key, secret_access_key;
+    read_keys(keyfile, access_key, secret_access_key);
+
+    download_stage_and_cleanup(bucket_name, filename, object_prefix);
+
+    std::ifstream in(filename, std::ifstream::binary);
+    std::string contents{std::istreambuf_iterator<char>(in), {}};
+    const auto file_size = static_cast<std::int64_t>(contents.size());
+    REQUIRE(file_size > 1024 * 1024);
+
+    s3_transport_config s3_config;
+    s3_config.hostname = hostname;
+    s3_config.number_of_cache_transfer_threads = 1;
+    s3_config.number_of_client_transfer_threads = 1;
+    s3_config.bucket_name = bucket_name;
+    s3_config.access_key = access_key;
+    s3_config.secret_access_key = secret_access_key;
+    s3_config.shared_memory_timeout_in_seconds = 20;
+    s3_config.put_repl_flag = true;
+    s3_config.region_name = "us-east-1";
+
+    s3_transport tp{s3_config};
+    dstream ds{tp, std::string(object_prefix)+filename, std::ios_base::in};
+    ds.seekg(100);
+
+    // adjacent, overlapping, far apart, and past the end of the object
+    std::vector<std::pair<std::int64_t, std::int64_t>> offsets_and_lengths{
+        {1000, 500}, {1500, 700}, {1800, 100}, {0, 10}, {file_size - 1024 * 1024, 4096},
+        {file_size - 10, 100}, {file_size + 10, 100}};
+    std::vector<std::string> buffers;
+    std::vector<s3_transport::read_range> ranges;
+    for (const auto& [offset, length] : offsets_and_lengths) {
+        buffers.emplace_back(length, '\0');
+    }
+    for (std::size_t i = 0; i < offsets_and_lengths.size(); ++i) {
+        ranges.push_back({offsets_and_lengths[i].first, offsets_and_lengths[i].second, buffers[i].data(), 0});
+    }
+
+    std::streamsize expected_total = 0;
+    const auto total = tp.receive_ranges(ranges);
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        const auto expected = std::max<std::int64_t>(0, std::min<std::int64_t>(ranges[i].length, file_size - ranges[i].offset));
+        REQUIRE(ranges[i].bytes_read == expected);
+        CHECK(std::memcmp(buffers[i].data(), contents.data() + ranges[i].offset, expected) == 0);
+        expected_total += expected;
+    }
+    CHECK(total == expected_total);
+
+    // the read position is unchanged
+    CHECK(ds.tellg() == 100);
+    char c;
+    ds.read(&c, 1);
+    CHECK(c == contents[100]);
+
+    ds.close();
+}
+
+// Opens an object with a sparse cache file, writes to it, and replaces the object in S3 before
+// closing.  The parts that were not written must not be copied from the replacement.  When
+// append is true the object is opened for append with append_with_copy_enabled instead.
+void test_sparse_cache_file_object_replaced(const std::string& bucket_name,
+                                            const std::string& filename,
+                                            const std::string& object_prefix,
+                                            const std::string& keyfile,
+                                            bool append)
+{
+
+    std::string access_key, secret_access_key;
+    read_keys(keyfile, access_key, secret_access_key);
+
+    download_stage_and_cleanup(bucket_name, filename, object_prefix);
+
+    // the replacement has the same size but different contents
+    std::ifstream in(filename, std::ifstream::binary);
+    std::string contents{std::istreambuf_iterator<char>(in), {}};
+    contents[0] = contents[0] == 'x' ? 'y' : 'x';
+    const auto replacement_filename = fmt::format("{}.replacement", filename);
+    std::ofstream{replacement_filename, std::ofstream::binary} << contents;
+
+    s3_transport_config s3_config;
+    s3_config.hostname = hostname;
+    s3_config.number_of_cache_transfer_threads = 5;
+    s3_config.number_of_client_transfer_threads = 1;
+    s3_config.bucket_name = bucket_name;
+    s3_config.access_key = access_key;
+    s3_config.secret_access_key = secret_access_key;
+    s3_config.shared_memory_timeout_in_seconds = 20;
+    s3_config.put_repl_flag = false;
+    s3_config.region_name = "us-east-1";
+    s3_config.cache_directory = ".";
+    s3_config.sparse_cache_file_enabled = !append;
+    s3_config.append_with_copy_enabled = append;
+
+    const auto open_modes = append
+        ? std::ios_base::in | std::ios_base::out | std::ios_base::app
+        : std::ios_base::in | std::ios_base::out;
+
+    s3_transport tp{s3_config};
+    dstream ds{tp, std::string(object_prefix)+filename, open_modes};
+    REQUIRE(ds.is_open());
+
+    if (!append) {
+        ds.seekp(10);
+    }
+    ds.write("xxx", 3);
+
+    const auto aws_cp_command = fmt::format("aws --endpoint-url http://{} s3 cp {} s3://{}/{}{}",
+            hostname, replacement_filename, bucket_name, object_prefix, filename);
+    fmt::print("{}\n", aws_cp_command);
+    std::system(aws_cp_command.c_str());
+    remove(replacement_filename.c_str());
+
+    ds.close();
+
+    CHECK(!tp.get_error().ok());
+}
+
+// Writes number_of_objects objects of object_size bytes, each through its own s3_transport as
+// a single threaded full upload would.
+void upload_small_objects(const std::string& bucket_name,
+                            const std::string& object_prefix,
+                            const std::string& keyfile,
+                            int number_of_objects,
+                            std::int64_t object_size,
+                            std::int64_t small_object_upload_size_limit,
+                            bool expected_small_object_flag)
+{
+    std::string access_key, secret_access_key;
+    read_keys(keyfile, access_key, secret_access_key);
+
+    std::vector<char> buffer(object_size, 'x');
+
+    for (int i = 0; i < number_of_objects; ++i) {
+        s3_transport_config s3_config;
+        s3_config.hostname = hostname;
+        s3_config.object_size = object_size;
+        s3_config.number_of_cache_transfer_threads = 1;
+        s3_config.number_of_client_transfer_threads = 1;
+        s3_config.bytes_this_thread = object_size;
+        s3_config.bucket_name = bucket_name;
+        s3_config.access_key = access_key;
+        s3_config.secret_access_key = secret_access_key;
+        s3_config.shared_memory_timeout_in_seconds = 20;
+        s3_config.put_repl_flag = true;
+        s3_config.region_name = "us-east-1";
+        s3_config.small_object_upload_size_limit = small_object_upload_size_limit;
+
+        s3_transport tp{s3_config};
+        dstream ds{tp, fmt::format("{}small_object_{}", object_prefix, i), std::ios_base::out | std::ios_base::trunc};
+
+        REQUIRE(ds.is_open());
+        REQUIRE(tp.get_use_cache() == false);
+        REQUIRE(tp.get_use_small_object_buffer() == expected_small_object_flag);
+
+        ds.write(buffer.data(), buffer.size());
+        ds.close();
+
+        REQUIRE(tp.get_error().ok());
+    }
+}
+
+// Writes an object with a single thread while computing the checksum with _scheme and
+// returns the transport's upload checksum.
+std::string upload_with_checksum(const std::string& bucket_name,
+                                 const std::string& object_key,
+                                 const std::string& keyfile,
+                                 const std::vector<char>& buffer,
+                                 const std::string& scheme,
+                                 std::int64_t small_object_upload_size_limit,
+                                 bool expected_in_object_metadata,
+                                 std::string* etag = nullptr)
+{
+    std::string access_key, secret_access_key;
+    read_keys(keyfile, access_key, secret_access_key);
+
+    s3_transport_config s3_config;
+    s3_config.hostname = hostname;
+    s3_config.object_size = buffer.size();
+    s3_config.number_of_cache_transfer_threads = 1;
+    s3_config.number_of_client_transfer_threads = 1;
+    s3_config.bytes_this_thread = buffer.size();
+    s3_config.bucket_name = bucket_name;
+    s3_config.access_key = access_key;
+    s3_config.secret_access_key = secret_access_key;
+    s3_config.shared_memory_timeout_in_seconds = 20;
+    s3_config.put_repl_flag = true;
+    s3_config.region_name = "us-east-1";
+    s3_config.small_object_upload_size_limit = small_object_upload_size_limit;
+    s3_config.upload_checksum_scheme = scheme;
+
+    s3_transport tp{s3_config};
+    dstream ds{tp, object_key, std::ios_base::out | std::ios_base::trunc};
+    REQUIRE(ds.is_open());
+
+    // write in pieces so the hash is updated more than once
+    const std::size_t piece_size = 1024*1024;
+    for (std::size_t offset = 0; offset < buffer.size(); offset += piece_size) {
+        ds.write(buffer.data() + offset, std::min(piece_size, buffer.size() - offset));
+    }
+    ds.close();
+
+    REQUIRE(tp.get_error().ok());
+    REQUIRE(tp.is_upload_checksum_in_object_metadata() == expected_in_object_metadata);
+
+    if (etag) {
+        *etag = tp.get_upload_etag();
+    }
+
+    return tp.get_upload_checksum();
+}
+
 TEST_CASE("quick test upload", "[quick_test][quick_test_upload]")
 {
 
@@ -901,6 +1178,698 @@ TEST_CASE("s3_transport_single_part", "[thread][upload][single_part]")
 }
 
 
+TEST_CASE("s3_transport_small_object_upload", "[thread][upload][small_object]")
+{
+    namespace bi = boost::interprocess;
+    using constants = irods::experimental::io::s3_transport::constants;
+
+    std::string bucket_name = create_bucket();
+    std::string object_prefix = "dir1/dir2/";
+    std::int64_t object_size = 4096;
+
+    SECTION("small object is uploaded without shared memory")
+    {
+        upload_small_objects(bucket_name, object_prefix, keyfile, 1, object_size, 1024*1024, true);
+
+        // the object was written with a single PUT
+        const auto object_key = fmt::format("{}small_object_0", object_prefix);
+        const auto downloaded_file_name = std::string{"small_object_0.downloaded"};
+        const auto aws_cp_command = fmt::format("aws --endpoint-url http://{} s3 cp s3://{}/{} {}",
+                hostname, bucket_name, object_key, downloaded_file_name);
+        fmt::print("{}\n", aws_cp_command);
+        REQUIRE(0 == std::system(aws_cp_command.c_str()));
+        REQUIRE(std::filesystem::file_size(downloaded_file_name) == static_cast<std::uintmax_t>(object_size));
+        remove(downloaded_file_name.c_str());
+
+        // and no shared memory was created for it
+        const std::string shmem_key = constants::SHARED_MEMORY_KEY_PREFIX +
+                std::to_string(std::hash<std::string>{}("/" + object_key));
+        REQUIRE_THROWS_AS((bi::shared_memory_object{bi::open_only, shmem_key.c_str(), bi::read_only}),
+                bi::interprocess_exception);
+    }
+
+    SECTION("object larger than the limit is streamed")
+    {
+        upload_small_objects(bucket_name, object_prefix, keyfile, 1, object_size, object_size - 1, false);
+    }
+
+    remove_bucket(bucket_name);
+}
+
+TEST_CASE("s3_transport_upload_checksum", "[upload][upload_checksum]")
+{
+    std::string bucket_name = create_bucket();
+    std::string object_prefix = "upload_checksum/";
+
+    std::vector<char> buffer(12*1024*1024);
+    for (std::size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = static_cast<char>(i * 7 + i / 4096);
+    }
+
+    irods::Hasher hasher;
+    REQUIRE(irods::getHasher("sha256", hasher).ok());
+    hasher.update(std::string(buffer.data(), buffer.size()));
+    std::string expected_checksum;
+    hasher.digest(expected_checksum);
+
+    SECTION("streamed upload")
+    {
+        // the checksum is only known after the upload so it is not in the metadata
+        std::string etag;
+        auto checksum = upload_with_checksum(bucket_name, object_prefix + "streamed", keyfile,
+                buffer, "sha256", 0, false, &etag);
+        REQUIRE(checksum == expected_checksum);
+
+        // the self-copy that saves the checksum later is conditional on this ETag
+        REQUIRE(!etag.empty());
+        std::erase(etag, '"');
+        const auto aws_head_command = fmt::format("aws --endpoint-url http://{} s3api head-object --bucket {} --key {}streamed "
+                "| grep -qF '{}'", hostname, bucket_name, object_prefix, etag);
+        fmt::print("{}\n", aws_head_command);
+        REQUIRE(0 == std::system(aws_head_command.c_str()));
+    }
+
+    SECTION("small object upload")
+    {
+        auto checksum = upload_with_checksum(bucket_name, object_prefix + "small", keyfile,
+                buffer, "sha256", buffer.size(), true);
+        REQUIRE(checksum == expected_checksum);
+
+        const auto aws_head_command = fmt::format("aws --endpoint-url http://{} s3api head-object --bucket {} --key {}small "
+                "| grep -q '{}'", hostname, bucket_name, object_prefix, expected_checksum);
+        fmt::print("{}\n", aws_head_command);
+        REQUIRE(0 == std::system(aws_head_command.c_str()));
+    }
+
+    SECTION("checksum not requested")
+    {
+        auto checksum = upload_with_checksum(bucket_name, object_prefix + "none", keyfile,
+                buffer, "", 0, false);
+        REQUIRE(checksum.empty());
+    }
+
+    remove_bucket(bucket_name);
+}
+
+#ifdef IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+TEST_CASE("crc64_nvme_combine", "[upload_checksum][crc64_nvme_combine]")
+{
+    using irods::experimental::io::s3_transport::crc64_nvme_combine;
+    using irods::experimental::io::s3_transport::decode_crc64_nvme_checksum;
+    using irods::experimental::io::s3_transport::encode_crc64_nvme_checksum;
+    using irods::experimental::io::s3_transport::remove_checksum_prefix;
+
+    auto crc_of = [](const std::string& _data) {
+        irods::Hasher hasher;
+        irods::getHasher(irods::CRC64NVME_NAME, hasher);
+        hasher.update(_data);
+        std::string digest;
+        hasher.digest(digest);
+        remove_checksum_prefix(digest, irods::CRC64NVME_NAME + ":");
+        std::uint64_t crc = 0;
+        REQUIRE(decode_crc64_nvme_checksum(digest, crc));
+        REQUIRE(encode_crc64_nvme_checksum(crc) == digest);
+        return crc;
+    };
+
+    // CRC64/NVME check value
+    REQUIRE(crc_of("123456789") == 0xae8b14860a799888ULL);
+
+    std::string data(100000, '\0');
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 31 + i / 257);
+    }
+    const std::uint64_t expected = crc_of(data);
+
+    for (std::size_t split : {std::size_t{0}, std::size_t{1}, std::size_t{4096}, data.size() - 1, data.size()}) {
+        const std::uint64_t crc1 = crc_of(data.substr(0, split));
+        const std::uint64_t crc2 = crc_of(data.substr(split));
+        REQUIRE(crc64_nvme_combine(crc1, crc2, data.size() - split) == expected);
+    }
+}
+
+TEST_CASE("crc64_nvme_update", "[upload_checksum][crc64_nvme_update]")
+{
+    using irods::experimental::io::s3_transport::crc64_nvme_update;
+    using irods::experimental::io::s3_transport::crc64_nvme_update_portable;
+    using irods::experimental::io::s3_transport::crc64_nvme_implementation;
+    using irods::experimental::io::s3_transport::encode_crc64_nvme_checksum;
+
+    INFO("implementation: " << crc64_nvme_implementation());
+
+    std::string data(5000, '\0');
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 131 + i / 7);
+    }
+
+    // every length up to a few folding strides and every alignment within a 32 byte register
+    for (std::size_t offset = 0; offset < 32; ++offset) {
+        for (std::size_t length = 0; offset + length <= data.size(); length += (length < 600 ? 1 : 97)) {
+            std::span<const char> span{data.data() + offset, length};
+
+            irods::Hasher hasher;
+            irods::getHasher(irods::CRC64NVME_NAME, hasher);
+            hasher.update(std::string(span.data(), span.size()));
+            std::string expected;
+            hasher.digest(expected);
+
+            const std::uint64_t crc = crc64_nvme_update(0, span);
+            REQUIRE(irods::CRC64NVME_NAME + ":" + encode_crc64_nvme_checksum(crc) == expected);
+            REQUIRE(crc64_nvme_update_portable(0, span) == crc);
+
+            // hashing in pieces is the same as hashing all at once
+            const std::size_t split = length / 3;
+            REQUIRE(crc64_nvme_update(crc64_nvme_update(0, span.first(split)), span.subspan(split)) == crc);
+        }
+    }
+}
+#endif // IRODS_LIBRARY_FEATURE_CHECKSUM_ALGORITHM_CRC64NVME
+
+TEST_CASE("cache_file_reader", "[cache_file_reader]")
+{
+    using irods::experimental::io::s3_transport::cache_file_reader;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "s3_transport_cache_file_reader_test").string();
+    std::string data(1024 * 1024 + 17, '\0');
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 131 + i / 7);
+    }
+    {
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs.write(data.data(), data.size());
+    }
+
+    {
+        cache_file_reader reader{path};
+        REQUIRE(reader.is_open());
+        REQUIRE(reader.size() == static_cast<std::int64_t>(data.size()));
+
+        // read the file in parts the way the flush threads do, with buffers that do not divide the part
+        const std::int64_t part_size = 300 * 1024;
+        const std::int64_t buffer_size = 64 * 1024 - 3;
+        std::string buffer(buffer_size, '\0');
+        std::string result;
+        for (std::int64_t part_offset = 0; part_offset < reader.size(); part_offset += part_size) {
+            reader.will_need(part_offset, part_size);
+            const std::int64_t part_end = std::min(part_offset + part_size, reader.size());
+            for (std::int64_t offset = part_offset; offset < part_end; ) {
+                auto n = reader.read(offset, buffer.data(), std::min(buffer_size, part_end - offset));
+                REQUIRE(n > 0);
+                result.append(buffer.data(), n);
+                offset += n;
+            }
+        }
+        CHECK(result == data);
+
+        // short read at the end of the file and nothing past it
+        CHECK(reader.read(data.size() - 10, buffer.data(), 100) == 10);
+        CHECK(reader.read(data.size(), buffer.data(), 100) == 0);
+        CHECK(reader.read(-1, buffer.data(), 100) == -1);
+    }
+
+    std::remove(path.c_str());
+
+    cache_file_reader missing{path};
+    CHECK_FALSE(missing.is_open());
+    CHECK(missing.size() == -1);
+}
+
+TEST_CASE("io_uring_file_io", "[io_uring_file_io]")
+{
+    using irods::experimental::io::s3_transport::io_uring_file_io;
+
+    if (!io_uring_file_io::is_supported()) {
+        SKIP("io_uring is not available");
+    }
+
+    const std::string path = (std::filesystem::temp_directory_path() / "s3_transport_io_uring_file_io_test").string();
+    std::string data(3 * 1024 * 1024 + 12345, '\0');
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 131 + i / 7);
+    }
+
+    // small buffers so that writes and reads span many buffers
+    const std::size_t buffer_size = 64 * 1024;
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    REQUIRE(fd != -1);
+
+    {
+        io_uring_file_io io{4, buffer_size};
+        REQUIRE(io.is_open());
+
+        // two parts written by the same ring in pieces the size libs3 hands over, the second first
+        const std::size_t split = data.size() / 3 + 1;
+        for (auto [begin, end] : {std::pair{split, data.size()}, std::pair{std::size_t{0}, split}}) {
+            for (std::size_t offset = begin; offset < end; ) {
+                const std::size_t n = std::min<std::size_t>(16 * 1024 - 7, end - offset);
+                REQUIRE(io.write(fd, offset, data.data() + offset, n));
+                offset += n;
+            }
+        }
+        REQUIRE(io.wait_for_writes());
+    }
+
+    struct stat st{};
+    REQUIRE(::fstat(fd, &st) == 0);
+    REQUIRE(static_cast<std::size_t>(st.st_size) == data.size());
+
+    {
+        io_uring_file_io io{4, buffer_size};
+        REQUIRE(io.is_open());
+
+        // sequential read of a range in pieces that do not divide the buffers
+        const std::int64_t begin = 1000;
+        const std::int64_t end = static_cast<std::int64_t>(data.size()) - 1000;
+        std::string buffer(20000, '\0');
+        std::string result;
+        for (std::int64_t offset = begin; offset < end; ) {
+            auto n = io.read(fd, offset, buffer.data(), std::min<std::int64_t>(buffer.size(), end - offset), end);
+            REQUIRE(n > 0);
+            result.append(buffer.data(), n);
+            offset += n;
+        }
+        CHECK(result == data.substr(begin, end - begin));
+
+        // a retry starts over at an earlier offset
+        auto n = io.read(fd, 10, buffer.data(), buffer.size(), data.size());
+        REQUIRE(n > 0);
+        CHECK(std::string(buffer.data(), n) == data.substr(10, n));
+
+        // reading ahead to past the end of the file stops at the end of the file
+        std::int64_t offset = data.size() - 100000;
+        result.clear();
+        while (true) {
+            n = io.read(fd, offset, buffer.data(), buffer.size(), data.size() + 1000000);
+            REQUIRE(n >= 0);
+            if (n == 0) {
+                break;
+            }
+            result.append(buffer.data(), n);
+            offset += n;
+        }
+        CHECK(result == data.substr(data.size() - 100000));
+    }
+
+    ::close(fd);
+    std::remove(path.c_str());
+}
+
+// The read cache index outlives the processes that use it.  Remove it so that it is rebuilt
+// from the block files in the directory.
+static void remove_read_cache_index()
+{
+    for (const auto& entry : std::filesystem::directory_iterator("/dev/shm")) {
+        if (entry.path().filename().string().find("irods_s3-read-cache-") != std::string::npos) {
+            std::filesystem::remove(entry.path());
+        }
+    }
+}
+
+TEST_CASE("read_cache", "[read_cache]")
+{
+    using irods::experimental::io::s3_transport::read_cache;
+
+    const auto directory = std::filesystem::temp_directory_path() / "s3_transport_read_cache_test";
+    const auto block_directory = directory / "read_cache";
+    std::filesystem::remove_all(directory);
+    remove_read_cache_index();
+
+    const std::int64_t block_size = read_cache::BLOCK_SIZE;
+    const auto object_id = read_cache::make_object_id("bucket", "key");
+    const auto other_object_id = read_cache::make_object_id("bucket", "other key");
+    const auto version_id = read_cache::make_version_id("etag", 3 * block_size, 100);
+    const auto new_version_id = read_cache::make_version_id("etag2", 3 * block_size, 101);
+    CHECK(object_id != read_cache::make_object_id("bucke", "tkey"));
+    CHECK(version_id != read_cache::make_version_id("etag", 3 * block_size, 101));
+
+    std::string block(block_size, '\0');
+    std::string buffer(100, '\0');
+
+    {
+        read_cache cache{directory.string(), 3 * block_size};
+        CHECK(cache.read(object_id, version_id, 0, 0, buffer.data(), 100) == -1);
+
+        // the last block of an object is short
+        for (std::uint64_t i = 0; i < 3; ++i) {
+            std::fill(block.begin(), block.end(), static_cast<char>('a' + i));
+            cache.store(object_id, version_id, i, block.data(), i == 2 ? 1000 : block_size);
+        }
+        CHECK(cache.read(object_id, version_id, 1, 5, buffer.data(), 100) == 100);
+        CHECK(buffer[0] == 'b');
+        CHECK(cache.read(object_id, version_id, 2, 900, buffer.data(), 100) == 100);
+        CHECK(buffer[99] == 'c');
+
+        // block 1 is the least recently used so it is evicted to make room for block 3
+        CHECK(cache.read(object_id, version_id, 0, 0, buffer.data(), 10) == 10);
+        cache.store(object_id, version_id, 3, block.data(), block_size);
+        CHECK(cache.read(object_id, version_id, 1, 0, buffer.data(), 10) == -1);
+        CHECK(cache.read(object_id, version_id, 0, 0, buffer.data(), 10) == 10);
+
+        const auto stats = cache.get_statistics();
+        CHECK(stats.hits == 4);
+        CHECK(stats.misses == 2);
+        CHECK(stats.insertions == 4);
+        CHECK(stats.evictions == 1);
+        CHECK(stats.number_of_blocks == 3);
+        CHECK(stats.bytes_used == static_cast<std::uint64_t>(2 * block_size + 1000));
+
+        cache.export_statistics();
+        CHECK(std::filesystem::exists(block_directory / "statistics.json"));
+    }
+
+    {
+        // the index is shared, opening a new version removes the blocks of the old one and
+        // leaves those of other objects
+        read_cache cache{directory.string(), 4 * block_size};
+        cache.store(other_object_id, version_id, 0, block.data(), 1000);
+        CHECK(cache.read(object_id, version_id, 0, 0, buffer.data(), 10) == 10);
+        cache.invalidate_other_versions(object_id, new_version_id);
+        CHECK(cache.read(object_id, version_id, 0, 0, buffer.data(), 10) == -1);
+        CHECK(cache.read(object_id, version_id, 3, 0, buffer.data(), 10) == -1);
+        CHECK(cache.read(other_object_id, version_id, 0, 0, buffer.data(), 10) == 10);
+        CHECK(cache.get_statistics().number_of_blocks == 1);
+        cache.store(object_id, new_version_id, 0, block.data(), block_size);
+        cache.store(object_id, new_version_id, 1, block.data(), block_size);
+    }
+
+    // the block files are reused when the index is rebuilt and anything else is removed
+    remove_read_cache_index();
+    std::ofstream(block_directory / "unknown_file") << "x";
+    {
+        read_cache cache{directory.string(), 3 * block_size};
+        CHECK(cache.get_statistics().number_of_blocks == 3);
+        CHECK(cache.read(object_id, new_version_id, 1, 0, buffer.data(), 10) == 10);
+        CHECK_FALSE(std::filesystem::exists(block_directory / "unknown_file"));
+    }
+
+    // a smaller cache evicts on load
+    remove_read_cache_index();
+    {
+        read_cache cache{directory.string(), block_size};
+        CHECK(cache.get_statistics().number_of_blocks == 1);
+    }
+
+    remove_read_cache_index();
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("read_page_cache", "[read_page_cache]")
+{
+    using irods::experimental::io::s3_transport::read_page_cache;
+
+    std::string object(10 * 1024 * 1024 + 123, '\0');
+    for (std::size_t i = 0; i < object.size(); ++i) {
+        object[i] = static_cast<char>(i * 131 + i / 7);
+    }
+    const auto object_size = static_cast<std::int64_t>(object.size());
+
+    int number_of_gets = 0;
+    auto fetch = [&object, &number_of_gets](char* _buffer, std::int64_t _offset, std::int64_t _length) -> std::int64_t
+    {
+        ++number_of_gets;
+        std::memcpy(_buffer, object.data() + _offset, _length);
+        return _length;
+    };
+
+    read_page_cache cache{64 * 1024, 1024 * 1024, object_size};
+    std::string buffer(4096, '\0');
+
+    // 1000 byte records read one at a time are merged into a few GETs
+    for (std::int64_t offset = 0; offset < 4 * 1024 * 1024; offset += 1000) {
+        REQUIRE(cache.read(offset, buffer.data(), 1000, fetch) == 1000);
+        REQUIRE(std::memcmp(buffer.data(), object.data() + offset, 1000) == 0);
+    }
+    CHECK(number_of_gets <= 8);
+
+    // random reads, including ones that cross pages and the end of the object
+    std::mt19937_64 generator{1};
+    for (int i = 0; i < 2000; ++i) {
+        const std::int64_t offset = generator() % object_size;
+        const std::int64_t length = 1 + generator() % buffer.size();
+        const auto expected = std::min(length, object_size - offset);
+        REQUIRE(cache.read(offset, buffer.data(), length, fetch) == expected);
+        REQUIRE(std::memcmp(buffer.data(), object.data() + offset, expected) == 0);
+    }
+    CHECK(cache.read(object_size, buffer.data(), 10, fetch) == 0);
+
+    const auto stats = cache.get_statistics();
+    CHECK(stats.requests == static_cast<std::uint64_t>(number_of_gets));
+    CHECK(stats.hits > 0);
+
+    // a failed GET is reported
+    read_page_cache failing_cache{64 * 1024, 0, object_size};
+    CHECK(failing_cache.read(0, buffer.data(), 10, [](char*, std::int64_t, std::int64_t) -> std::int64_t { return 0; }) == -1);
+}
+
+// Builds a ListObjectsV2 response like the ones S3 returns for a collection with
+// _number_of_keys data objects and _number_of_prefixes sub-collections.
+static std::string make_list_objects_v2_response(int _number_of_keys, int _number_of_prefixes)
+{
+    std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+        "<Name>bucket</Name><Prefix>home/rods/coll/</Prefix>"
+        "<NextContinuationToken>1ueGcxLPRx1Tr/XYExHnhbYLgveDs2J/wm36Hy4vbOwM=</NextContinuationToken>"
+        "<KeyCount>" + std::to_string(_number_of_keys + _number_of_prefixes) + "</KeyCount>"
+        "<MaxKeys>1000</MaxKeys><Delimiter>/</Delimiter><IsTruncated>true</IsTruncated>";
+    for (int i = 0; i < _number_of_keys; ++i) {
+        xml += fmt::format("<Contents><Key>home/rods/coll/data_object_{:06}</Key>"
+                "<LastModified>2024-05-01T12:00:00.000Z</LastModified>"
+                "<ETag>&quot;9b2cf535f27731c974343645a3985328&quot;</ETag>"
+                "<Size>{}</Size><StorageClass>STANDARD</StorageClass></Contents>", i, i * 1000);
+    }
+    for (int i = 0; i < _number_of_prefixes; ++i) {
+        xml += fmt::format("<CommonPrefixes><Prefix>home/rods/coll/subcollection_{:04}/</Prefix></CommonPrefixes>", i);
+    }
+    xml += "</ListBucketResult>";
+    return xml;
+}
+
+struct list_objects_v2_results
+{
+    int number_of_callbacks{0};
+    bool is_truncated{false};
+    std::string next_continuation_token;
+    std::vector<std::string> keys;
+    std::vector<std::uint64_t> sizes;
+    std::vector<std::string> etags;
+    std::vector<std::string> prefixes;
+};
+
+static S3Status collect_list_objects_v2_results(int _is_truncated, const char* _next_marker, int _contents_count,
+        const S3ListBucketContent* _contents, int _common_prefixes_count, const char** _common_prefixes,
+        void* _callback_data)
+{
+    auto* results = static_cast<list_objects_v2_results*>(_callback_data);
+    ++results->number_of_callbacks;
+    results->is_truncated = _is_truncated;
+    results->next_continuation_token = _next_marker;
+    for (int i = 0; i < _contents_count; ++i) {
+        results->keys.emplace_back(_contents[i].key);
+        results->sizes.push_back(_contents[i].size);
+        results->etags.emplace_back(_contents[i].eTag);
+    }
+    for (int i = 0; i < _common_prefixes_count; ++i) {
+        results->prefixes.emplace_back(_common_prefixes[i]);
+    }
+    return S3StatusOK;
+}
+
+TEST_CASE("list_objects_v2_parse", "[list_objects_v2_parse]")
+{
+    const std::string xml = make_list_objects_v2_response(1000, 20);
+
+    list_objects_v2_results results;
+    REQUIRE(S3_parse_list_bucket_response(xml.data(), xml.size(), &collect_list_objects_v2_results, &results) == S3StatusOK);
+
+    // the whole page is delivered at once
+    CHECK(results.number_of_callbacks == 1);
+    CHECK(results.is_truncated);
+    CHECK(results.next_continuation_token == "1ueGcxLPRx1Tr/XYExHnhbYLgveDs2J/wm36Hy4vbOwM=");
+    REQUIRE(results.keys.size() == 1000);
+    CHECK(results.keys.front() == "home/rods/coll/data_object_000000");
+    CHECK(results.keys.back() == "home/rods/coll/data_object_000999");
+    CHECK(results.sizes.back() == 999000);
+    REQUIRE(results.prefixes.size() == 20);
+    CHECK(results.prefixes.back() == "home/rods/coll/subcollection_0019/");
+    CHECK(results.etags.front() == "\"9b2cf535f27731c974343645a3985328\"");
+}
+
+TEST_CASE("list_objects_v2_parse_escaped_values", "[list_objects_v2_parse]")
+{
+    const std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">\n"
+        "  <IsTruncated>false</IsTruncated>\n"
+        "  <Contents>\n"
+        "    <Key>a &amp; b &lt;c&gt; &apos;d&apos; &#233;&#x4E2D;</Key>\n"
+        "    <ETag>&quot;etag&quot;</ETag>\n"
+        "    <Size>12</Size>\n"
+        "  </Contents>\n"
+        "  <Contents><Key>empty</Key><ETag/><Size>0</Size></Contents>\n"
+        "  <CommonPrefixes><Prefix>x&amp;y/</Prefix></CommonPrefixes>\n"
+        "</ListBucketResult>";
+
+    list_objects_v2_results results;
+    REQUIRE(S3_parse_list_bucket_response(xml.data(), xml.size(), &collect_list_objects_v2_results, &results) == S3StatusOK);
+
+    CHECK(!results.is_truncated);
+    CHECK(results.next_continuation_token.empty());
+    REQUIRE(results.keys.size() == 2);
+    CHECK(results.keys[0] == "a & b <c> 'd' \xC3\xA9\xE4\xB8\xAD");
+    CHECK(results.etags[0] == "\"etag\"");
+    CHECK(results.sizes[0] == 12);
+    CHECK(results.keys[1] == "empty");
+    CHECK(results.etags[1].empty());
+    REQUIRE(results.prefixes.size() == 1);
+    CHECK(results.prefixes[0] == "x&y/");
+
+    // truncated and malformed responses are rejected
+    CHECK(S3_parse_list_bucket_response(xml.data(), xml.size() / 2, &collect_list_objects_v2_results, &results) == S3StatusXmlParseFailure);
+    const std::string mismatched = "<ListBucketResult><Contents><Key>k</Size></Contents></ListBucketResult>";
+    CHECK(S3_parse_list_bucket_response(mismatched.data(), mismatched.size(), &collect_list_objects_v2_results, &results) == S3StatusXmlParseFailure);
+}
+
+struct delete_objects_results
+{
+    S3Status status{S3StatusOK};
+    std::vector<std::string> deleted;
+    std::vector<std::string> failed;
+};
+
+static S3Status collect_delete_objects_results(const char* _key, S3Status _status, const char*, const char*,
+        void* _callback_data)
+{
+    auto* results = static_cast<delete_objects_results*>(_callback_data);
+    (_status == S3StatusOK ? results->deleted : results->failed).emplace_back(_key);
+    return S3StatusOK;
+}
+
+static void delete_objects_complete(S3Status _status, const S3ErrorDetails*, void* _callback_data)
+{
+    static_cast<delete_objects_results*>(_callback_data)->status = _status;
+}
+
+static void list_objects_v2_complete(S3Status, const S3ErrorDetails*, void*)
+{
+}
+
+TEST_CASE("s3_delete_objects", "[delete_objects]")
+{
+    std::string bucket_name = create_bucket();
+    const std::string object_prefix = "delete_objects/";
+    const int number_of_objects = 20;
+
+    upload_small_objects(bucket_name, object_prefix, keyfile, number_of_objects, 1024, 0, false);
+
+    std::string access_key, secret_access_key;
+    read_keys(keyfile, access_key, secret_access_key);
+
+    REQUIRE(S3_initialize("s3", S3_INIT_ALL, hostname.c_str()) == S3StatusOK);
+
+    S3BucketContext bucket_context{};
+    bucket_context.hostName = hostname.c_str();
+    bucket_context.bucketName = bucket_name.c_str();
+    bucket_context.protocol = S3ProtocolHTTP;
+    bucket_context.uriStyle = S3UriStylePath;
+    bucket_context.stsDate = S3STSAmzOnly;
+    bucket_context.accessKeyId = access_key.c_str();
+    bucket_context.secretAccessKey = secret_access_key.c_str();
+    bucket_context.authRegion = "us-east-1";
+
+    // all but the last object, plus a key that does not exist
+    std::vector<std::string> keys;
+    for (int i = 0; i < number_of_objects - 1; ++i) {
+        keys.push_back(fmt::format("{}small_object_{}", object_prefix, i));
+    }
+    keys.push_back(object_prefix + "does not exist & never did");
+    std::vector<const char*> key_pointers;
+    for (const auto& key : keys) {
+        key_pointers.push_back(key.c_str());
+    }
+
+    S3DeleteObjectsHandler handler{{nullptr, &delete_objects_complete}, &collect_delete_objects_results};
+
+    delete_objects_results results;
+    S3_delete_objects(&bucket_context, key_pointers.size(), key_pointers.data(), 0, nullptr, 0, &handler, &results);
+    CHECK(results.status == S3StatusOK);
+    CHECK(results.failed.empty());
+    CHECK(results.deleted.size() == keys.size());
+
+    // only the last object is left
+    list_objects_v2_results list_results;
+    S3ListBucketHandler list_handler{{nullptr, &list_objects_v2_complete}, &collect_list_objects_v2_results};
+    S3_list_objects_v2(&bucket_context, object_prefix.c_str(), nullptr, nullptr, nullptr, 0, nullptr, 0,
+            &list_handler, &list_results);
+    REQUIRE(list_results.keys.size() == 1);
+    CHECK(list_results.keys.front() == fmt::format("{}small_object_{}", object_prefix, number_of_objects - 1));
+
+    // too many keys for one request
+    std::vector<const char*> too_many_keys(S3_MAX_DELETE_OBJECTS_COUNT + 1, key_pointers.front());
+    S3_delete_objects(&bucket_context, too_many_keys.size(), too_many_keys.data(), 1, nullptr, 0, &handler, &results);
+    CHECK(results.status == S3StatusXmlDocumentTooLarge);
+
+    S3_deinitialize();
+
+    remove_bucket(bucket_name);
+}
+
+struct head_object_results
+{
+    S3Status status{S3StatusOK};
+    std::int64_t content_length{-1};
+};
+
+static S3Status head_object_properties(const S3ResponseProperties* _properties, void* _callback_data)
+{
+    static_cast<head_object_results*>(_callback_data)->content_length = _properties->contentLength;
+    return S3StatusOK;
+}
+
+static void head_object_complete(S3Status _status, const S3ErrorDetails*, void* _callback_data)
+{
+    static_cast<head_object_results*>(_callback_data)->status = _status;
+}
+
+// The first open initializes the library and it stays initialized after the transport is
+// destroyed, so the next operation reuses the pooled requests and their connections.
+TEST_CASE("s3_transport_keeps_library_initialized", "[s3_initialize]")
+{
+    std::string bucket_name = create_bucket();
+    const std::string object_prefix = "keeps_library_initialized/";
+    const std::int64_t object_size = 1024;
+
+    // the transport initializes the library with the S3 host as the default host
+    upload_small_objects(bucket_name, object_prefix, keyfile, 1, object_size, 0, false);
+
+    std::string access_key, secret_access_key;
+    read_keys(keyfile, access_key, secret_access_key);
+
+    // While the library is initialized this only counts, and the default host is kept.  Had the
+    // transport deinitialized it, the default host would now be one that does not resolve.
+    REQUIRE(S3_initialize("s3", S3_INIT_ALL, "s3.invalid") == S3StatusOK);
+
+    S3BucketContext bucket_context{};
+    bucket_context.hostName = nullptr;
+    bucket_context.bucketName = bucket_name.c_str();
+    bucket_context.protocol = S3ProtocolHTTP;
+    bucket_context.uriStyle = S3UriStylePath;
+    bucket_context.stsDate = S3STSAmzOnly;
+    bucket_context.accessKeyId = access_key.c_str();
+    bucket_context.secretAccessKey = secret_access_key.c_str();
+    bucket_context.authRegion = "us-east-1";
+
+    const auto key = fmt::format("{}small_object_0", object_prefix);
+    S3ResponseHandler handler{&head_object_properties, &head_object_complete};
+    head_object_results results;
+    S3_head_object(&bucket_context, key.c_str(), nullptr, 0, &handler, &results);
+    CHECK(results.status == S3StatusOK);
+    CHECK(results.content_length == object_size);
+
+    S3_deinitialize();
+
+    remove_bucket(bucket_name);
+}
+
 TEST_CASE("s3_transport_upload_multiple_threads", "[upload][thread]")
 {
 
@@ -1140,6 +2109,23 @@ TEST_CASE("s3_transport_readwrite_thread", "[rw][thread]")
         std::ios_base::openmode open_modes = std::ios_base::in | std::ios_base::out | std::ios_base::app;
         do_read_write_thread(bucket_name, filename, object_prefix, keyfile, thread_count, open_modes);
 
+    }
+
+    SECTION("read write medium file with sparse cache file")
+    {
+        // only the first and last parts are written, the others are copied within S3
+        thread_count = 8;
+        std::ios_base::openmode open_modes = std::ios_base::in | std::ios_base::out;
+        do_read_write_thread(bucket_name, filename, object_prefix, keyfile, thread_count, open_modes, true);
+
+    }
+
+    SECTION("append medium file with sparse cache file")
+    {
+        // the existing object is copied and only the appended bytes are uploaded
+        std::ios_base::openmode open_modes = std::ios_base::in | std::ios_base::out | std::ios_base::app;
+        do_read_write_thread(bucket_name, filename, object_prefix, keyfile, thread_count, open_modes, true);
+
     }
     remove_bucket(bucket_name);
 }
@@ -1167,6 +2153,47 @@ TEST_CASE("test_seek_end_existing_file", "[seek_end]")
     remove_bucket(bucket_name);
 }
 
+TEST_CASE("s3_transport_existing_object_metadata", "[download][existing_object_metadata]")
+{
+    std::string bucket_name = create_bucket();
+    std::string filename = "small_file";
+    std::string object_prefix = "dir1/dir2/";
+
+    test_existing_object_metadata(bucket_name, filename, object_prefix, keyfile);
+
+    remove_bucket(bucket_name);
+}
+
+TEST_CASE("s3_transport_receive_ranges", "[download][receive_ranges]")
+{
+    std::string bucket_name = create_bucket();
+    std::string filename = "medium_file";
+    std::string object_prefix = "dir1/dir2/";
+
+    test_receive_ranges(bucket_name, filename, object_prefix, keyfile);
+
+    remove_bucket(bucket_name);
+}
+
+TEST_CASE("s3_transport_sparse_cache_file_object_replaced", "[rw][sparse_cache_file]")
+{
+    std::string bucket_name = create_bucket();
+    std::string filename = "medium_file";
+    std::string object_prefix = "dir1/dir2/";
+
+    SECTION("update")
+    {
+        test_sparse_cache_file_object_replaced(bucket_name, filename, object_prefix, keyfile, false);
+    }
+
+    SECTION("append with copy")
+    {
+        test_sparse_cache_file_object_replaced(bucket_name, filename, object_prefix, keyfile, true);
+    }
+
+    remove_bucket(bucket_name);
+}
+
 TEST_CASE("test_part_splits", "[part_splits]")
 {
 